@@ -17,6 +17,7 @@
 #include <QtMultimedia/private/qaudiohelpers_p.h>
 #include "qalsaaudiosink_p.h"
 #include "qalsaaudiodevice_p.h"
+#include "qalsammap_p.h"
 #include <QLoggingCategory>
 
 QT_BEGIN_NAMESPACE
@@ -44,6 +45,8 @@ QAlsaAudioSink::~QAlsaAudioSink()
 void QAlsaAudioSink::setVolume(qreal vol)
 {
     m_volume = vol;
+    if (ioThread)
+        ioThread->setVolume(vol);
 }
 
 qreal QAlsaAudioSink::volume() const
@@ -73,6 +76,7 @@ int QAlsaAudioSink::xrun_recovery(int err)
 #endif
 
     if(err == -EPIPE) {
+        recordUnderrun();
         errorState = QAudio::UnderrunError;
         emit errorChanged(errorState);
         err = snd_pcm_prepare(handle);
@@ -109,7 +113,7 @@ int QAlsaAudioSink::setFormat()
 {
     snd_pcm_format_t pcmformat = SND_PCM_FORMAT_UNKNOWN;
 
-    switch (settings.sampleFormat()) {
+    switch (deviceFormat.sampleFormat()) {
     case QAudioFormat::UInt8:
         pcmformat = SND_PCM_FORMAT_U8;
         break;
@@ -159,7 +163,12 @@ void QAlsaAudioSink::start(QIODevice* device)
     audioSource = device;
 
     connect(audioSource, &QIODevice::readyRead, timer, [this] {
-        if (!timer->isActive()) {
+        if (ioThread) {
+            // The I/O thread asks for data while the ring buffer drains, not after the
+            // source has run dry
+            if (deviceState == QAudio::IdleState)
+                userFeed();
+        } else if (!timer->isActive()) {
             timer->start(period_time / 1000);
         }
     });
@@ -218,6 +227,8 @@ bool QAlsaAudioSink::open()
     qDebug()<<now.second()<<"s "<<now.msec()<<"ms :open()";
 #endif
     elapsedTimeOffset = 0;
+    telemetry.reset();
+    underrunRecorded = false;
 
     int dir;
     int err = 0;
@@ -274,14 +285,38 @@ bool QAlsaAudioSink::open()
         }
     }
     if ( !fatal ) {
+        static const bool user_mmap = qEnvironmentVariableIntValue("QT_ALSA_OUTPUT_MMAP");
+        access = user_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED;
         err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        if (err < 0 && access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+            qCDebug(lcAlsaOutput) << "mmap access is not supported, using read/write access";
+            access = SND_PCM_ACCESS_RW_INTERLEAVED;
+            err = snd_pcm_hw_params_set_access( handle, hwparams, access );
+        }
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioSink: snd_pcm_hw_params_set_access: err = %1").arg(err);
         }
     }
     if ( !fatal ) {
+        deviceFormat = settings;
         err = setFormat();
+        if (err < 0 && access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+            // The samples are converted while they are written into the mmapped buffer.
+            // UInt8 is not a fallback, it would drop all but the 8 most significant bits.
+            for (auto sampleFormat :
+                 { QAudioFormat::Float, QAudioFormat::Int32, QAudioFormat::Int16 }) {
+                if (sampleFormat == settings.sampleFormat())
+                    continue;
+                deviceFormat.setSampleFormat(sampleFormat);
+                err = setFormat();
+                if (err >= 0) {
+                    qCDebug(lcAlsaOutput) << "converting" << settings.sampleFormat() << "to"
+                                          << sampleFormat;
+                    break;
+                }
+            }
+        }
         if ( err < 0 ) {
             fatal = true;
             errMessage = QString::fromLatin1("QAudioSink: snd_pcm_hw_params_set_format: err = %1").arg(err);
@@ -373,9 +408,9 @@ bool QAlsaAudioSink::open()
         return false;
     }
     snd_pcm_hw_params_get_buffer_size(hwparams,&buffer_frames);
-    buffer_size = snd_pcm_frames_to_bytes(handle,buffer_frames);
+    buffer_size = settings.bytesForFrames(buffer_frames);
     snd_pcm_hw_params_get_period_size(hwparams,&period_frames, &dir);
-    period_size = snd_pcm_frames_to_bytes(handle,period_frames);
+    period_size = settings.bytesForFrames(period_frames);
     snd_pcm_hw_params_get_buffer_time(hwparams,&buffer_time, &dir);
     snd_pcm_hw_params_get_period_time(hwparams,&period_time, &dir);
 
@@ -390,21 +425,51 @@ bool QAlsaAudioSink::open()
 
     // Step 4: Prepare audio
     if(audioBuffer == 0)
-        audioBuffer = new char[snd_pcm_frames_to_bytes(handle,buffer_frames)];
+        audioBuffer = new char[settings.bytesForFrames(buffer_frames)];
     snd_pcm_prepare( handle );
-    snd_pcm_start(handle);
+
+    const QAlsaIOThread::Config &ioConfig = QAlsaIOThread::Config::fromEnvironment();
+    if (ioConfig.enabled) {
+        ioThread = std::make_unique<QAlsaIOThread>(
+                handle, QAlsaIOThread::Playback, settings, period_frames, ioConfig,
+                [this] {
+                    // The sink may have closed the thread by the time it's delivered
+                    QMetaObject::invokeMethod(
+                            this, [this] { if (ioThread) userFeed(); }, Qt::QueuedConnection);
+                },
+                [this] {
+                    QMetaObject::invokeMethod(this, &QAlsaAudioSink::handleIOThreadError,
+                                              Qt::QueuedConnection);
+                });
+        if (!ioThread->isValid()) {
+            ioThread.reset();
+        } else {
+            ioThread->setVolume(m_volume);
+            ioThread->setTelemetry(&telemetry);
+            if (access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+                ioThread->setMMapFormat(deviceFormat);
+        }
+    }
+
+    // The device starts with the first period written by the I/O thread
+    if (!ioThread)
+        snd_pcm_start(handle);
 
     // Step 5: Setup timer
     bytesAvailable = bytesFree();
 
-    // Step 6: Start audio processing
-    timer->start(period_time/1000);
+    // Step 6: Start audio processing; the I/O thread asks for data by itself
+    if (!ioThread)
+        timer->start(period_time/1000);
 
     elapsedTimeOffset = 0;
     errorState  = QAudio::NoError;
     totalTimeValue = 0;
     opened = true;
 
+    if (ioThread)
+        ioThread->startIO();
+
     return true;
 }
 
@@ -412,6 +477,15 @@ void QAlsaAudioSink::close()
 {
     timer->stop();
 
+    if (ioThread) {
+        ioThread->stopIO();
+        totalTimeValue += ioThread->processedFrames();
+        ioThread.reset();
+    }
+
+    if (opened)
+        telemetry.log("QAlsaAudioSink");
+
     if ( handle ) {
         snd_pcm_drain( handle );
         snd_pcm_close( handle );
@@ -428,6 +502,12 @@ void QAlsaAudioSink::close()
 
 qsizetype QAlsaAudioSink::bytesFree() const
 {
+    if (ioThread) {
+        if (deviceState != QAudio::ActiveState && deviceState != QAudio::IdleState)
+            return 0;
+        return ioThread->ringBuffer().free();
+    }
+
     if(resuming)
         return period_size;
 
@@ -449,7 +529,7 @@ qsizetype QAlsaAudioSink::bytesFree() const
     if ((int)frames > (int)buffer_frames)
         frames = buffer_frames;
 
-    return snd_pcm_frames_to_bytes(handle, frames);
+    return settings.bytesForFrames(frames);
 }
 
 qint64 QAlsaAudioSink::write( const char *data, qint64 len )
@@ -459,8 +539,23 @@ qint64 QAlsaAudioSink::write( const char *data, qint64 len )
         return 0;
 #ifdef DEBUG_AUDIO
     qDebug()<<"frames to write out = "<<
-        snd_pcm_bytes_to_frames( handle, (int)len )<<" ("<<len<<") bytes";
+        settings.framesForBytes((int)len)<<" ("<<len<<") bytes";
 #endif
+    if (ioThread) {
+        auto &ring = ioThread->ringBuffer();
+        const int written = ring.write(QSpan<const char>(data, qMin<qint64>(len, ring.free())));
+        if (written > 0) {
+            ioThread->wake();
+            resuming = false;
+            errorState = QAudio::NoError;
+            if (deviceState != QAudio::ActiveState) {
+                deviceState = QAudio::ActiveState;
+                emit stateChanged(deviceState);
+            }
+        }
+        return written;
+    }
+
     int frames, err;
     int space = bytesFree();
 
@@ -470,9 +565,11 @@ qint64 QAlsaAudioSink::write( const char *data, qint64 len )
     if (len < space)
         space = len;
 
-    frames = snd_pcm_bytes_to_frames(handle, space);
+    frames = settings.framesForBytes(space);
 
-    if (m_volume < 1.0f) {
+    if (access == SND_PCM_ACCESS_MMAP_INTERLEAVED) {
+        err = QAlsaMMap::writeInterleaved(handle, data, frames, settings, deviceFormat, m_volume);
+    } else if (m_volume < 1.0f) {
         QVarLengthArray<char, 4096> out(space);
         QAudioHelperInternal::qMultiplySamples(m_volume, settings, data, out.data(), space);
         err = snd_pcm_writei(handle, out.constData(), frames);
@@ -482,13 +579,15 @@ qint64 QAlsaAudioSink::write( const char *data, qint64 len )
 
     if(err > 0) {
         totalTimeValue += err;
+        updateTelemetry();
         resuming = false;
+        underrunRecorded = false;
         errorState = QAudio::NoError;
         if (deviceState != QAudio::ActiveState) {
             deviceState = QAudio::ActiveState;
             emit stateChanged(deviceState);
         }
-        return snd_pcm_frames_to_bytes( handle, err );
+        return settings.bytesForFrames(err);
     } else
         err = xrun_recovery(err);
 
@@ -515,7 +614,25 @@ qsizetype QAlsaAudioSink::bufferSize() const
 
 qint64 QAlsaAudioSink::processedUSecs() const
 {
-    return qint64(1000000) * totalTimeValue / settings.sampleRate();
+    const qint64 frames = totalTimeValue + (ioThread ? ioThread->processedFrames() : 0);
+    return qint64(1000000) * frames / settings.sampleRate();
+}
+
+void QAlsaAudioSink::recordUnderrun()
+{
+    if (!underrunRecorded) {
+        underrunRecorded = true;
+        telemetry.addUnderrun();
+    }
+}
+
+void QAlsaAudioSink::updateTelemetry()
+{
+    snd_pcm_sframes_t delay = 0;
+    if (snd_pcm_delay(handle, &delay) == 0 && delay >= 0) {
+        telemetry.setLatency(settings.durationForFrames(int(delay)));
+        telemetry.setBufferFill(settings.bytesForFrames(int(delay)), buffer_size);
+    }
 }
 
 void QAlsaAudioSink::resume()
@@ -528,17 +645,22 @@ void QAlsaAudioSink::resume()
             if(err < 0)
                 xrun_recovery(err);
 
-            err = snd_pcm_start(handle);
-            if(err < 0)
-                xrun_recovery(err);
+            if (!ioThread) {
+                err = snd_pcm_start(handle);
+                if(err < 0)
+                    xrun_recovery(err);
+            }
 
-            bytesAvailable = (int)snd_pcm_frames_to_bytes(handle, buffer_frames);
+            bytesAvailable = (int)settings.bytesForFrames(buffer_frames);
         }
         resuming = true;
 
         deviceState = suspendedInState;
         errorState = QAudio::NoError;
-        timer->start(period_time/1000);
+        if (ioThread)
+            ioThread->startIO();
+        else
+            timer->start(period_time/1000);
         emit stateChanged(deviceState);
     }
 }
@@ -557,6 +679,8 @@ void QAlsaAudioSink::suspend()
 {
     if(deviceState == QAudio::ActiveState || deviceState == QAudio::IdleState || resuming) {
         suspendedInState = deviceState;
+        if (ioThread)
+            ioThread->stopIO();
         snd_pcm_drain(handle);
         timer->stop();
         deviceState = QAudio::SuspendedState;
@@ -576,11 +700,18 @@ void QAlsaAudioSink::userFeed()
     if(deviceState ==  QAudio::IdleState)
         bytesAvailable = bytesFree();
 
+    // The I/O thread records the wake ups of the device itself
+    if (!ioThread)
+        telemetry.recordCallback(period_time);
+
     deviceReady();
 }
 
 bool QAlsaAudioSink::deviceReady()
 {
+    if (ioThread)
+        return feedIOThread();
+
     if(pullMode) {
         int l = 0;
         int chunks = bytesAvailable/period_size;
@@ -595,7 +726,10 @@ bool QAlsaAudioSink::deviceReady()
         int input = period_frames*chunks;
         if(input > (int)buffer_frames)
             input = buffer_frames;
-        l = audioSource->read(audioBuffer,snd_pcm_frames_to_bytes(handle, input));
+        {
+            QAudioTelemetry::UserCallbackScope scope(telemetry);
+            l = audioSource->read(audioBuffer,settings.bytesForFrames(input));
+        }
 
         // reading can take a while and stream may have been stopped
         if (!handle)
@@ -615,10 +749,12 @@ bool QAlsaAudioSink::deviceReady()
             timer->stop();
             snd_pcm_drain(handle);
             bytesAvailable = bytesFree();
-            if(bytesAvailable > snd_pcm_frames_to_bytes(handle, buffer_frames-period_frames)) {
+            if(bytesAvailable > settings.bytesForFrames(buffer_frames-period_frames)) {
                 // Underrun
                 if (deviceState != QAudio::IdleState) {
                     errorState = audioSource->atEnd() ? QAudio::NoError : QAudio::UnderrunError;
+                    if (errorState == QAudio::UnderrunError)
+                        recordUnderrun();
                     emit errorChanged(errorState);
                     deviceState = QAudio::IdleState;
                     emit stateChanged(deviceState);
@@ -634,9 +770,10 @@ bool QAlsaAudioSink::deviceReady()
         }
     } else {
         bytesAvailable = bytesFree();
-        if(bytesAvailable > snd_pcm_frames_to_bytes(handle, buffer_frames-period_frames)) {
+        if(bytesAvailable > settings.bytesForFrames(buffer_frames-period_frames)) {
             // Underrun
             if (deviceState != QAudio::IdleState) {
+                recordUnderrun();
                 errorState = QAudio::UnderrunError;
                 emit errorChanged(errorState);
                 deviceState = QAudio::IdleState;
@@ -651,8 +788,95 @@ bool QAlsaAudioSink::deviceReady()
     return true;
 }
 
+bool QAlsaAudioSink::feedIOThread()
+{
+    ioThread->acknowledgeNotification();
+    QAlsaIOThread *thread = ioThread.get();
+    auto &ring = thread->ringBuffer();
+
+    if (!pullMode) {
+        if (ring.used() == 0 && deviceState != QAudio::IdleState) {
+            // Underrun, counted by the I/O thread
+            errorState = QAudio::UnderrunError;
+            emit errorChanged(errorState);
+            deviceState = QAudio::IdleState;
+            emit stateChanged(deviceState);
+        }
+        return true;
+    }
+
+    // Reads straight into the ring buffer; the I/O thread writes out whole frames only
+    qint64 l = 0;
+    qint64 bytesRead = 0;
+    while (true) {
+        const auto region = ring.acquireWriteRegion(ring.free());
+        if (region.isEmpty())
+            break;
+
+        {
+            QAudioTelemetry::UserCallbackScope scope(telemetry);
+            l = audioSource->read(region.data(), region.size());
+        }
+
+        // reading can take a while and stream may have been stopped
+        if (ioThread.get() != thread)
+            return false;
+
+        if (l <= 0)
+            break;
+
+        ring.releaseWriteRegion(int(l));
+        bytesRead += l;
+        if (l < region.size())
+            break;
+    }
+
+    if (bytesRead > 0) {
+        thread->wake();
+        resuming = false;
+        if (deviceState != QAudio::ActiveState) {
+            errorState = QAudio::NoError;
+            deviceState = QAudio::ActiveState;
+            emit stateChanged(deviceState);
+        }
+    } else if (l < 0) {
+        close();
+        deviceState = QAudio::StoppedState;
+        errorState = QAudio::IOError;
+        emit errorChanged(errorState);
+        emit stateChanged(deviceState);
+    } else if (ring.used() == 0) {
+        // Did not get any data and the ring buffer has been written out;
+        // readyRead() resumes the feeding
+        if (deviceState != QAudio::IdleState) {
+            errorState = audioSource->atEnd() ? QAudio::NoError : QAudio::UnderrunError;
+            emit errorChanged(errorState);
+            deviceState = QAudio::IdleState;
+            emit stateChanged(deviceState);
+        }
+    }
+
+    return true;
+}
+
+void QAlsaAudioSink::handleIOThreadError()
+{
+    // Ignore the notifications of a thread which has been stopped since
+    if (!ioThread || ioThread->error() == 0)
+        return;
+
+    close();
+    errorState = QAudio::FatalError;
+    emit errorChanged(errorState);
+    deviceState = QAudio::StoppedState;
+    emit stateChanged(deviceState);
+}
+
 void QAlsaAudioSink::reset()
 {
+    if (ioThread)
+        ioThread->stopIO();
+
     if(handle)
         snd_pcm_reset(handle);
 
@@ -29,6 +29,10 @@
 #include <QtMultimedia/qaudiodevice.h>
 #include <private/qaudiosystem_p.h>
 
+#include "qalsaiothread_p.h"
+
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QAlsaAudioSink : public QPlatformAudioSink
@@ -58,7 +62,6 @@ public:
     void setVolume(qreal) override;
     qreal volume() const override;
 
-
     QIODevice* audioSource = nullptr;
     QAudioFormat settings;
     QAudio::Error errorState = QAudio::NoError;
@@ -76,6 +79,7 @@ private:
     bool opened = false;
     bool pullMode = true;
     bool resuming = false;
+    bool underrunRecorded = false; // since the last write
     int buffer_size = 0;
     int period_size = 0;
     qint64 totalTimeValue = 0;
@@ -84,10 +88,18 @@ private:
     snd_pcm_uframes_t buffer_frames;
     snd_pcm_uframes_t period_frames;
     int xrun_recovery(int err);
+    // An xrun of the PCM and the Idle transition which follows it are one underrun
+    void recordUnderrun();
 
     int setFormat();
     bool open();
     void close();
+    // The latency and the buffer fill from the delay of the PCM
+    void updateTelemetry();
+
+    // The I/O thread mode, see QAlsaIOThread
+    bool feedIOThread();
+    void handleIOThreadError();
 
     QTimer* timer = nullptr;
     QByteArray m_device;
@@ -98,6 +110,11 @@ private:
     snd_pcm_access_t access = SND_PCM_ACCESS_RW_INTERLEAVED;
     snd_pcm_hw_params_t *hwparams = nullptr;
     qreal m_volume = 1.0f;
+
+    // The format of the PCM; with mmap access, its sample format may differ from settings
+    QAudioFormat deviceFormat;
+
+    std::unique_ptr<QAlsaIOThread> ioThread;
 };
 
 class AlsaOutputPrivate : public QIODevice
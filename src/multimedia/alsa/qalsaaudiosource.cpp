@@ -58,6 +58,8 @@ QAlsaAudioSource::~QAlsaAudioSource()
 void QAlsaAudioSource::setVolume(qreal vol)
 {
     m_volume = vol;
+    if (ioThread)
+        ioThread->setVolume(vol);
 }
 
 qreal QAlsaAudioSource::volume() const
@@ -98,6 +100,7 @@ int QAlsaAudioSource::xrun_recovery(int err)
 #endif
 
     if(err == -EPIPE) {
+        telemetry.addOverrun();
         errorState = QAudio::UnderrunError;
         err = snd_pcm_prepare(handle);
         if(err < 0)
@@ -226,6 +229,7 @@ bool QAlsaAudioSource::open()
     qDebug()<<now.second()<<"s "<<now.msec()<<"ms :open()";
 #endif
     elapsedTimeOffset = 0;
+    telemetry.reset();
 
     int dir;
     int err = 0;
@@ -311,6 +315,13 @@ bool QAlsaAudioSource::open()
         }
     }
     if ( !fatal ) {
+        static const unsigned user_buffer_time = qEnvironmentVariableIntValue("QT_ALSA_INPUT_BUFFER_TIME");
+        static const unsigned user_period_time = qEnvironmentVariableIntValue("QT_ALSA_INPUT_PERIOD_TIME");
+        if (user_buffer_time)
+            buffer_time = user_buffer_time;
+        if (user_period_time)
+            period_time = user_period_time;
+
         err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &buffer_time, &dir);
         if ( err < 0 ) {
             fatal = true;
@@ -364,7 +375,31 @@ bool QAlsaAudioSource::open()
     // Step 4: Prepare audio
     ringBuffer.resize(buffer_size);
     snd_pcm_prepare( handle );
-    snd_pcm_start(handle);
+
+    const QAlsaIOThread::Config &ioConfig = QAlsaIOThread::Config::fromEnvironment();
+    if (ioConfig.enabled) {
+        ioThread = std::make_unique<QAlsaIOThread>(
+                handle, QAlsaIOThread::Capture, settings, period_frames, ioConfig,
+                [this] {
+                    // The source may have closed the thread by the time it's delivered
+                    QMetaObject::invokeMethod(
+                            this, [this] { if (ioThread) userFeed(); }, Qt::QueuedConnection);
+                },
+                [this] {
+                    QMetaObject::invokeMethod(this, &QAlsaAudioSource::handleIOThreadError,
+                                              Qt::QueuedConnection);
+                });
+        if (ioThread->isValid()) {
+            ioThread->setVolume(m_volume);
+            ioThread->setTelemetry(&telemetry);
+        } else {
+            ioThread.reset();
+        }
+    }
+
+    // The I/O thread starts the device itself
+    if (!ioThread)
+        snd_pcm_start(handle);
 
     // Step 5: Setup timer
     bytesAvailable = checkBytesReady();
@@ -372,14 +407,18 @@ bool QAlsaAudioSource::open()
     if(pullMode)
         connect(audioSource, &QIODevice::readyRead, this, &QAlsaAudioSource::userFeed);
 
-    // Step 6: Start audio processing
+    // Step 6: Start audio processing; the I/O thread notifies about the data by itself
     chunks = buffer_size/period_size;
-    timer->start(period_time*chunks/2000);
+    if (!ioThread)
+        timer->start(period_time*chunks/2000);
 
     errorState  = QAudio::NoError;
 
     totalTimeValue = 0;
 
+    if (ioThread)
+        ioThread->startIO();
+
     return true;
 }
 
@@ -387,7 +426,13 @@ void QAlsaAudioSource::close()
 {
     timer->stop();
 
+    if (ioThread) {
+        ioThread->stopIO();
+        ioThread.reset();
+    }
+
     if ( handle ) {
+        telemetry.log("QAlsaAudioSource");
         snd_pcm_drop( handle );
         snd_pcm_close( handle );
         handle = 0;
@@ -396,7 +441,9 @@ void QAlsaAudioSource::close()
 
 int QAlsaAudioSource::checkBytesReady()
 {
-    if(resuming)
+    if (ioThread)
+        bytesAvailable = ioThread->ringBuffer().used();
+    else if(resuming)
         bytesAvailable = period_size;
     else if(deviceState != QAudio::ActiveState
             && deviceState != QAudio::IdleState)
@@ -416,6 +463,8 @@ int QAlsaAudioSource::checkBytesReady()
 
 qsizetype QAlsaAudioSource::bytesReady() const
 {
+    if (ioThread)
+        return ioThread->ringBuffer().used();
     return qMax(bytesAvailable, 0);
 }
 
@@ -425,6 +474,9 @@ qint64 QAlsaAudioSource::read(char* data, qint64 len)
     if ( !handle )
         return 0;
 
+    if (ioThread)
+        return readFromIOThread(data, len);
+
     int bytesRead = 0;
     int bytesInRingbufferBeforeRead = ringBuffer.bytesOfDataInBuffer();
 
@@ -469,6 +521,7 @@ qint64 QAlsaAudioSource::read(char* data, qint64 len)
 
             if (readFrames >= 0) {
                 ringBuffer.write(buffer.data(), bytesRead);
+                updateTelemetry();
 #ifdef DEBUG_AUDIO
                 qDebug() << QString::fromLatin1("read in bytes = %1 (frames=%2)").arg(bytesRead).arg(readFrames).toLatin1().constData();
 #endif
@@ -479,6 +532,7 @@ qint64 QAlsaAudioSource::read(char* data, qint64 len)
                 break;
             } else {
                 if(readFrames == -EPIPE) {
+                    telemetry.addOverrun();
                     errorState = QAudio::UnderrunError;
                     err = snd_pcm_prepare(handle);
 #ifdef ESTRPIPE
@@ -508,7 +562,10 @@ qint64 QAlsaAudioSource::read(char* data, qint64 len)
             qint64 l = 0;
             qint64 bytesWritten = 0;
             while (ringBuffer.bytesOfDataInBuffer() > 0) {
-                l = audioSource->write(ringBuffer.availableData(), ringBuffer.availableDataBlockSize());
+                {
+                    QAudioTelemetry::UserCallbackScope scope(telemetry);
+                    l = audioSource->write(ringBuffer.availableData(), ringBuffer.availableDataBlockSize());
+                }
                 if (l > 0) {
                     ringBuffer.readBytes(l);
                     bytesWritten += l;
@@ -574,16 +631,21 @@ void QAlsaAudioSource::resume()
             if(err < 0)
                 xrun_recovery(err);
 
-            err = snd_pcm_start(handle);
-            if(err < 0)
-                xrun_recovery(err);
+            if (!ioThread) {
+                err = snd_pcm_start(handle);
+                if(err < 0)
+                    xrun_recovery(err);
+            }
 
             bytesAvailable = buffer_size;
         }
         resuming = true;
         deviceState = QAudio::ActiveState;
         int chunks = buffer_size/period_size;
-        timer->start(period_time*chunks/2000);
+        if (ioThread)
+            ioThread->startIO();
+        else
+            timer->start(period_time*chunks/2000);
         emit stateChanged(deviceState);
     }
 }
@@ -610,6 +672,8 @@ qint64 QAlsaAudioSource::processedUSecs() const
 void QAlsaAudioSource::suspend()
 {
     if(deviceState == QAudio::ActiveState||resuming) {
+        if (ioThread)
+            ioThread->stopIO();
         snd_pcm_drain(handle);
         timer->stop();
         deviceState = QAudio::SuspendedState;
@@ -625,9 +689,22 @@ void QAlsaAudioSource::userFeed()
     QTime now(QTime::currentTime());
     qDebug()<<now.second()<<"s "<<now.msec()<<"ms :userFeed() IN";
 #endif
+    // The I/O thread records the wake ups of the device itself
+    if (!ioThread)
+        telemetry.recordCallback(timer->interval() * qint64(1000));
+
     deviceReady();
 }
 
+void QAlsaAudioSource::updateTelemetry()
+{
+    snd_pcm_sframes_t delay = 0;
+    if (snd_pcm_delay(handle, &delay) == 0 && delay >= 0) {
+        telemetry.setLatency(settings.durationForFrames(int(delay)));
+        telemetry.setBufferFill(settings.bytesForFrames(int(delay)), buffer_size);
+    }
+}
+
 bool QAlsaAudioSource::deviceReady()
 {
     if(pullMode) {
@@ -640,6 +717,10 @@ bool QAlsaAudioSource::deviceReady()
     }
     bytesAvailable = checkBytesReady();
 
+    // The I/O thread recovers from the errors itself
+    if (ioThread)
+        return true;
+
     if(deviceState != QAudio::ActiveState)
         return true;
 
@@ -660,8 +741,98 @@ bool QAlsaAudioSource::deviceReady()
     return true;
 }
 
+qint64 QAlsaAudioSource::readFromIOThread(char *data, qint64 len)
+{
+    ioThread->acknowledgeNotification();
+    QAlsaIOThread *thread = ioThread.get();
+    auto &ring = thread->ringBuffer();
+
+    if (deviceState != QAudio::ActiveState && deviceState != QAudio::IdleState)
+        return 0;
+
+    qint64 bytesRead = 0;
+    if (pullMode) {
+        qint64 l = 0;
+        while (true) {
+            const auto region = ring.acquireReadRegion(ring.used());
+            if (region.isEmpty())
+                break;
+
+            {
+                QAudioTelemetry::UserCallbackScope scope(telemetry);
+                l = audioSource->write(region.data(), region.size());
+            }
+
+            // writing can take a while and stream may have been stopped
+            if (ioThread.get() != thread)
+                return bytesRead;
+
+            if (l <= 0)
+                break;
+
+            ring.releaseReadRegion(int(l));
+            bytesRead += l;
+            if (l < region.size())
+                break;
+        }
+
+        if (l < 0) {
+            close();
+            errorState = QAudio::IOError;
+            deviceState = QAudio::StoppedState;
+            emit stateChanged(deviceState);
+            return 0;
+        }
+
+        if (l == 0 && bytesRead == 0 && ring.used() > 0) {
+            // The device doesn't accept the data
+            if (deviceState != QAudio::IdleState) {
+                errorState = QAudio::NoError;
+                deviceState = QAudio::IdleState;
+                emit stateChanged(deviceState);
+            }
+            return 0;
+        }
+    } else {
+        ring.consume(int(qMin<qint64>(len, ring.used())), [&](QSpan<const char> region) {
+            memcpy(data + bytesRead, region.data(), region.size());
+            bytesRead += region.size();
+        });
+    }
+
+    if (bytesRead > 0) {
+        // The ring buffer has room again
+        thread->wake();
+        bytesAvailable = ring.used();
+        totalTimeValue += bytesRead;
+        resuming = false;
+        if (deviceState != QAudio::ActiveState) {
+            errorState = QAudio::NoError;
+            deviceState = QAudio::ActiveState;
+            emit stateChanged(deviceState);
+        }
+    }
+
+    return bytesRead;
+}
+
+void QAlsaAudioSource::handleIOThreadError()
+{
+    // Ignore the notifications of a thread which has been stopped since
+    if (!ioThread || ioThread->error() == 0)
+        return;
+
+    close();
+    errorState = QAudio::FatalError;
+    deviceState = QAudio::StoppedState;
+    emit stateChanged(deviceState);
+}
+
 void QAlsaAudioSource::reset()
 {
+    if (ioThread)
+        ioThread->stopIO();
+
     if(handle)
         snd_pcm_reset(handle);
     stop();
@@ -30,6 +30,10 @@
 #include <QtMultimedia/qaudiodevice.h>
 #include <private/qaudiosystem_p.h>
 
+#include "qalsaiothread_p.h"
+
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -83,6 +87,7 @@ public:
     QAudioFormat format() const override;
     void setVolume(qreal) override;
     qreal volume() const override;
+
     bool resuming;
     snd_pcm_t* handle;
     qint64 totalTimeValue;
@@ -102,6 +107,12 @@ private:
     bool open();
     void close();
     void drain();
+    // The latency and the buffer fill from the delay of the PCM
+    void updateTelemetry();
+
+    // The I/O thread mode, see QAlsaIOThread
+    qint64 readFromIOThread(char *data, qint64 len);
+    void handleIOThreadError();
 
     QTimer* timer;
     qint64 elapsedTimeOffset;
@@ -119,6 +130,8 @@ private:
     snd_pcm_format_t pcmformat;
     snd_pcm_hw_params_t *hwparams;
     qreal m_volume;
+
+    std::unique_ptr<QAlsaIOThread> ioThread;
 };
 
 class AlsaInputPrivate : public QIODevice
@@ -0,0 +1,380 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qalsaiothread_p.h"
+#include "qalsammap_p.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtMultimedia/private/qaudiohelpers_p.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+static Q_LOGGING_CATEGORY(lcAlsaIOThread, "qt.multimedia.alsa.iothread")
+
+const QAlsaIOThread::Config &QAlsaIOThread::Config::fromEnvironment()
+{
+    static const Config config = [] {
+        Config config;
+        config.enabled = qEnvironmentVariableIntValue("QT_ALSA_IO_THREAD") > 0;
+
+        bool ok = false;
+        const int priority = qEnvironmentVariableIntValue("QT_ALSA_IO_THREAD_PRIORITY", &ok);
+        if (ok)
+            config.priority = qMax(priority, 0);
+
+        const int ringPeriods = qEnvironmentVariableIntValue("QT_ALSA_IO_THREAD_RING_PERIODS", &ok);
+        if (ok && ringPeriods >= 2)
+            config.ringPeriods = ringPeriods;
+
+        return config;
+    }();
+
+    return config;
+}
+
+QAlsaIOThread::QAlsaIOThread(snd_pcm_t *handle, Direction direction, const QAudioFormat &format,
+                             snd_pcm_uframes_t periodFrames, const Config &config,
+                             std::function<void()> notifier,
+                             std::function<void()> errorNotifier)
+    : m_handle(handle),
+      m_direction(direction),
+      m_format(format),
+      m_frameBytes(format.bytesPerFrame()),
+      m_periodFrames(periodFrames),
+      m_periodBytes(int(periodFrames) * format.bytesPerFrame()),
+      m_periodUs(format.durationForFrames(int(periodFrames))),
+      m_priority(config.priority),
+      m_ringBuffer(m_periodBytes * qMax(config.ringPeriods, 2)),
+      m_scratch(m_periodBytes),
+      m_notifier(std::move(notifier)),
+      m_errorNotifier(std::move(errorNotifier))
+{
+    setObjectName(direction == Playback ? QLatin1String("QAlsaAudioSink IO")
+                                        : QLatin1String("QAlsaAudioSource IO"));
+
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0)
+        qCWarning(lcAlsaIOThread) << "Cannot create the wake up descriptor:" << qt_error_string();
+}
+
+QAlsaIOThread::~QAlsaIOThread()
+{
+    stopIO();
+
+    if (m_wakeFd >= 0)
+        ::close(m_wakeFd);
+}
+
+void QAlsaIOThread::startIO()
+{
+    if (isRunning())
+        return;
+
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    m_notificationPending.store(false, std::memory_order_relaxed);
+    m_error.store(0, std::memory_order_relaxed);
+    m_starving = false;
+
+    start();
+}
+
+void QAlsaIOThread::stopIO()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+    wake();
+    wait();
+}
+
+void QAlsaIOThread::wake()
+{
+    if (m_wakeFd >= 0)
+        eventfd_write(m_wakeFd, 1);
+}
+
+void QAlsaIOThread::acknowledgeNotification()
+{
+    m_notificationPending.store(false, std::memory_order_release);
+}
+
+void QAlsaIOThread::setVolume(float volume)
+{
+    m_volume.store(volume, std::memory_order_relaxed);
+}
+
+void QAlsaIOThread::setMMapFormat(const QAudioFormat &deviceFormat)
+{
+    Q_ASSERT(m_direction == Playback);
+    Q_ASSERT(!isRunning());
+    m_mmapFormat = deviceFormat;
+}
+
+void QAlsaIOThread::setTelemetry(QAudioTelemetry *telemetry)
+{
+    Q_ASSERT(!isRunning());
+    m_telemetry = telemetry;
+}
+
+void QAlsaIOThread::run()
+{
+    applyPriority();
+
+    // The wake up descriptor goes first, so that waiting for it only polls one descriptor
+    const int pcmFdCount = qMax(snd_pcm_poll_descriptors_count(m_handle), 0);
+    m_pollFds.assign(pcmFdCount + 1, pollfd{});
+    m_pollFds[0] = { m_wakeFd, POLLIN, 0 };
+    snd_pcm_poll_descriptors(m_handle, m_pollFds.data() + 1, pcmFdCount);
+
+    // Unlike playback, capture doesn't start by itself
+    if (m_direction == Capture && snd_pcm_state(m_handle) == SND_PCM_STATE_PREPARED)
+        snd_pcm_start(m_handle);
+
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(m_handle);
+        int err = avail < 0 ? int(avail) : 0;
+
+        if (err == 0) {
+            if (snd_pcm_uframes_t(avail) < m_periodFrames) {
+                err = waitForEvents(true);
+            } else if (!ringReady()) {
+                // The owner hasn't kept up; wait until it writes (playback) or reads (capture)
+                if (!m_starving && snd_pcm_state(m_handle) == SND_PCM_STATE_RUNNING) {
+                    m_starving = true;
+                    addXrunToTelemetry();
+                    qCDebug(lcAlsaIOThread) << "Ring buffer underrun";
+                }
+                notify();
+                err = waitForEvents(false);
+            } else {
+                m_starving = false;
+                if (m_telemetry)
+                    m_telemetry->recordCallback(m_periodUs);
+                err = transfer(avail);
+                updateTelemetry();
+            }
+
+            if (err == 0)
+                continue;
+        }
+
+        if (!recover(err)) {
+            qCWarning(lcAlsaIOThread) << "Stopping on error:" << snd_strerror(err);
+            m_error.store(err, std::memory_order_release);
+            m_errorNotifier();
+            break;
+        }
+    }
+}
+
+void QAlsaIOThread::applyPriority()
+{
+    if (m_priority <= 0)
+        return;
+
+    sched_param param = {};
+    param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), m_priority,
+                                  sched_get_priority_max(SCHED_FIFO));
+
+    // Needs CAP_SYS_NICE or an RLIMIT_RTPRIO; keep the default policy otherwise
+    const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0)
+        qCWarning(lcAlsaIOThread) << "Cannot set SCHED_FIFO priority" << param.sched_priority
+                                  << ":" << qt_error_string(err);
+    else
+        qCDebug(lcAlsaIOThread) << "SCHED_FIFO priority" << param.sched_priority;
+}
+
+int QAlsaIOThread::waitForEvents(bool waitForPcm)
+{
+    const nfds_t count = waitForPcm ? m_pollFds.size() : 1;
+
+    int result = 0;
+    do {
+        result = ::poll(m_pollFds.data(), count, -1);
+    } while (result < 0 && errno == EINTR);
+
+    if (result < 0)
+        return -errno;
+
+    if (m_pollFds[0].revents & POLLIN) {
+        eventfd_t value = 0;
+        eventfd_read(m_wakeFd, &value);
+    }
+
+    // Lets the PCM plugin translate the events; the errors are reported by snd_pcm_avail_update
+    if (count > 1) {
+        unsigned short revents = 0;
+        snd_pcm_poll_descriptors_revents(m_handle, m_pollFds.data() + 1, count - 1, &revents);
+    }
+
+    return 0;
+}
+
+bool QAlsaIOThread::recover(int err)
+{
+    if (err == -EAGAIN || err == -EINTR)
+        return true;
+
+    if (err == -EPIPE) {
+        // The xrun of a starving ring buffer has been counted when the ring ran out
+        if (!m_starving)
+            addXrunToTelemetry();
+        qCDebug(lcAlsaIOThread) << "PCM xrun";
+        err = snd_pcm_prepare(m_handle);
+#ifdef ESTRPIPE
+    } else if (err == -ESTRPIPE) {
+        // The system has been suspended; wait until the device can be resumed
+        while ((err = snd_pcm_resume(m_handle)) == -EAGAIN
+               && !m_stopRequested.load(std::memory_order_acquire))
+            QThread::msleep(10);
+        if (err < 0)
+            err = snd_pcm_prepare(m_handle);
+#endif
+    } else {
+        return false;
+    }
+
+    if (err >= 0 && m_direction == Capture)
+        err = snd_pcm_start(m_handle);
+
+    return err >= 0;
+}
+
+int QAlsaIOThread::transfer(snd_pcm_uframes_t avail)
+{
+    if (m_direction == Playback) {
+        const int err = writeFromRing(avail);
+        if (m_ringBuffer.used() <= m_ringBuffer.size() / 2)
+            notify();
+        return err;
+    }
+
+    const int err = readIntoRing(avail);
+    notify();
+    return err;
+}
+
+int QAlsaIOThread::writeFromRing(snd_pcm_uframes_t avail)
+{
+    const float volume = m_volume.load(std::memory_order_relaxed);
+
+    // The owner may have written a part of a frame; it's written with the rest of the frame
+    qint64 remaining = qMin(qint64(avail) * m_frameBytes,
+                            qint64(m_ringBuffer.used() / m_frameBytes * m_frameBytes));
+
+    while (remaining > 0) {
+        const int chunk = int(qMin<qint64>(remaining, m_periodBytes));
+        const auto region = m_ringBuffer.acquireReadRegion(chunk);
+        const int frames = int(region.size()) / m_frameBytes;
+        if (frames == 0)
+            break;
+
+        snd_pcm_sframes_t written = 0;
+        if (m_mmapFormat) {
+            // Converts straight into the buffer of the PCM
+            written = QAlsaMMap::writeInterleaved(m_handle, region.data(), frames, m_format,
+                                                  *m_mmapFormat, volume);
+        } else {
+            const char *data = region.data();
+            if (volume < 1.f) {
+                QAudioHelperInternal::qMultiplySamples(volume, m_format, data, m_scratch.data(),
+                                                       frames * m_frameBytes);
+                data = m_scratch.data();
+            }
+            written = snd_pcm_writei(m_handle, data, frames);
+        }
+
+        if (written == -EAGAIN)
+            break;
+        if (written < 0)
+            return int(written);
+
+        m_ringBuffer.releaseReadRegion(int(written) * m_frameBytes);
+        m_processedFrames.fetch_add(written, std::memory_order_relaxed);
+        remaining -= written * m_frameBytes;
+
+        if (written < frames)
+            break;
+    }
+
+    return 0;
+}
+
+int QAlsaIOThread::readIntoRing(snd_pcm_uframes_t avail)
+{
+    const float volume = m_volume.load(std::memory_order_relaxed);
+
+    qint64 remaining = qMin(qint64(avail) * m_frameBytes,
+                            qint64(m_ringBuffer.free() / m_frameBytes * m_frameBytes));
+
+    while (remaining > 0) {
+        const int chunk = int(qMin<qint64>(remaining, m_periodBytes));
+        const auto region = m_ringBuffer.acquireWriteRegion(chunk);
+        const int frames = int(region.size()) / m_frameBytes;
+        if (frames == 0)
+            break;
+
+        const snd_pcm_sframes_t read = snd_pcm_readi(m_handle, region.data(), frames);
+        if (read == -EAGAIN)
+            break;
+        if (read < 0)
+            return int(read);
+
+        const int bytes = int(read) * m_frameBytes;
+        if (volume < 1.f)
+            QAudioHelperInternal::qMultiplySamples(volume, m_format, region.data(), region.data(),
+                                                   bytes);
+
+        m_ringBuffer.releaseWriteRegion(bytes);
+        m_processedFrames.fetch_add(read, std::memory_order_relaxed);
+        remaining -= bytes;
+
+        if (read < frames)
+            break;
+    }
+
+    return 0;
+}
+
+bool QAlsaIOThread::ringReady() const
+{
+    return m_direction == Playback ? m_ringBuffer.used() >= m_frameBytes
+                                   : m_ringBuffer.free() >= m_frameBytes;
+}
+
+void QAlsaIOThread::notify()
+{
+    if (!m_notificationPending.exchange(true, std::memory_order_acq_rel))
+        m_notifier();
+}
+
+void QAlsaIOThread::updateTelemetry()
+{
+    if (!m_telemetry)
+        return;
+
+    m_telemetry->setBufferFill(m_ringBuffer.used(), m_ringBuffer.size());
+
+    snd_pcm_sframes_t delay = 0;
+    if (snd_pcm_delay(m_handle, &delay) == 0 && delay >= 0)
+        m_telemetry->setLatency(m_format.durationForFrames(int(delay)));
+}
+
+void QAlsaIOThread::addXrunToTelemetry()
+{
+    if (!m_telemetry)
+        return;
+
+    if (m_direction == Playback)
+        m_telemetry->addUnderrun();
+    else
+        m_telemetry->addOverrun();
+}
+
+QT_END_NAMESPACE
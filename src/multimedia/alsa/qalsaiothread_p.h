@@ -0,0 +1,137 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef QALSAIOTHREAD_P_H
+#define QALSAIOTHREAD_P_H
+
+#include <alsa/asoundlib.h>
+
+#include <QtCore/qthread.h>
+#include <QtMultimedia/qaudioformat.h>
+#include <QtMultimedia/private/qaudioringbuffer_p.h>
+#include <QtMultimedia/private/qaudiotelemetry_p.h>
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include <poll.h>
+
+QT_BEGIN_NAMESPACE
+
+// Transfers the audio between a PCM and a ring buffer on a dedicated thread,
+// which blocks in poll() on the PCM descriptors instead of relying on the
+// timers of the sink's or source's thread.
+//
+// Playback: the owner thread writes the ring buffer, the I/O thread writes
+// the PCM from it. Capture: the I/O thread reads the PCM into the ring buffer,
+// the owner thread reads it.
+class QAlsaIOThread : public QThread
+{
+public:
+    enum Direction { Playback, Capture };
+
+    struct Config
+    {
+        bool enabled = false;
+        // SCHED_FIFO priority of the thread; 0 keeps the default policy
+        int priority = 0;
+        // The size of the ring buffer in PCM periods
+        int ringPeriods = 4;
+
+        // QT_ALSA_IO_THREAD, QT_ALSA_IO_THREAD_PRIORITY and QT_ALSA_IO_THREAD_RING_PERIODS
+        static const Config &fromEnvironment();
+    };
+
+    // The notifiers are called on the I/O thread
+    QAlsaIOThread(snd_pcm_t *handle, Direction direction, const QAudioFormat &format,
+                  snd_pcm_uframes_t periodFrames, const Config &config,
+                  std::function<void()> notifier, std::function<void()> errorNotifier);
+    ~QAlsaIOThread() override;
+
+    bool isValid() const { return m_wakeFd >= 0; }
+
+    void startIO();
+    void stopIO();
+
+    // Wakes the thread up after the owner has written (playback) or read (capture) the ring
+    void wake();
+
+    // The notifier isn't called again until the owner acknowledges the previous call
+    void acknowledgeNotification();
+
+    QtPrivate::QAudioRingBuffer<char> &ringBuffer() { return m_ringBuffer; }
+
+    void setVolume(float volume);
+
+    // Playback through mmap (SND_PCM_ACCESS_MMAP_INTERLEAVED), converting to deviceFormat;
+    // must be set before starting the thread
+    void setMMapFormat(const QAudioFormat &deviceFormat);
+
+    // Updated by the thread with the period wake ups, the latency, the fill of the ring buffer
+    // and the xruns; must be set before starting the thread
+    void setTelemetry(QAudioTelemetry *telemetry);
+
+    // The negative ALSA error code which has stopped the thread, or 0
+    int error() const { return m_error.load(std::memory_order_acquire); }
+
+    // The frames written to (playback) or read from (capture) the PCM
+    qint64 processedFrames() const { return m_processedFrames.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    void applyPriority();
+    int waitForEvents(bool waitForPcm);
+    bool recover(int err);
+    int transfer(snd_pcm_uframes_t avail);
+    int writeFromRing(snd_pcm_uframes_t avail);
+    int readIntoRing(snd_pcm_uframes_t avail);
+    bool ringReady() const;
+    void notify();
+    void updateTelemetry();
+    void addXrunToTelemetry();
+
+    snd_pcm_t *m_handle = nullptr;
+    const Direction m_direction;
+    const QAudioFormat m_format;
+    const int m_frameBytes;
+    const snd_pcm_uframes_t m_periodFrames;
+    const int m_periodBytes;
+    const qint64 m_periodUs;
+    const int m_priority;
+
+    QtPrivate::QAudioRingBuffer<char> m_ringBuffer;
+    std::vector<char> m_scratch;
+    std::optional<QAudioFormat> m_mmapFormat;
+    QAudioTelemetry *m_telemetry = nullptr;
+    std::vector<pollfd> m_pollFds;
+    int m_wakeFd = -1;
+    bool m_starving = false;
+
+    std::function<void()> m_notifier;
+    std::function<void()> m_errorNotifier;
+
+    std::atomic<bool> m_stopRequested = false;
+    std::atomic<bool> m_notificationPending = false;
+    std::atomic<float> m_volume = 1.f;
+    std::atomic<int> m_error = 0;
+    std::atomic<qint64> m_processedFrames = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QALSAIOTHREAD_P_H
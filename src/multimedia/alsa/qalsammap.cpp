@@ -0,0 +1,71 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qalsammap_p.h"
+
+#include <QtMultimedia/private/qaudiohelpers_p.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace QAlsaMMap
+{
+
+snd_pcm_sframes_t writeInterleaved(snd_pcm_t *handle, const char *data, snd_pcm_uframes_t frames,
+                                   const QAudioFormat &format, const QAudioFormat &deviceFormat,
+                                   float volume)
+{
+    const int bytesPerFrame = format.bytesPerFrame();
+    const bool copyOnly = volume >= 1.f && format.sampleFormat() == deviceFormat.sampleFormat();
+
+    snd_pcm_sframes_t written = 0;
+    while (frames > 0) {
+        // Updates the position of the hardware, as snd_pcm_mmap_begin() requires
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+        if (avail < 0)
+            return written > 0 ? written : avail;
+        if (avail == 0)
+            break;
+
+        const snd_pcm_channel_area_t *areas = nullptr;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t count = qMin(frames, snd_pcm_uframes_t(avail));
+        const int err = snd_pcm_mmap_begin(handle, &areas, &offset, &count);
+        if (err < 0)
+            return written > 0 ? written : err;
+
+        // The channels of interleaved frames share an area; the first channel starts each frame
+        Q_ASSERT(areas[0].step == unsigned(deviceFormat.bytesPerFrame()) * 8);
+        char *dest = static_cast<char *>(areas[0].addr)
+                + (areas[0].first + offset * areas[0].step) / 8;
+        const int bytes = int(count) * bytesPerFrame;
+
+        if (copyOnly)
+            std::memcpy(dest, data, bytes);
+        else
+            QAudioHelperInternal::qConvertAndMultiplySamples(volume, format, data, deviceFormat,
+                                                             dest, bytes);
+
+        const snd_pcm_sframes_t committed = snd_pcm_mmap_commit(handle, offset, count);
+        if (committed < 0)
+            return written > 0 ? written : committed;
+
+        data += committed * bytesPerFrame;
+        written += committed;
+        frames -= committed;
+
+        if (snd_pcm_uframes_t(committed) < count)
+            break;
+    }
+
+    // Unlike snd_pcm_writei(), committing doesn't start the PCM
+    if (written > 0 && snd_pcm_state(handle) == SND_PCM_STATE_PREPARED)
+        snd_pcm_start(handle);
+
+    return written;
+}
+
+} // namespace QAlsaMMap
+
+QT_END_NAMESPACE
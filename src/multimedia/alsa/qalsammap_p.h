@@ -0,0 +1,38 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifndef QALSAMMAP_P_H
+#define QALSAMMAP_P_H
+
+#include <alsa/asoundlib.h>
+
+#include <QtMultimedia/qaudioformat.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QAlsaMMap
+{
+// Like snd_pcm_writei() for a PCM with SND_PCM_ACCESS_MMAP_INTERLEAVED access, but converts
+// the frames from format to the sample format of deviceFormat and applies the volume while
+// copying them into the buffer of the PCM, instead of handing a converted copy to the PCM.
+// Writes as many frames as the buffer has room for without blocking, and starts the PCM.
+// Returns the number of frames written or a negative error code.
+snd_pcm_sframes_t writeInterleaved(snd_pcm_t *handle, const char *data, snd_pcm_uframes_t frames,
+                                   const QAudioFormat &format, const QAudioFormat &deviceFormat,
+                                   float volume);
+}
+
+QT_END_NAMESPACE
+
+#endif // QALSAMMAP_P_H
@@ -4,35 +4,259 @@
 #include "qaudiohelpers_p.h"
 
 #include <QDebug>
+#include <QtCore/private/qsimd_p.h>
+
+#include <cmath>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
 namespace QAudioHelperInternal
 {
 
-template<class T> void adjustSamples(qreal factor, const void *src, void *dst, int samples)
+// Scalar conversions between the sample types and float (double for Int32 to keep
+// the full precision). Results saturate instead of wrapping around, and are rounded
+// to the nearest integer, ties to even, like the vectorized kernels do.
+// Normalized samples are in [-1, 1); unsigned samples are biased by 0x80.
+template<class T> struct SampleTraits {};
+
+template<> struct SampleTraits<quint8>
 {
-    const T *pSrc = (const T *)src;
-    T *pDst = (T*)dst;
-    for ( int i = 0; i < samples; i++ )
-        pDst[i] = pSrc[i] * factor;
-}
+    using Scaled = float;
+    static Scaled scaled(quint8 sample, Scaled factor) { return (int(sample) - 0x80) * factor; }
+    static quint8 fromScaled(Scaled value)
+    {
+        return quint8(0x80 + std::lrint(qBound(-128.f, value, 127.f)));
+    }
+    static float toNormalized(quint8 sample) { return (int(sample) - 0x80) / 128.f; }
+    static quint8 fromNormalized(float value) { return fromScaled(value * 128.f); }
+};
+
+template<> struct SampleTraits<qint16>
+{
+    using Scaled = float;
+    static Scaled scaled(qint16 sample, Scaled factor) { return sample * factor; }
+    static qint16 fromScaled(Scaled value)
+    {
+        return qint16(std::lrint(qBound(-32768.f, value, 32767.f)));
+    }
+    static float toNormalized(qint16 sample) { return sample / 32768.f; }
+    static qint16 fromNormalized(float value) { return fromScaled(value * 32768.f); }
+};
 
-// Unsigned samples are biased around 0x80/0x8000 :/
-// This makes a pure template solution a bit unwieldy but possible
-template<class T> struct signedVersion {};
-template<> struct signedVersion<quint8>
+template<> struct SampleTraits<qint32>
 {
-    using TS = qint8;
-    static constexpr int offset = 0x80;
+    using Scaled = double;
+    static Scaled scaled(qint32 sample, Scaled factor) { return sample * factor; }
+    static qint32 fromScaled(Scaled value)
+    {
+        return qint32(std::llrint(qBound(-2147483648., value, 2147483647.)));
+    }
+    static float toNormalized(qint32 sample) { return float(sample / 2147483648.); }
+    static qint32 fromNormalized(float value) { return fromScaled(value * 2147483648.); }
 };
 
-template<class T> void adjustUnsignedSamples(qreal factor, const void *src, void *dst, int samples)
+template<> struct SampleTraits<float>
+{
+    using Scaled = float;
+    static Scaled scaled(float sample, Scaled factor) { return sample * factor; }
+    static float fromScaled(Scaled value) { return value; }
+    static float toNormalized(float sample) { return sample; }
+    static float fromNormalized(float value) { return qBound(-1.f, value, 1.f); }
+};
+
+template<class T>
+void adjustSamplesScalar(qreal factor, const T *src, T *dst, qsizetype samples)
+{
+    using Traits = SampleTraits<T>;
+    const auto f = typename Traits::Scaled(factor);
+    for (qsizetype i = 0; i < samples; ++i)
+        dst[i] = Traits::fromScaled(Traits::scaled(src[i], f));
+}
+
+// The vectorized kernels process the bulk of the samples and return how many
+// samples they have processed; the scalar loop takes care of the rest.
+template<class T>
+qsizetype adjustSamplesSimd(float, const T *, T *, qsizetype)
+{
+    return 0;
+}
+
+#if defined(__SSE2__)
+
+template<>
+qsizetype adjustSamplesSimd<float>(float factor, const float *src, float *dst, qsizetype samples)
+{
+    const __m128 f = _mm_set1_ps(factor);
+    qsizetype i = 0;
+    for (; i + 4 <= samples; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), f));
+    return i;
+}
+
+// Clamps in float, as out of range conversions yield INT_MIN, and rounds
+// to nearest even with the default MXCSR rounding mode
+static inline __m128i scaleInt32(__m128i v, __m128 f, __m128 min, __m128 max)
+{
+    const __m128 scaled = _mm_mul_ps(_mm_cvtepi32_ps(v), f);
+    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(scaled, min), max));
+}
+
+template<>
+qsizetype adjustSamplesSimd<qint16>(float factor, const qint16 *src, qint16 *dst, qsizetype samples)
+{
+    const __m128 f = _mm_set1_ps(factor);
+    const __m128 min = _mm_set1_ps(-32768.f);
+    const __m128 max = _mm_set1_ps(32767.f);
+    qsizetype i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        const __m128i result =
+                _mm_packs_epi32(scaleInt32(lo, f, min, max), scaleInt32(hi, f, min, max));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), result);
+    }
+    return i;
+}
+
+template<>
+qsizetype adjustSamplesSimd<quint8>(float factor, const quint8 *src, quint8 *dst, qsizetype samples)
 {
-    const T *pSrc = (const T *)src;
-    T *pDst = (T*)dst;
-    for ( int i = 0; i < samples; i++ ) {
-        pDst[i] = signedVersion<T>::offset + ((typename signedVersion<T>::TS)(pSrc[i] - signedVersion<T>::offset) * factor);
+    // Bias to signed samples, then widen 8 -> 16 -> 32 bits and saturate back
+    const __m128 f = _mm_set1_ps(factor);
+    const __m128 min = _mm_set1_ps(-128.f);
+    const __m128 max = _mm_set1_ps(127.f);
+    const __m128i bias = _mm_set1_epi8(char(0x80));
+    qsizetype i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        const __m128i v = _mm_xor_si128(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), bias);
+        const __m128i v16lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        const __m128i v16hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+
+        auto scale16 = [f, min, max](__m128i v16) {
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v16, v16), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v16, v16), 16);
+            return _mm_packs_epi32(scaleInt32(lo, f, min, max), scaleInt32(hi, f, min, max));
+        };
+
+        const __m128i result = _mm_packs_epi16(scale16(v16lo), scale16(v16hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_xor_si128(result, bias));
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+template<>
+qsizetype adjustSamplesSimd<float>(float factor, const float *src, float *dst, qsizetype samples)
+{
+    qsizetype i = 0;
+    for (; i + 4 <= samples; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), factor));
+    return i;
+}
+
+#if defined(Q_PROCESSOR_ARM_64)
+
+static inline int32x4_t scaleInt32(int32x4_t v, float factor)
+{
+    // vcvtnq_s32_f32 rounds to nearest even and saturates
+    return vcvtnq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(v), factor));
+}
+
+template<>
+qsizetype adjustSamplesSimd<qint16>(float factor, const qint16 *src, qint16 *dst, qsizetype samples)
+{
+    qsizetype i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const int16x8_t v = vld1q_s16(src + i);
+        const int32x4_t lo = scaleInt32(vmovl_s16(vget_low_s16(v)), factor);
+        const int32x4_t hi = scaleInt32(vmovl_s16(vget_high_s16(v)), factor);
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    return i;
+}
+
+template<>
+qsizetype adjustSamplesSimd<quint8>(float factor, const quint8 *src, quint8 *dst, qsizetype samples)
+{
+    const uint8x16_t bias = vdupq_n_u8(0x80);
+    qsizetype i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        const int8x16_t v = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(src + i), bias));
+
+        auto scale16 = [factor](int16x8_t v16) {
+            const int32x4_t lo = scaleInt32(vmovl_s16(vget_low_s16(v16)), factor);
+            const int32x4_t hi = scaleInt32(vmovl_s16(vget_high_s16(v16)), factor);
+            return vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+        };
+
+        const int16x8_t lo = scale16(vmovl_s8(vget_low_s8(v)));
+        const int16x8_t hi = scale16(vmovl_s8(vget_high_s8(v)));
+        const int8x16_t result = vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi));
+        vst1q_u8(dst + i, veorq_u8(vreinterpretq_u8_s8(result), bias));
+    }
+    return i;
+}
+
+#endif // Q_PROCESSOR_ARM_64
+
+#endif
+
+template<class T>
+void adjustSamples(qreal factor, const void *src, void *dst, qsizetype samples)
+{
+    const T *pSrc = static_cast<const T *>(src);
+    T *pDst = static_cast<T *>(dst);
+    const qsizetype processed = adjustSamplesSimd<T>(float(factor), pSrc, pDst, samples);
+    adjustSamplesScalar<T>(factor, pSrc + processed, pDst + processed, samples - processed);
+}
+
+template<class T>
+void rampSamples(qreal startFactor, qreal endFactor, int channels, const void *src, void *dst,
+                 qsizetype frames)
+{
+    using Traits = SampleTraits<T>;
+    using Scaled = typename Traits::Scaled;
+
+    const T *pSrc = static_cast<const T *>(src);
+    T *pDst = static_cast<T *>(dst);
+    const Scaled step = frames > 0 ? Scaled((endFactor - startFactor) / frames) : Scaled(0);
+
+    for (qsizetype frame = 0; frame < frames; ++frame) {
+        const Scaled factor = Scaled(startFactor) + step * Scaled(frame);
+        for (int channel = 0; channel < channels; ++channel, ++pSrc, ++pDst)
+            *pDst = Traits::fromScaled(Traits::scaled(*pSrc, factor));
+    }
+}
+
+template<class Src, class Dst>
+void convertSamples(float factor, const void *src, void *dst, qsizetype samples)
+{
+    const Src *pSrc = static_cast<const Src *>(src);
+    Dst *pDst = static_cast<Dst *>(dst);
+    for (qsizetype i = 0; i < samples; ++i)
+        pDst[i] = SampleTraits<Dst>::fromNormalized(SampleTraits<Src>::toNormalized(pSrc[i]) * factor);
+}
+
+template<class Src>
+void convertSamplesFrom(float factor, QAudioFormat::SampleFormat dstFormat, const void *src,
+                        void *dst, qsizetype samples)
+{
+    switch (dstFormat) {
+    case QAudioFormat::Unknown:
+    case QAudioFormat::NSampleFormats:
+        return;
+    case QAudioFormat::UInt8:
+        return convertSamples<Src, quint8>(factor, src, dst, samples);
+    case QAudioFormat::Int16:
+        return convertSamples<Src, qint16>(factor, src, dst, samples);
+    case QAudioFormat::Int32:
+        return convertSamples<Src, qint32>(factor, src, dst, samples);
+    case QAudioFormat::Float:
+        return convertSamples<Src, float>(factor, src, dst, samples);
     }
 }
 
@@ -45,7 +269,7 @@ void qMultiplySamples(qreal factor, const QAudioFormat &format, const void* src,
     case QAudioFormat::NSampleFormats:
         return;
     case QAudioFormat::UInt8:
-        QAudioHelperInternal::adjustUnsignedSamples<quint8>(factor,src,dest,samplesCount);
+        QAudioHelperInternal::adjustSamples<quint8>(factor,src,dest,samplesCount);
         break;
     case QAudioFormat::Int16:
         QAudioHelperInternal::adjustSamples<qint16>(factor,src,dest,samplesCount);
@@ -58,6 +282,62 @@ void qMultiplySamples(qreal factor, const QAudioFormat &format, const void* src,
         break;
     }
 }
+
+void qMultiplySamples(qreal startFactor, qreal endFactor, const QAudioFormat &format,
+                      const void *src, void *dest, int len)
+{
+    if (qFuzzyCompare(startFactor, endFactor))
+        return qMultiplySamples(endFactor, format, src, dest, len);
+
+    const int channels = qMax(1, format.channelCount());
+    const int framesCount = len / qMax(1, format.bytesPerFrame());
+
+    switch (format.sampleFormat()) {
+    case QAudioFormat::Unknown:
+    case QAudioFormat::NSampleFormats:
+        return;
+    case QAudioFormat::UInt8:
+        rampSamples<quint8>(startFactor, endFactor, channels, src, dest, framesCount);
+        break;
+    case QAudioFormat::Int16:
+        rampSamples<qint16>(startFactor, endFactor, channels, src, dest, framesCount);
+        break;
+    case QAudioFormat::Int32:
+        rampSamples<qint32>(startFactor, endFactor, channels, src, dest, framesCount);
+        break;
+    case QAudioFormat::Float:
+        rampSamples<float>(startFactor, endFactor, channels, src, dest, framesCount);
+        break;
+    }
+}
+
+void qConvertAndMultiplySamples(qreal factor, const QAudioFormat &srcFormat, const void *src,
+                                const QAudioFormat &dstFormat, void *dest, int len)
+{
+    Q_ASSERT(srcFormat.channelCount() == dstFormat.channelCount());
+
+    // Float output is clamped, so it goes through the conversion
+    if (srcFormat.sampleFormat() == dstFormat.sampleFormat()
+        && srcFormat.sampleFormat() != QAudioFormat::Float)
+        return qMultiplySamples(factor, srcFormat, src, dest, len);
+
+    const int samplesCount = len / qMax(1, srcFormat.bytesPerSample());
+    const auto dstSampleFormat = dstFormat.sampleFormat();
+
+    switch (srcFormat.sampleFormat()) {
+    case QAudioFormat::Unknown:
+    case QAudioFormat::NSampleFormats:
+        return;
+    case QAudioFormat::UInt8:
+        return convertSamplesFrom<quint8>(factor, dstSampleFormat, src, dest, samplesCount);
+    case QAudioFormat::Int16:
+        return convertSamplesFrom<qint16>(factor, dstSampleFormat, src, dest, samplesCount);
+    case QAudioFormat::Int32:
+        return convertSamplesFrom<qint32>(factor, dstSampleFormat, src, dest, samplesCount);
+    case QAudioFormat::Float:
+        return convertSamplesFrom<float>(factor, dstSampleFormat, src, dest, samplesCount);
+    }
+}
 }
 
 QT_END_NAMESPACE
@@ -23,6 +23,19 @@ QT_BEGIN_NAMESPACE
 namespace QAudioHelperInternal
 {
 Q_MULTIMEDIA_EXPORT void qMultiplySamples(qreal factor, const QAudioFormat& format, const void *src, void* dest, int len);
+
+// Ramps the factor linearly from startFactor to endFactor over the frames of src,
+// which avoids audible steps when the volume changes
+Q_MULTIMEDIA_EXPORT void qMultiplySamples(qreal startFactor, qreal endFactor,
+                                          const QAudioFormat &format, const void *src, void *dest,
+                                          int len);
+
+// Converts the samples of src to the sample format of dstFormat and applies the factor
+// in a single pass. Both formats must have the same channel count; len is the size of src.
+// Integer results saturate, float results are clamped to [-1, 1].
+Q_MULTIMEDIA_EXPORT void qConvertAndMultiplySamples(qreal factor, const QAudioFormat &srcFormat,
+                                                    const void *src, const QAudioFormat &dstFormat,
+                                                    void *dest, int len);
 }
 
 QT_END_NAMESPACE
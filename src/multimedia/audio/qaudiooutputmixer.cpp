@@ -0,0 +1,375 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qaudiooutputmixer_p.h"
+#include "qaudiosink.h"
+#include "qaudiohelpers_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+static Q_LOGGING_CATEGORY(qLcAudioOutputMixer, "qt.multimedia.audiooutputmixer")
+
+namespace {
+
+constexpr qint64 SinkBufferDurationUs = 40000;
+
+// The drift compensation: the fill of an input is averaged over the mix cycles, and
+// its deviation from the target speeds the consumption up or slows it down by up to 0.5%
+constexpr double DriftAveraging = 0.05;
+constexpr double DriftCorrectionGain = 0.01;
+constexpr double MaxDriftCorrection = 0.005;
+
+} // namespace
+
+QAudioOutputMixer::QAudioOutputMixer(const QAudioFormat &format) : m_format(format)
+{
+    Q_ASSERT(format.isValid());
+    open(QIODevice::ReadOnly);
+}
+
+QAudioOutputMixer::QAudioOutputMixer(const QAudioDevice &device, const QAudioFormat &format)
+    : QAudioOutputMixer(format)
+{
+    m_thread = std::make_unique<QThread>();
+    m_thread->setObjectName(QLatin1String("QAudioOutputMixer"));
+    moveToThread(m_thread.get());
+    m_thread->start(QThread::TimeCriticalPriority);
+
+    // The sink pulls the mixer on its own thread
+    QMetaObject::invokeMethod(
+            this,
+            [this, device] {
+                m_sink = std::make_unique<QAudioSink>(device, m_format);
+                m_sink->setBufferSize(m_format.bytesForDuration(SinkBufferDurationUs));
+                // Until the first mix cycle measures it
+                m_downstreamLatencyUs.store(SinkBufferDurationUs, std::memory_order_relaxed);
+                connect(m_sink.get(), &QAudioSink::stateChanged, this, [this](QAudio::State state) {
+                    if (state == QAudio::StoppedState && m_sink->error() != QAudio::NoError)
+                        qCWarning(qLcAudioOutputMixer)
+                                << "Audio sink stopped with error" << m_sink->error();
+                });
+                m_sink->start(this);
+            },
+            Qt::BlockingQueuedConnection);
+}
+
+QAudioOutputMixer::~QAudioOutputMixer()
+{
+    Q_ASSERT(inputCount() == 0);
+
+    if (m_thread) {
+        QThread *thread = QThread::currentThread();
+        QMetaObject::invokeMethod(
+                this,
+                [this, thread] {
+                    disconnect(m_sink.get(), nullptr, this, nullptr);
+                    m_sink->stop();
+                    m_sink.reset();
+                    moveToThread(thread);
+                },
+                Qt::BlockingQueuedConnection);
+
+        m_thread->quit();
+        m_thread->wait();
+    }
+}
+
+std::shared_ptr<QAudioOutputMixer> QAudioOutputMixer::instance(const QAudioDevice &device)
+{
+    // The players output from different threads
+    static QBasicMutex mutex;
+    static QHash<QByteArray, std::weak_ptr<QAudioOutputMixer>> mixers;
+
+    QMutexLocker locker(&mutex);
+
+    std::weak_ptr<QAudioOutputMixer> &entry = mixers[device.id()];
+    if (auto mixer = entry.lock())
+        return mixer;
+
+    QAudioFormat format = device.preferredFormat();
+    if (!format.isValid())
+        return {};
+
+    QAudioFormat floatFormat = format;
+    floatFormat.setSampleFormat(QAudioFormat::Float);
+    if (device.isFormatSupported(floatFormat))
+        format = floatFormat;
+
+    qCDebug(qLcAudioOutputMixer) << "Create mixer for" << device.description() << format;
+
+    std::shared_ptr<QAudioOutputMixer> mixer(new QAudioOutputMixer(device, format));
+    entry = mixer;
+    return mixer;
+}
+
+bool QAudioOutputMixer::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_MEDIA_PLAYER_SHARED_AUDIO_MIXER");
+    return enabled;
+}
+
+QAudioFormat QAudioOutputMixer::inputFormat() const
+{
+    QAudioFormat result = m_format;
+    result.setSampleFormat(QAudioFormat::Float);
+    return result;
+}
+
+int QAudioOutputMixer::inputCount() const
+{
+    return int(std::count_if(m_inputs.begin(), m_inputs.end(),
+                             [](const auto &input) { return input.load() != nullptr; }));
+}
+
+qint64 QAudioOutputMixer::readData(char *data, qint64 len)
+{
+    const int bytesPerFrame = m_format.bytesPerFrame();
+    const qint64 frames = len / bytesPerFrame;
+    if (frames <= 0)
+        return 0;
+
+    const qsizetype samples = frames * m_format.channelCount();
+    m_accumulator.assign(samples, 0.f);
+
+    m_mixCycle.fetch_add(1);
+    for (auto &slot : m_inputs) {
+        if (QAudioOutputMixerInput *input = slot.load())
+            input->mix(m_accumulator.data(), frames);
+    }
+    m_mixCycle.fetch_add(1);
+
+    // Plays silence while no input has data, keeping the device stream running
+    QAudioHelperInternal::qConvertAndMultiplySamples(1., inputFormat(), m_accumulator.data(),
+                                                     m_format, data,
+                                                     int(samples * sizeof(float)));
+
+    updateDownstreamLatency(frames * bytesPerFrame);
+
+    return frames * bytesPerFrame;
+}
+
+qint64 QAudioOutputMixer::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return 0;
+}
+
+bool QAudioOutputMixer::addInput(QAudioOutputMixerInput *input)
+{
+    for (auto &slot : m_inputs) {
+        QAudioOutputMixerInput *expected = nullptr;
+        if (slot.compare_exchange_strong(expected, input))
+            return true;
+    }
+
+    qCWarning(qLcAudioOutputMixer) << "No free input, the limit is" << MaxInputs;
+    return false;
+}
+
+void QAudioOutputMixer::updateDownstreamLatency(qint64 mixedBytes)
+{
+    // Called on the sink's thread while it pulls the mixer; without a sink, the caller
+    // of read() accounts for the data it buffers itself
+    if (!m_sink)
+        return;
+
+    // The data left in the inputs plays after what the sink holds and what has just been mixed
+    const qsizetype sinkBytes = qMax(m_sink->bufferSize() - m_sink->bytesFree(), qsizetype(0));
+    m_downstreamLatencyUs.store(m_format.durationForBytes(qint32(sinkBytes + mixedBytes)),
+                                std::memory_order_relaxed);
+}
+
+void QAudioOutputMixer::removeInput(QAudioOutputMixerInput *input)
+{
+    auto found = std::find_if(m_inputs.begin(), m_inputs.end(),
+                              [input](const auto &slot) { return slot.load() == input; });
+    if (found == m_inputs.end())
+        return;
+
+    found->store(nullptr);
+
+    // A mix cycle in progress may still use the input; the next ones won't see it
+    const quint64 cycle = m_mixCycle.load();
+    if (cycle % 2 != 0) {
+        while (m_mixCycle.load() == cycle)
+            QThread::yieldCurrentThread();
+    }
+}
+
+QAudioOutputMixerInput::QAudioOutputMixerInput(std::shared_ptr<QAudioOutputMixer> mixer,
+                                               qint64 bufferDurationUs, qint64 targetDurationUs)
+    : m_mixer(std::move(mixer)),
+      m_channels(qMax(m_mixer->format().channelCount(), 1)),
+      m_ringBuffer(qMax(m_mixer->format().framesForDuration(bufferDurationUs), 1) * m_channels),
+      m_targetFrames(qMax(m_mixer->format().framesForDuration(targetDurationUs), 1)),
+      m_previousFrame(m_channels),
+      m_nextFrame(m_channels),
+      m_averageFrames(m_targetFrames)
+{
+    if (m_mixer->addInput(this))
+        open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+QAudioOutputMixerInput::~QAudioOutputMixerInput()
+{
+    if (isOpen())
+        m_mixer->removeInput(this);
+}
+
+QAudio::State QAudioOutputMixerInput::state() const
+{
+    return m_idle.load(std::memory_order_acquire) ? QAudio::IdleState : QAudio::ActiveState;
+}
+
+qsizetype QAudioOutputMixerInput::bytesFree() const
+{
+    return qsizetype(m_ringBuffer.free() / m_channels * m_channels) * sizeof(float);
+}
+
+qsizetype QAudioOutputMixerInput::bufferSize() const
+{
+    return qsizetype(m_ringBuffer.size()) * sizeof(float);
+}
+
+qint64 QAudioOutputMixerInput::downstreamLatencyUs() const
+{
+    return m_mixer->m_downstreamLatencyUs.load(std::memory_order_relaxed);
+}
+
+void QAudioOutputMixerInput::setVolume(float volume)
+{
+    m_volume.store(volume, std::memory_order_relaxed);
+}
+
+qint64 QAudioOutputMixerInput::readData(char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+}
+
+qint64 QAudioOutputMixerInput::writeData(const char *data, qint64 len)
+{
+    // Whole frames only, so that the mixer always reads whole frames
+    const int frameSamples = m_channels;
+    int samples = int(qMin<qint64>(len / qint64(sizeof(float)), m_ringBuffer.free()));
+    samples -= samples % frameSamples;
+
+    int written = 0;
+    while (written < samples) {
+        const auto region = m_ringBuffer.acquireWriteRegion(samples - written);
+        if (region.isEmpty())
+            break;
+
+        memcpy(region.data(), data + written * sizeof(float), region.size() * sizeof(float));
+        m_ringBuffer.releaseWriteRegion(region.size());
+        written += region.size();
+    }
+
+    if (written > 0 && m_idle.exchange(false, std::memory_order_acq_rel))
+        emit stateChanged(QAudio::ActiveState);
+
+    return qint64(written) * sizeof(float);
+}
+
+void QAudioOutputMixerInput::mix(float *accumulator, qint64 frames)
+{
+    if (m_ringBuffer.used() < m_channels) {
+        setIdle();
+        return;
+    }
+
+    const double ratio = driftRatio();
+    const float volume = m_volume.load(std::memory_order_relaxed);
+
+    QtPrivate::QAudioRingBuffer<float>::ConstRegion region;
+    int position = 0;
+
+    auto nextFrame = [&]() -> const float * {
+        if (position == region.size()) {
+            if (position > 0)
+                m_ringBuffer.releaseReadRegion(position);
+            region = m_ringBuffer.acquireReadRegion(m_ringBuffer.size());
+            position = 0;
+            if (region.size() < m_channels)
+                return nullptr;
+        }
+
+        const float *frame = region.data() + position;
+        position += m_channels;
+        return frame;
+    };
+
+    // Linear interpolation between the frames around the read position,
+    // which advances by the drift ratio per output frame
+    qint64 mixed = 0;
+    for (; mixed < frames; ++mixed) {
+        m_phase += ratio;
+        bool starved = false;
+        while (m_phase >= 1.) {
+            const float *frame = nextFrame();
+            if (!frame) {
+                starved = true;
+                break;
+            }
+
+            std::swap(m_previousFrame, m_nextFrame);
+            std::copy_n(frame, m_channels, m_nextFrame.data());
+            m_phase -= 1.;
+        }
+
+        if (starved)
+            break;
+
+        const float t = float(m_phase);
+        float *output = accumulator + mixed * m_channels;
+        for (int channel = 0; channel < m_channels; ++channel) {
+            const float previous = m_previousFrame[channel];
+            output[channel] += volume * (previous + (m_nextFrame[channel] - previous) * t);
+        }
+    }
+
+    if (position > 0)
+        m_ringBuffer.releaseReadRegion(position);
+
+    if (mixed < frames)
+        setIdle();
+    else
+        m_idle.store(false, std::memory_order_release);
+}
+
+double QAudioOutputMixerInput::driftRatio()
+{
+    const double frames = m_ringBuffer.used() / m_channels;
+    m_averageFrames += (frames - m_averageFrames) * DriftAveraging;
+
+    const double deviation = (m_averageFrames - m_targetFrames) / m_targetFrames;
+    return 1. + qBound(-MaxDriftCorrection, deviation * DriftCorrectionGain, MaxDriftCorrection);
+}
+
+void QAudioOutputMixerInput::setIdle()
+{
+    // Starts over from silence once the owner writes again
+    m_phase = 1.;
+    m_averageFrames = m_targetFrames;
+    std::fill(m_previousFrame.begin(), m_previousFrame.end(), 0.f);
+    std::fill(m_nextFrame.begin(), m_nextFrame.end(), 0.f);
+
+    if (!m_idle.exchange(true, std::memory_order_acq_rel)) {
+        // Queued to the owner's thread; the owner removes the input before deleting it
+        QMetaObject::invokeMethod(
+                this, [this] { emit stateChanged(QAudio::IdleState); }, Qt::QueuedConnection);
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qaudiooutputmixer_p.cpp"
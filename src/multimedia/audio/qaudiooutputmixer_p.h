@@ -0,0 +1,157 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QAUDIOOUTPUTMIXER_P_H
+#define QAUDIOOUTPUTMIXER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/private/qglobal_p.h>
+#include <QtMultimedia/qaudio.h>
+#include <QtMultimedia/qaudiodevice.h>
+#include <QtMultimedia/qaudioformat.h>
+#include <QtMultimedia/private/qaudioringbuffer_p.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QAudioSink;
+class QAudioOutputMixerInput;
+class QThread;
+
+// Mixes the audio of several players that output to the same audio device into a
+// single audio sink stream. The sink runs on a dedicated thread, which pulls the
+// inputs' ring buffers without locks.
+class Q_MULTIMEDIA_EXPORT QAudioOutputMixer : public QIODevice
+{
+public:
+    static constexpr int MaxInputs = 32;
+
+    // Creates a mixer without an audio sink, the mixed data is pulled via read().
+    explicit QAudioOutputMixer(const QAudioFormat &format);
+    ~QAudioOutputMixer() override;
+
+    // Returns the mixer for the device, creating it if needed; can be called from any thread.
+    static std::shared_ptr<QAudioOutputMixer> instance(const QAudioDevice &device);
+
+    // The shared mixer is opt-in via QT_MEDIA_PLAYER_SHARED_AUDIO_MIXER
+    static bool isEnabled();
+
+    // The format of the device stream
+    QAudioFormat format() const { return m_format; }
+
+    // The format of the data written to the inputs: float samples in the rate
+    // and the channel layout of the device stream
+    QAudioFormat inputFormat() const;
+
+    int inputCount() const;
+
+    bool isSequential() const override { return true; }
+
+protected:
+    qint64 readData(char *data, qint64 len) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    friend class QAudioOutputMixerInput;
+
+    QAudioOutputMixer(const QAudioDevice &device, const QAudioFormat &format);
+
+    bool addInput(QAudioOutputMixerInput *input);
+    void removeInput(QAudioOutputMixerInput *input);
+
+    void updateDownstreamLatency(qint64 mixedBytes);
+
+private:
+    QAudioFormat m_format;
+    std::unique_ptr<QThread> m_thread;
+    std::unique_ptr<QAudioSink> m_sink; // lives on m_thread
+    std::vector<float> m_accumulator;
+
+    std::array<std::atomic<QAudioOutputMixerInput *>, MaxInputs> m_inputs = {};
+
+    // Odd while readData() is mixing; lets removeInput() wait until the input is unused
+    std::atomic<quint64> m_mixCycle = 0;
+
+    // How long the mixed data takes to reach the device, updated by each mix cycle
+    std::atomic<qint64> m_downstreamLatencyUs = 0;
+};
+
+// An input of QAudioOutputMixer: the owner writes float frames in the mixer's
+// inputFormat() to it, like to the QIODevice of a push mode audio sink.
+//
+// The mixer compensates the drift between the owner's clock and the device clock
+// by consuming the input slightly faster or slower, so that the input's buffer stays
+// filled up to the target duration.
+class Q_MULTIMEDIA_EXPORT QAudioOutputMixerInput : public QIODevice
+{
+    Q_OBJECT
+public:
+    // Not open if the mixer has no free input
+    QAudioOutputMixerInput(std::shared_ptr<QAudioOutputMixer> mixer, qint64 bufferDurationUs,
+                           qint64 targetDurationUs);
+    ~QAudioOutputMixerInput() override;
+
+    // Idle until data is written and after the mixer has played it all, active otherwise
+    QAudio::State state() const;
+
+    qsizetype bytesFree() const;
+    qsizetype bufferSize() const;
+
+    // The latency after the input's buffer: the mixed data that the mixer's audio sink
+    // hasn't played yet; 0 if the mixer has no sink. It adds to the duration of the input's data.
+    qint64 downstreamLatencyUs() const;
+
+    void setVolume(float volume);
+    float volume() const { return m_volume.load(std::memory_order_relaxed); }
+
+    bool isSequential() const override { return true; }
+
+Q_SIGNALS:
+    void stateChanged(QAudio::State state);
+
+protected:
+    qint64 readData(char *data, qint64 len) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    friend class QAudioOutputMixer;
+
+    // Called by the mixer's thread
+    void mix(float *accumulator, qint64 frames);
+    double driftRatio();
+    void setIdle();
+
+private:
+    std::shared_ptr<QAudioOutputMixer> m_mixer;
+    const int m_channels;
+    QtPrivate::QAudioRingBuffer<float> m_ringBuffer;
+    const double m_targetFrames;
+
+    std::atomic<float> m_volume = 1.f;
+    std::atomic<bool> m_idle = true;
+
+    // The resampling state of the mixer's thread
+    std::vector<float> m_previousFrame;
+    std::vector<float> m_nextFrame;
+    double m_phase = 1.;
+    double m_averageFrames = 0.;
+};
+
+QT_END_NAMESPACE
+
+#endif // QAUDIOOUTPUTMIXER_P_H
@@ -20,6 +20,7 @@
 #include <QtMultimedia/qaudio.h>
 #include <QtMultimedia/qaudioformat.h>
 #include <QtMultimedia/qaudiodevice.h>
+#include <QtMultimedia/private/qaudiotelemetry_p.h>
 
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/private/qglobal_p.h>
@@ -63,6 +64,9 @@ public:
     virtual qreal volume() const;
 
     QElapsedTimer elapsedTime;
+
+    // Updated by the backends which support it
+    QAudioTelemetry telemetry;
 };
 
 class Q_MULTIMEDIA_EXPORT QPlatformAudioSource : public QAudioStateChangeNotifier
@@ -89,6 +93,9 @@ public:
     virtual qreal volume() const = 0;
 
     QElapsedTimer elapsedTime;
+
+    // Updated by the backends which support it
+    QAudioTelemetry telemetry;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,134 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qaudiotelemetry_p.h"
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qloggingcategory.h>
+
+#include <algorithm>
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+static Q_LOGGING_CATEGORY(qLcAudioTelemetry, "qt.multimedia.audio.telemetry")
+
+void QAudioTelemetry::reset()
+{
+    m_latencyUs.store(-1, std::memory_order_relaxed);
+    m_bufferFill.store(0, std::memory_order_relaxed);
+    m_bufferSize.store(0, std::memory_order_relaxed);
+    m_underrunCount.store(0, std::memory_order_relaxed);
+    m_overrunCount.store(0, std::memory_order_relaxed);
+    m_callbackCount.store(0, std::memory_order_relaxed);
+    m_lastCallbackUs.store(0, std::memory_order_relaxed);
+    for (auto &bucket : m_jitterHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+    m_maxJitterUs.store(0, std::memory_order_relaxed);
+    m_userCallbackTimeUs.store(0, std::memory_order_relaxed);
+    m_maxUserCallbackTimeUs.store(0, std::memory_order_relaxed);
+}
+
+void QAudioTelemetry::setLatency(qint64 latencyUs)
+{
+    m_latencyUs.store(latencyUs, std::memory_order_relaxed);
+}
+
+void QAudioTelemetry::setBufferFill(qsizetype fill, qsizetype size)
+{
+    m_bufferFill.store(fill, std::memory_order_relaxed);
+    m_bufferSize.store(size, std::memory_order_relaxed);
+}
+
+void QAudioTelemetry::addUnderrun()
+{
+    m_underrunCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void QAudioTelemetry::addOverrun()
+{
+    m_overrunCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void QAudioTelemetry::recordCallback(qint64 expectedIntervalUs, qint64 nowUs)
+{
+    m_callbackCount.fetch_add(1, std::memory_order_relaxed);
+
+    const qint64 lastUs = m_lastCallbackUs.exchange(nowUs, std::memory_order_relaxed);
+    if (lastUs == 0 || expectedIntervalUs <= 0)
+        return;
+
+    const qint64 jitterUs = qAbs(nowUs - lastUs - expectedIntervalUs);
+    const auto bound = std::lower_bound(JitterBucketBoundsUs.begin(), JitterBucketBoundsUs.end(),
+                                        jitterUs);
+    m_jitterHistogram[bound - JitterBucketBoundsUs.begin()].fetch_add(1,
+                                                                      std::memory_order_relaxed);
+    updateMax(m_maxJitterUs, jitterUs);
+}
+
+void QAudioTelemetry::recordUserCallbackTime(qint64 durationUs)
+{
+    m_userCallbackTimeUs.fetch_add(durationUs, std::memory_order_relaxed);
+    updateMax(m_maxUserCallbackTimeUs, durationUs);
+}
+
+QAudioTelemetry::Snapshot QAudioTelemetry::snapshot() const
+{
+    Snapshot result;
+    result.latencyUs = m_latencyUs.load(std::memory_order_relaxed);
+    result.bufferFill = m_bufferFill.load(std::memory_order_relaxed);
+    result.bufferSize = m_bufferSize.load(std::memory_order_relaxed);
+    result.underrunCount = m_underrunCount.load(std::memory_order_relaxed);
+    result.overrunCount = m_overrunCount.load(std::memory_order_relaxed);
+    result.callbackCount = m_callbackCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < JitterBucketCount; ++i)
+        result.jitterHistogram[i] = m_jitterHistogram[i].load(std::memory_order_relaxed);
+    result.maxJitterUs = m_maxJitterUs.load(std::memory_order_relaxed);
+    result.userCallbackTimeUs = m_userCallbackTimeUs.load(std::memory_order_relaxed);
+    result.maxUserCallbackTimeUs = m_maxUserCallbackTimeUs.load(std::memory_order_relaxed);
+    return result;
+}
+
+void QAudioTelemetry::log(const char *streamName) const
+{
+    qCDebug(qLcAudioTelemetry).nospace() << streamName << ": " << snapshot();
+}
+
+qint64 QAudioTelemetry::currentTimeUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void QAudioTelemetry::updateMax(std::atomic<qint64> &max, qint64 value)
+{
+    qint64 current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        ;
+}
+
+#ifndef QT_NO_DEBUG_STREAM
+QDebug operator<<(QDebug dbg, const QAudioTelemetry::Snapshot &snapshot)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace();
+    dbg << "latency: " << snapshot.latencyUs << "us, buffer: " << snapshot.bufferFill << "/"
+        << snapshot.bufferSize << ", underruns: " << snapshot.underrunCount
+        << ", overruns: " << snapshot.overrunCount << ", callbacks: " << snapshot.callbackCount
+        << ", max jitter: " << snapshot.maxJitterUs << "us, jitter histogram: [";
+    for (int i = 0; i < QAudioTelemetry::JitterBucketCount; ++i) {
+        if (i > 0)
+            dbg << ", ";
+        if (i < int(QAudioTelemetry::JitterBucketBoundsUs.size()))
+            dbg << "<=" << QAudioTelemetry::JitterBucketBoundsUs[i] << "us: ";
+        else
+            dbg << ">" << QAudioTelemetry::JitterBucketBoundsUs.back() << "us: ";
+        dbg << snapshot.jitterHistogram[i];
+    }
+    dbg << "], user callback time: " << snapshot.userCallbackTimeUs
+        << "us (max " << snapshot.maxUserCallbackTimeUs << "us)";
+    return dbg;
+}
+#endif
+
+QT_END_NAMESPACE
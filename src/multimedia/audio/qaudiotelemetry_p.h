@@ -0,0 +1,120 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QAUDIOTELEMETRY_P_H
+#define QAUDIOTELEMETRY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qtmultimediaglobal.h>
+#include <QtCore/private/qglobal_p.h>
+
+#include <array>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+/* QAudioTelemetry collects the statistics of an audio sink or source:
+ * the device latency, the buffer fill, the underruns and overruns, the jitter
+ * of the backend callbacks and the time spent in the user code (the QIODevice).
+ *
+ * The backends update it from their hot paths, possibly on real-time threads;
+ * all updates are lock-free. snapshot() can be called from any thread.
+ */
+class Q_MULTIMEDIA_EXPORT QAudioTelemetry
+{
+public:
+    // The upper bounds of the buckets of the jitter histogram; the last bucket has none
+    static constexpr std::array<qint64, 7> JitterBucketBoundsUs = { 100,  500,   1000, 2000,
+                                                                    5000, 10000, 20000 };
+    static constexpr int JitterBucketCount = int(JitterBucketBoundsUs.size()) + 1;
+
+    struct Snapshot
+    {
+        qint64 latencyUs = -1; // -1 if unknown
+        qsizetype bufferFill = 0; // bytes
+        qsizetype bufferSize = 0; // bytes
+        quint64 underrunCount = 0;
+        quint64 overrunCount = 0;
+        quint64 callbackCount = 0;
+        std::array<quint64, JitterBucketCount> jitterHistogram = {};
+        qint64 maxJitterUs = 0;
+        qint64 userCallbackTimeUs = 0; // in total
+        qint64 maxUserCallbackTimeUs = 0;
+    };
+
+    // Records the time spent in the user code within its scope
+    class UserCallbackScope
+    {
+    public:
+        explicit UserCallbackScope(QAudioTelemetry &telemetry)
+            : m_telemetry(telemetry), m_start(currentTimeUs())
+        {
+        }
+        ~UserCallbackScope() { m_telemetry.recordUserCallbackTime(currentTimeUs() - m_start); }
+
+        Q_DISABLE_COPY_MOVE(UserCallbackScope)
+
+    private:
+        QAudioTelemetry &m_telemetry;
+        const qint64 m_start;
+    };
+
+    QAudioTelemetry() = default;
+    Q_DISABLE_COPY_MOVE(QAudioTelemetry)
+
+    // Clears the statistics; not to be called concurrently with the updates
+    void reset();
+
+    void setLatency(qint64 latencyUs);
+    void setBufferFill(qsizetype fill, qsizetype size);
+    void addUnderrun();
+    void addOverrun();
+
+    // To be called whenever the backend wakes up to transfer the audio (a device callback,
+    // a timer tick); the jitter is the deviation of the interval from expectedIntervalUs.
+    void recordCallback(qint64 expectedIntervalUs, qint64 nowUs = currentTimeUs());
+    void recordUserCallbackTime(qint64 durationUs);
+
+    Snapshot snapshot() const;
+
+    // Logs the snapshot to the qt.multimedia.audio.telemetry category, if it's enabled
+    void log(const char *streamName) const;
+
+    // A monotonic clock
+    static qint64 currentTimeUs();
+
+private:
+    static void updateMax(std::atomic<qint64> &max, qint64 value);
+
+    std::atomic<qint64> m_latencyUs = -1;
+    std::atomic<qsizetype> m_bufferFill = 0;
+    std::atomic<qsizetype> m_bufferSize = 0;
+    std::atomic<quint64> m_underrunCount = 0;
+    std::atomic<quint64> m_overrunCount = 0;
+    std::atomic<quint64> m_callbackCount = 0;
+    std::atomic<qint64> m_lastCallbackUs = 0;
+    std::array<std::atomic<quint64>, JitterBucketCount> m_jitterHistogram = {};
+    std::atomic<qint64> m_maxJitterUs = 0;
+    std::atomic<qint64> m_userCallbackTimeUs = 0;
+    std::atomic<qint64> m_maxUserCallbackTimeUs = 0;
+};
+
+#ifndef QT_NO_DEBUG_STREAM
+Q_MULTIMEDIA_EXPORT QDebug operator<<(QDebug dbg, const QAudioTelemetry::Snapshot &snapshot);
+#endif
+
+QT_END_NAMESPACE
+
+#endif // QAUDIOTELEMETRY_P_H
@@ -68,6 +68,7 @@ QSampleCache::QSampleCache(QObject *parent)
     , m_networkAccessManager(nullptr)
     , m_capacity(0)
     , m_usage(0)
+    , m_mappingEnabled(qEnvironmentVariableIntValue("QT_MULTIMEDIA_SAMPLECACHE_MAPPING") != 0)
     , m_loadingRefCount(0)
 {
     m_loadingThread.setObjectName(QLatin1String("QSampleCache::LoadingThread"));
@@ -186,10 +187,37 @@ void QSampleCache::setCapacity(qint64 capacity)
     refresh(0);
 }
 
+void QSampleCache::setMappingEnabled(bool enabled)
+{
+    const std::lock_guard<QRecursiveMutex> locker(m_mutex);
+    m_mappingEnabled = enabled;
+}
+
+bool QSampleCache::isMappingEnabled() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(m_mutex);
+    return m_mappingEnabled;
+}
+
+qint64 QSampleCache::usage() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(m_mutex);
+    return m_usage;
+}
+
+qint64 QSampleCache::mappedUsage() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(m_mutex);
+    return m_mappedUsage;
+}
+
 // Called locked
 void QSampleCache::unloadSample(QSample *sample)
 {
-    m_usage -= sample->m_soundData.size();
+    if (sample->m_mappedFile)
+        m_mappedUsage -= sample->m_soundData.size();
+    else
+        m_usage -= sample->m_soundData.size();
     m_staleSamples.insert(sample);
     sample->deleteLater();
 }
@@ -207,6 +235,7 @@ void QSampleCache::refresh(qint64 usageChange)
     //free unused samples to keep usage under capacity limit.
     for (QMap<QUrl, QSample*>::iterator it = m_samples.begin(); it != m_samples.end();) {
         QSample* sample = *it;
+        // Unreferenced mapped samples are unloaded too, they only keep their files open
         if (sample->m_ref > 0) {
             ++it;
             continue;
@@ -226,6 +255,15 @@ void QSampleCache::refresh(qint64 usageChange)
         qWarning() << "QSampleCache: usage" << m_usage << "out of limit" << m_capacity;
 }
 
+// Called in loader thread
+void QSampleCache::refreshMapped(qint64 usageChange)
+{
+    const std::lock_guard<QRecursiveMutex> locker(m_mutex);
+    m_mappedUsage += usageChange;
+    qCDebug(qLcSampleCache) << "QSampleCache: refreshMapped(" << usageChange
+                            << ") new mapped usage =" << m_mappedUsage;
+}
+
 // Called in both threads
 void QSampleCache::removeUnreferencedSample(QSample *sample)
 {
@@ -265,7 +303,9 @@ bool QSampleCache::notifyUnreferencedSample(QSample* sample)
 
     const std::lock_guard<QRecursiveMutex> locker(m_mutex);
 
-    if (m_capacity > 0)
+    // Mapping a sample again is cheap, so an unreferenced mapped sample
+    // isn't worth keeping its file open
+    if (m_capacity > 0 && !sample->m_mappedFile)
         return false;
     m_samples.remove(sample->m_url);
     unloadSample(sample);
@@ -370,6 +410,9 @@ void QSample::load()
         return;
     }
 
+    if (m_parent->isMappingEnabled() && loadMapped())
+        return;
+
     QNetworkReply *reply = m_parent->networkAccessManager().get(QNetworkRequest(m_url));
     m_stream = reply;
     connect(reply, &QNetworkReply::errorOccurred, this, &QSample::loadingError);
@@ -422,6 +465,56 @@ void QSample::onReady()
     emit ready(this);
 }
 
+// Called in loading thread
+// Maps the sample data of a local file that doesn't need decoding; on failure
+// the sample is loaded the regular way, which reports the errors.
+bool QSample::loadMapped()
+{
+#if QT_CONFIG(thread)
+    Q_ASSERT(QThread::currentThread()->objectName() == QLatin1String("QSampleCache::LoadingThread"));
+#endif
+    QString path;
+    if (m_url.isLocalFile())
+        path = m_url.toLocalFile();
+    else if (m_url.scheme() == QLatin1String("qrc"))
+        path = QLatin1Char(':') + m_url.path();
+    else
+        return false;
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly))
+        return false;
+
+    // The header of a complete file is parsed right on opening
+    QWaveDecoder decoder(file.get());
+    if (!decoder.open(QIODevice::ReadOnly) || !decoder.hasRawSampleData())
+        return false;
+
+    const qint64 offset = file->pos();
+    const qint64 size = qMin(decoder.size(), file->size() - offset);
+    if (size <= 0)
+        return false;
+
+    uchar *data = file->map(offset, size);
+    if (!data) {
+        qCDebug(qLcSampleCache) << "QSample: cannot map" << path << file->errorString();
+        return false;
+    }
+
+    QMutexLocker m(&m_mutex);
+    qCDebug(qLcSampleCache) << "QSample: mapped" << size << "bytes of" << m_url;
+    m_soundData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), size);
+    m_sampleReadLength = size;
+    m_audioFormat = decoder.audioFormat();
+    m_mappedFile = std::move(file);
+    m_parent->refreshMapped(size);
+
+    m_state = QSample::Ready;
+    m_parent->loadingRelease();
+    emit ready(this);
+    return true;
+}
+
 // Called in application thread, then moved to loader thread
 QSample::QSample(const QUrl& url, QSampleCache *parent)
     : m_parent(parent)
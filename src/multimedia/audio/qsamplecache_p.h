@@ -15,6 +15,7 @@
 // We mean it.
 //
 
+#include <QtCore/qfile.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qobject.h>
@@ -26,6 +27,8 @@
 #include <QtMultimedia/qaudioformat.h>
 #include <QtNetwork/qnetworkreply.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QIODevice;
@@ -51,6 +54,8 @@ public:
     // variables are updated to their final states
     const QByteArray& data() const { Q_ASSERT(state() == Ready); return m_soundData; }
     const QAudioFormat& format() const { Q_ASSERT(state() == Ready); return m_audioFormat; }
+    // Whether data() is mapped from the file rather than read into memory
+    bool isMapped() const { Q_ASSERT(state() == Ready); return m_mappedFile != nullptr; }
     void release();
 
 Q_SIGNALS:
@@ -69,6 +74,7 @@ private Q_SLOTS:
 
 private:
     void onReady();
+    bool loadMapped();
     void cleanup();
     void addRef();
     void loadIfNecessary();
@@ -82,6 +88,7 @@ private:
     QIODevice    *m_stream;
     QWaveDecoder *m_waveDecoder;
     QUrl         m_url;
+    std::unique_ptr<QFile> m_mappedFile;
     qint64       m_sampleReadLength;
     State        m_state;
     int          m_ref;
@@ -99,6 +106,17 @@ public:
     QSample* requestSample(const QUrl& url);
     void setCapacity(qint64 capacity);
 
+    // Uncompressed local WAV files are mapped instead of being read into memory.
+    // The mapped data is backed by the file, the system can drop its pages at any
+    // time, thus, it is accounted separately and doesn't count towards the capacity.
+    // Mapped samples are unloaded once they are no longer referenced.
+    // Disabled by default, can be enabled by QT_MULTIMEDIA_SAMPLECACHE_MAPPING=1.
+    void setMappingEnabled(bool enabled);
+    bool isMappingEnabled() const;
+
+    qint64 usage() const;
+    qint64 mappedUsage() const;
+
     bool isLoading() const;
     bool isCached(const QUrl& url) const;
 
@@ -109,10 +127,13 @@ private:
     mutable QRecursiveMutex m_mutex;
     qint64 m_capacity;
     qint64 m_usage;
+    qint64 m_mappedUsage = 0;
+    bool m_mappingEnabled;
     QThread m_loadingThread;
 
     QNetworkAccessManager& networkAccessManager();
     void refresh(qint64 usageChange);
+    void refreshMapped(qint64 usageChange);
     bool notifyUnreferencedSample(QSample* sample);
     void removeUnreferencedSample(QSample* sample);
     void unloadSample(QSample* sample);
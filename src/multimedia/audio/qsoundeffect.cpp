@@ -4,6 +4,7 @@
 #include <QtMultimedia/private/qtmultimediaglobal_p.h>
 #include "qsoundeffect.h"
 #include "qsamplecache_p.h"
+#include "qsoundeffectmixer_p.h"
 #include "qaudiodevice.h"
 #include "qaudiosink.h"
 #include "qmediadevices.h"
@@ -40,11 +41,11 @@ struct SampleDeleter
 };
 }
 
-class QSoundEffectPrivate : public QIODevice
+class QSoundEffectPrivate : public QIODevice, public QSoundEffectMixer::Voice
 {
 public:
     QSoundEffectPrivate(QSoundEffect *q, const QAudioDevice &audioDevice = QAudioDevice());
-    ~QSoundEffectPrivate() override = default;
+    ~QSoundEffectPrivate() override { resetMixer(); }
 
     qint64 readData(char *data, qint64 len) override;
     qint64 writeData(const char *data, qint64 len) override;
@@ -71,6 +72,11 @@ public:
     void setStatus(QSoundEffect::Status status);
     void setPlaying(bool playing);
     bool updateAudioOutput();
+    bool setupMixer(const QAudioDevice &audioDevice);
+    void resetMixer();
+
+    bool mix(float *accumulator, qint64 frames) override;
+    void voiceStopped() override;
 
 public Q_SLOTS:
     void sampleReady(QSample *);
@@ -85,6 +91,7 @@ public:
     bool m_playing = false;
     QSoundEffect::Status m_status = QSoundEffect::Null;
     std::unique_ptr<QAudioSink, AudioSinkDeleter> m_audioSink;
+    std::shared_ptr<QSoundEffectMixer> m_mixer;
     std::unique_ptr<QSample, SampleDeleter> m_sample;
     QAudioBuffer m_audioBuffer;
     bool m_muted = false;
@@ -116,7 +123,7 @@ void QSoundEffectPrivate::sampleReady(QSample *sample)
     disconnect(m_sample.get(), &QSample::error, this, &QSoundEffectPrivate::decoderError);
     disconnect(m_sample.get(), &QSample::ready, this, &QSoundEffectPrivate::sampleReady);
 
-    if (!m_audioSink) {
+    if (!m_audioSink && !m_mixer) {
         if (!updateAudioOutput()) // Create audio sink
             return; // Returns if no audio devices are available
     }
@@ -124,7 +131,10 @@ void QSoundEffectPrivate::sampleReady(QSample *sample)
     m_sampleReady = true;
     setStatus(QSoundEffect::Ready);
 
-    if (m_playing && m_audioSink->state() == QAudio::StoppedState) {
+    if (m_playing && m_mixer) {
+        qCDebug(qLcSoundEffect) << this << "starting playback on the shared mixer";
+        m_mixer->startVoice(this);
+    } else if (m_playing && m_audioSink->state() == QAudio::StoppedState) {
         qCDebug(qLcSoundEffect) << this << "starting playback on audiooutput";
         m_audioSink->start(this);
     }
@@ -166,9 +176,15 @@ bool QSoundEffectPrivate::updateAudioOutput()
     }
 
     m_audioBuffer = {};
+    resetMixer();
 
     Q_ASSERT(m_sample);
 
+    if (QSoundEffectMixer::isEnabled() && setupMixer(audioDevice)) {
+        m_audioSink.reset();
+        return true;
+    }
+
     const auto &sampleFormat = m_sample->format();
     const auto sampleChannelConfig =
             sampleFormat.channelConfig() == QAudioFormat::ChannelConfigUnknown
@@ -206,6 +222,82 @@ bool QSoundEffectPrivate::updateAudioOutput()
     return true;
 }
 
+bool QSoundEffectPrivate::setupMixer(const QAudioDevice &audioDevice)
+{
+    auto mixer = QSoundEffectMixer::instance(audioDevice);
+    if (!mixer)
+        return false;
+
+    const QAudioFormat voiceFormat = mixer->voiceFormat();
+    if (m_sample->format() == voiceFormat) {
+        m_audioBuffer = QAudioBuffer(m_sample->data(), voiceFormat);
+    } else {
+        const auto resampler = QPlatformMediaIntegration::instance()->createAudioResampler(
+                m_sample->format(), voiceFormat);
+        if (!resampler) {
+            qCDebug(qLcSoundEffect) << "Cannot convert the sample to the mixer format"
+                                    << voiceFormat << "; using a dedicated audio sink";
+            return false;
+        }
+        m_audioBuffer = resampler.value()->resample(m_sample->data().constData(),
+                                                    m_sample->data().size());
+    }
+
+    if (!m_audioBuffer.isValid())
+        return false;
+
+    m_mixer = std::move(mixer);
+    return true;
+}
+
+void QSoundEffectPrivate::resetMixer()
+{
+    if (m_mixer) {
+        m_mixer->stopVoice(this);
+        m_mixer.reset();
+    }
+}
+
+bool QSoundEffectPrivate::mix(float *accumulator, qint64 frames)
+{
+    if (m_sample->state() != QSample::Ready || m_runningCount == 0 || !m_playing)
+        return false;
+
+    const float gain = m_muted ? 0.f : m_volume;
+    const int channels = m_audioBuffer.format().channelCount();
+    const int bytesPerFrame = m_audioBuffer.format().bytesPerFrame();
+    const qint64 sampleFrames = m_audioBuffer.frameCount();
+    const float *sampleData = m_audioBuffer.constData<float>();
+    if (sampleFrames == 0)
+        return false;
+
+    while (frames && m_runningCount) {
+        const qint64 offsetFrames = m_offset / bytesPerFrame;
+        const qint64 toMix = qMax(0, qMin(sampleFrames - offsetFrames, frames));
+
+        const float *src = sampleData + offsetFrames * channels;
+        for (qint64 i = 0, count = toMix * channels; i < count; ++i)
+            accumulator[i] += src[i] * gain;
+
+        accumulator += toMix * channels;
+        frames -= toMix;
+        m_offset += toMix * bytesPerFrame;
+        if (offsetFrames + toMix >= sampleFrames) {
+            if (m_runningCount > 0 && m_runningCount != QSoundEffect::Infinite)
+                setLoopsRemaining(m_runningCount - 1);
+            m_offset = 0;
+        }
+    }
+
+    return m_runningCount != 0;
+}
+
+void QSoundEffectPrivate::voiceStopped()
+{
+    qCDebug(qLcSoundEffect) << this << "voice stopped by the mixer" << m_runningCount;
+    q_ptr->stop();
+}
+
 qint64 QSoundEffectPrivate::readData(char *data, qint64 len)
 {
     qCDebug(qLcSoundEffect) << this << "readData" << len << m_runningCount;
@@ -269,7 +361,12 @@ void QSoundEffectPrivate::setStatus(QSoundEffect::Status status)
 void QSoundEffectPrivate::setPlaying(bool playing)
 {
     qCDebug(qLcSoundEffect) << this << "setPlaying(" << playing << ")" << m_playing;
-    if (m_audioSink) {
+    if (m_mixer) {
+        // The mixer doesn't report state changes, so (re)start the voice explicitly
+        m_mixer->stopVoice(this);
+        if (playing && m_sampleReady)
+            m_mixer->startVoice(this);
+    } else if (m_audioSink) {
         m_audioSink->stop();
         if (playing && !m_sampleReady)
             return;
@@ -372,6 +469,9 @@ QSoundEffect::~QSoundEffect()
 {
     stop();
     d->m_audioSink.reset();
+    d->resetMixer();
+    // The buffer may refer to the data of a mapped sample
+    d->m_audioBuffer = {};
     d->m_sample.reset();
     delete d;
 }
@@ -440,19 +540,22 @@ void QSoundEffect::setSource(const QUrl &url)
         return;
     }
 
+    if (d->m_audioSink) {
+        disconnect(d->m_audioSink.get(), &QAudioSink::stateChanged, d, &QSoundEffectPrivate::stateChanged);
+        d->m_audioSink.reset();
+    }
+    d->resetMixer();
+
     if (d->m_sample) {
         if (!d->m_sampleReady) {
             disconnect(d->m_sample.get(), &QSample::error, d, &QSoundEffectPrivate::decoderError);
             disconnect(d->m_sample.get(), &QSample::ready, d, &QSoundEffectPrivate::sampleReady);
         }
+        // The buffer may refer to the data of a mapped sample, release it first
+        d->m_audioBuffer = {};
         d->m_sample.reset();
     }
 
-    if (d->m_audioSink) {
-        disconnect(d->m_audioSink.get(), &QAudioSink::stateChanged, d, &QSoundEffectPrivate::stateChanged);
-        d->m_audioSink.reset();
-    }
-
     d->setStatus(QSoundEffect::Loading);
     d->m_sample.reset(sampleCache()->requestSample(url));
     connect(d->m_sample.get(), &QSample::error, d, &QSoundEffectPrivate::decoderError);
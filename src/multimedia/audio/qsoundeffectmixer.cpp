@@ -0,0 +1,202 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qsoundeffectmixer_p.h"
+#include "qaudiosink.h"
+#include "qaudiohelpers_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+static Q_LOGGING_CATEGORY(qLcSoundEffectMixer, "qt.multimedia.soundeffect.mixer")
+
+QSoundEffectMixer::Voice::~Voice() = default;
+
+QSoundEffectMixer::QSoundEffectMixer(const QAudioFormat &format) : m_format(format)
+{
+    Q_ASSERT(format.isValid());
+    open(QIODevice::ReadOnly);
+}
+
+QSoundEffectMixer::QSoundEffectMixer(const QAudioDevice &device, const QAudioFormat &format)
+    : QSoundEffectMixer(format)
+{
+    m_sink = std::make_unique<QAudioSink>(device, format);
+    connect(m_sink.get(), &QAudioSink::stateChanged, this, &QSoundEffectMixer::sinkStateChanged);
+}
+
+QSoundEffectMixer::~QSoundEffectMixer()
+{
+    if (m_sink) {
+        disconnect(m_sink.get(), nullptr, this, nullptr);
+        m_sink->stop();
+    }
+}
+
+std::shared_ptr<QSoundEffectMixer> QSoundEffectMixer::instance(const QAudioDevice &device)
+{
+    static thread_local QHash<QByteArray, std::weak_ptr<QSoundEffectMixer>> mixers;
+
+    std::weak_ptr<QSoundEffectMixer> &entry = mixers[device.id()];
+    if (auto mixer = entry.lock())
+        return mixer;
+
+    QAudioFormat format = device.preferredFormat();
+    if (!format.isValid())
+        return {};
+
+    QAudioFormat floatFormat = format;
+    floatFormat.setSampleFormat(QAudioFormat::Float);
+    if (device.isFormatSupported(floatFormat))
+        format = floatFormat;
+
+    qCDebug(qLcSoundEffectMixer) << "Create mixer for" << device.description() << format;
+
+    std::shared_ptr<QSoundEffectMixer> mixer(new QSoundEffectMixer(device, format));
+    entry = mixer;
+    return mixer;
+}
+
+bool QSoundEffectMixer::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_SOUNDEFFECT_SHARED_MIXER");
+    return enabled;
+}
+
+QAudioFormat QSoundEffectMixer::voiceFormat() const
+{
+    QAudioFormat result = m_format;
+    result.setSampleFormat(QAudioFormat::Float);
+    return result;
+}
+
+void QSoundEffectMixer::setMaxVoices(int maxVoices)
+{
+    m_maxVoices = qMax(maxVoices, 1);
+}
+
+bool QSoundEffectMixer::isVoiceActive(const Voice *voice) const
+{
+    return std::find(m_voices.begin(), m_voices.end(), voice) != m_voices.end();
+}
+
+void QSoundEffectMixer::startVoice(Voice *voice)
+{
+    Q_ASSERT(voice);
+    if (isVoiceActive(voice))
+        return;
+
+    while (activeVoiceCount() >= m_maxVoices) {
+        Voice *stolenVoice = m_voices.front();
+        m_voices.erase(m_voices.begin());
+        qCDebug(qLcSoundEffectMixer) << "Polyphony limit" << m_maxVoices << "reached, stealing voice";
+        stolenVoice->voiceStopped();
+    }
+
+    m_voices.push_back(voice);
+    resumeSink();
+}
+
+void QSoundEffectMixer::stopVoice(Voice *voice)
+{
+    auto found = std::find(m_voices.begin(), m_voices.end(), voice);
+    if (found != m_voices.end())
+        m_voices.erase(found);
+}
+
+qint64 QSoundEffectMixer::readData(char *data, qint64 len)
+{
+    const int bytesPerFrame = m_format.bytesPerFrame();
+    const qint64 frames = len / bytesPerFrame;
+    if (frames <= 0)
+        return 0;
+
+    const qsizetype samples = frames * m_format.channelCount();
+    m_accumulator.assign(samples, 0.f);
+
+    // Voices emit signals while mixing, and their handlers may start or stop other voices
+    const QVarLengthArray<Voice *, DefaultMaxVoices> voices(m_voices.begin(), m_voices.end());
+    QVarLengthArray<Voice *, 8> finishedVoices;
+
+    for (Voice *voice : voices) {
+        if (isVoiceActive(voice) && !voice->mix(m_accumulator.data(), frames))
+            finishedVoices.push_back(voice);
+    }
+
+    for (Voice *voice : finishedVoices) {
+        if (!isVoiceActive(voice))
+            continue;
+        stopVoice(voice);
+        voice->voiceStopped();
+    }
+
+    QAudioHelperInternal::qConvertAndMultiplySamples(1., voiceFormat(), m_accumulator.data(),
+                                                     m_format, data,
+                                                     int(samples * sizeof(float)));
+
+    if (m_voices.empty() && m_sink && !m_suspendPending) {
+        // Don't keep the stream busy with silence, but avoid suspending from the pull callback
+        m_suspendPending = true;
+        QMetaObject::invokeMethod(this, &QSoundEffectMixer::suspendSinkIfIdle,
+                                  Qt::QueuedConnection);
+    }
+
+    return frames * bytesPerFrame;
+}
+
+qint64 QSoundEffectMixer::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return 0;
+}
+
+void QSoundEffectMixer::resumeSink()
+{
+    if (!m_sink)
+        return;
+
+    switch (m_sink->state()) {
+    case QAudio::StoppedState:
+        m_sink->start(this);
+        break;
+    case QAudio::SuspendedState:
+        m_sink->resume();
+        break;
+    default:
+        break;
+    }
+}
+
+void QSoundEffectMixer::suspendSinkIfIdle()
+{
+    m_suspendPending = false;
+    if (m_voices.empty() && m_sink && m_sink->state() == QAudio::ActiveState)
+        m_sink->suspend();
+}
+
+void QSoundEffectMixer::sinkStateChanged(QAudio::State state)
+{
+    qCDebug(qLcSoundEffectMixer) << "Sink state changed:" << state;
+
+    if (state == QAudio::StoppedState && m_sink->error() != QAudio::NoError) {
+        qCWarning(qLcSoundEffectMixer) << "Audio sink stopped with error" << m_sink->error();
+        stopAllVoices();
+    }
+}
+
+void QSoundEffectMixer::stopAllVoices()
+{
+    while (!m_voices.empty()) {
+        Voice *voice = m_voices.back();
+        m_voices.pop_back();
+        voice->voiceStopped();
+    }
+}
+
+QT_END_NAMESPACE
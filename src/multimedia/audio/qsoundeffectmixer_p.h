@@ -0,0 +1,101 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSOUNDEFFECTMIXER_P_H
+#define QSOUNDEFFECTMIXER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/private/qglobal_p.h>
+#include <QtMultimedia/qaudio.h>
+#include <QtMultimedia/qaudiodevice.h>
+#include <QtMultimedia/qaudioformat.h>
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QAudioSink;
+
+// Mixes the voices of all the sound effects that play on the same audio device
+// (within one thread) into a single audio sink stream.
+class Q_MULTIMEDIA_EXPORT QSoundEffectMixer : public QIODevice
+{
+public:
+    class Q_MULTIMEDIA_EXPORT Voice
+    {
+    public:
+        virtual ~Voice();
+
+        // Adds up to the given number of frames, scaled by the voice gain, to the accumulator.
+        // The samples are in voiceFormat(). Returns false once the voice has finished.
+        virtual bool mix(float *accumulator, qint64 frames) = 0;
+
+        // Called when the mixer drops the voice because it finished or got stolen
+        // by a newer voice.
+        virtual void voiceStopped() = 0;
+    };
+
+    static constexpr int DefaultMaxVoices = 32;
+
+    // Creates a mixer without an audio sink, the mixed data is pulled via read().
+    explicit QSoundEffectMixer(const QAudioFormat &format);
+    ~QSoundEffectMixer() override;
+
+    // Returns the mixer for the device and the current thread, creating it if needed.
+    static std::shared_ptr<QSoundEffectMixer> instance(const QAudioDevice &device);
+
+    // The shared mixer is opt-in via QT_SOUNDEFFECT_SHARED_MIXER
+    static bool isEnabled();
+
+    QAudioFormat format() const { return m_format; }
+    QAudioFormat voiceFormat() const;
+
+    int maxVoices() const { return m_maxVoices; }
+    void setMaxVoices(int maxVoices);
+
+    int activeVoiceCount() const { return static_cast<int>(m_voices.size()); }
+    bool isVoiceActive(const Voice *voice) const;
+
+    // Starts mixing the voice; if the polyphony limit is reached,
+    // the oldest voice is stolen.
+    void startVoice(Voice *voice);
+    void stopVoice(Voice *voice);
+
+    bool isSequential() const override { return true; }
+
+protected:
+    qint64 readData(char *data, qint64 len) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    QSoundEffectMixer(const QAudioDevice &device, const QAudioFormat &format);
+
+    void resumeSink();
+    void suspendSinkIfIdle();
+    void sinkStateChanged(QAudio::State state);
+    void stopAllVoices();
+
+private:
+    QAudioFormat m_format;
+    std::unique_ptr<QAudioSink> m_sink;
+    std::vector<Voice *> m_voices; // in the starting order
+    std::vector<float> m_accumulator;
+    int m_maxVoices = DefaultMaxVoices;
+    bool m_suspendPending = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSOUNDEFFECTMIXER_P_H
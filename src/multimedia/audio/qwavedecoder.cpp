@@ -118,6 +118,11 @@ qint64 QWaveDecoder::headerLength()
     return HeaderLength;
 }
 
+bool QWaveDecoder::hasRawSampleData() const
+{
+    return haveFormat && bps != 24 && (!byteSwap || format.bytesPerSample() == 1);
+}
+
 qint64 QWaveDecoder::readData(char *data, qint64 maxlen)
 {
     const int bytesPerSample = format.bytesPerSample();
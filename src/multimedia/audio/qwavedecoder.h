@@ -27,6 +27,10 @@ public:
     int duration() const;
     static qint64 headerLength();
 
+    // Whether the sample data in the device is in audioFormat() as it is stored,
+    // so that it can be used without reading it through the decoder
+    bool hasRawSampleData() const;
+
     bool open(QIODevice::OpenMode mode) override;
     void close() override;
     bool seek(qint64 pos) override;
@@ -20,13 +20,32 @@ static constexpr uint DefaultBufferLengthMs = 100;
 
 #define LOW_LATENCY_CATEGORY_NAME "game"
 
+// In pull mode, write from the write callback of the stream instead of the timer of the sink
+static bool callbackModeEnabled()
+{
+    static const bool enabled =
+            qEnvironmentVariableIntValue("QT_PULSEAUDIO_OUTPUT_CALLBACK_MODE") > 0;
+    return enabled;
+}
+
+// The minimum request of the server in callback mode, which is how much data
+// a write callback asks for at least
+static uint callbackMinRequestMs()
+{
+    static const uint minRequestMs = [] {
+        bool ok = false;
+        const int value = qEnvironmentVariableIntValue("QT_PULSEAUDIO_OUTPUT_MINREQ_MS", &ok);
+        return ok && value > 0 ? uint(value) : SinkPeriodTimeMs;
+    }();
+    return minRequestMs;
+}
+
 static void outputStreamWriteCallback(pa_stream *stream, size_t length, void *userdata)
 {
     Q_UNUSED(stream);
-    Q_UNUSED(userdata);
     qCDebug(qLcPulseAudioOut) << "Write callback:" << length;
-    QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
-    pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+    if (userdata)
+        static_cast<QPulseAudioSink *>(userdata)->streamWriteCallback(length);
 }
 
 static void outputStreamStateCallback(pa_stream *stream, void *userdata)
@@ -62,8 +81,9 @@ static void outputStreamUnderflowCallback(pa_stream *stream, void *userdata)
 static void outputStreamOverflowCallback(pa_stream *stream, void *userdata)
 {
     Q_UNUSED(stream);
-    Q_UNUSED(userdata);
     qCDebug(qLcPulseAudioOut) << "Buffer overflow";
+    if (userdata)
+        static_cast<QPulseAudioSink *>(userdata)->telemetry.addOverrun();
 }
 
 static void outputStreamLatencyCallback(pa_stream *stream, void *userdata)
@@ -146,7 +166,14 @@ QAudio::State QPulseAudioSink::state() const
 
 void QPulseAudioSink::streamUnderflowCallback()
 {
-    bool atEnd = m_audioSource && m_audioSource->atEnd();
+    telemetry.addUnderrun();
+
+    // The ring buffer may have been refilled since the last write request
+    if (m_ringBuffer)
+        writeFromRingBuffer(pa_stream_writable_size(m_stream));
+
+    bool atEnd = m_audioSource && m_audioSource->atEnd()
+            && (!m_ringBuffer || m_ringBuffer->used() < int(pa_frame_size(&m_spec)));
     if (atEnd && m_stateMachine.state() != QAudio::StoppedState) {
         qCDebug(qLcPulseAudioOut) << "Draining stream at end of buffer";
         exchangeDrainOperation(pa_stream_drain(m_stream, outputStreamDrainComplete, this));
@@ -163,6 +190,27 @@ void QPulseAudioSink::streamDrainedCallback()
         return;
 }
 
+void QPulseAudioSink::streamWriteCallback(size_t length)
+{
+    if (!m_ringBuffer) {
+        QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
+        pa_threaded_mainloop_signal(pulseEngine->mainloop(), 0);
+        return;
+    }
+
+    // The server requests about as much as it has played since the previous request
+    telemetry.recordCallback(m_format.durationForBytes(int(length)));
+
+    m_writeStarved.store(writeFromRingBuffer(length) < length, std::memory_order_relaxed);
+
+    if (m_ringBuffer->used() <= m_ringBuffer->size() / 2
+        && !m_fillRequested.exchange(true, std::memory_order_acq_rel)) {
+        // The sink may have been closed by the time it's delivered
+        QMetaObject::invokeMethod(
+                this, [this] { if (m_ringBuffer) fillRingBuffer(); }, Qt::QueuedConnection);
+    }
+}
+
 void QPulseAudioSink::start(QIODevice *device)
 {
     reset();
@@ -243,12 +291,25 @@ bool QPulseAudioSink::open()
     }
 
     m_spec = spec;
-    m_totalTimeValue = 0;
+    m_totalTimeValue.store(0, std::memory_order_relaxed);
+    // The callbacks of the stream update the telemetry once it's connected
+    telemetry.reset();
 
     if (m_streamName.isNull())
         m_streamName =
                 QStringLiteral("QtmPulseStream-%1-%2").arg(::getpid()).arg(quintptr(this)).toUtf8();
 
+    if (m_pullMode && callbackModeEnabled()) {
+        // Twice the target latency, which leaves the owner thread a target latency to refill it
+        const qsizetype frameSize = pa_frame_size(&m_spec);
+        const qsizetype targetSize = m_userBufferSize ? *m_userBufferSize : defaultBufferSize();
+        const qsizetype ringSize = qMax(targetSize * 2 / frameSize, qsizetype(1)) * frameSize;
+        m_ringBuffer = std::make_unique<QtPrivate::QAudioRingBuffer<char>>(int(ringSize));
+
+        // Pre-buffer, so that the first write requests are served right away
+        fillRingBuffer();
+    }
+
     if (Q_UNLIKELY(qLcPulseAudioOut().isEnabled(QtDebugMsg))) {
         qCDebug(qLcPulseAudioOut) << "Opening stream with.";
         qCDebug(qLcPulseAudioOut) << "\tFormat: " << spec.format;
@@ -309,6 +370,9 @@ bool QPulseAudioSink::open()
     requestedBuffer.maxlength = static_cast<uint32_t>(-1);
     requestedBuffer.minreq = static_cast<uint32_t>(-1);
     requestedBuffer.prebuf = static_cast<uint32_t>(-1);
+    if (m_ringBuffer)
+        requestedBuffer.minreq =
+                static_cast<uint32_t>(pa_usec_to_bytes(callbackMinRequestMs() * 1000, &m_spec));
 
     pa_stream_flags flags =
             pa_stream_flags(PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_ADJUST_LATENCY);
@@ -363,6 +427,7 @@ bool QPulseAudioSink::open()
             &QPulseAudioSink::onPulseContextFailed);
 
     m_opened = true;
+    m_appliedVolume = m_volume;
 
     if (m_pullMode)
         startPulling();
@@ -377,6 +442,8 @@ void QPulseAudioSink::close()
     if (!m_opened)
         return;
 
+    telemetry.log("QPulseAudioSink");
+
     stopTimer();
 
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
@@ -416,6 +483,9 @@ void QPulseAudioSink::close()
 
     m_opened = false;
     m_audioBuffer.clear();
+    m_ringBuffer.reset();
+    m_writeStarved.store(false, std::memory_order_relaxed);
+    m_fillRequested.store(false, std::memory_order_relaxed);
 }
 
 void QPulseAudioSink::timerEvent(QTimerEvent *event)
@@ -428,6 +498,14 @@ void QPulseAudioSink::timerEvent(QTimerEvent *event)
 
 void QPulseAudioSink::userFeed()
 {
+    // Callback mode records the write requests of the server instead
+    if (m_ringBuffer) {
+        fillRingBuffer();
+        return;
+    }
+
+    telemetry.recordCallback(m_pullingPeriodTime * qint64(1000));
+
     int writableSize = bytesFree();
 
     if (writableSize == 0) {
@@ -441,7 +519,11 @@ void QPulseAudioSink::userFeed()
             std::min({ m_pullingPeriodSize, static_cast<int>(m_audioBuffer.size()), writableSize });
 
     Q_ASSERT(!m_audioBuffer.empty());
-    int audioBytesPulled = m_audioSource->read(m_audioBuffer.data(), inputSize);
+    int audioBytesPulled = 0;
+    {
+        QAudioTelemetry::UserCallbackScope scope(telemetry);
+        audioBytesPulled = m_audioSource->read(m_audioBuffer.data(), inputSize);
+    }
     Q_ASSERT(audioBytesPulled <= inputSize);
 
     if (audioBytesPulled > 0) {
@@ -487,13 +569,7 @@ qint64 QPulseAudioSink::write(const char *data, qint64 len)
 
     len = qMin(len, qint64(nbytes));
 
-    if (m_volume < 1.0f) {
-        // Don't use PulseAudio volume, as it might affect all other streams of the same category
-        // or even affect the system volume if flat volumes are enabled
-        QAudioHelperInternal::qMultiplySamples(m_volume, m_format, data, dest, len);
-    } else {
-        memcpy(dest, data, len);
-    }
+    applyVolume(data, dest, len);
 
     data = reinterpret_cast<char *>(dest);
 
@@ -505,13 +581,140 @@ qint64 QPulseAudioSink::write(const char *data, qint64 len)
         return 0;
     }
 
+    updateTelemetry();
     pulseEngine->unlock();
-    m_totalTimeValue += len;
+    m_totalTimeValue.fetch_add(len, std::memory_order_relaxed);
 
     m_stateMachine.updateActiveOrIdle(QAudioStateMachine::RunningState::Active);
     return len;
 }
 
+void QPulseAudioSink::applyVolume(const char *src, void *dest, qsizetype len)
+{
+    // Don't use PulseAudio volume, as it might affect all other streams of the same category
+    // or even affect the system volume if flat volumes are enabled
+    const qreal volume = m_volume;
+    if (volume != m_appliedVolume) {
+        // Ramp to the new volume over the chunk to avoid zipper noise
+        QAudioHelperInternal::qMultiplySamples(m_appliedVolume, volume, m_format, src, dest, len);
+        m_appliedVolume = volume;
+    } else if (volume < 1.0f) {
+        QAudioHelperInternal::qMultiplySamples(volume, m_format, src, dest, len);
+    } else {
+        memcpy(dest, src, len);
+    }
+}
+
+void QPulseAudioSink::fillRingBuffer()
+{
+    m_fillRequested.store(false, std::memory_order_release);
+
+    qint64 bytesRead = 0;
+    bool sourceDrained = false;
+    while (true) {
+        const auto region = m_ringBuffer->acquireWriteRegion(m_ringBuffer->free());
+        if (region.isEmpty())
+            break;
+
+        qint64 l = 0;
+        {
+            QAudioTelemetry::UserCallbackScope scope(telemetry);
+            l = m_audioSource->read(region.data(), region.size());
+        }
+        if (l <= 0) {
+            sourceDrained = true;
+            break;
+        }
+
+        m_ringBuffer->releaseWriteRegion(int(l));
+        bytesRead += l;
+        if (l < region.size())
+            break;
+    }
+
+    if (bytesRead > 0) {
+        m_stateMachine.activateFromIdle();
+    } else if (sourceDrained) {
+        // readyRead() restarts the timer
+        stopTimer();
+        qCDebug(qLcPulseAudioOut) << "No more data available, source is done:"
+                                  << m_audioSource->atEnd();
+    }
+
+    // The server waits for the data the last write callback couldn't provide;
+    // it doesn't call the write callback again until it gets it
+    if (m_stream && m_writeStarved.load(std::memory_order_relaxed)
+        && m_ringBuffer->used() >= int(pa_frame_size(&m_spec))) {
+        std::lock_guard lock(*QPulseAudioEngine::instance());
+        const size_t writableSize = pa_stream_writable_size(m_stream);
+        m_writeStarved.store(writeFromRingBuffer(writableSize) < writableSize,
+                             std::memory_order_relaxed);
+    }
+}
+
+size_t QPulseAudioSink::writeFromRingBuffer(size_t length)
+{
+    using namespace QPulseAudioInternal;
+
+    // The pull source may have written a part of a frame; it's written with the rest of it
+    const size_t frameSize = pa_frame_size(&m_spec);
+    size_t remaining = qMin(length, size_t(m_ringBuffer->used()) / frameSize * frameSize);
+    size_t written = 0;
+
+    while (remaining > 0) {
+        const auto region = m_ringBuffer->acquireReadRegion(int(remaining));
+        if (region.isEmpty())
+            break;
+
+        void *dest = nullptr;
+        size_t nbytes = region.size();
+        if (pa_stream_begin_write(m_stream, &dest, &nbytes) < 0) {
+            qCWarning(qLcPulseAudioOut) << "pa_stream_begin_write error:"
+                                        << currentError(QPulseAudioEngine::instance()->context());
+            break;
+        }
+
+        nbytes = qMin(nbytes, size_t(region.size())) / frameSize * frameSize;
+        if (nbytes == 0) {
+            pa_stream_cancel_write(m_stream);
+            break;
+        }
+
+        applyVolume(region.data(), dest, nbytes);
+
+        if (pa_stream_write(m_stream, dest, nbytes, nullptr, 0, PA_SEEK_RELATIVE) < 0) {
+            qCWarning(qLcPulseAudioOut) << "pa_stream_write error:"
+                                        << currentError(QPulseAudioEngine::instance()->context());
+            break;
+        }
+
+        m_ringBuffer->releaseReadRegion(int(nbytes));
+        written += nbytes;
+        remaining -= nbytes;
+    }
+
+    m_totalTimeValue.fetch_add(qint64(written), std::memory_order_relaxed);
+    updateTelemetry();
+    return written;
+}
+
+void QPulseAudioSink::updateTelemetry()
+{
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(m_stream, &latency, &negative) == 0)
+        telemetry.setLatency(negative ? 0 : qint64(latency));
+
+    if (m_ringBuffer) {
+        telemetry.setBufferFill(m_ringBuffer->used(), m_ringBuffer->size());
+    } else {
+        const size_t writable = pa_stream_writable_size(m_stream);
+        if (writable != size_t(-1))
+            telemetry.setBufferFill(qMax(m_bufferSize - qsizetype(writable), qsizetype(0)),
+                                    m_bufferSize);
+    }
+}
+
 void QPulseAudioSink::stop()
 {
     if (auto notifier = m_stateMachine.stop()) {
@@ -28,8 +28,12 @@
 
 #include <private/qaudiosystem_p.h>
 #include <private/qaudiostatemachine_p.h>
+#include <private/qaudioringbuffer_p.h>
 #include <pulse/pulseaudio.h>
 
+#include <atomic>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QPulseAudioSink : public QPlatformAudioSink
@@ -61,6 +65,7 @@ public:
 
     void streamUnderflowCallback();
     void streamDrainedCallback();
+    void streamWriteCallback(size_t length);
 
 protected:
     void timerEvent(QTimerEvent *event) override;
@@ -72,6 +77,13 @@ private:
     bool open();
     void close();
     qint64 write(const char *data, qint64 len);
+    void applyVolume(const char *src, void *dest, qsizetype len);
+    void updateTelemetry(); // the mainloop must be locked
+
+    // Callback mode: the owner thread fills the ring buffer from the pull source, and
+    // the write callback of the stream writes it out on the PulseAudio mainloop thread
+    void fillRingBuffer();
+    size_t writeFromRingBuffer(size_t length); // the mainloop must be locked
 
 private Q_SLOTS:
     void userFeed();
@@ -97,11 +109,16 @@ private:
     pa_stream *m_stream = nullptr;
     std::vector<char> m_audioBuffer;
 
-    qint64 m_totalTimeValue = 0;
+    std::atomic<qint64> m_totalTimeValue = 0; // also written by the write callback
     qint64 m_elapsedTimeOffset = 0;
     mutable qint64 averageLatency = 0; // average latency
     mutable qint64 lastProcessedUSecs = 0;
-    qreal m_volume = 1.0;
+    std::atomic<qreal> m_volume = 1.0;
+    qreal m_appliedVolume = 1.0; // the volume the last written chunk ended with
+
+    std::unique_ptr<QtPrivate::QAudioRingBuffer<char>> m_ringBuffer;
+    std::atomic<bool> m_fillRequested = false;
+    std::atomic<bool> m_writeStarved = false; // the last write request wasn't fully served
 
     std::atomic<pa_operation *> m_drainOperation = nullptr;
     qsizetype m_bufferSize = 0;
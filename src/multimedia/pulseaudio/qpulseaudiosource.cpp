@@ -66,16 +66,18 @@ static void inputStreamStateCallback(pa_stream *stream, void *userdata)
 
 static void inputStreamUnderflowCallback(pa_stream *stream, void *userdata)
 {
-    Q_UNUSED(userdata);
     Q_UNUSED(stream);
     qWarning() << "Got a buffer underflow!";
+    if (userdata)
+        static_cast<QPulseAudioSource *>(userdata)->telemetry.addUnderrun();
 }
 
 static void inputStreamOverflowCallback(pa_stream *stream, void *userdata)
 {
     Q_UNUSED(stream);
-    Q_UNUSED(userdata);
     qWarning() << "Got a buffer overflow!";
+    if (userdata)
+        static_cast<QPulseAudioSource *>(userdata)->telemetry.addOverrun();
 }
 
 static void inputStreamSuccessCallback(pa_stream *stream, int success, void *userdata)
@@ -193,6 +195,8 @@ bool QPulseAudioSource::open()
     }
 
     m_spec = spec;
+    // The callbacks of the stream update the telemetry once it's connected
+    telemetry.reset();
 
     //if (Q_UNLIKELY(qLcPulseAudioIn().isEnabled(QtDebugMsg)) {
     //    QTime now(QTime::currentTime());
@@ -284,6 +288,8 @@ void QPulseAudioSource::close()
     if (!m_opened)
         return;
 
+    telemetry.log("QPulseAudioSource");
+
     m_timer.stop();
 
     QPulseAudioEngine *pulseEngine = QPulseAudioEngine::instance();
@@ -375,11 +381,16 @@ qint64 QPulseAudioSource::read(char *data, qint64 len)
             return 0;
         }
 
+        updateTelemetry();
+
         qint64 actualLength = 0;
         if (m_pullMode) {
             QByteArray adjusted(readLength, Qt::Uninitialized);
             applyVolume(audioBuffer, adjusted.data(), readLength);
-            actualLength = m_audioSource->write(adjusted);
+            {
+                QAudioTelemetry::UserCallbackScope scope(telemetry);
+                actualLength = m_audioSource->write(adjusted);
+            }
 
             if (actualLength < qint64(readLength)) {
                 pulseEngine->unlock();
@@ -500,10 +511,24 @@ void QPulseAudioSource::suspend()
     }
 }
 
+void QPulseAudioSource::updateTelemetry()
+{
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(m_stream, &latency, &negative) == 0)
+        telemetry.setLatency(negative ? 0 : qint64(latency));
+
+    const size_t readable = pa_stream_readable_size(m_stream);
+    if (readable != size_t(-1))
+        telemetry.setBufferFill(qsizetype(readable), m_bufferSize);
+}
+
 void QPulseAudioSource::timerEvent(QTimerEvent *event)
 {
-    if (event->timerId() == m_timer.timerId())
+    if (event->timerId() == m_timer.timerId()) {
+        telemetry.recordCallback(m_periodTime * qint64(1000));
         userFeed();
+    }
 
     QPlatformAudioSource::timerEvent(event);
 }
@@ -524,6 +549,7 @@ void QPulseAudioSource::userFeed()
     } else if (m_audioSource != nullptr) {
         // emits readyRead() so user will call read() on QIODevice to get some audio data
         PulseInputPrivate *a = qobject_cast<PulseInputPrivate*>(m_audioSource);
+        QAudioTelemetry::UserCallbackScope scope(telemetry);
         a->trigger();
     }
 }
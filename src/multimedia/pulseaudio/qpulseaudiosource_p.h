@@ -75,6 +75,7 @@ private slots:
 
 private:
     void applyVolume(const void *src, void *dest, int len);
+    void updateTelemetry(); // the mainloop must be locked
 
     bool open();
     void close();
@@ -48,6 +48,19 @@ public:
     virtual quint64 textureHandle(QRhi *, int /*plane*/) const { return 0; }
     virtual QMatrix4x4 externalTextureMatrix() const { return {}; }
 
+    struct DmaBufPlane
+    {
+        int fd = -1;
+        qsizetype offset = 0;
+        int stride = 0;
+    };
+
+    // Describes a plane of a buffer backed by a Linux dmabuf; the fd is -1 for other buffers.
+    // The descriptor stays owned by the buffer. If only plane 0 is valid, the remaining planes
+    // follow it in the same dmabuf with the layout QVideoFrame::map derives for single plane
+    // buffers.
+    virtual DmaBufPlane dmaBufPlane(int /*plane*/) const { return {}; }
+
 protected:
     QVideoFrame::HandleType m_type;
     QRhi *m_rhi = nullptr;
@@ -4,28 +4,12 @@
 #include "qvideoframeconversionhelper_p.h"
 #include "qrgb.h"
 
+#include <algorithm>
+#include <array>
 #include <mutex>
 
 QT_BEGIN_NAMESPACE
 
-#define CLAMP(n) (n > 255 ? 255 : (n < 0 ? 0 : n))
-
-#define EXPAND_UV(u, v) \
-    int uu = u - 128; \
-    int vv = v - 128; \
-    int rv = 409 * vv + 128; \
-    int guv = 100 * uu + 208 * vv + 128; \
-    int bu = 516 * uu + 128; \
-
-static inline quint32 qYUVToARGB32(int y, int rv, int guv, int bu, int a = 0xff)
-{
-    int yy = (y - 16) * 298;
-    return (a << 24)
-            | CLAMP((yy + rv) >> 8) << 16
-            | CLAMP((yy - guv) >> 8) << 8
-            | CLAMP((yy + bu) >> 8);
-}
-
 static inline void planarYUV420_to_ARGB32(const uchar *y, int yStride,
                                           const uchar *u, int uStride,
                                           const uchar *v, int vStride,
@@ -44,7 +28,7 @@ static inline void planarYUV420_to_ARGB32(const uchar *y, int yStride,
         quint32 *rgb0 = rgb;
         quint32 *rgb1 = rgb + width;
         for (int i = 0; i + 1 < width; i += 2) {
-            EXPAND_UV(*lineU, *lineV);
+            const auto [rv, guv, bu] = qExpandUV(*lineU, *lineV);
             lineU += uvPixelStride;
             lineV += uvPixelStride;
 
@@ -74,7 +58,7 @@ static inline void planarYUV422_to_ARGB32(const uchar *y, int yStride,
         const uchar *lineV = v;
 
         for (int i = 0; i + 1 < width; i += 2) {
-            EXPAND_UV(*lineU, *lineV);
+            const auto [rv, guv, bu] = qExpandUV(*lineU, *lineV);
             lineU += uvPixelStride;
             lineV += uvPixelStride;
 
@@ -139,7 +123,7 @@ static void QT_FASTCALL qt_convert_AYUV_to_ARGB32(const QVideoFrame &frame, ucha
             int u = *lineSrc++;
             int v = *lineSrc++;
 
-            EXPAND_UV(u, v);
+            const auto [rv, guv, bu] = qExpandUV(u, v);
 
             *rgb++ = qPremultiply(qYUVToARGB32(y, rv, guv, bu, a));
         }
@@ -164,7 +148,7 @@ static void QT_FASTCALL qt_convert_AYUV_Premultiplied_to_ARGB32(const QVideoFram
             int u = *lineSrc++;
             int v = *lineSrc++;
 
-            EXPAND_UV(u, v);
+            const auto [rv, guv, bu] = qExpandUV(u, v);
 
             *rgb++ = qYUVToARGB32(y, rv, guv, bu, a);
         }
@@ -188,7 +172,7 @@ static void QT_FASTCALL qt_convert_UYVY_to_ARGB32(const QVideoFrame &frame, ucha
             int v = *lineSrc++;
             int y1 = *lineSrc++;
 
-            EXPAND_UV(u, v);
+            const auto [rv, guv, bu] = qExpandUV(u, v);
 
             rgb[j] = qYUVToARGB32(y0, rv, guv, bu);
             rgb[j+1] = qYUVToARGB32(y1, rv, guv, bu);
@@ -214,7 +198,7 @@ static void QT_FASTCALL qt_convert_YUYV_to_ARGB32(const QVideoFrame &frame, ucha
             int y1 = *lineSrc++;
             int v = *lineSrc++;
 
-            EXPAND_UV(u, v);
+            const auto [rv, guv, bu] = qExpandUV(u, v);
 
             rgb[j] = qYUVToARGB32(y0, rv, guv, bu);
             rgb[j+1] = qYUVToARGB32(y1, rv, guv, bu);
@@ -389,7 +373,7 @@ static inline void planarYUV420_16bit_to_ARGB32(const uchar *y, int yStride,
         quint32 *rgb1 = rgb + width;
 
         for (int i = 0; i + 1 < width; i += 2) {
-            EXPAND_UV(*lineU, *lineV);
+            const auto [rv, guv, bu] = qExpandUV(*lineU, *lineV);
             lineU += uvPixelStride;
             lineV += uvPixelStride;
 
@@ -466,7 +450,8 @@ static void QT_FASTCALL qt_copy_pixels_with_mask(Pixel *dst, const Pixel *src, s
         dst[x] = src[x] | mask;
 }
 
-static VideoFrameConvertFunc qConvertFuncs[QVideoFrameFormat::NPixelFormats] = {
+// The scalar reference implementations
+static const VideoFrameConvertFunc qGenericConvertFuncs[QVideoFrameFormat::NPixelFormats] = {
     /* Format_Invalid */                nullptr, // Not needed
     /* Format_ARGB8888 */                 qt_convert_to_ARGB32<ARGB8888>,
     /* Format_ARGB8888_Premultiplied */   qt_convert_premultiplied_to_ARGB32<ARGB8888>,
@@ -498,73 +483,220 @@ static VideoFrameConvertFunc qConvertFuncs[QVideoFrameFormat::NPixelFormats] = {
     /* Format_Jpeg */                   nullptr, // Not needed
 };
 
+static VideoFrameConvertFunc qConvertFuncs[QVideoFrameFormat::NPixelFormats];
+
 static PixelsCopyFunc qPixelsCopyFunc = qt_copy_pixels_with_mask<uint32_t>;
 
 static std::once_flag InitFuncsAsmFlag;
 
+using ConvertFuncs = std::array<VideoFrameConvertFunc, QVideoFrameFormat::NPixelFormats>;
+
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+extern void QT_FASTCALL qt_convert_ARGB8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_ABGR8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_RGBA8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_BGRA8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_copy_pixels_with_mask_sse2(uint32_t * dst, const uint32_t *src, size_t size, uint32_t mask);
+extern void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YV12_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_UYVY_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUYV_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV12_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV21_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC1_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC2_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC3_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC4_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_P016_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
+
+// The SSE2 converters; nullptr for the formats without one
+static const ConvertFuncs &qConvertFuncsSse2()
+{
+    static const ConvertFuncs funcs = [] {
+        ConvertFuncs funcs{};
+        funcs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_sse2;
+
+        funcs[QVideoFrameFormat::Format_YUV420P] = qt_convert_YUV420P_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_YUV422P] = qt_convert_YUV422P_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_YV12] = qt_convert_YV12_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_UYVY] = qt_convert_UYVY_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_YUYV] = qt_convert_YUYV_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_NV12] = qt_convert_NV12_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_NV21] = qt_convert_NV21_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_IMC1] = qt_convert_IMC1_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_IMC2] = qt_convert_IMC2_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_IMC3] = qt_convert_IMC3_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_IMC4] = qt_convert_IMC4_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_P010] = qt_convert_P016_to_ARGB32_sse2;
+        funcs[QVideoFrameFormat::Format_P016] = qt_convert_P016_to_ARGB32_sse2;
+        return funcs;
+    }();
+
+    return funcs;
+}
+#endif
+#ifdef QT_COMPILER_SUPPORTS_SSSE3
+extern void QT_FASTCALL qt_convert_ARGB8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_ABGR8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_RGBA8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_BGRA8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
+
+// The SSSE3 converters; nullptr for the formats without one
+static const ConvertFuncs &qConvertFuncsSsse3()
+{
+    static const ConvertFuncs funcs = [] {
+        ConvertFuncs funcs{};
+        funcs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_ssse3;
+        funcs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_ssse3;
+        return funcs;
+    }();
+
+    return funcs;
+}
+#endif
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+extern void QT_FASTCALL qt_convert_ARGB8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_ABGR8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_RGBA8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_BGRA8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_copy_pixels_with_mask_avx2(uint32_t * dst, const uint32_t *src, size_t size, uint32_t mask);
+extern void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YV12_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_UYVY_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUYV_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV12_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV21_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC1_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC2_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC3_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC4_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_P016_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
+
+// The AVX2 converters; nullptr for the formats without one
+static const ConvertFuncs &qConvertFuncsAvx2()
+{
+    static const ConvertFuncs funcs = [] {
+        ConvertFuncs funcs{};
+        funcs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_avx2;
+
+        funcs[QVideoFrameFormat::Format_YUV420P] = qt_convert_YUV420P_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_YUV422P] = qt_convert_YUV422P_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_YV12] = qt_convert_YV12_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_UYVY] = qt_convert_UYVY_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_YUYV] = qt_convert_YUYV_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_NV12] = qt_convert_NV12_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_NV21] = qt_convert_NV21_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_IMC1] = qt_convert_IMC1_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_IMC2] = qt_convert_IMC2_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_IMC3] = qt_convert_IMC3_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_IMC4] = qt_convert_IMC4_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_P010] = qt_convert_P016_to_ARGB32_avx2;
+        funcs[QVideoFrameFormat::Format_P016] = qt_convert_P016_to_ARGB32_avx2;
+        return funcs;
+    }();
+
+    return funcs;
+}
+#endif
+#if defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+extern void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YV12_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_UYVY_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_YUYV_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV12_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_NV21_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC1_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC2_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC3_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_IMC4_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+extern void QT_FASTCALL qt_convert_P016_to_ARGB32_neon(const QVideoFrame &frame, uchar *output);
+
+// The NEON converters; nullptr for the formats without one
+static const ConvertFuncs &qConvertFuncsNeon()
+{
+    static const ConvertFuncs funcs = [] {
+        ConvertFuncs funcs{};
+        funcs[QVideoFrameFormat::Format_YUV420P] = qt_convert_YUV420P_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_YUV422P] = qt_convert_YUV422P_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_YV12] = qt_convert_YV12_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_UYVY] = qt_convert_UYVY_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_YUYV] = qt_convert_YUYV_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_NV12] = qt_convert_NV12_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_NV21] = qt_convert_NV21_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_IMC1] = qt_convert_IMC1_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_IMC2] = qt_convert_IMC2_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_IMC3] = qt_convert_IMC3_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_IMC4] = qt_convert_IMC4_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_P010] = qt_convert_P016_to_ARGB32_neon;
+        funcs[QVideoFrameFormat::Format_P016] = qt_convert_P016_to_ARGB32_neon;
+        return funcs;
+    }();
+
+    return funcs;
+}
+#endif
+
+static void qOverrideConvertFuncs(const ConvertFuncs &funcs)
+{
+    for (size_t i = 0; i < funcs.size(); ++i) {
+        if (funcs[i])
+            qConvertFuncs[i] = funcs[i];
+    }
+}
+
 static void qInitFuncsAsm()
 {
-#ifdef QT_COMPILER_SUPPORTS_SSE2
-    extern void QT_FASTCALL  qt_convert_ARGB8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_ABGR8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_RGBA8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_BGRA8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_copy_pixels_with_mask_sse2(uint32_t * dst, const uint32_t *src, size_t size, uint32_t mask);
-
-    if (qCpuHasFeature(SSE2)){
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_sse2;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_sse2;
+    std::copy(std::begin(qGenericConvertFuncs), std::end(qGenericConvertFuncs), qConvertFuncs);
 
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+    if (qCpuHasFeature(SSE2)) {
+        qOverrideConvertFuncs(qConvertFuncsSse2());
         qPixelsCopyFunc = qt_copy_pixels_with_mask_sse2;
     }
 #endif
 #ifdef QT_COMPILER_SUPPORTS_SSSE3
-    extern void QT_FASTCALL  qt_convert_ARGB8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_ABGR8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_RGBA8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_BGRA8888_to_ARGB32_ssse3(const QVideoFrame &frame, uchar *output);
-    if (qCpuHasFeature(SSSE3)){
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_ssse3;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_ssse3;
-    }
+    if (qCpuHasFeature(SSSE3))
+        qOverrideConvertFuncs(qConvertFuncsSsse3());
 #endif
 #ifdef QT_COMPILER_SUPPORTS_AVX2
-    extern void QT_FASTCALL  qt_convert_ARGB8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_ABGR8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_RGBA8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_convert_BGRA8888_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output);
-    extern void QT_FASTCALL  qt_copy_pixels_with_mask_avx2(uint32_t * dst, const uint32_t *src, size_t size, uint32_t mask);
-    if (qCpuHasFeature(AVX2)){
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888] = qt_convert_ARGB8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_ARGB8888_Premultiplied] = qt_convert_ARGB8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_XRGB8888] = qt_convert_ARGB8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888] = qt_convert_BGRA8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRA8888_Premultiplied] = qt_convert_BGRA8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_BGRX8888] = qt_convert_BGRA8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_ABGR8888] = qt_convert_ABGR8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_XBGR8888] = qt_convert_ABGR8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBA8888] = qt_convert_RGBA8888_to_ARGB32_avx2;
-        qConvertFuncs[QVideoFrameFormat::Format_RGBX8888] = qt_convert_RGBA8888_to_ARGB32_avx2;
-
+    if (qCpuHasFeature(AVX2)) {
+        qOverrideConvertFuncs(qConvertFuncsAvx2());
         qPixelsCopyFunc = qt_copy_pixels_with_mask_avx2;
     }
 #endif
+#if defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (qCpuHasFeature(NEON))
+        qOverrideConvertFuncs(qConvertFuncsNeon());
+#endif
 }
 
 VideoFrameConvertFunc qConverterForFormat(QVideoFrameFormat::PixelFormat format)
@@ -575,6 +707,44 @@ VideoFrameConvertFunc qConverterForFormat(QVideoFrameFormat::PixelFormat format)
     return convert;
 }
 
+VideoFrameConvertFunc qGenericConverterForFormat(QVideoFrameFormat::PixelFormat format)
+{
+    return qGenericConvertFuncs[format];
+}
+
+VideoFrameConvertFunc qSimdConverterForFormat(QVideoFrameFormat::PixelFormat format,
+                                              VideoFrameConverterIsa isa)
+{
+    switch (isa) {
+    case VideoFrameConverterIsa::Sse2:
+#ifdef QT_COMPILER_SUPPORTS_SSE2
+        if (qCpuHasFeature(SSE2))
+            return qConvertFuncsSse2()[format];
+#endif
+        break;
+    case VideoFrameConverterIsa::Ssse3:
+#ifdef QT_COMPILER_SUPPORTS_SSSE3
+        if (qCpuHasFeature(SSSE3))
+            return qConvertFuncsSsse3()[format];
+#endif
+        break;
+    case VideoFrameConverterIsa::Avx2:
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+        if (qCpuHasFeature(AVX2))
+            return qConvertFuncsAvx2()[format];
+#endif
+        break;
+    case VideoFrameConverterIsa::Neon:
+#if defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        if (qCpuHasFeature(NEON))
+            return qConvertFuncsNeon()[format];
+#endif
+        break;
+    }
+
+    return nullptr;
+}
+
 void Q_MULTIMEDIA_EXPORT qCopyPixelsWithAlphaMask(uint32_t *dst,
                                                   const uint32_t *src,
                                                   size_t pixCount,
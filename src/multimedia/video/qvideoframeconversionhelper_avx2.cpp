@@ -70,6 +70,134 @@ void convert_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
     }
 }
 
+inline __m256i int16Pairs(short low, short high)
+{
+    return _mm256_set1_epi32(int(quint32(quint16(high)) << 16 | quint16(low)));
+}
+
+// Loads the luma of the pixels [x, x + 16) as 16 x int16
+template<bool Y16>
+inline __m256i loadLuma(const uchar *y, int x)
+{
+    if (Y16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y - 1 + x * 2));
+        return _mm256_srli_epi16(data, 8);
+    }
+
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+}
+
+// Loads the chroma of the pixels [x, x + 16) as 8 x (u - 128, v - 128) int16 pairs,
+// the pairs of the pixels [x, x + 8) in the low lane.
+template<YUVChromaLayout Layout>
+inline __m256i loadChroma(const uchar *u, const uchar *v, int x)
+{
+    __m256i uv;
+
+    switch (Layout) {
+    case YUVChromaLayout::Planar: {
+        const __m128i uData = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2));
+        const __m128i vData = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2));
+        uv = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(uData, vData));
+        break;
+    }
+    case YUVChromaLayout::InterleavedUV:
+        uv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x)));
+        break;
+    case YUVChromaLayout::InterleavedVU:
+        uv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x)));
+        uv = _mm256_shufflelo_epi16(_mm256_shufflehi_epi16(uv, _MM_SHUFFLE(2, 3, 0, 1)),
+                                    _MM_SHUFFLE(2, 3, 0, 1));
+        break;
+    case YUVChromaLayout::Interleaved16:
+        uv = _mm256_srli_epi16(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(u - 1 + x * 2)), 8);
+        break;
+    }
+
+    return _mm256_sub_epi16(uv, _mm256_set1_epi16(128));
+}
+
+// Converts 16 pixels to ARGB32, bit-exact with qYUVToARGB32. Each 128-bit lane holds
+// 8 pixels: the luma as 8 x int16, the chroma as 4 x (u - 128, v - 128) int16 pairs.
+inline void yuvToARGB32_avx2(__m256i y, __m256i uv, quint32 *rgb)
+{
+    const __m256i rounding = _mm256_set1_epi32(128);
+
+    // (y - 16) * 298 as y * 298 + 1 * (-16 * 298)
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i yCoeffs = int16Pairs(298, -16 * 298);
+    const __m256i yy0 = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, one), yCoeffs);
+    const __m256i yy1 = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, one), yCoeffs);
+
+    const __m256i rv = _mm256_add_epi32(_mm256_madd_epi16(uv, int16Pairs(0, 409)), rounding);
+    const __m256i guv = _mm256_add_epi32(_mm256_madd_epi16(uv, int16Pairs(100, 208)), rounding);
+    const __m256i bu = _mm256_add_epi32(_mm256_madd_epi16(uv, int16Pairs(516, 0)), rounding);
+
+    // each chroma sample covers two neighbouring pixels
+    const __m256i r = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_add_epi32(yy0, _mm256_unpacklo_epi32(rv, rv)), 8),
+            _mm256_srai_epi32(_mm256_add_epi32(yy1, _mm256_unpackhi_epi32(rv, rv)), 8));
+    const __m256i g = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_sub_epi32(yy0, _mm256_unpacklo_epi32(guv, guv)), 8),
+            _mm256_srai_epi32(_mm256_sub_epi32(yy1, _mm256_unpackhi_epi32(guv, guv)), 8));
+    const __m256i b = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_add_epi32(yy0, _mm256_unpacklo_epi32(bu, bu)), 8),
+            _mm256_srai_epi32(_mm256_add_epi32(yy1, _mm256_unpackhi_epi32(bu, bu)), 8));
+
+    // packus clamps to [0, 255] like qClampToByte
+    const __m256i bg = _mm256_unpacklo_epi8(_mm256_packus_epi16(b, b), _mm256_packus_epi16(g, g));
+    const __m256i ra = _mm256_unpacklo_epi8(_mm256_packus_epi16(r, r), _mm256_set1_epi8(char(0xff)));
+
+    // lo holds the pixels 0-3 and 8-11, hi the pixels 4-7 and 12-15
+    const __m256i lo = _mm256_unpacklo_epi16(bg, ra);
+    const __m256i hi = _mm256_unpackhi_epi16(bg, ra);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(rgb), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(rgb + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+template<bool Y16, YUVChromaLayout Layout>
+void QT_FASTCALL convert_YUV_row_to_ARGB32_avx2(const uchar *y, const uchar *u, const uchar *v,
+                                                quint32 *rgb, int width)
+{
+    int x = 0;
+    for (; x < width - 15; x += 16)
+        yuvToARGB32_avx2(loadLuma<Y16>(y, x), loadChroma<Layout>(u, v, x), rgb + x);
+
+    // leftovers
+    qYUVRowToARGB32(y, Y16 ? 2 : 1, u, v, chromaPixelStride(Layout), rgb, x, width);
+}
+
+template<bool YFirst>
+void QT_FASTCALL convert_packed_YUV422_row_to_ARGB32_avx2(const uchar *src, quint32 *rgb,
+                                                          int width)
+{
+    const __m256i lowBytes = _mm256_set1_epi16(0xff);
+    const __m256i chromaOffset = _mm256_set1_epi16(128);
+
+    int x = 0;
+    for (; x < width - 15; x += 16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x * 2));
+        const __m256i low = _mm256_and_si256(data, lowBytes);
+        const __m256i high = _mm256_srli_epi16(data, 8);
+        yuvToARGB32_avx2(YFirst ? low : high,
+                         _mm256_sub_epi16(YFirst ? high : low, chromaOffset), rgb + x);
+    }
+
+    // leftovers
+    qPackedYUV422RowToARGB32<YFirst>(src, rgb, x, width);
+}
+
+struct YUVKernels_avx2
+{
+    static constexpr auto planarRow = convert_YUV_row_to_ARGB32_avx2<false, YUVChromaLayout::Planar>;
+    static constexpr auto nv12Row = convert_YUV_row_to_ARGB32_avx2<false, YUVChromaLayout::InterleavedUV>;
+    static constexpr auto nv21Row = convert_YUV_row_to_ARGB32_avx2<false, YUVChromaLayout::InterleavedVU>;
+    static constexpr auto p016Row = convert_YUV_row_to_ARGB32_avx2<true, YUVChromaLayout::Interleaved16>;
+    static constexpr auto uyvyRow = convert_packed_YUV422_row_to_ARGB32_avx2<false>;
+    static constexpr auto yuyvRow = convert_packed_YUV422_row_to_ARGB32_avx2<true>;
+};
+
 }
 
 
@@ -93,6 +221,66 @@ void QT_FASTCALL qt_convert_BGRA8888_to_ARGB32_avx2(const QVideoFrame &frame, uc
     convert_to_ARGB32_avx2<3, 2, 1, 0>(frame, output);
 }
 
+void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV420P_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV422P_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YV12_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YV12_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_UYVY_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_UYVY_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUYV_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUYV_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV12_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV12_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV21_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV21_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC1_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC1_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC2_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC2_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC3_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC3_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC4_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC4_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_P016_to_ARGB32_avx2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_P016_to_ARGB32_simd<YUVKernels_avx2>(frame, output);
+}
+
 void QT_FASTCALL qt_copy_pixels_with_mask_avx2(uint32_t *dst, const uint32_t *src, size_t size, uint32_t mask)
 {
     const auto mask256 = _mm256_set_epi32(mask, mask, mask, mask, mask, mask, mask, mask);
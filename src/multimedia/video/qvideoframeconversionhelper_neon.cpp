@@ -0,0 +1,203 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qvideoframeconversionhelper_p.h"
+
+#if defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+
+QT_BEGIN_NAMESPACE
+
+namespace  {
+
+// Loads the luma of the pixels [x, x + 16)
+template<bool Y16>
+inline uint8x16_t loadLuma(const uchar *y, int x)
+{
+    if (Y16)
+        return vld2q_u8(y - 1 + x * 2).val[1];
+
+    return vld1q_u8(y + x);
+}
+
+// Loads the chroma of the pixels [x, x + 16) as 8 u and 8 v samples
+template<YUVChromaLayout Layout>
+inline uint8x8x2_t loadChroma(const uchar *u, const uchar *v, int x)
+{
+    uint8x8x2_t uv;
+
+    switch (Layout) {
+    case YUVChromaLayout::Planar:
+        uv.val[0] = vld1_u8(u + x / 2);
+        uv.val[1] = vld1_u8(v + x / 2);
+        break;
+    case YUVChromaLayout::InterleavedUV:
+        uv = vld2_u8(u + x);
+        break;
+    case YUVChromaLayout::InterleavedVU: {
+        const uint8x8x2_t vu = vld2_u8(v + x);
+        uv.val[0] = vu.val[1];
+        uv.val[1] = vu.val[0];
+        break;
+    }
+    case YUVChromaLayout::Interleaved16: {
+        const uint8x8x4_t data = vld4_u8(u - 1 + x * 2);
+        uv.val[0] = data.val[1];
+        uv.val[1] = data.val[3];
+        break;
+    }
+    }
+
+    return uv;
+}
+
+inline uint8x8_t packChannel(int32x4_t yy0, int32x4_t yy1, int32x4x2_t c, bool subtract)
+{
+    const int32x4_t c0 = subtract ? vsubq_s32(yy0, c.val[0]) : vaddq_s32(yy0, c.val[0]);
+    const int32x4_t c1 = subtract ? vsubq_s32(yy1, c.val[1]) : vaddq_s32(yy1, c.val[1]);
+
+    // saturating narrowing clamps to [0, 255] like qClampToByte
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(c0, 8)),
+                                    vqmovn_s32(vshrq_n_s32(c1, 8))));
+}
+
+// Converts 8 pixels; y holds (y - 16), rv, guv and bu the chroma terms of the 4 pixel pairs
+inline void yuvToARGB32Half_neon(int16x8_t y, int32x4_t rv, int32x4_t guv, int32x4_t bu,
+                                 quint32 *rgb)
+{
+    const int32x4_t yy0 = vmull_n_s16(vget_low_s16(y), 298);
+    const int32x4_t yy1 = vmull_n_s16(vget_high_s16(y), 298);
+
+    // each chroma sample covers two neighbouring pixels
+    uint8x8x4_t bgra;
+    bgra.val[0] = packChannel(yy0, yy1, vzipq_s32(bu, bu), false);
+    bgra.val[1] = packChannel(yy0, yy1, vzipq_s32(guv, guv), true);
+    bgra.val[2] = packChannel(yy0, yy1, vzipq_s32(rv, rv), false);
+    bgra.val[3] = vdup_n_u8(0xff);
+    vst4_u8(reinterpret_cast<uint8_t *>(rgb), bgra);
+}
+
+// Converts 16 pixels to ARGB32, bit-exact with qYUVToARGB32
+inline void yuvToARGB32_neon(uint8x16_t y, uint8x8x2_t uv, quint32 *rgb)
+{
+    const int16x8_t uu = vreinterpretq_s16_u16(vsubl_u8(uv.val[0], vdup_n_u8(128)));
+    const int16x8_t vv = vreinterpretq_s16_u16(vsubl_u8(uv.val[1], vdup_n_u8(128)));
+    const int16x8_t y0 = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(y), vdup_n_u8(16)));
+    const int16x8_t y1 = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(y), vdup_n_u8(16)));
+    const int32x4_t rounding = vdupq_n_s32(128);
+
+    const int32x4_t rv0 = vmlal_n_s16(rounding, vget_low_s16(vv), 409);
+    const int32x4_t rv1 = vmlal_n_s16(rounding, vget_high_s16(vv), 409);
+    const int32x4_t guv0 =
+            vmlal_n_s16(vmlal_n_s16(rounding, vget_low_s16(uu), 100), vget_low_s16(vv), 208);
+    const int32x4_t guv1 =
+            vmlal_n_s16(vmlal_n_s16(rounding, vget_high_s16(uu), 100), vget_high_s16(vv), 208);
+    const int32x4_t bu0 = vmlal_n_s16(rounding, vget_low_s16(uu), 516);
+    const int32x4_t bu1 = vmlal_n_s16(rounding, vget_high_s16(uu), 516);
+
+    yuvToARGB32Half_neon(y0, rv0, guv0, bu0, rgb);
+    yuvToARGB32Half_neon(y1, rv1, guv1, bu1, rgb + 8);
+}
+
+template<bool Y16, YUVChromaLayout Layout>
+void QT_FASTCALL convert_YUV_row_to_ARGB32_neon(const uchar *y, const uchar *u, const uchar *v,
+                                                quint32 *rgb, int width)
+{
+    int x = 0;
+    for (; x < width - 15; x += 16)
+        yuvToARGB32_neon(loadLuma<Y16>(y, x), loadChroma<Layout>(u, v, x), rgb + x);
+
+    // leftovers
+    qYUVRowToARGB32(y, Y16 ? 2 : 1, u, v, chromaPixelStride(Layout), rgb, x, width);
+}
+
+template<bool YFirst>
+void QT_FASTCALL convert_packed_YUV422_row_to_ARGB32_neon(const uchar *src, quint32 *rgb,
+                                                          int width)
+{
+    int x = 0;
+    for (; x < width - 15; x += 16) {
+        const uint8x16x2_t data = vld2q_u8(src + x * 2);
+        const uint8x16_t chroma = YFirst ? data.val[1] : data.val[0];
+        yuvToARGB32_neon(YFirst ? data.val[0] : data.val[1],
+                         vuzp_u8(vget_low_u8(chroma), vget_high_u8(chroma)), rgb + x);
+    }
+
+    // leftovers
+    qPackedYUV422RowToARGB32<YFirst>(src, rgb, x, width);
+}
+
+struct YUVKernels_neon
+{
+    static constexpr auto planarRow = convert_YUV_row_to_ARGB32_neon<false, YUVChromaLayout::Planar>;
+    static constexpr auto nv12Row = convert_YUV_row_to_ARGB32_neon<false, YUVChromaLayout::InterleavedUV>;
+    static constexpr auto nv21Row = convert_YUV_row_to_ARGB32_neon<false, YUVChromaLayout::InterleavedVU>;
+    static constexpr auto p016Row = convert_YUV_row_to_ARGB32_neon<true, YUVChromaLayout::Interleaved16>;
+    static constexpr auto uyvyRow = convert_packed_YUV422_row_to_ARGB32_neon<false>;
+    static constexpr auto yuyvRow = convert_packed_YUV422_row_to_ARGB32_neon<true>;
+};
+
+}
+
+void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV420P_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV422P_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YV12_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YV12_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_UYVY_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_UYVY_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUYV_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUYV_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV12_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV12_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV21_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV21_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC1_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC1_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC2_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC2_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC3_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC3_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC4_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC4_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_P016_to_ARGB32_neon(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_P016_to_ARGB32_simd<YUVKernels_neon>(frame, output);
+}
+
+QT_END_NAMESPACE
+
+#endif
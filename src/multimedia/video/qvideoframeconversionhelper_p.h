@@ -24,7 +24,19 @@ QT_BEGIN_NAMESPACE
 typedef void (QT_FASTCALL *VideoFrameConvertFunc)(const QVideoFrame &frame, uchar *output);
 typedef void(QT_FASTCALL *PixelsCopyFunc)(uint32_t *dst, const uint32_t *src, size_t size, uint32_t mask);
 
-VideoFrameConvertFunc qConverterForFormat(QVideoFrameFormat::PixelFormat format);
+Q_MULTIMEDIA_EXPORT VideoFrameConvertFunc qConverterForFormat(QVideoFrameFormat::PixelFormat format);
+
+// Returns the scalar converter, the reference for the SIMD converters
+Q_MULTIMEDIA_EXPORT VideoFrameConvertFunc
+qGenericConverterForFormat(QVideoFrameFormat::PixelFormat format);
+
+enum class VideoFrameConverterIsa { Sse2, Ssse3, Avx2, Neon };
+
+// Returns the converter of the instruction set, or nullptr if the instruction set has none
+// for the format, is not compiled in, or is not supported by the CPU. Unlike
+// qConverterForFormat(), doesn't fall back to the other instruction sets.
+Q_MULTIMEDIA_EXPORT VideoFrameConvertFunc
+qSimdConverterForFormat(QVideoFrameFormat::PixelFormat format, VideoFrameConverterIsa isa);
 
 void Q_MULTIMEDIA_EXPORT qCopyPixelsWithAlphaMask(uint32_t *dst,
                                                   const uint32_t *src,
@@ -93,6 +105,114 @@ struct YPixel
 };
 
 
+inline int qClampToByte(int n)
+{
+    return n > 255 ? 255 : (n < 0 ? 0 : n);
+}
+
+// The chroma terms of the BT.601 conversion
+struct YUVChromaTerms
+{
+    int rv;
+    int guv;
+    int bu;
+};
+
+inline YUVChromaTerms qExpandUV(int u, int v)
+{
+    const int uu = u - 128;
+    const int vv = v - 128;
+    return { 409 * vv + 128, 100 * uu + 208 * vv + 128, 516 * uu + 128 };
+}
+
+inline quint32 qYUVToARGB32(int y, int rv, int guv, int bu, int a = 0xff)
+{
+    int yy = (y - 16) * 298;
+    return (a << 24)
+            | qClampToByte((yy + rv) >> 8) << 16
+            | qClampToByte((yy - guv) >> 8) << 8
+            | qClampToByte((yy + bu) >> 8);
+}
+
+// Scalar conversion of the pixel pairs [from, width) of a row with horizontally
+// subsampled chroma. The SIMD row kernels use it for their leftovers.
+inline void qYUVRowToARGB32(const uchar *y, int yPixelStride,
+                            const uchar *u, const uchar *v, int uvPixelStride,
+                            quint32 *rgb, int from, int width)
+{
+    for (int i = from; i + 1 < width; i += 2) {
+        const int c = (i >> 1) * uvPixelStride;
+        const auto [rv, guv, bu] = qExpandUV(u[c], v[c]);
+
+        rgb[i] = qYUVToARGB32(y[i * yPixelStride], rv, guv, bu);
+        rgb[i + 1] = qYUVToARGB32(y[(i + 1) * yPixelStride], rv, guv, bu);
+    }
+}
+
+// Chroma layouts handled by the SIMD row kernels
+enum class YUVChromaLayout {
+    Planar,        // separate U and V planes
+    InterleavedUV, // NV12: v == u + 1
+    InterleavedVU, // NV21: u == v + 1
+    Interleaved16, // P010/P016: 16-bit samples, u and v point to the most significant bytes
+};
+
+constexpr int chromaPixelStride(YUVChromaLayout layout)
+{
+    switch (layout) {
+    case YUVChromaLayout::Planar:
+        return 1;
+    case YUVChromaLayout::InterleavedUV:
+    case YUVChromaLayout::InterleavedVU:
+        return 2;
+    case YUVChromaLayout::Interleaved16:
+        return 4;
+    }
+    return 1;
+}
+
+// Scalar conversion of the pixel pairs [from, width) of a packed 4:2:2 row (UYVY or YUYV)
+template<bool YFirst>
+inline void qPackedYUV422RowToARGB32(const uchar *src, quint32 *rgb, int from, int width)
+{
+    for (int i = from; i + 1 < width; i += 2) {
+        const uchar *p = src + i * 2;
+        const int y0 = YFirst ? p[0] : p[1];
+        const int u = YFirst ? p[1] : p[0];
+        const int y1 = YFirst ? p[2] : p[3];
+        const int v = YFirst ? p[3] : p[2];
+
+        const auto [rv, guv, bu] = qExpandUV(u, v);
+
+        rgb[i] = qYUVToARGB32(y0, rv, guv, bu);
+        rgb[i + 1] = qYUVToARGB32(y1, rv, guv, bu);
+    }
+}
+
+// Runs a row kernel over a frame with 4:2:0 (VerticalSubsampling == 2) or
+// 4:2:2 (VerticalSubsampling == 1) chroma.
+template<int VerticalSubsampling, typename RowFunc>
+inline void qPlanarYUVToARGB32(RowFunc convertRow,
+                               const uchar *y, int yStride,
+                               const uchar *u, int uStride,
+                               const uchar *v, int vStride,
+                               quint32 *rgb, int width, int height)
+{
+    if (VerticalSubsampling == 2)
+        height &= ~1;
+
+    for (int j = 0; j < height; ++j) {
+        convertRow(y, u, v, rgb, width);
+
+        y += yStride;
+        rgb += width;
+        if (j % VerticalSubsampling == VerticalSubsampling - 1) {
+            u += uStride;
+            v += vStride;
+        }
+    }
+}
+
 using ARGB8888 = ArgbPixel<0, 1, 2, 3>;
 using ABGR8888 = ArgbPixel<0, 3, 2, 1>;
 using RGBA8888 = ArgbPixel<3, 0, 1, 2>;
@@ -136,6 +256,154 @@ using BGRX8888 = RgbPixel<2, 1, 0>;
 #define QT_MEDIA_ALIGN(boundary, ptr, x, length) \
     for (; ((reinterpret_cast<qintptr>(ptr) & (boundary - 1)) != 0) && x < length; ++x)
 
+// Frame-level drivers for the SIMD YUV converters. Kernels provides the row functions
+// planarRow, nv12Row, nv21Row and p016Row with the signature
+//     void (const uchar *y, const uchar *u, const uchar *v, quint32 *rgb, int width)
+// and uyvyRow and yuyvRow with the signature
+//     void (const uchar *src, quint32 *rgb, int width).
+// The pointers passed to the row functions are the same as in the scalar converters.
+
+template<typename Kernels>
+void qt_convert_YUV420P_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_TRIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane2, plane2Stride,
+                          plane3, plane3Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_YUV422P_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_TRIPLANAR(frame)
+    qPlanarYUVToARGB32<1>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane2, plane2Stride,
+                          plane3, plane3Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_YV12_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_TRIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane3, plane3Stride,
+                          plane2, plane2Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_IMC1_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_TRIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane3, plane3Stride,
+                          plane2, plane2Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_IMC2_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_BIPLANAR(frame)
+    Q_UNUSED(plane2Stride);
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane2 + (plane1Stride >> 1), plane1Stride,
+                          plane2, plane1Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_IMC3_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_TRIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane2, plane2Stride,
+                          plane3, plane3Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_IMC4_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_BIPLANAR(frame)
+    Q_UNUSED(plane2Stride);
+    qPlanarYUVToARGB32<2>(Kernels::planarRow,
+                          plane1, plane1Stride,
+                          plane2, plane1Stride,
+                          plane2 + (plane1Stride >> 1), plane1Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_NV12_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_BIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::nv12Row,
+                          plane1, plane1Stride,
+                          plane2, plane2Stride,
+                          plane2 + 1, plane2Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_NV21_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_BIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::nv21Row,
+                          plane1, plane1Stride,
+                          plane2 + 1, plane2Stride,
+                          plane2, plane2Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename Kernels>
+void qt_convert_P016_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    FETCH_INFO_BIPLANAR(frame)
+    qPlanarYUVToARGB32<2>(Kernels::p016Row,
+                          plane1 + 1, plane1Stride,
+                          plane2 + 1, plane2Stride,
+                          plane2 + 3, plane2Stride,
+                          reinterpret_cast<quint32 *>(output), width, height);
+}
+
+template<typename RowFunc>
+inline void qPackedYUV422ToARGB32(RowFunc convertRow, const QVideoFrame &frame,
+                                  uchar *output)
+{
+    FETCH_INFO_PACKED(frame)
+    MERGE_LOOPS(width, height, stride, 2)
+
+    quint32 *rgb = reinterpret_cast<quint32 *>(output);
+
+    for (int i = 0; i < height; ++i) {
+        convertRow(src, rgb, width);
+
+        src += stride;
+        rgb += width;
+    }
+}
+
+template<typename Kernels>
+void qt_convert_UYVY_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    qPackedYUV422ToARGB32(Kernels::uyvyRow, frame, output);
+}
+
+template<typename Kernels>
+void qt_convert_YUYV_to_ARGB32_simd(const QVideoFrame &frame, uchar *output)
+{
+    qPackedYUV422ToARGB32(Kernels::yuyvRow, frame, output);
+}
+
 QT_END_NAMESPACE
 
 #endif // QVIDEOFRAMECONVERSIONHELPER_P_H
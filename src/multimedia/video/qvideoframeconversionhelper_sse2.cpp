@@ -3,6 +3,8 @@
 
 #include "qvideoframeconversionhelper_p.h"
 
+#include <QtCore/qendian.h>
+
 #ifdef QT_COMPILER_SUPPORTS_SSE2
 
 QT_BEGIN_NAMESPACE
@@ -58,6 +60,131 @@ void convert_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
     }
 }
 
+inline __m128i int16Pairs(short low, short high)
+{
+    return _mm_set1_epi32(int(quint32(quint16(high)) << 16 | quint16(low)));
+}
+
+// Loads the luma of the pixels [x, x + 8) as 8 x int16
+template<bool Y16>
+inline __m128i loadLuma(const uchar *y, int x)
+{
+    if (Y16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y - 1 + x * 2));
+        return _mm_srli_epi16(data, 8);
+    }
+
+    const __m128i data = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x));
+    return _mm_unpacklo_epi8(data, _mm_setzero_si128());
+}
+
+// Loads the chroma of the pixels [x, x + 8) as 4 x (u - 128, v - 128) int16 pairs
+template<YUVChromaLayout Layout>
+inline __m128i loadChroma(const uchar *u, const uchar *v, int x)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i uv;
+
+    switch (Layout) {
+    case YUVChromaLayout::Planar: {
+        const __m128i uData = _mm_cvtsi32_si128(qFromUnaligned<int>(u + x / 2));
+        const __m128i vData = _mm_cvtsi32_si128(qFromUnaligned<int>(v + x / 2));
+        uv = _mm_unpacklo_epi8(_mm_unpacklo_epi8(uData, vData), zero);
+        break;
+    }
+    case YUVChromaLayout::InterleavedUV:
+        uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x)), zero);
+        break;
+    case YUVChromaLayout::InterleavedVU:
+        uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x)), zero);
+        uv = _mm_shufflelo_epi16(_mm_shufflehi_epi16(uv, _MM_SHUFFLE(2, 3, 0, 1)),
+                                 _MM_SHUFFLE(2, 3, 0, 1));
+        break;
+    case YUVChromaLayout::Interleaved16:
+        uv = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u - 1 + x * 2)), 8);
+        break;
+    }
+
+    return _mm_sub_epi16(uv, _mm_set1_epi16(128));
+}
+
+// Converts 8 pixels to ARGB32, bit-exact with qYUVToARGB32. The luma is given as
+// 8 x int16, the chroma of the 4 pixel pairs as (u - 128, v - 128) int16 pairs.
+inline void yuvToARGB32_sse2(__m128i y, __m128i uv, quint32 *rgb)
+{
+    const __m128i rounding = _mm_set1_epi32(128);
+
+    // (y - 16) * 298 as y * 298 + 1 * (-16 * 298)
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i yCoeffs = int16Pairs(298, -16 * 298);
+    const __m128i yy0 = _mm_madd_epi16(_mm_unpacklo_epi16(y, one), yCoeffs);
+    const __m128i yy1 = _mm_madd_epi16(_mm_unpackhi_epi16(y, one), yCoeffs);
+
+    const __m128i rv = _mm_add_epi32(_mm_madd_epi16(uv, int16Pairs(0, 409)), rounding);
+    const __m128i guv = _mm_add_epi32(_mm_madd_epi16(uv, int16Pairs(100, 208)), rounding);
+    const __m128i bu = _mm_add_epi32(_mm_madd_epi16(uv, int16Pairs(516, 0)), rounding);
+
+    // each chroma sample covers two neighbouring pixels
+    const __m128i r = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(yy0, _mm_unpacklo_epi32(rv, rv)), 8),
+            _mm_srai_epi32(_mm_add_epi32(yy1, _mm_unpackhi_epi32(rv, rv)), 8));
+    const __m128i g = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_sub_epi32(yy0, _mm_unpacklo_epi32(guv, guv)), 8),
+            _mm_srai_epi32(_mm_sub_epi32(yy1, _mm_unpackhi_epi32(guv, guv)), 8));
+    const __m128i b = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(yy0, _mm_unpacklo_epi32(bu, bu)), 8),
+            _mm_srai_epi32(_mm_add_epi32(yy1, _mm_unpackhi_epi32(bu, bu)), 8));
+
+    // packus clamps to [0, 255] like qClampToByte
+    const __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+    const __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_set1_epi8(char(0xff)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 4), _mm_unpackhi_epi16(bg, ra));
+}
+
+template<bool Y16, YUVChromaLayout Layout>
+void QT_FASTCALL convert_YUV_row_to_ARGB32_sse2(const uchar *y, const uchar *u, const uchar *v,
+                                                quint32 *rgb, int width)
+{
+    int x = 0;
+    for (; x < width - 7; x += 8)
+        yuvToARGB32_sse2(loadLuma<Y16>(y, x), loadChroma<Layout>(u, v, x), rgb + x);
+
+    // leftovers
+    qYUVRowToARGB32(y, Y16 ? 2 : 1, u, v, chromaPixelStride(Layout), rgb, x, width);
+}
+
+template<bool YFirst>
+void QT_FASTCALL convert_packed_YUV422_row_to_ARGB32_sse2(const uchar *src, quint32 *rgb,
+                                                          int width)
+{
+    const __m128i lowBytes = _mm_set1_epi16(0xff);
+    const __m128i chromaOffset = _mm_set1_epi16(128);
+
+    int x = 0;
+    for (; x < width - 7; x += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2));
+        const __m128i low = _mm_and_si128(data, lowBytes);
+        const __m128i high = _mm_srli_epi16(data, 8);
+        yuvToARGB32_sse2(YFirst ? low : high, _mm_sub_epi16(YFirst ? high : low, chromaOffset),
+                         rgb + x);
+    }
+
+    // leftovers
+    qPackedYUV422RowToARGB32<YFirst>(src, rgb, x, width);
+}
+
+struct YUVKernels_sse2
+{
+    static constexpr auto planarRow = convert_YUV_row_to_ARGB32_sse2<false, YUVChromaLayout::Planar>;
+    static constexpr auto nv12Row = convert_YUV_row_to_ARGB32_sse2<false, YUVChromaLayout::InterleavedUV>;
+    static constexpr auto nv21Row = convert_YUV_row_to_ARGB32_sse2<false, YUVChromaLayout::InterleavedVU>;
+    static constexpr auto p016Row = convert_YUV_row_to_ARGB32_sse2<true, YUVChromaLayout::Interleaved16>;
+    static constexpr auto uyvyRow = convert_packed_YUV422_row_to_ARGB32_sse2<false>;
+    static constexpr auto yuyvRow = convert_packed_YUV422_row_to_ARGB32_sse2<true>;
+};
+
 }
 
 void QT_FASTCALL qt_convert_ARGB8888_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
@@ -80,6 +207,66 @@ void QT_FASTCALL qt_convert_BGRA8888_to_ARGB32_sse2(const QVideoFrame &frame, uc
     convert_to_ARGB32_sse2<3, 2, 1, 0>(frame, output);
 }
 
+void QT_FASTCALL qt_convert_YUV420P_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV420P_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUV422P_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUV422P_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YV12_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YV12_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_UYVY_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_UYVY_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_YUYV_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_YUYV_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV12_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV12_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_NV21_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_NV21_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC1_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC1_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC2_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC2_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC3_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC3_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_IMC4_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_IMC4_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
+void QT_FASTCALL qt_convert_P016_to_ARGB32_sse2(const QVideoFrame &frame, uchar *output)
+{
+    qt_convert_P016_to_ARGB32_simd<YUVKernels_sse2>(frame, output);
+}
+
 void QT_FASTCALL qt_copy_pixels_with_mask_sse2(uint32_t *dst, const uint32_t *src, size_t size, uint32_t mask)
 {
     const auto mask128 = _mm_set_epi32(mask, mask, mask, mask);
@@ -12,7 +12,10 @@
 #include <QtCore/qsize.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
 #include <QtCore/qthreadstorage.h>
+#include <QtCore/qwaitcondition.h>
 #include <QtGui/qimage.h>
 #include <QtGui/qoffscreensurface.h>
 #include <qpa/qplatformintegration.h>
@@ -263,7 +266,200 @@ static QImage convertJPEG(const QVideoFrame &frame, const VideoTransformation &t
     return image;
 }
 
-static QImage convertCPU(const QVideoFrame &frame, const VideoTransformation &transform)
+namespace {
+
+// The CPU conversion works on tiles of TileRows rows. Tiles are small enough for the
+// intermediate buffer of a transformed conversion to stay in the cache.
+constexpr int TileRows = 32;
+
+// Frames below this size per thread are not worth distributing
+constexpr qsizetype MinPixelsPerThread = 256 * 1024;
+
+// Exposes the rows [firstRow, firstRow + rowCount) of a mapped frame as a frame of its own,
+// without copying the data.
+class VideoFrameStripeBuffer : public QAbstractVideoBuffer
+{
+public:
+    VideoFrameStripeBuffer(const MapData &frameData, QVideoFrameFormat::PixelFormat pixelFormat,
+                           int width, int firstRow, int rowCount)
+        : m_format(QSize(width, rowCount), pixelFormat), m_mapData(frameData)
+    {
+        const auto *textureDesc = QVideoTextureHelper::textureDescription(pixelFormat);
+        for (int plane = 0; plane < m_mapData.planeCount; ++plane) {
+            const int offset =
+                    firstRow / textureDesc->sizeScale[plane].y * m_mapData.bytesPerLine[plane];
+            m_mapData.data[plane] += offset;
+            m_mapData.dataSize[plane] -= offset;
+        }
+    }
+
+    MapData map(QVideoFrame::MapMode) override { return m_mapData; }
+
+    QVideoFrameFormat format() const override { return m_format; }
+
+private:
+    QVideoFrameFormat m_format;
+    MapData m_mapData;
+};
+
+// Where the converted source pixel (x, y) lands in the transformed image:
+// origin + x * xStep + y * yStep, in pixels. Matches rasterTransform().
+struct TransformedAddressing
+{
+    qsizetype origin = 0;
+    qsizetype xStep = 1;
+    qsizetype yStep = 0;
+};
+
+TransformedAddressing transformedAddressing(const VideoTransformation &transform, QSize size,
+                                            qsizetype stride)
+{
+    const qsizetype lastX = size.width() - 1;
+    const qsizetype lastY = size.height() - 1;
+    const bool mirrored = transform.mirrorredHorizontallyAfterRotation;
+
+    // The QTransform of rasterTransform() mirrors the points before rotating them
+    switch (transform.rotation) {
+    case QtVideo::Rotation::None:
+        return mirrored ? TransformedAddressing{ lastX, -1, stride }
+                        : TransformedAddressing{ 0, 1, stride };
+    case QtVideo::Rotation::Clockwise90:
+        return mirrored ? TransformedAddressing{ lastX * stride + lastY, -stride, -1 }
+                        : TransformedAddressing{ lastY, stride, -1 };
+    case QtVideo::Rotation::Clockwise180:
+        return mirrored ? TransformedAddressing{ lastY * stride, 1, -stride }
+                        : TransformedAddressing{ lastY * stride + lastX, -1, -stride };
+    case QtVideo::Rotation::Clockwise270:
+        return mirrored ? TransformedAddressing{ 0, stride, 1 }
+                        : TransformedAddressing{ lastX * stride, -stride, 1 };
+    }
+
+    Q_UNREACHABLE_RETURN({});
+}
+
+// Converts a frame tile by tile. The tiles are handed out dynamically, so the
+// calling thread completes the job even if no pool thread picks it up.
+class CpuConversionJob
+{
+public:
+    CpuConversionJob(VideoFrameConvertFunc convert, const QVideoFrame &frame,
+                     const VideoTransformation &transform, QImage &image)
+        : m_convert(convert),
+          m_pixelFormat(frame.pixelFormat()),
+          m_size(frame.size()),
+          m_transformed(transform != VideoTransformation{}),
+          m_imageBits(reinterpret_cast<quint32 *>(image.bits())),
+          m_imageStride(image.bytesPerLine() / 4),
+          m_addressing(transformedAddressing(transform, frame.size(), m_imageStride)),
+          m_tileCount((frame.height() + TileRows - 1) / TileRows),
+          m_remainingTiles(m_tileCount)
+    {
+        m_frameData.planeCount = frame.planeCount();
+        for (int plane = 0; plane < m_frameData.planeCount; ++plane) {
+            m_frameData.bytesPerLine[plane] = frame.bytesPerLine(plane);
+            m_frameData.data[plane] = const_cast<uchar *>(frame.bits(plane));
+            m_frameData.dataSize[plane] = frame.mappedBytes(plane);
+        }
+    }
+
+    int tileCount() const { return m_tileCount; }
+
+    void run()
+    {
+        std::vector<quint32> tileBuffer;
+
+        for (int tile = m_nextTile.fetchAndAddRelaxed(1); tile < m_tileCount;
+             tile = m_nextTile.fetchAndAddRelaxed(1)) {
+            convertTile(tile, tileBuffer);
+
+            if (m_remainingTiles.fetchAndSubOrdered(1) == 1) {
+                QMutexLocker locker(&m_mutex);
+                m_finished.wakeAll();
+            }
+        }
+    }
+
+    void waitForFinished()
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_remainingTiles.loadAcquire() > 0)
+            m_finished.wait(&m_mutex);
+    }
+
+private:
+    void convertTile(int tile, std::vector<quint32> &tileBuffer)
+    {
+        const int firstRow = tile * TileRows;
+        const int rowCount = qMin(TileRows, m_size.height() - firstRow);
+
+        QVideoFrame stripe(std::make_unique<VideoFrameStripeBuffer>(
+                m_frameData, m_pixelFormat, m_size.width(), firstRow, rowCount));
+        if (!stripe.map(QVideoFrame::ReadOnly))
+            return;
+
+        if (!m_transformed) {
+            m_convert(stripe, reinterpret_cast<uchar *>(m_imageBits + firstRow * m_imageStride));
+            stripe.unmap();
+            return;
+        }
+
+        tileBuffer.resize(qsizetype(m_size.width()) * rowCount);
+        m_convert(stripe, reinterpret_cast<uchar *>(tileBuffer.data()));
+        stripe.unmap();
+
+        const qsizetype width = m_size.width();
+        quint32 *dst = m_imageBits + m_addressing.origin + firstRow * m_addressing.yStep;
+
+        if (qAbs(m_addressing.xStep) == 1) {
+            // source rows stay image rows
+            for (int y = 0; y < rowCount; ++y, dst += m_addressing.yStep) {
+                const quint32 *src = tileBuffer.data() + y * width;
+                if (m_addressing.xStep == 1)
+                    std::copy(src, src + width, dst);
+                else
+                    std::reverse_copy(src, src + width, dst - width + 1);
+            }
+        } else {
+            // source rows become image columns; write the tile column by column
+            for (qsizetype x = 0; x < width; ++x, dst += m_addressing.xStep) {
+                const quint32 *src = tileBuffer.data() + x;
+                for (int y = 0; y < rowCount; ++y, src += width)
+                    dst[y * m_addressing.yStep] = *src;
+            }
+        }
+    }
+
+    VideoFrameConvertFunc m_convert;
+    QAbstractVideoBuffer::MapData m_frameData;
+    QVideoFrameFormat::PixelFormat m_pixelFormat;
+    QSize m_size;
+    bool m_transformed;
+    quint32 *m_imageBits;
+    qsizetype m_imageStride;
+    TransformedAddressing m_addressing;
+    int m_tileCount;
+
+    QAtomicInt m_nextTile = 0;
+    QAtomicInt m_remainingTiles;
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+};
+
+int cpuConversionThreadCount(const QVideoFrame &frame, int tileCount)
+{
+    static const int maxThreadCount = [] {
+        const int threadCount = qEnvironmentVariableIntValue("QT_MEDIA_CPU_CONVERSION_THREADS");
+        return threadCount > 0 ? threadCount : QThread::idealThreadCount();
+    }();
+
+    const qsizetype pixelCount = qsizetype(frame.width()) * frame.height();
+    return qBound(1, int(pixelCount / MinPixelsPerThread), qMin(maxThreadCount, tileCount));
+}
+
+} // namespace
+
+static QImage convertCPU(const QVideoFrame &frame, const VideoTransformation &transform,
+                         int threadCount = 0)
 {
     VideoFrameConvertFunc convert = qConverterForFormat(frame.pixelFormat());
     if (!convert) {
@@ -276,10 +472,28 @@ static QImage convertCPU(const QVideoFrame &frame, const VideoTransformation &tr
             return {};
         }
         auto format = pixelFormatHasAlpha(varFrame.pixelFormat()) ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
-        QImage image = QImage(varFrame.width(), varFrame.height(), format);
-        convert(varFrame, image.bits());
+        QImage image = QImage(qRotatedFrameSize(varFrame.size(), transform.rotation), format);
+        if (image.isNull()) {
+            varFrame.unmap();
+            return {};
+        }
+
+        // Rotation and mirroring are applied while writing the converted tiles,
+        // so the image is written only once.
+        auto job = std::make_shared<CpuConversionJob>(convert, varFrame, transform, image);
+
+        if (threadCount <= 0)
+            threadCount = cpuConversionThreadCount(varFrame, job->tileCount());
+        threadCount = qMin(threadCount, job->tileCount());
+
+        // The pool threads keep the job alive; if they start late they find no tiles left
+        for (int i = 1; i < threadCount; ++i)
+            QThreadPool::globalInstance()->start([job]() { job->run(); });
+
+        job->run();
+        job->waitForFinished();
+
         varFrame.unmap();
-        rasterTransform(image, transform);
         return image;
     }
 }
@@ -430,6 +644,18 @@ QImage qImageFromVideoFrame(const QVideoFrame &frame, const VideoTransformation
                   QImage::Format_RGBA8888_Premultiplied, imageCleanupHandler, imageData);
 }
 
+QImage qImageFromVideoFrameOnCpu(const QVideoFrame &frame,
+                                 const VideoTransformation &transformation, int threadCount)
+{
+    if (frame.size().isEmpty() || frame.pixelFormat() == QVideoFrameFormat::Format_Invalid)
+        return {};
+
+    if (frame.pixelFormat() == QVideoFrameFormat::Format_Jpeg)
+        return convertJPEG(frame, transformation);
+
+    return convertCPU(frame, transformation, threadCount);
+}
+
 QImage videoFramePlaneAsImage(QVideoFrame &frame, int plane, QImage::Format targetFormat,
                               QSize targetSize)
 {
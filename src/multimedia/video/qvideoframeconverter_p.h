@@ -27,6 +27,17 @@ Q_MULTIMEDIA_EXPORT QImage qImageFromVideoFrame(const QVideoFrame &frame,
 
 Q_MULTIMEDIA_EXPORT QImage qImageFromVideoFrame(const QVideoFrame &frame, bool forceCpu = false);
 
+/**
+ *  @brief Converts the video frame on the CPU. The frame is converted in tiles of rows,
+ * distributed over up to \a threadCount threads of the global thread pool, and the
+ * transformation is applied while writing the tiles to the image. If \a threadCount
+ * is 0, it is chosen from the frame size, QThread::idealThreadCount() and the
+ * QT_MEDIA_CPU_CONVERSION_THREADS environment variable.
+ */
+Q_MULTIMEDIA_EXPORT QImage qImageFromVideoFrameOnCpu(const QVideoFrame &frame,
+                                                     const VideoTransformation &transformation,
+                                                     int threadCount = 0);
+
 /**
  *  @brief Maps the video frame and returns an image having a shared ownership for the video frame
  * and referencing to its mapped data.
@@ -139,7 +139,7 @@ function(qt_internal_multimedia_set_stub_libraries stub stub_target)
     qt_internal_extend_target(${stub_target} LIBRARIES Qt::Core Qt::MultimediaPrivate)
 
     if (LINK_STUBS_TO_FFMPEG_PLUGIN AND ${stub} STREQUAL "va")
-        qt_internal_extend_target(QFFmpegMediaPlugin LIBRARIES ${stub_target})
+        qt_internal_extend_target(QFFmpegMediaPluginImplPrivate LIBRARIES ${stub_target})
     endif()
 endfunction()
 
@@ -167,9 +167,9 @@ function(qt_internal_multimedia_add_shared_stub stub)
 endfunction()
 
 function(qt_internal_multimedia_add_private_stub_to_plugin stub)
-    qt_internal_multimedia_set_stub_include_directories(${stub} QFFmpegMediaPlugin)
-    qt_internal_multimedia_define_stub_needed_version(${stub} QFFmpegMediaPlugin)
-    qt_internal_extend_target(QFFmpegMediaPlugin SOURCES "symbolstubs/qffmpegsymbols-${stub}.cpp")
+    qt_internal_multimedia_set_stub_include_directories(${stub} QFFmpegMediaPluginImplPrivate)
+    qt_internal_multimedia_define_stub_needed_version(${stub} QFFmpegMediaPluginImplPrivate)
+    qt_internal_extend_target(QFFmpegMediaPluginImplPrivate SOURCES "symbolstubs/qffmpegsymbols-${stub}.cpp")
 endfunction()
 
 # Main function
@@ -6,6 +6,7 @@
 #include "qaudiooutput.h"
 #include "qaudiobufferoutput.h"
 #include "private/qplatformaudiooutput_p.h"
+#include "private/qaudiooutputmixer_p.h"
 #include <QtCore/qloggingcategory.h>
 
 #include "qffmpegresampler_p.h"
@@ -102,8 +103,11 @@ AudioRenderer::~AudioRenderer()
 
 void AudioRenderer::updateVolume()
 {
+    const float volume = m_output->isMuted() ? 0.f : m_output->volume();
     if (m_sink)
-        m_sink->setVolume(m_output->isMuted() ? 0.f : m_output->volume());
+        m_sink->setVolume(volume);
+    if (m_mixerInput)
+        m_mixerInput->setVolume(volume);
 }
 
 void AudioRenderer::onDeviceChanged()
@@ -134,11 +138,11 @@ AudioRenderer::RenderingResult AudioRenderer::pushFrameToOutput(const Frame &fra
     if (!m_ioDevice || !m_resampler)
         return {};
 
-    Q_ASSERT(m_sink);
+    Q_ASSERT(m_sink || m_mixerInput);
 
     auto firstFrameFlagGuard = qScopeGuard([&]() { m_firstFrameToSink = false; });
 
-    const SynchronizationStamp syncStamp{ m_sink->state(), m_sink->bytesFree(),
+    const SynchronizationStamp syncStamp{ sinkState(), sinkBytesFree(), sinkDownstreamLatency(),
                                           m_bufferedData.offset, Clock::now() };
 
     if (!m_bufferedData.isValid()) {
@@ -206,7 +210,7 @@ int AudioRenderer::timerInterval() const
 
     const auto interval = Renderer::timerInterval();
 
-    if (m_firstFrameToSink || !m_sink || m_sink->state() != QAudio::IdleState
+    if (m_firstFrameToSink || (!m_sink && !m_mixerInput) || sinkState() != QAudio::IdleState
         || interval > MaxFixableInterval)
         return interval;
 
@@ -239,6 +243,7 @@ void AudioRenderer::freeOutput()
         m_sink.reset();
     }
 
+    m_mixerInput.reset();
     m_ioDevice = nullptr;
 
     m_bufferedData = {};
@@ -272,12 +277,15 @@ void AudioRenderer::updateOutputs(const Frame &frame)
     if (!m_output)
         return;
 
+    if (!m_sinkFormat.isValid() && QAudioOutputMixer::isEnabled())
+        openMixerInput();
+
     if (!m_sinkFormat.isValid()) {
         m_sinkFormat = audioFormatFromFrame(frame);
         m_sinkFormat.setChannelConfig(m_output->device().channelConfiguration());
     }
 
-    if (!m_sink) {
+    if (!m_sink && !m_mixerInput) {
         // Insert a delay here to test time offset synchronization, e.g. QThread::sleep(1)
         m_sink = std::make_unique<QAudioSink>(m_output->device(), m_sinkFormat);
         updateVolume();
@@ -288,25 +296,82 @@ void AudioRenderer::updateOutputs(const Frame &frame)
         connect(m_sink.get(), &QAudioSink::stateChanged, this,
                 &AudioRenderer::onAudioSinkStateChanged);
 
-        m_timings.actualBufferDuration = durationForBytes(m_sink->bufferSize());
-        m_timings.maxSoundDelay = qMin(MaxDesiredBufferTime,
-                                       m_timings.actualBufferDuration - MinDesiredFreeBufferTime);
-        m_timings.minSoundDelay = MinDesiredBufferTime;
-
-        Q_ASSERT(DurationBias < m_timings.minSoundDelay
-                 && m_timings.maxSoundDelay < m_timings.actualBufferDuration);
+        initTimings(m_sink->bufferSize());
     }
 
     if (!m_resampler)
         initResempler(frame);
 }
 
+void AudioRenderer::openMixerInput()
+{
+    auto mixer = QAudioOutputMixer::instance(m_output->device());
+    if (!mixer)
+        return;
+
+    // The mixer keeps the input filled up to the middle of the range
+    // that updateSynchronization() tolerates
+    const QAudioFormat format = mixer->inputFormat();
+    constexpr auto TargetDelay = (MinDesiredBufferTime + MaxDesiredBufferTime) / 2;
+    auto input = std::make_unique<QAudioOutputMixerInput>(
+            std::move(mixer), DesiredBufferTime.count(), TargetDelay.count());
+
+    // The mixer has no free input; fall back to a sink
+    if (!input->isOpen())
+        return;
+
+    qCDebug(qLcAudioRenderer) << "Output to the shared mixer, format:" << format;
+
+    m_mixerInput = std::move(input);
+    m_sinkFormat = format;
+    updateVolume();
+    m_ioDevice = m_mixerInput.get();
+    m_firstFrameToSink = true;
+
+    connect(m_mixerInput.get(), &QAudioOutputMixerInput::stateChanged, this,
+            &AudioRenderer::onAudioSinkStateChanged);
+
+    initTimings(m_mixerInput->bufferSize(), sinkDownstreamLatency());
+}
+
+void AudioRenderer::initTimings(qsizetype bufferSize, Microseconds downstreamLatency)
+{
+    // The sound delay includes the downstream latency, so the tolerated range moves with it
+    m_timings.actualBufferDuration = durationForBytes(bufferSize);
+    m_timings.maxSoundDelay = downstreamLatency
+            + qMin(MaxDesiredBufferTime, m_timings.actualBufferDuration - MinDesiredFreeBufferTime);
+    m_timings.minSoundDelay = downstreamLatency + MinDesiredBufferTime;
+
+    Q_ASSERT(DurationBias < m_timings.minSoundDelay
+             && m_timings.maxSoundDelay < m_timings.actualBufferDuration + downstreamLatency);
+}
+
+QAudio::State AudioRenderer::sinkState() const
+{
+    return m_mixerInput ? m_mixerInput->state() : m_sink->state();
+}
+
+qsizetype AudioRenderer::sinkBytesFree() const
+{
+    return m_mixerInput ? m_mixerInput->bytesFree() : m_sink->bytesFree();
+}
+
+qsizetype AudioRenderer::sinkBufferSize() const
+{
+    return m_mixerInput ? m_mixerInput->bufferSize() : m_sink->bufferSize();
+}
+
+microseconds AudioRenderer::sinkDownstreamLatency() const
+{
+    return m_mixerInput ? microseconds(m_mixerInput->downstreamLatencyUs()) : microseconds(0);
+}
+
 void AudioRenderer::updateSynchronization(const SynchronizationStamp &stamp, const Frame &frame)
 {
     if (!frame.isValid())
         return;
 
-    Q_ASSERT(m_sink);
+    Q_ASSERT(m_sink || m_mixerInput);
 
     const auto bufferLoadingTime = this->bufferLoadingTime(stamp);
     const auto currentFrameDelay = frameDelay(frame, stamp.timePoint);
@@ -371,12 +436,12 @@ void AudioRenderer::updateSynchronization(const SynchronizationStamp &stamp, con
 
 microseconds AudioRenderer::bufferLoadingTime(const SynchronizationStamp &syncStamp) const
 {
-    Q_ASSERT(m_sink);
+    Q_ASSERT(m_sink || m_mixerInput);
 
     if (syncStamp.audioSinkState == QAudio::IdleState)
         return microseconds(0);
 
-    const auto bytes = qMax(m_sink->bufferSize() - syncStamp.audioSinkBytesFree, 0);
+    const auto bytes = qMax(sinkBufferSize() - syncStamp.audioSinkBytesFree, 0);
 
 #ifdef Q_OS_ANDROID
     // The hack has been added due to QAndroidAudioSink issues (QTBUG-118609).
@@ -386,7 +451,7 @@ microseconds AudioRenderer::bufferLoadingTime(const SynchronizationStamp &syncSt
         return m_timings.minSoundDelay + MinDesiredBufferTime;
 #endif
 
-    return durationForBytes(bytes);
+    return durationForBytes(bytes) + syncStamp.downstreamLatency;
 }
 
 void AudioRenderer::onAudioSinkStateChanged(QAudio::State state)
@@ -23,6 +23,7 @@ QT_BEGIN_NAMESPACE
 class QAudioOutput;
 class QAudioBufferOutput;
 class QAudioSink;
+class QAudioOutputMixerInput;
 class QFFmpegResampler;
 
 namespace QFFmpeg {
@@ -45,6 +46,7 @@ protected:
     {
         QAudio::State audioSinkState = QAudio::IdleState;
         qsizetype audioSinkBytesFree = 0;
+        Microseconds downstreamLatency = Microseconds(0);
         qsizetype bufferBytesWritten = 0;
         TimePoint timePoint = TimePoint::max();
     };
@@ -90,6 +92,18 @@ protected:
 
     void updateOutputs(const Frame &frame);
 
+    // Opens an input of the shared mixer of the output device instead of a sink
+    void openMixerInput();
+
+    void initTimings(qsizetype bufferSize, Microseconds downstreamLatency = Microseconds(0));
+
+    // The sink or the mixer input
+    QAudio::State sinkState() const;
+    qsizetype sinkBytesFree() const;
+    qsizetype sinkBufferSize() const;
+    // The latency after the sink buffer, which the mixer adds
+    Microseconds sinkDownstreamLatency() const;
+
     void initResempler(const Frame &frame);
 
     void onDeviceChanged();
@@ -108,6 +122,7 @@ private:
     QPointer<QAudioOutput> m_output;
     QPointer<QAudioBufferOutput> m_bufferOutput;
     std::unique_ptr<QAudioSink> m_sink;
+    std::unique_ptr<QAudioOutputMixerInput> m_mixerInput;
     AudioTimings m_timings;
     BufferLoadingInfo m_bufferLoadingInfo;
     std::unique_ptr<QFFmpegResampler> m_resampler;
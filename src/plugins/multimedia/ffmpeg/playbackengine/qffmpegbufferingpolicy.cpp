@@ -0,0 +1,61 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "playbackengine/qffmpegbufferingpolicy_p.h"
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+BufferingPolicy BufferingPolicy::defaultPolicy()
+{
+    static const BufferingPolicy policy = fromEnvironment();
+    return policy;
+}
+
+BufferingPolicy BufferingPolicy::fromEnvironment()
+{
+    return fromSettings(&qEnvironmentVariableIntValue);
+}
+
+BufferingPolicy BufferingPolicy::fromSettings(const SettingReader &intValue,
+                                              const BufferingPolicy &fallback)
+{
+    bool ok = false;
+    const int liveMode = intValue("QT_FFMPEG_DEMUXER_LIVE_MODE", &ok);
+    BufferingPolicy result = !ok ? fallback : liveMode ? live() : BufferingPolicy{};
+
+    const int durationMs = intValue("QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS", &ok);
+    if (ok && durationMs > 0)
+        result.maxDurationUs = durationMs * 1000ll;
+
+    const int size = intValue("QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE", &ok);
+    if (ok && size > 0)
+        result.maxSize = size;
+
+    const int lowWaterMark = intValue("QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT", &ok);
+    if (ok && lowWaterMark > 0 && lowWaterMark <= 100)
+        result.lowWaterMark = lowWaterMark / 100.f;
+
+    return result;
+}
+
+bool BufferingPolicy::isLimitReached(qint64 bufferedDurationUs, qint64 packetsPosDiffUs,
+                                     qint64 bufferedSize, bool paused) const
+{
+    // Stay paused until the stream drains to the low water mark, so that
+    // the demuxer reads in bursts rather than packet by packet.
+    const float fraction = paused ? lowWaterMark : 1.f;
+    const auto durationLimit = qint64(maxDurationUs * fraction);
+    const auto sizeLimit = qint64(maxSize * fraction);
+
+    return bufferedDurationUs >= durationLimit
+            || (bufferedDurationUs == 0 && packetsPosDiffUs >= durationLimit)
+            || bufferedSize >= sizeLimit;
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
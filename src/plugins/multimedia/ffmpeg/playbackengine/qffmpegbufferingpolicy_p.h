@@ -0,0 +1,94 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGBUFFERINGPOLICY_P_H
+#define QFFMPEGBUFFERINGPOLICY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <qtypes.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+// Defines how far the demuxer may read ahead of the stream decoders.
+struct BufferingPolicy
+{
+    // The demuxer pauses once any of the streams reaches one of the limits
+    qint64 maxDurationUs = 4'000'000;
+    qint64 maxSize = 32 * 1024 * 1024; // around 4 sec of hdr video
+
+    // Once paused, the demuxer resumes when the stream has drained below this fraction
+    // of the limits. 1 resumes as soon as the stream drops below the limits.
+    float lowWaterMark = 1.f;
+
+    // Report the media as buffered after the first packet instead of waiting
+    // for the limits to be reached, which keeps the start latency low.
+    bool liveMode = false;
+
+    // The defaults, which can be overridden by the environment variables
+    // QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS, QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE,
+    // QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT and QT_FFMPEG_DEMUXER_LIVE_MODE.
+    // The environment is read once.
+    static BufferingPolicy defaultPolicy();
+
+    // Reads the environment variables on each call
+    static BufferingPolicy fromEnvironment();
+
+    // Reads the settings named as the environment variables above through
+    // intValue(name, &ok). The policy starts from fallback if the live mode is
+    // not set, and the missing or invalid limits keep their values.
+    using SettingReader = std::function<int(const char *name, bool *ok)>;
+    static BufferingPolicy fromSettings(const SettingReader &intValue,
+                                        const BufferingPolicy &fallback = {});
+
+    // A small read-ahead for low latency live sources
+    static BufferingPolicy live()
+    {
+        BufferingPolicy result;
+        result.maxDurationUs = 500'000;
+        result.maxSize = 4 * 1024 * 1024;
+        result.liveMode = true;
+        return result;
+    }
+
+    // Whether the demuxer should pause reading a stream. packetsPosDiffUs is used if the
+    // packets have no durations. Once paused, the lower limits given by the low water mark apply.
+    bool isLimitReached(qint64 bufferedDurationUs, qint64 packetsPosDiffUs, qint64 bufferedSize,
+                        bool paused) const;
+
+    friend bool operator==(const BufferingPolicy &lhs, const BufferingPolicy &rhs)
+    {
+        return lhs.maxDurationUs == rhs.maxDurationUs && lhs.maxSize == rhs.maxSize
+                && lhs.lowWaterMark == rhs.lowWaterMark && lhs.liveMode == rhs.liveMode;
+    }
+    friend bool operator!=(const BufferingPolicy &lhs, const BufferingPolicy &rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+// Data demuxed but not yet processed by the stream decoders
+struct BufferOccupancy
+{
+    qint64 durationUs = 0; // of the most buffered stream
+    qint64 size = 0;       // of all streams
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGBUFFERINGPOLICY_P_H
@@ -39,6 +39,18 @@ QMaybe<Codec> Codec::create(AVStream *stream, AVFormatContext *formatContext)
     return codec;
 }
 
+QMaybe<Codec> Codec::createSoftware(AVStream *stream, AVFormatContext *formatContext, int lowres)
+{
+    if (!stream)
+        return { "Invalid stream" };
+
+    auto codec = create(stream, formatContext, Sw, lowres);
+    if (!codec)
+        qCWarning(qLcPlaybackEngineCodec) << codec.error();
+
+    return codec;
+}
+
 AVRational Codec::pixelAspectRatio(AVFrame *frame) const
 {
     // does the same as av_guess_sample_aspect_ratio, but more efficient
@@ -47,7 +59,7 @@ AVRational Codec::pixelAspectRatio(AVFrame *frame) const
 }
 
 QMaybe<Codec> Codec::create(AVStream *stream, AVFormatContext *formatContext,
-                            VideoCodecCreationPolicy videoCodecPolicy)
+                            VideoCodecCreationPolicy videoCodecPolicy, int lowres)
 {
     Q_ASSERT(stream);
 
@@ -99,6 +111,9 @@ QMaybe<Codec> Codec::create(AVStream *stream, AVFormatContext *formatContext,
     // But it would be good to get so we can filter out pixel format we don't support natively
     context->get_format = QFFmpeg::getFormat;
 
+    if (lowres > 0 && context->codec_type == AVMEDIA_TYPE_VIDEO)
+        context->lowres = qMin(lowres, int(decoder->max_lowres));
+
     /* Init the decoder, with reference counting and threading */
     AVDictionaryHolder opts;
     av_dict_set(opts, "refcounted_frames", "1", 0);
@@ -41,6 +41,11 @@ class Codec
 public:
     static QMaybe<Codec> create(AVStream *stream, AVFormatContext *formatContext);
 
+    // A software decoder; for video, lowres makes the decoder downscale
+    // the frames by 2^lowres if it supports that.
+    static QMaybe<Codec> createSoftware(AVStream *stream, AVFormatContext *formatContext,
+                                        int lowres = 0);
+
     AVRational pixelAspectRatio(AVFrame *frame) const;
 
     AVCodecContext *context() const { return d->context.get(); }
@@ -57,7 +62,7 @@ private:
     };
 
     static QMaybe<Codec> create(AVStream *stream, AVFormatContext *formatContext,
-                                VideoCodecCreationPolicy videoCodecPolicy);
+                                VideoCodecCreationPolicy videoCodecPolicy, int lowres = 0);
     Codec(Data *data) : d(data) { }
     QExplicitlySharedDataPointer<Data> d;
 };
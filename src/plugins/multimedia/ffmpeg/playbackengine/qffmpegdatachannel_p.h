@@ -0,0 +1,206 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGDATACHANNEL_P_H
+#define QFFMPEGDATACHANNEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+// Single-producer, single-consumer wait-free queue, unbounded.
+// The elements are stored in fixed-size segments; the consumer hands
+// a drained segment back to the producer for reuse, so a queue with
+// a steady load doesn't allocate.
+template <typename T, int SegmentSize = 32>
+class SpscQueue
+{
+    struct Segment
+    {
+        std::array<T, SegmentSize> items;
+        QAtomicPointer<Segment> next;
+    };
+
+public:
+    SpscQueue() : m_head(new Segment), m_tail(m_head) { }
+
+    ~SpscQueue()
+    {
+        while (m_head) {
+            Segment *next = m_head->next.loadRelaxed();
+            delete m_head;
+            m_head = next;
+        }
+        delete m_spare.loadRelaxed();
+    }
+
+    Q_DISABLE_COPY_MOVE(SpscQueue)
+
+    // Producer thread only
+    void push(T value)
+    {
+        if (m_writePos == SegmentSize) {
+            Segment *segment = m_spare.fetchAndStoreAcquire(nullptr);
+            if (!segment)
+                segment = new Segment;
+
+            m_tail->next.storeRelease(segment);
+            m_tail = segment;
+            m_writePos = 0;
+        }
+
+        m_tail->items[m_writePos++] = std::move(value);
+        m_size.fetchAndAddRelease(1);
+    }
+
+    // Consumer thread only
+    bool pop(T &value)
+    {
+        if (m_size.loadAcquire() == 0)
+            return false;
+
+        if (m_readPos == SegmentSize) {
+            Segment *drained = m_head;
+            m_head = drained->next.loadAcquire();
+            Q_ASSERT(m_head);
+            m_readPos = 0;
+
+            drained->next.storeRelaxed(nullptr);
+            delete m_spare.fetchAndStoreRelease(drained);
+        }
+
+        // Release the reference held by the queue immediately
+        value = std::exchange(m_head->items[m_readPos++], T{});
+        m_size.fetchAndAddRelease(-1);
+        return true;
+    }
+
+    // CAVEAT: beware of the thread safety
+    int size() const { return m_size.loadRelaxed(); }
+
+private:
+    Segment *m_head = nullptr; // consumer side
+    int m_readPos = 0;
+
+    Segment *m_tail = nullptr; // producer side
+    int m_writePos = 0;
+
+    QAtomicPointer<Segment> m_spare;
+    QAtomicInt m_size;
+};
+
+/*!
+    Delivers values from one producer thread to a handler of a consumer object,
+    which is invoked in the consumer thread.
+
+    This is the data path between the playback engine objects, replacing
+    queued signals: pushing a value doesn't allocate an event and the consumer
+    is woken up once per batch of values rather than once per value.
+    Values pushed before a signal is emitted are handled before the signal's
+    slot, given that the consumer is the signal receiver, since the wake-up
+    event goes to the same event queue.
+ */
+template <typename T>
+class DataChannel : public std::enable_shared_from_this<DataChannel<T>>
+{
+public:
+    template <typename Consumer>
+    static std::shared_ptr<DataChannel> create(Consumer *consumer,
+                                               void (Consumer::*handler)(T))
+    {
+        Q_ASSERT(consumer);
+        std::shared_ptr<DataChannel> result(new DataChannel(
+                consumer, [consumer, handler](T value) { (consumer->*handler)(std::move(value)); }));
+
+        // The consumer is deleted in its own thread, which might be pushed to concurrently
+        QObject::connect(consumer, &QObject::destroyed,
+                         [weakChannel = std::weak_ptr<DataChannel>(result)]() {
+                             if (auto channel = weakChannel.lock())
+                                 channel->close();
+                         });
+
+        return result;
+    }
+
+    // Producer thread only
+    void push(T value)
+    {
+        m_queue.push(std::move(value));
+
+        // Pairs with the fence in drain(): either drain() pops the value,
+        // or the flag reset by drain() is seen here and one more wake-up is sent.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_wakeUpPending.fetchAndStoreRelaxed(true))
+            wakeUp();
+    }
+
+private:
+    DataChannel(QObject *consumer, std::function<void(T)> handler)
+        : m_consumer(consumer), m_handler(std::move(handler))
+    {
+    }
+
+    void wakeUp()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_consumer)
+            QMetaObject::invokeMethod(
+                    m_consumer, [self = this->shared_from_this()]() { self->drain(); },
+                    Qt::QueuedConnection);
+    }
+
+    void drain()
+    {
+        // Reset before popping so that a concurrent push either gets popped
+        // in this loop or triggers one more wake-up. The store and the loads of
+        // the queue must not be reordered, thus the fence.
+        m_wakeUpPending.storeRelaxed(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        T value;
+        while (m_queue.pop(value))
+            m_handler(std::exchange(value, T{}));
+    }
+
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_consumer = nullptr;
+    }
+
+private:
+    QMutex m_mutex;
+    QObject *m_consumer = nullptr;
+    std::function<void(T)> m_handler;
+    SpscQueue<T> m_queue;
+    QAtomicInteger<bool> m_wakeUpPending = false;
+};
+
+template <typename T>
+using DataChannelPtr = std::shared_ptr<DataChannel<T>>;
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGDATACHANNEL_P_H
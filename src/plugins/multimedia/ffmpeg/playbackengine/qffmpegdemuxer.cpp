@@ -6,12 +6,6 @@
 
 QT_BEGIN_NAMESPACE
 
-// 4 sec for buffering. TODO: maybe move to env var customization
-static constexpr qint64 MaxBufferedDurationUs = 4'000'000;
-
-// around 4 sec of hdr video
-static constexpr qint64 MaxBufferedSize = 32 * 1024 * 1024;
-
 namespace QFFmpeg {
 
 static Q_LOGGING_CATEGORY(qLcDemuxer, "qt.multimedia.ffmpeg.demuxer");
@@ -43,12 +37,22 @@ static bool isPacketWithinStreamDuration(const AVFormatContext *context, const P
 }
 
 Demuxer::Demuxer(AVFormatContext *context, const PositionWithOffset &posWithOffset,
-                 const StreamIndexes &streamIndexes, int loops)
-    : m_context(context), m_posWithOffset(posWithOffset), m_loops(loops)
+                 const StreamIndexes &streamIndexes, int loops,
+                 const BufferingPolicy &bufferingPolicy,
+                 std::shared_ptr<KeyframeIndex> keyframeIndex)
+    : m_context(context),
+      m_posWithOffset(posWithOffset),
+      m_loops(loops),
+      m_bufferingPolicy(bufferingPolicy),
+      m_keyframeIndex(std::move(keyframeIndex))
 {
     qCDebug(qLcDemuxer) << "Create demuxer."
                         << "pos:" << posWithOffset.pos << "loop offset:" << posWithOffset.offset.pos
-                        << "loop index:" << posWithOffset.offset.index << "loops:" << loops;
+                        << "loop index:" << posWithOffset.offset.index << "loops:" << loops
+                        << "max buffered duration:" << bufferingPolicy.maxDurationUs
+                        << "max buffered size:" << bufferingPolicy.maxSize
+                        << "low water mark:" << bufferingPolicy.lowWaterMark
+                        << "live mode:" << bufferingPolicy.liveMode;
 
     Q_ASSERT(m_context);
 
@@ -65,7 +69,7 @@ void Demuxer::doNextStep()
 {
     ensureSeeked();
 
-    Packet packet(m_posWithOffset.offset, AVPacketUPtr{ av_packet_alloc() }, id());
+    Packet packet(m_posWithOffset.offset, acquireAVPacket(), id());
     if (av_read_frame(m_context, packet.avPacket()) < 0
         || !isPacketWithinStreamDuration(m_context, packet)) {
         ++m_posWithOffset.offset.index;
@@ -113,8 +117,12 @@ void Demuxer::doNextStep()
         streamData.bufferedSize += avPacket.size;
         streamData.maxSentPacketsPos = qMax(streamData.maxSentPacketsPos, endPos);
         updateStreamDataLimitFlag(streamData);
+        updateBufferOccupancy();
 
-        if (!m_buffered && streamData.isDataLimitReached) {
+        if (streamData.trackType == QPlatformMediaPlayer::VideoStream)
+            addToKeyframeIndex(streamIndex, stream, avPacket);
+
+        if (!m_buffered && (streamData.isDataLimitReached || m_bufferingPolicy.liveMode)) {
             m_buffered = true;
             emit packetsBuffered();
         }
@@ -125,8 +133,8 @@ void Demuxer::doNextStep()
             emit firstPacketFound(std::chrono::steady_clock::now(), pos);
         }
 
-        auto signal = signalByTrackType(it->second.trackType);
-        emit (this->*signal)(packet);
+        if (auto &output = m_packetOutputs[it->second.trackType])
+            output->push(packet);
     }
 
     scheduleNextStep(false);
@@ -159,6 +167,7 @@ void Demuxer::onPacketProcessed(Packet packet)
         Q_ASSERT(it->second.bufferedSize >= 0);
 
         updateStreamDataLimitFlag(streamData);
+        updateBufferOccupancy();
     }
 
     scheduleNextStep();
@@ -185,7 +194,11 @@ void Demuxer::ensureSeeked()
     if (std::exchange(m_seeked, true))
         return;
 
-    if ((m_context->ctx_flags & AVFMTCTX_UNSEEKABLE) == 0) {
+    for (auto &[index, streamData] : m_streams)
+        streamData.lastKeyframePos.reset();
+
+    if ((m_context->ctx_flags & AVFMTCTX_UNSEEKABLE) == 0
+        && !seekByKeyframeIndex(m_posWithOffset.pos)) {
         const qint64 seekPos = m_posWithOffset.pos * AV_TIME_BASE / 1000000;
         auto err = av_seek_frame(m_context, -1, seekPos, AVSEEK_FLAG_BACKWARD);
 
@@ -203,20 +216,55 @@ void Demuxer::ensureSeeked()
     setAtEnd(false);
 }
 
-Demuxer::RequestingSignal Demuxer::signalByTrackType(QPlatformMediaPlayer::TrackType trackType)
+bool Demuxer::seekByKeyframeIndex(qint64 pos)
 {
-    switch (trackType) {
-    case QPlatformMediaPlayer::TrackType::VideoStream:
-        return &Demuxer::requestProcessVideoPacket;
-    case QPlatformMediaPlayer::TrackType::AudioStream:
-        return &Demuxer::requestProcessAudioPacket;
-    case QPlatformMediaPlayer::TrackType::SubtitleStream:
-        return &Demuxer::requestProcessSubtitlePacket;
-    default:
-        Q_ASSERT(!"Unknown track type");
+    if (!m_keyframeIndex || (m_context->iformat->flags & AVFMT_NO_BYTE_SEEK))
+        return false;
+
+    for (const auto &[streamIndex, streamData] : m_streams) {
+        if (streamData.trackType != QPlatformMediaPlayer::VideoStream)
+            continue;
+
+#if QT_FFMPEG_HAS_AVFORMAT_INDEX_GET_ENTRY
+        // FFmpeg seeks efficiently by the container index
+        if (avformat_index_get_entries_count(m_context->streams[streamIndex]) > 0)
+            return false;
+#endif
+
+        const auto keyframe = m_keyframeIndex->keyframeBefore(streamIndex, pos);
+        if (!keyframe || keyframe->bytePos < 0)
+            return false;
+
+        const int err = av_seek_frame(m_context, -1, keyframe->bytePos, AVSEEK_FLAG_BYTE);
+        qCDebug(qLcDemuxer) << "Seek to keyframe" << keyframe->pos << "at byte"
+                            << keyframe->bytePos << "result:" << err;
+        return err >= 0;
     }
 
-    return nullptr;
+    return false;
+}
+
+void Demuxer::addToKeyframeIndex(int streamIndex, const AVStream *stream, const AVPacket &packet)
+{
+    if (!m_keyframeIndex || !(packet.flags & AV_PKT_FLAG_KEY))
+        return;
+
+    // Presentation time stamps, like the seek positions; the decoding ones of
+    // reordered streams are earlier by the reorder delay
+    const qint64 timeStamp = packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts;
+    if (timeStamp == AV_NOPTS_VALUE)
+        return;
+
+    auto &streamData = m_streams[streamIndex];
+    const qint64 pos = streamTimeToUs(stream, timeStamp);
+    m_keyframeIndex->addKeyframe(streamIndex, { pos, packet.pos }, streamData.lastKeyframePos);
+    streamData.lastKeyframePos = pos;
+}
+
+void Demuxer::setPacketOutput(QPlatformMediaPlayer::TrackType trackType,
+                              DataChannelPtr<Packet> channel)
+{
+    setOutputChannel(m_packetOutputs[trackType], std::move(channel));
 }
 
 void Demuxer::setLoops(int loopsCount)
@@ -225,13 +273,52 @@ void Demuxer::setLoops(int loopsCount)
     m_loops.storeRelease(loopsCount);
 }
 
+void Demuxer::setBufferingPolicy(const BufferingPolicy &policy)
+{
+    // The stream data is owned by the demuxer thread
+    QMetaObject::invokeMethod(this, [this, policy]() {
+        qCDebug(qLcDemuxer) << "setBufferingPolicy to demuxer."
+                            << "max buffered duration:" << policy.maxDurationUs
+                            << "max buffered size:" << policy.maxSize
+                            << "low water mark:" << policy.lowWaterMark
+                            << "live mode:" << policy.liveMode;
+
+        m_bufferingPolicy = policy;
+
+        for (auto &[index, streamData] : m_streams) {
+            // Re-evaluate against the new limits from scratch
+            streamData.isDataLimitReached = false;
+            updateStreamDataLimitFlag(streamData);
+        }
+
+        scheduleNextStep();
+    });
+}
+
+BufferOccupancy Demuxer::bufferOccupancy() const
+{
+    return { m_bufferedDuration.loadRelaxed(), m_bufferedSize.loadRelaxed() };
+}
+
 void Demuxer::updateStreamDataLimitFlag(StreamData &streamData)
 {
     const auto packetsPosDiff = streamData.maxSentPacketsPos - streamData.maxProcessedPacketPos;
-    streamData.isDataLimitReached =
-           streamData.bufferedDuration >= MaxBufferedDurationUs
-        || (streamData.bufferedDuration == 0 && packetsPosDiff >= MaxBufferedDurationUs)
-        || streamData.bufferedSize >= MaxBufferedSize;
+    streamData.isDataLimitReached = m_bufferingPolicy.isLimitReached(
+            streamData.bufferedDuration, packetsPosDiff, streamData.bufferedSize,
+            streamData.isDataLimitReached);
+}
+
+void Demuxer::updateBufferOccupancy()
+{
+    qint64 duration = 0;
+    qint64 size = 0;
+    for (const auto &[index, streamData] : m_streams) {
+        duration = qMax(duration, streamData.bufferedDuration);
+        size += streamData.bufferedSize;
+    }
+
+    m_bufferedDuration.storeRelaxed(duration);
+    m_bufferedSize.storeRelaxed(size);
 }
 
 } // namespace QFFmpeg
@@ -18,6 +18,8 @@
 #include "private/qplatformmediaplayer_p.h"
 #include "playbackengine/qffmpegpacket_p.h"
 #include "playbackengine/qffmpegpositionwithoffset_p.h"
+#include "playbackengine/qffmpegbufferingpolicy_p.h"
+#include "playbackengine/qffmpegkeyframeindex_p.h"
 
 #include <unordered_map>
 
@@ -30,20 +32,24 @@ class Demuxer : public PlaybackEngineObject
     Q_OBJECT
 public:
     Demuxer(AVFormatContext *context, const PositionWithOffset &posWithOffset,
-            const StreamIndexes &streamIndexes, int loops);
-
-    using RequestingSignal = void (Demuxer::*)(Packet);
-    static RequestingSignal signalByTrackType(QPlatformMediaPlayer::TrackType trackType);
+            const StreamIndexes &streamIndexes, int loops,
+            const BufferingPolicy &bufferingPolicy = BufferingPolicy::defaultPolicy(),
+            std::shared_ptr<KeyframeIndex> keyframeIndex = {});
 
     void setLoops(int loopsCount);
 
+    void setPacketOutput(QPlatformMediaPlayer::TrackType trackType,
+                         DataChannelPtr<Packet> channel);
+
+    void setBufferingPolicy(const BufferingPolicy &policy);
+
+    // Can be called from any thread
+    BufferOccupancy bufferOccupancy() const;
+
 public slots:
     void onPacketProcessed(Packet);
 
 signals:
-    void requestProcessAudioPacket(Packet);
-    void requestProcessVideoPacket(Packet);
-    void requestProcessSubtitlePacket(Packet);
     void firstPacketFound(TimePoint tp, qint64 trackPos);
     void packetsBuffered();
 
@@ -54,6 +60,12 @@ private:
 
     void ensureSeeked();
 
+    // Seeks to the byte offset of a keyframe known from the index,
+    // which is faster than seeking by time stamp in media without an index
+    bool seekByKeyframeIndex(qint64 pos);
+
+    void addToKeyframeIndex(int streamIndex, const AVStream *stream, const AVPacket &packet);
+
 private:
     struct StreamData
     {
@@ -65,9 +77,13 @@ private:
         qint64 maxProcessedPacketPos = 0;
 
         bool isDataLimitReached = false;
+
+        // Of the last keyframe read since the latest seek
+        std::optional<qint64> lastKeyframePos;
     };
 
     void updateStreamDataLimitFlag(StreamData &streamData);
+    void updateBufferOccupancy();
 
 private:
     AVFormatContext *m_context = nullptr;
@@ -78,6 +94,11 @@ private:
     qint64 m_maxPacketsEndPos = 0;
     QAtomicInt m_loops = QMediaPlayer::Once;
     bool m_buffered = false;
+    BufferingPolicy m_bufferingPolicy;
+    QAtomicInteger<qint64> m_bufferedDuration = 0;
+    QAtomicInteger<qint64> m_bufferedSize = 0;
+    std::array<DataChannelPtr<Packet>, QPlatformMediaPlayer::NTrackTypes> m_packetOutputs;
+    std::shared_ptr<KeyframeIndex> m_keyframeIndex;
 };
 
 } // namespace QFFmpeg
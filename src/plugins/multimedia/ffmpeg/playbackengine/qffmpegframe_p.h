@@ -18,6 +18,7 @@
 #include "qffmpeg_p.h"
 #include "playbackengine/qffmpegcodec_p.h"
 #include "playbackengine/qffmpegpositionwithoffset_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
 #include "QtCore/qsharedpointer.h"
 #include "qpointer.h"
 #include "qobject.h"
@@ -30,7 +31,7 @@ namespace QFFmpeg {
 
 struct Frame
 {
-    struct Data
+    struct Data : PoolAllocated<Data>
     {
         Data(const LoopOffset &offset, AVFrameUPtr f, const Codec &codec, qint64, quint64 sourceId)
             : loopOffset(offset), codec(codec), frame(std::move(f)), sourceId(sourceId)
@@ -56,6 +57,7 @@ struct Frame
             : loopOffset(offset), text(text), pts(pts), duration(duration), sourceId(sourceId)
         {
         }
+        ~Data() { recycleAVFrame(std::move(frame)); }
 
         QAtomicInt ref;
         LoopOffset loopOffset;
@@ -92,6 +94,8 @@ struct Frame
     qint64 absolutePts() const { return pts() + loopOffset().pos; }
     qint64 absoluteEnd() const { return end() + loopOffset().pos; }
 
+    static PoolStatistics dataPoolStatistics() { return Data::poolStatistics(); }
+
 private:
     Data &data() const
     {
@@ -0,0 +1,181 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "playbackengine/qffmpegkeyframeindex_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+static Q_LOGGING_CATEGORY(qLcKeyframeIndex, "qt.multimedia.ffmpeg.keyframeindex");
+
+namespace {
+
+// Bounds the memory of the index; about 12 days of video with a keyframe per second
+constexpr size_t MaxKeyframesPerStream = 1 << 20;
+
+// Identifies the media content; a file replaced at the same url gets a new index
+struct MediaKey
+{
+    QUrl url;
+    qint64 size = -1;
+    QDateTime lastModified;
+
+    friend bool operator==(const MediaKey &a, const MediaKey &b)
+    {
+        return a.url == b.url && a.size == b.size && a.lastModified == b.lastModified;
+    }
+
+    friend size_t qHash(const MediaKey &key, size_t seed = 0)
+    {
+        return qHashMulti(seed, key.url, key.size, key.lastModified);
+    }
+};
+
+std::optional<MediaKey> mediaKey(const QUrl &url, qint64 mediaSize)
+{
+    if (url.isEmpty())
+        return {};
+
+    if (url.isLocalFile()) {
+        const QFileInfo info(url.toLocalFile());
+        if (!info.exists())
+            return {};
+        return MediaKey{ url, info.size(), info.lastModified() };
+    }
+
+    if (mediaSize < 0)
+        return {};
+
+    return MediaKey{ url, mediaSize, {} };
+}
+
+} // namespace
+
+SeekMode defaultSeekMode()
+{
+    static const SeekMode mode = [] {
+        const QByteArray name = qgetenv("QT_FFMPEG_PLAYBACK_SEEK_MODE");
+        if (name.isEmpty())
+            return SeekMode::Accurate;
+
+        const std::optional<SeekMode> mode = seekModeFromName(name);
+        if (!mode)
+            qCWarning(qLcKeyframeIndex) << "Unknown seek mode" << name;
+        return mode.value_or(SeekMode::Accurate);
+    }();
+
+    return mode;
+}
+
+std::optional<SeekMode> seekModeFromName(QByteArrayView name)
+{
+    if (name == "accurate")
+        return SeekMode::Accurate;
+    if (name == "fast")
+        return SeekMode::Fast;
+    return std::nullopt;
+}
+
+std::shared_ptr<KeyframeIndex> KeyframeIndex::forMedia(const QUrl &url, qint64 mediaSize)
+{
+    const std::optional<MediaKey> key = mediaKey(url, mediaSize);
+    if (!key)
+        return std::make_shared<KeyframeIndex>();
+
+    static QMutex mutex;
+    static QHash<MediaKey, std::weak_ptr<KeyframeIndex>> indexes;
+
+    QMutexLocker locker(&mutex);
+
+    if (auto index = indexes.value(*key).lock())
+        return index;
+
+    indexes.removeIf([](const auto &entry) { return entry.value().expired(); });
+
+    auto index = std::make_shared<KeyframeIndex>();
+    indexes.insert(*key, index);
+    return index;
+}
+
+void KeyframeIndex::addKeyframe(int streamIndex, const Keyframe &keyframe,
+                                std::optional<qint64> previousPos)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto &keyframes = m_streams[streamIndex];
+    if (keyframes.size() >= MaxKeyframesPerStream)
+        return;
+
+    auto [it, inserted] = keyframes.try_emplace(keyframe.pos, Entry{ keyframe.bytePos });
+    if (!inserted && it->second.bytePos < 0)
+        it->second.bytePos = keyframe.bytePos;
+
+    // The demuxer has read all packets since the previous keyframe,
+    // unless there is a keyframe it hasn't read in between.
+    if (previousPos && it != keyframes.begin() && std::prev(it)->first == *previousPos)
+        it->second.followsPrevious = true;
+}
+
+std::optional<std::pair<KeyframeIndex::StreamKeyframes::const_iterator,
+                        KeyframeIndex::StreamKeyframes::const_iterator>>
+KeyframeIndex::findInterval(const StreamKeyframes &keyframes, qint64 pos) const
+{
+    auto after = keyframes.upper_bound(pos);
+    if (after == keyframes.begin() || after == keyframes.end() || !after->second.followsPrevious)
+        return {};
+
+    return std::make_pair(std::prev(after), after);
+}
+
+std::optional<KeyframeIndex::Keyframe> KeyframeIndex::keyframeBefore(int streamIndex,
+                                                                     qint64 pos) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto stream = m_streams.find(streamIndex);
+    if (stream == m_streams.end())
+        return {};
+
+    const auto interval = findInterval(stream->second, pos);
+    if (!interval)
+        return {};
+
+    const auto before = interval->first;
+    return Keyframe{ before->first, before->second.bytePos };
+}
+
+std::optional<KeyframeIndex::Keyframe> KeyframeIndex::nearestKeyframe(int streamIndex,
+                                                                      qint64 pos) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto stream = m_streams.find(streamIndex);
+    if (stream == m_streams.end())
+        return {};
+
+    const auto interval = findInterval(stream->second, pos);
+    if (!interval)
+        return {};
+
+    const auto [before, after] = *interval;
+    const auto nearest = pos - before->first <= after->first - pos ? before : after;
+    return Keyframe{ nearest->first, nearest->second.bytePos };
+}
+
+qsizetype KeyframeIndex::keyframeCount(int streamIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto stream = m_streams.find(streamIndex);
+    return stream == m_streams.end() ? 0 : qsizetype(stream->second.size());
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGKEYFRAMEINDEX_P_H
+#define QFFMPEGKEYFRAMEINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qurl.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+enum class SeekMode {
+    Accurate, // to the requested position; decodes from the preceding keyframe
+    Fast,     // to the nearest keyframe if it's known from the index
+};
+
+// Accurate, can be overridden by QT_FFMPEG_PLAYBACK_SEEK_MODE set to accurate or fast
+SeekMode defaultSeekMode();
+
+// Parses accurate or fast; returns nullopt for an unknown name
+std::optional<SeekMode> seekModeFromName(QByteArrayView name);
+
+/*!
+    Thread-safe index of the keyframes of the media streams, mapping
+    the keyframe positions to their byte offsets.
+
+    The index is built lazily, from the container index if the media has one,
+    and from the keyframes the demuxer reads. Since the demuxer reads only
+    parts of the media, an interval between two neighboring keyframes is known
+    to contain no other keyframes only if the demuxer has read it through;
+    lookups succeed only within such intervals.
+ */
+class KeyframeIndex
+{
+public:
+    struct Keyframe
+    {
+        // us, stream time; the presentation time stamp, like the positions
+        // the player seeks to
+        qint64 pos = 0;
+        qint64 bytePos = -1; // -1 if unknown
+    };
+
+    // Shared between the players of the same media: the same url and size, and for
+    // local files, the same modification time. Media that cannot be identified,
+    // i.e. an empty url or a remote one with an unknown size, get a new index.
+    static std::shared_ptr<KeyframeIndex> forMedia(const QUrl &url, qint64 mediaSize);
+
+    // Adds a keyframe read by the demuxer; previousPos is the position of the previous
+    // keyframe of the stream the demuxer has read without seeking, if any.
+    void addKeyframe(int streamIndex, const Keyframe &keyframe,
+                     std::optional<qint64> previousPos = {});
+
+    // The keyframe at or before pos
+    std::optional<Keyframe> keyframeBefore(int streamIndex, qint64 pos) const;
+
+    // The keyframe closest to pos
+    std::optional<Keyframe> nearestKeyframe(int streamIndex, qint64 pos) const;
+
+    qsizetype keyframeCount(int streamIndex) const;
+
+private:
+    struct Entry
+    {
+        qint64 bytePos = -1;
+        bool followsPrevious = false; // no keyframes between the previous entry and this one
+    };
+
+    using StreamKeyframes = std::map<qint64, Entry>;
+
+    // The keyframes around pos, if the index is known to be complete there
+    std::optional<std::pair<StreamKeyframes::const_iterator, StreamKeyframes::const_iterator>>
+    findInterval(const StreamKeyframes &keyframes, qint64 pos) const;
+
+private:
+    mutable QMutex m_mutex;
+    std::unordered_map<int, StreamKeyframes> m_streams;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGKEYFRAMEINDEX_P_H
@@ -262,14 +262,21 @@ MediaDataHolder::Maybe MediaDataHolder::create(const QUrl &url, QIODevice *strea
     QMaybe context = loadMedia(url, stream, cancelToken);
     if (context) {
         // MediaDataHolder is wrapped in a shared pointer to interop with signal/slot mechanism
-        return QSharedPointer<MediaDataHolder>{ new MediaDataHolder{ std::move(context.value()), cancelToken } };
+        // Streams cannot be identified, so they don't share the keyframe index
+        const qint64 mediaSize = context.value()->pb ? avio_size(context.value()->pb) : -1;
+        auto keyframeIndex = KeyframeIndex::forMedia(stream ? QUrl() : url, mediaSize);
+        return QSharedPointer<MediaDataHolder>{ new MediaDataHolder{
+                std::move(context.value()), cancelToken, std::move(keyframeIndex) } };
     }
     return context.error();
 }
 
 MediaDataHolder::MediaDataHolder(AVFormatContextUPtr context,
-                                 const std::shared_ptr<ICancelToken> &cancelToken)
-    : m_cancelToken{ cancelToken }
+                                 const std::shared_ptr<ICancelToken> &cancelToken,
+                                 std::shared_ptr<KeyframeIndex> keyframeIndex)
+    : m_cancelToken{ cancelToken },
+      m_keyframeIndex{ keyframeIndex ? std::move(keyframeIndex)
+                                     : std::make_shared<KeyframeIndex>() }
 {
     Q_ASSERT(context);
 
@@ -324,6 +331,38 @@ MediaDataHolder::MediaDataHolder(AVFormatContextUPtr context,
     }
 
     updateMetaData();
+    addContainerKeyframes();
+}
+
+void MediaDataHolder::addContainerKeyframes()
+{
+#if QT_FFMPEG_HAS_AVFORMAT_INDEX_GET_ENTRY
+    // The index entries available after opening come either from the container's own index
+    // or from the packets probed from the start, so they have no gaps between them.
+    for (const StreamInfo &info : std::as_const(m_streamMap[QPlatformMediaPlayer::VideoStream])) {
+        AVStream *stream = m_context->streams[info.avStreamIndex];
+        const int count = avformat_index_get_entries_count(stream);
+        if (count <= 0 || m_keyframeIndex->keyframeCount(info.avStreamIndex) > 0)
+            continue;
+
+        std::optional<qint64> previousPos;
+        for (int i = 0; i < count; ++i) {
+            const AVIndexEntry *entry = avformat_index_get_entry(stream, i);
+            if (!entry || !(entry->flags & AVINDEX_KEYFRAME))
+                continue;
+
+            const auto pos = timeStampUs(entry->timestamp, stream->time_base);
+            if (!pos)
+                continue;
+
+            m_keyframeIndex->addKeyframe(info.avStreamIndex, { *pos, entry->pos }, previousPos);
+            previousPos = *pos;
+        }
+
+        qCDebug(qLcMediaDataHolder) << "Container keyframes of stream" << info.avStreamIndex << ":"
+                                    << m_keyframeIndex->keyframeCount(info.avStreamIndex);
+    }
+#endif
 }
 
 namespace {
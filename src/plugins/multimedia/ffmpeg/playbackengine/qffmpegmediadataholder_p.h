@@ -19,6 +19,7 @@
 #include "private/qplatformmediaplayer_p.h"
 #include "qffmpeg_p.h"
 #include "qvideoframe.h"
+#include "playbackengine/qffmpegkeyframeindex_p.h"
 #include <private/qmultimediautils_p.h>
 
 #include <array>
@@ -56,7 +57,8 @@ public:
     using StreamIndexes = std::array<int, QPlatformMediaPlayer::NTrackTypes>;
 
     MediaDataHolder() = default;
-    MediaDataHolder(AVFormatContextUPtr context, const std::shared_ptr<ICancelToken> &cancelToken);
+    MediaDataHolder(AVFormatContextUPtr context, const std::shared_ptr<ICancelToken> &cancelToken,
+                    std::shared_ptr<KeyframeIndex> keyframeIndex = {});
 
     static QPlatformMediaPlayer::TrackType trackTypeFromMediaType(int mediaType);
 
@@ -72,6 +74,9 @@ public:
 
     VideoTransformation transformation() const;
 
+    // Shared with the other players of the same url
+    const std::shared_ptr<KeyframeIndex> &keyframeIndex() const { return m_keyframeIndex; }
+
     AVFormatContext *avContext();
 
     int currentStreamIndex(QPlatformMediaPlayer::TrackType trackType) const;
@@ -85,6 +90,8 @@ public:
 private:
     void updateMetaData();
 
+    void addContainerKeyframes();
+
     std::shared_ptr<ICancelToken> m_cancelToken; // NOTE: Cancel token may be accessed by
                                                  // AVFormatContext during destruction and
                                                  // must outlive the context object
@@ -98,6 +105,7 @@ private:
     qint64 m_duration = 0;
     QMediaMetaData m_metaData;
     std::optional<QImage> m_cachedThumbnail;
+    std::shared_ptr<KeyframeIndex> m_keyframeIndex;
 };
 
 } // namespace QFFmpeg
@@ -0,0 +1,118 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "playbackengine/qffmpegobjectpool_p.h"
+
+#include <algorithm>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+namespace {
+
+constexpr int DefaultMaxIdlePoolObjects = 128;
+
+using AVPacketPool = RecyclingPool<AVPacket, AVPacketUPtr::deleter_type>;
+using AVFramePool = RecyclingPool<AVFrame, AVFrameUPtr::deleter_type>;
+
+// Intentionally leaked: objects might be recycled during static destruction
+AVPacketPool &avPacketPool()
+{
+    static auto *pool = new AVPacketPool;
+    return *pool;
+}
+
+AVFramePool &avFramePool()
+{
+    static auto *pool = new AVFramePool;
+    return *pool;
+}
+
+} // namespace
+
+int defaultMaxIdlePoolObjects()
+{
+    static const int size = [] {
+        bool ok = false;
+        const int size = qEnvironmentVariableIntValue("QT_FFMPEG_OBJECT_POOL_SIZE", &ok);
+        return ok ? qMax(size, 0) : DefaultMaxIdlePoolObjects;
+    }();
+    return size;
+}
+
+AVPacketUPtr acquireAVPacket()
+{
+    return avPacketPool().acquire([]() { return AVPacketUPtr(av_packet_alloc()); });
+}
+
+void recycleAVPacket(AVPacketUPtr packet)
+{
+    if (!packet)
+        return;
+
+    av_packet_unref(packet.get());
+    avPacketPool().recycle(std::move(packet));
+}
+
+PoolStatistics avPacketPoolStatistics()
+{
+    return avPacketPool().statistics();
+}
+
+AVFrameUPtr acquireAVFrame()
+{
+    return avFramePool().acquire([]() { return makeAVFrame(); });
+}
+
+void recycleAVFrame(AVFrameUPtr frame)
+{
+    if (!frame)
+        return;
+
+    av_frame_unref(frame.get());
+    avFramePool().recycle(std::move(frame));
+}
+
+PoolStatistics avFramePoolStatistics()
+{
+    return avFramePool().statistics();
+}
+
+QByteArray ByteArrayPool::take(qsizetype size)
+{
+    // An array no longer referenced by the consumers is only referenced by the pool
+    auto it = std::find_if(m_tracked.begin(), m_tracked.end(),
+                           [](const QByteArray &data) { return data.isDetached(); });
+
+    if (it == m_tracked.end())
+        return QByteArray(size, Qt::Uninitialized);
+
+    // isDetached() reads the reference count relaxed. The consumer may have
+    // released its copy in another thread, so synchronize with that release
+    // before the buffer is reused for writing; otherwise the consumer's last
+    // reads of the data could race with our writes.
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    QByteArray data = std::move(*it);
+    m_tracked.erase(it);
+
+    data.resize(size);
+    return data;
+}
+
+void ByteArrayPool::track(const QByteArray &data)
+{
+    if (data.isEmpty() || m_maxTracked <= 0)
+        return;
+
+    if (static_cast<int>(m_tracked.size()) >= m_maxTracked)
+        m_tracked.erase(m_tracked.begin());
+
+    m_tracked.push_back(data);
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
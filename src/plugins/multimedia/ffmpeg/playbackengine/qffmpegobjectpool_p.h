@@ -0,0 +1,182 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGOBJECTPOOL_P_H
+#define QFFMPEGOBJECTPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qffmpeg_p.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qmutex.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+struct PoolStatistics
+{
+    quint64 created = 0; // objects that had to be allocated
+    quint64 reused = 0;  // objects taken from the pool
+    quint64 dropped = 0; // recycled objects freed because the pool was full
+    int idle = 0;
+};
+
+// The maximum number of idle objects per pool,
+// can be overridden by QT_FFMPEG_OBJECT_POOL_SIZE; 0 disables pooling.
+int defaultMaxIdlePoolObjects();
+
+/*!
+    Thread-safe bounded free list of recycled objects.
+
+    The playback engine passes packets and frames between threads at
+    a high rate, so the objects are usually created on one thread and
+    freed on another one; thus, a shared pool rather than per-thread caches.
+    In steady state, statistics().created stops growing.
+ */
+template <typename T, typename Deleter = std::default_delete<T>>
+class RecyclingPool
+{
+public:
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    explicit RecyclingPool(int maxIdle = defaultMaxIdlePoolObjects()) : m_maxIdle(maxIdle) { }
+
+    template <typename Create>
+    Ptr acquire(Create &&create)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!m_idle.empty()) {
+                Ptr result = std::move(m_idle.back());
+                m_idle.pop_back();
+                ++m_statistics.reused;
+                return result;
+            }
+
+            ++m_statistics.created;
+        }
+
+        return create();
+    }
+
+    // The object must be reset by the caller
+    void recycle(Ptr object)
+    {
+        if (!object)
+            return;
+
+        QMutexLocker locker(&m_mutex);
+        if (static_cast<int>(m_idle.size()) >= m_maxIdle) {
+            ++m_statistics.dropped;
+            locker.unlock();
+            return; // object gets freed outside the lock
+        }
+
+        m_idle.push_back(std::move(object));
+    }
+
+    PoolStatistics statistics() const
+    {
+        QMutexLocker locker(&m_mutex);
+        PoolStatistics result = m_statistics;
+        result.idle = static_cast<int>(m_idle.size());
+        return result;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    std::vector<Ptr> m_idle;
+    const int m_maxIdle;
+    PoolStatistics m_statistics;
+};
+
+// Packets and frames are reset before they go back to the pool
+AVPacketUPtr acquireAVPacket();
+void recycleAVPacket(AVPacketUPtr packet);
+PoolStatistics avPacketPoolStatistics();
+
+AVFrameUPtr acquireAVFrame();
+void recycleAVFrame(AVFrameUPtr frame);
+PoolStatistics avFramePoolStatistics();
+
+/*!
+    Base class that makes the memory of T come from a RecyclingPool,
+    which suits small ref-counted objects with a high churn rate.
+ */
+template <typename T>
+struct PoolAllocated
+{
+    static void *operator new(std::size_t size)
+    {
+        Q_ASSERT(size == sizeof(T));
+        Q_UNUSED(size);
+        return pool().acquire([]() { return std::make_unique<Block>(); }).release();
+    }
+
+    static void operator delete(void *ptr)
+    {
+        pool().recycle(std::unique_ptr<Block>(static_cast<Block *>(ptr)));
+    }
+
+    static PoolStatistics poolStatistics() { return pool().statistics(); }
+
+private:
+    struct Block
+    {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    static RecyclingPool<Block> &pool()
+    {
+        // Intentionally leaked: objects might be freed during static destruction
+        static auto *pool = new RecyclingPool<Block>;
+        return *pool;
+    }
+};
+
+/*!
+    Recycles the data of the buffers a producer hands out, e.g. the samples
+    of QAudioBuffers: a tracked QByteArray can be reused once the consumers
+    have released it, i.e. when the pool holds its only reference.
+
+    Unlike RecyclingPool, it's not thread-safe; only the producer uses it.
+ */
+class ByteArrayPool
+{
+public:
+    explicit ByteArrayPool(int maxTracked) : m_maxTracked(maxTracked) { }
+
+    // A released array resized to size, keeping its allocation if it suffices, or a new one
+    QByteArray take(qsizetype size);
+
+    // Tracks the array handed out; the oldest one is forgotten if the pool is full
+    void track(const QByteArray &data);
+
+    void clear() { m_tracked.clear(); }
+    int trackedCount() const { return static_cast<int>(m_tracked.size()); }
+
+private:
+    std::vector<QByteArray> m_tracked;
+    const int m_maxTracked;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGOBJECTPOOL_P_H
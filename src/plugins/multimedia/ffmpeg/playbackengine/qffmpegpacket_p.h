@@ -18,6 +18,7 @@
 #include "qffmpeg_p.h"
 #include "QtCore/qsharedpointer.h"
 #include "playbackengine/qffmpegpositionwithoffset_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -25,12 +26,13 @@ namespace QFFmpeg {
 
 struct Packet
 {
-    struct Data
+    struct Data : PoolAllocated<Data>
     {
         Data(const LoopOffset &offset, AVPacketUPtr p, quint64 sourceId)
             : loopOffset(offset), packet(std::move(p)), sourceId(sourceId)
         {
         }
+        ~Data() { recycleAVPacket(std::move(packet)); }
 
         QAtomicInt ref;
         LoopOffset loopOffset;
@@ -48,6 +50,8 @@ struct Packet
     const LoopOffset &loopOffset() const { return d->loopOffset; }
     quint64 sourceId() const { return d->sourceId; }
 
+    static PoolStatistics dataPoolStatistics() { return Data::poolStatistics(); }
+
 private:
     QExplicitlySharedDataPointer<Data> d;
 };
@@ -15,6 +15,7 @@
 //
 
 #include "playbackengine/qffmpegplaybackenginedefs_p.h"
+#include "playbackengine/qffmpegdatachannel_p.h"
 #include "qthread.h"
 #include "qatomic.h"
 
@@ -66,6 +67,15 @@ protected:
 
     virtual void doNextStep() { }
 
+    // Sets the channel in the object's thread, after the events posted before
+    template <typename T>
+    void setOutputChannel(DataChannelPtr<T> &output, DataChannelPtr<T> channel)
+    {
+        QMetaObject::invokeMethod(this, [&output, channel = std::move(channel)]() mutable {
+            output = std::move(channel);
+        });
+    }
+
 private slots:
     void onTimeout();
 
@@ -80,6 +80,17 @@ void Renderer::setInitialPosition(TimePoint tp, qint64 trackPos)
     });
 }
 
+void Renderer::setProcessedFrameOutput(DataChannelPtr<Frame> channel)
+{
+    setOutputChannel(m_processedFrameOutput, std::move(channel));
+}
+
+void Renderer::notifyFrameProcessed(const Frame &frame)
+{
+    if (m_processedFrameOutput)
+        m_processedFrameOutput->push(frame);
+}
+
 void Renderer::onFinalFrameReceived()
 {
     render({});
@@ -92,7 +103,7 @@ void Renderer::render(Frame frame)
     if (isFrameOutdated) {
         qCDebug(qLcRenderer) << "frame outdated! absEnd:" << frame.absoluteEnd() << "absPts"
                              << frame.absolutePts() << "seekPos:" << seekPosition();
-        emit frameProcessed(frame);
+        notifyFrameProcessed(frame);
         return;
     }
 
@@ -182,7 +193,7 @@ void Renderer::doNextStep()
                 emit loopChanged(id(), frame.loopOffset().pos, m_loopIndex);
             }
 
-            emit frameProcessed(frame);
+            notifyFrameProcessed(frame);
         } else {
             m_lastPosition.storeRelease(std::max(m_lastFrameEnd, lastPosition()));
         }
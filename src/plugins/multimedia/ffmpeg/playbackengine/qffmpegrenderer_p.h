@@ -46,6 +46,8 @@ public:
 
     bool isStepForced() const;
 
+    void setProcessedFrameOutput(DataChannelPtr<Frame> channel);
+
 public slots:
     void setInitialPosition(TimePoint tp, qint64 trackPos);
 
@@ -54,8 +56,6 @@ public slots:
     void render(Frame);
 
 signals:
-    void frameProcessed(Frame);
-
     void synchronized(Id id, TimePoint tp, qint64 pos);
 
     void forceStepDone();
@@ -105,6 +105,8 @@ protected:
 private:
     void doNextStep() override;
 
+    void notifyFrameProcessed(const Frame &frame);
+
 private:
     TimeController m_timeController;
     qint64 m_lastFrameEnd = 0;
@@ -116,6 +118,8 @@ private:
 
     QAtomicInteger<bool> m_isStepForced = false;
     std::optional<TimePoint> m_explicitNextFrameTime;
+
+    DataChannelPtr<Frame> m_processedFrameOutput;
 };
 
 } // namespace QFFmpeg
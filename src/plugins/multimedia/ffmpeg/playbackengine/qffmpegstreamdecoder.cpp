@@ -67,8 +67,8 @@ void StreamDecoder::doNextStep()
 
     setAtEnd(!packet.isValid());
 
-    if (packet.isValid())
-        emit packetProcessed(packet);
+    if (packet.isValid() && m_processedPacketOutput)
+        m_processedPacketOutput->push(packet);
 
     scheduleNextStep(false);
 }
@@ -78,6 +78,16 @@ QPlatformMediaPlayer::TrackType StreamDecoder::trackType() const
     return m_trackType;
 }
 
+void StreamDecoder::setFrameOutput(DataChannelPtr<Frame> channel)
+{
+    setOutputChannel(m_frameOutput, std::move(channel));
+}
+
+void StreamDecoder::setProcessedPacketOutput(DataChannelPtr<Packet> channel)
+{
+    setOutputChannel(m_processedPacketOutput, std::move(channel));
+}
+
 qint32 StreamDecoder::maxQueueSize(QPlatformMediaPlayer::TrackType type)
 {
     switch (type) {
@@ -119,7 +129,9 @@ void StreamDecoder::onFrameFound(Frame frame)
 
     Q_ASSERT(m_pendingFramesCount >= 0);
     ++m_pendingFramesCount;
-    emit requestHandleFrame(frame);
+
+    if (m_frameOutput)
+        m_frameOutput->push(frame);
 }
 
 void StreamDecoder::decodeMedia(Packet packet)
@@ -145,13 +157,33 @@ void StreamDecoder::decodeMedia(Packet packet)
 
 int StreamDecoder::sendAVPacket(Packet packet)
 {
+    if (m_trackType == QPlatformMediaPlayer::VideoStream && packet.isValid())
+        updateSkipFrame(packet);
+
     return avcodec_send_packet(m_codec.context(), packet.isValid() ? packet.avPacket() : nullptr);
 }
 
+void StreamDecoder::updateSkipFrame(const Packet &packet)
+{
+    // After seeking, the frames before the seek position are decoded only to be dropped
+    // in onFrameFound. The non-reference ones are not needed to decode the others either,
+    // so the decoder may skip them.
+    const AVPacket &avPacket = *packet.avPacket();
+    const bool isBeforeSeekPos = avPacket.pts != AV_NOPTS_VALUE && avPacket.duration > 0
+            && packet.loopOffset().pos + m_codec.toUs(avPacket.pts + avPacket.duration)
+                    < m_absSeekPos;
+
+    m_codec.context()->skip_frame = isBeforeSeekPos ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+}
+
 void StreamDecoder::receiveAVFrames(bool flushPacket)
 {
+    // A frame that hasn't been filled is reused in the next iteration
+    AVFrameUPtr avFrame;
+
     while (true) {
-        auto avFrame = makeAVFrame();
+        if (!avFrame)
+            avFrame = acquireAVFrame();
 
         const auto receiveFrameResult = avcodec_receive_frame(m_codec.context(), avFrame.get());
 
@@ -184,6 +216,8 @@ void StreamDecoder::receiveAVFrames(bool flushPacket)
 
         onFrameFound({ m_offset, std::move(avFrame), m_codec, 0, id() });
     }
+
+    recycleAVFrame(std::move(avFrame));
 }
 
 void StreamDecoder::decodeSubtitle(Packet packet)
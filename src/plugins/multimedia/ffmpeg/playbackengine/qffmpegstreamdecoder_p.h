@@ -38,6 +38,10 @@ public:
     // Maximum number of frames that we are allowed to keep in render queue
     static qint32 maxQueueSize(QPlatformMediaPlayer::TrackType type);
 
+    void setFrameOutput(DataChannelPtr<Frame> channel);
+
+    void setProcessedPacketOutput(DataChannelPtr<Packet> channel);
+
 public slots:
     void setInitialPosition(TimePoint tp, qint64 trackPos);
 
@@ -47,11 +51,6 @@ public slots:
 
     void onFrameProcessed(Frame frame);
 
-signals:
-    void requestHandleFrame(Frame frame);
-
-    void packetProcessed(Packet);
-
 protected:
     bool canDoNextStep() const override;
 
@@ -66,6 +65,8 @@ private:
 
     int sendAVPacket(Packet);
 
+    void updateSkipFrame(const Packet &packet);
+
     void receiveAVFrames(bool flushPacket = false);
 
 private:
@@ -78,6 +79,9 @@ private:
     LoopOffset m_offset;
 
     QQueue<Packet> m_packets;
+
+    DataChannelPtr<Frame> m_frameOutput;
+    DataChannelPtr<Packet> m_processedPacketOutput;
 };
 
 } // namespace QFFmpeg
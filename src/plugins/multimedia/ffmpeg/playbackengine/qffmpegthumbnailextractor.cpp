@@ -0,0 +1,288 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "playbackengine/qffmpegthumbnailextractor_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
+#include "qffmpegswscontextcache_p.h"
+
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qtransform.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+static Q_LOGGING_CATEGORY(qLcThumbnailExtractor, "qt.multimedia.ffmpeg.thumbnailextractor");
+
+namespace {
+
+// Decoders support up to 1/8 of the size, if at all
+constexpr int MaxLowres = 3;
+
+QSize targetSize(const QSize &frameSize, const QSize &maxSize)
+{
+    if (maxSize.isEmpty() || (frameSize.width() <= maxSize.width()
+                              && frameSize.height() <= maxSize.height()))
+        return frameSize;
+
+    return frameSize.scaled(maxSize, Qt::KeepAspectRatio).expandedTo({ 1, 1 });
+}
+
+// The largest downscaling by the decoder that keeps the frames not smaller than the target
+int lowresFor(const QSize &frameSize, const QSize &maxSize)
+{
+    const QSize target = targetSize(frameSize, maxSize);
+
+    int lowres = 0;
+    while (lowres < MaxLowres && (frameSize.width() >> (lowres + 1)) >= target.width()
+           && (frameSize.height() >> (lowres + 1)) >= target.height())
+        ++lowres;
+
+    return lowres;
+}
+
+QImage transformed(QImage image, const VideoTransformation &transformation)
+{
+    if (transformation.rotation != QtVideo::Rotation::None)
+        image = image.transformed(QTransform().rotate(qToUnderlying(transformation.rotation)));
+
+    if (transformation.mirrorredHorizontallyAfterRotation)
+        image = image.mirrored(true, false);
+
+    return image;
+}
+
+} // namespace
+
+QMaybe<QList<Thumbnail>>
+ThumbnailExtractor::extract(const QUrl &url, const ThumbnailRequest &request,
+                            const std::shared_ptr<ICancelToken> &cancelToken)
+{
+    auto media = MediaDataHolder::create(url, nullptr, cancelToken);
+    if (!media)
+        return media.error().description;
+
+    QSharedPointer<MediaDataHolder> holder = media.value();
+    const int streamIndex = holder->currentStreamIndex(QPlatformMediaPlayer::VideoStream);
+    if (streamIndex < 0)
+        return QStringLiteral("No video stream");
+
+    AVFormatContext *context = holder->avContext();
+    AVStream *stream = context->streams[streamIndex];
+
+    // The other streams aren't read at all
+    for (unsigned i = 0; i < context->nb_streams; ++i)
+        context->streams[i]->discard = int(i) == streamIndex ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+
+    const QSize frameSize(stream->codecpar->width, stream->codecpar->height);
+    auto codec = Codec::createSoftware(stream, context, lowresFor(frameSize, request.maxSize));
+    if (!codec)
+        return codec.error();
+
+    qCDebug(qLcThumbnailExtractor) << "Extracting thumbnails from" << url << "frame size"
+                                   << frameSize << "lowres" << codec.value().context()->lowres;
+
+    ThumbnailExtractor extractor(std::move(holder), codec.value(), streamIndex, request);
+
+    QList<Thumbnail> result;
+    for (qint64 pos : extractor.positions()) {
+        if (cancelToken && cancelToken->isCancelled())
+            break;
+
+        AVFrameUPtr frame = extractor.decodeFrame(pos);
+        if (!frame)
+            continue;
+
+        Thumbnail thumbnail{ codec.value().toUs(frame->best_effort_timestamp),
+                             extractor.toImage(frame.get()) };
+        recycleAVFrame(std::move(frame));
+
+        if (!thumbnail.image.isNull())
+            result.append(std::move(thumbnail));
+    }
+
+    return result;
+}
+
+QFuture<QList<Thumbnail>>
+ThumbnailExtractor::extractAsync(const QUrl &url, const ThumbnailRequest &request,
+                                 const std::shared_ptr<ICancelToken> &cancelToken)
+{
+    return QtConcurrent::run(threadPool(), [url, request, cancelToken]() {
+        auto thumbnails = extract(url, request, cancelToken);
+        if (!thumbnails) {
+            qCWarning(qLcThumbnailExtractor)
+                    << "Cannot extract thumbnails from" << url << ":" << thumbnails.error();
+            return QList<Thumbnail>{};
+        }
+
+        return thumbnails.value();
+    });
+}
+
+QThreadPool *ThumbnailExtractor::threadPool()
+{
+    static QThreadPool *pool = [] {
+        auto pool = new QThreadPool;
+        pool->setObjectName(QLatin1String("ThumbnailExtractor"));
+
+        bool ok = false;
+        const int threads = qEnvironmentVariableIntValue("QT_FFMPEG_THUMBNAIL_THREADS", &ok);
+        // The decoders are multithreaded themselves, thus, fewer threads than cores
+        pool->setMaxThreadCount(ok && threads > 0 ? threads
+                                                  : qMax(1, QThread::idealThreadCount() / 2));
+        return pool;
+    }();
+
+    return pool;
+}
+
+ThumbnailExtractor::ThumbnailExtractor(QSharedPointer<MediaDataHolder> media, Codec codec,
+                                       int streamIndex, const ThumbnailRequest &request)
+    : m_media(std::move(media)),
+      m_codec(std::move(codec)),
+      m_streamIndex(streamIndex),
+      m_request(request)
+{
+}
+
+QList<qint64> ThumbnailExtractor::positions() const
+{
+    if (!m_request.positions.empty())
+        return m_request.positions;
+
+    const qint64 duration = m_media->duration();
+    const int count = qMax(m_request.count, 1);
+
+    // The middle of each of count equal intervals, so that the intro and
+    // the credits don't get too many thumbnails
+    QList<qint64> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i)
+        result.append(duration * (2 * i + 1) / (2 * count));
+
+    return result;
+}
+
+AVFrameUPtr ThumbnailExtractor::decodeFrame(qint64 pos)
+{
+    AVFormatContext *context = m_media->avContext();
+    AVCodecContext *codecContext = m_codec.context();
+    const bool keyframesOnly = m_request.mode == ThumbnailRequest::Keyframes;
+
+    const qint64 seekPos = pos * AV_TIME_BASE / 1000000;
+    if (av_seek_frame(context, -1, seekPos, AVSEEK_FLAG_BACKWARD) < 0)
+        qCDebug(qLcThumbnailExtractor) << "Failed to seek, pos" << seekPos;
+
+    avcodec_flush_buffers(codecContext);
+    codecContext->skip_frame = keyframesOnly ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+
+    AVPacketUPtr packet = acquireAVPacket();
+    AVFrameUPtr frame = acquireAVFrame();
+    AVFrameUPtr previous;
+
+    // Returns the frame to show at pos, if it's decoded
+    auto receiveFrames = [&]() -> AVFrameUPtr {
+        while (avcodec_receive_frame(codecContext, frame.get()) >= 0) {
+            if (keyframesOnly)
+                return std::move(frame);
+
+            const qint64 framePos = m_codec.toUs(frame->best_effort_timestamp);
+            if (framePos == pos)
+                return std::move(frame);
+
+            if (framePos > pos)
+                return previous ? std::move(previous) : std::move(frame);
+
+            std::swap(previous, frame);
+            if (frame)
+                av_frame_unref(frame.get());
+            else
+                frame = acquireAVFrame();
+        }
+
+        return nullptr;
+    };
+
+    AVFrameUPtr result;
+    while (!result && av_read_frame(context, packet.get()) >= 0) {
+        if (packet->stream_index == m_streamIndex) {
+            // The frames before pos are needed only as references
+            if (!keyframesOnly) {
+                const bool beforePos = packet->pts != AV_NOPTS_VALUE
+                        && m_codec.toUs(packet->pts + packet->duration) <= pos;
+                codecContext->skip_frame = beforePos ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+            }
+
+            if (avcodec_send_packet(codecContext, packet.get()) >= 0)
+                result = receiveFrames();
+        }
+
+        av_packet_unref(packet.get());
+    }
+
+    if (!result) {
+        // The end of the stream; take the frames buffered by the decoder
+        avcodec_send_packet(codecContext, nullptr);
+        result = receiveFrames();
+        if (!result && previous)
+            result = std::move(previous);
+    }
+
+    recycleAVPacket(std::move(packet));
+    if (frame)
+        recycleAVFrame(std::move(frame));
+    if (previous)
+        recycleAVFrame(std::move(previous));
+
+    return result;
+}
+
+QImage ThumbnailExtractor::toImage(AVFrame *frame) const
+{
+    const QSize frameSize(frame->width, frame->height);
+    if (frameSize.isEmpty())
+        return {};
+
+    // Apply the pixel aspect ratio so that the image has square pixels
+    const AVRational pixelAspectRatio = m_codec.pixelAspectRatio(frame);
+    QSize displaySize = frameSize;
+    if (pixelAspectRatio.num > 0 && pixelAspectRatio.den > 0)
+        displaySize.setWidth(qMax(1, int(qint64(frameSize.width()) * pixelAspectRatio.num
+                                         / pixelAspectRatio.den)));
+
+    // The rotation swaps the bounds
+    const VideoTransformation transformation = m_media->transformation();
+    QSize maxSize = m_request.maxSize;
+    if (transformation.rotationIndex() % 2 != 0)
+        maxSize.transpose();
+
+    const QSize size = targetSize(displaySize, maxSize);
+
+    SwsContextKey key;
+    key.srcSize = frameSize;
+    key.srcPixFmt = AVPixelFormat(frame->format);
+    key.dstSize = size;
+    key.dstPixFmt = AV_PIX_FMT_RGB32; // the memory layout of QImage::Format_ARGB32
+    key.conversionType = SWS_BILINEAR;
+    const SwsContextCache::Handle scaleContext = SwsContextCache::instance().acquire(key);
+    if (!scaleContext) {
+        qCWarning(qLcThumbnailExtractor) << "Cannot convert the frame from"
+                                         << av_get_pix_fmt_name(key.srcPixFmt);
+        return {};
+    }
+
+    QImage image(size, QImage::Format_ARGB32);
+    uint8_t *const dstData[] = { image.bits() };
+    const int dstLinesize[] = { int(image.bytesPerLine()) };
+    sws_scale(scaleContext.get(), frame->data, frame->linesize, 0, frame->height, dstData,
+              dstLinesize);
+
+    return transformed(std::move(image), transformation);
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGTHUMBNAILEXTRACTOR_P_H
+#define QFFMPEGTHUMBNAILEXTRACTOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "playbackengine/qffmpegcodec_p.h"
+#include "playbackengine/qffmpegmediadataholder_p.h"
+
+#include <QtCore/qfuture.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qsize.h>
+#include <QtCore/qurl.h>
+#include <QtGui/qimage.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+
+namespace QFFmpeg {
+
+struct ThumbnailRequest
+{
+    enum Mode {
+        Keyframes, // the keyframe at or before each position; decodes keyframes only
+        Exact,     // the frame displayed at each position
+    };
+
+    QList<qint64> positions; // us; if empty, count positions spread evenly over the duration
+    int count = 1;
+    QSize maxSize; // the thumbnails fit into it keeping the aspect ratio; empty for the frame size
+    Mode mode = Keyframes;
+};
+
+struct Thumbnail
+{
+    qint64 pos = 0; // us, the position of the extracted frame
+    QImage image;
+};
+
+/*!
+    Extracts thumbnails from the video stream of a media without playing it back:
+    there are no renderers and no clock, and only the video stream is demuxed and decoded.
+
+    Frames are decoded in software, since only a few of them are needed; if the requested
+    size is much smaller than the frame size, the decoder downscales the frames
+    (lowres) if it supports that, and swscale does the rest.
+ */
+class ThumbnailExtractor
+{
+public:
+    // Synchronous; can be called from any thread.
+    static QMaybe<QList<Thumbnail>> extract(const QUrl &url, const ThumbnailRequest &request,
+                                            const std::shared_ptr<ICancelToken> &cancelToken = {});
+
+    // Runs extract() on threadPool(), so that the thumbnails of several media
+    // are extracted in parallel. The result is empty if the extraction fails.
+    static QFuture<QList<Thumbnail>>
+    extractAsync(const QUrl &url, const ThumbnailRequest &request,
+                 const std::shared_ptr<ICancelToken> &cancelToken = {});
+
+    // A dedicated pool so that the extraction doesn't occupy the global one;
+    // the thread count can be overridden by QT_FFMPEG_THUMBNAIL_THREADS.
+    static QThreadPool *threadPool();
+
+private:
+    ThumbnailExtractor(QSharedPointer<MediaDataHolder> media, Codec codec, int streamIndex,
+                       const ThumbnailRequest &request);
+
+    QList<qint64> positions() const;
+
+    // Decodes the frame for the position; a null pointer if there is none
+    AVFrameUPtr decodeFrame(qint64 pos);
+
+    QImage toImage(AVFrame *frame) const;
+
+private:
+    QSharedPointer<MediaDataHolder> m_media;
+    Codec m_codec;
+    int m_streamIndex = -1;
+    ThumbnailRequest m_request;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGTHUMBNAILEXTRACTOR_P_H
@@ -0,0 +1,149 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qffmpegasyncwriter_p.h"
+#include "qffmpegdefs_p.h"
+#include "qiodevice.h"
+#include "QtCore/qloggingcategory.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+static Q_LOGGING_CATEGORY(qLcAsyncWriter, "qt.multimedia.ffmpeg.asyncwriter");
+
+namespace {
+
+constexpr int DefaultBufferSize = 1024 * 1024;
+
+// Enough to absorb a short stall of the storage without blocking the muxer
+constexpr size_t MaxPendingBlocks = 8;
+
+} // namespace
+
+AsyncWriter::AsyncWriter(QIODevice *device) : m_device(device)
+{
+    Q_ASSERT(device);
+    setObjectName(QLatin1String("AsyncWriter"));
+}
+
+int AsyncWriter::bufferSize()
+{
+    static const int size = [] {
+        bool ok = false;
+        const int size = qEnvironmentVariableIntValue("QT_FFMPEG_ENCODING_IO_BUFFER_SIZE", &ok);
+        // av_malloc aligns the buffer, keep its size a multiple of the page size
+        return ok && size > 0 ? (size + 4095) & ~4095 : DefaultBufferSize;
+    }();
+    return size;
+}
+
+int AsyncWriter::writeCallback(void *opaque, AvioWriteBufferType buf, int buf_size)
+{
+    auto writer = static_cast<AsyncWriter *>(opaque);
+    Q_ASSERT(writer);
+
+    return writer->write(buf, buf_size);
+}
+
+int64_t AsyncWriter::seekCallback(void *opaque, int64_t offset, int whence)
+{
+    auto writer = static_cast<AsyncWriter *>(opaque);
+    Q_ASSERT(writer);
+
+    return writer->seek(offset, whence);
+}
+
+int AsyncWriter::write(const uint8_t *buf, int size)
+{
+    {
+        auto locker = lockLoopData();
+        waitForPendingBlocks(locker, MaxPendingBlocks - 1);
+
+        if (m_error)
+            return AVERROR(EIO);
+
+        // The AVIOContext reuses its buffer, thus, a copy
+        m_blocks.emplace_back(reinterpret_cast<const char *>(buf), size);
+    }
+
+    dataReady();
+    return size;
+}
+
+int64_t AsyncWriter::seek(int64_t offset, int whence)
+{
+    // The device is accessed by the writer thread until the pending blocks are written
+    auto locker = lockLoopData();
+    waitForPendingBlocks(locker, 0);
+
+    if (m_error)
+        return AVERROR(EIO);
+
+    return seekQIODevice(m_device, offset, whence);
+}
+
+bool AsyncWriter::flush()
+{
+    auto locker = lockLoopData();
+    waitForPendingBlocks(locker, 0);
+    return !m_error;
+}
+
+void AsyncWriter::waitForPendingBlocks(QMutexLocker<QMutex> &locker, size_t maxPendingBlocks)
+{
+    while (!m_error && (m_blocks.size() > maxPendingBlocks || (maxPendingBlocks == 0 && m_writing)))
+        m_blockWrittenCondition.wait(locker.mutex());
+}
+
+bool AsyncWriter::init()
+{
+    qCDebug(qLcAsyncWriter) << "AsyncWriter::init started thread, buffer size:" << bufferSize();
+    return true;
+}
+
+void AsyncWriter::cleanup()
+{
+    while (hasData())
+        processOne();
+}
+
+bool AsyncWriter::hasData() const
+{
+    return !m_blocks.empty() && !m_error;
+}
+
+void AsyncWriter::processOne()
+{
+    QByteArray block;
+
+    {
+        auto locker = lockLoopData();
+        if (m_blocks.empty())
+            return;
+
+        block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        m_writing = true;
+    }
+
+    const bool written = m_device->write(block) == block.size();
+
+    {
+        auto locker = lockLoopData();
+        m_writing = false;
+
+        if (!written) {
+            qCWarning(qLcAsyncWriter) << "Cannot write to the output device:"
+                                      << m_device->errorString();
+            m_error = true;
+            m_blocks.clear();
+        }
+
+        m_blockWrittenCondition.wakeAll();
+    }
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,83 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGASYNCWRITER_P_H
+#define QFFMPEGASYNCWRITER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qffmpegthread_p.h"
+#include "qffmpegioutils_p.h"
+
+#include <QtCore/qbytearray.h>
+
+#include <deque>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+namespace QFFmpeg {
+
+/*!
+    Writes the data coming from an AVIOContext to a QIODevice on a dedicated thread,
+    so that the muxer doesn't wait for slow storage.
+
+    The AVIOContext is expected to have a large buffer, so the device receives
+    a few big writes rather than many small ones. The number of blocks in flight
+    is limited; if the device cannot keep up, write() blocks.
+    Seeking waits until the pending blocks have been written.
+ */
+class AsyncWriter : public ConsumerThread
+{
+public:
+    explicit AsyncWriter(QIODevice *device);
+
+    // The buffer size for the AVIOContext, can be overridden by QT_FFMPEG_ENCODING_IO_BUFFER_SIZE
+    static int bufferSize();
+
+    // AVIO callbacks, the opaque pointer must be an AsyncWriter
+    static int writeCallback(void *opaque, AvioWriteBufferType buf, int buf_size);
+    static int64_t seekCallback(void *opaque, int64_t offset, int whence);
+
+    // Waits until the pending blocks have been written;
+    // returns false if writing to the device has failed.
+    bool flush();
+
+private:
+    int write(const uint8_t *buf, int size);
+    int64_t seek(int64_t offset, int whence);
+
+    // To be called with the loop data locked
+    void waitForPendingBlocks(QMutexLocker<QMutex> &locker, size_t maxPendingBlocks);
+
+    bool init() override;
+    void cleanup() override;
+    bool hasData() const override;
+    void processOne() override;
+
+private:
+    QIODevice *m_device = nullptr;
+
+    // Protected by the loop data mutex
+    std::deque<QByteArray> m_blocks;
+    bool m_writing = false;
+    bool m_error = false;
+
+    QWaitCondition m_blockWrittenCondition;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGASYNCWRITER_P_H
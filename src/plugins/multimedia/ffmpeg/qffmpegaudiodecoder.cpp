@@ -127,25 +127,22 @@ void QFFmpegAudioDecoder::start()
         positionChanged(-1);
 
         m_decoder.reset();
+        m_bulkDecoder.reset();
 
         return false;
     };
 
-    m_decoder = std::make_unique<AudioDecoder>(m_audioFormat);
-    connect(m_decoder.get(), &AudioDecoder::errorOccured, this, &QFFmpegAudioDecoder::errorSignal);
-    connect(m_decoder.get(), &AudioDecoder::endOfStream, this, &QFFmpegAudioDecoder::done);
-    connect(m_decoder.get(), &AudioDecoder::newAudioBuffer, this,
-            &QFFmpegAudioDecoder::newAudioBuffer);
-
     QFFmpeg::MediaDataHolder::Maybe media = QFFmpeg::MediaDataHolder::create(m_url, m_sourceDevice, nullptr);
 
     if (media) {
         Q_ASSERT(media.value());
-        if (media.value()->streamInfo(QPlatformMediaPlayer::AudioStream).isEmpty())
+        if (media.value()->streamInfo(QPlatformMediaPlayer::AudioStream).isEmpty()) {
             error(QAudioDecoder::FormatError,
                   QLatin1String("The media doesn't contain an audio stream"));
-        else
-            m_decoder->setMedia(std::move(*media.value()));
+        } else if (m_decodingOptions.mode == QFFmpeg::AudioDecodingOptions::Bulk) {
+            startBulkDecoding(media.value());
+            return;
+        }
     } else {
         auto [code, description] = media.error();
         errorSignal(code, description);
@@ -154,6 +151,14 @@ void QFFmpegAudioDecoder::start()
     if (!checkNoError())
         return;
 
+    m_decoder = std::make_unique<AudioDecoder>(m_audioFormat);
+    connect(m_decoder.get(), &AudioDecoder::errorOccured, this, &QFFmpegAudioDecoder::errorSignal);
+    connect(m_decoder.get(), &AudioDecoder::endOfStream, this, &QFFmpegAudioDecoder::done);
+    connect(m_decoder.get(), &AudioDecoder::newAudioBuffer, this,
+            &QFFmpegAudioDecoder::newAudioBuffer);
+
+    m_decoder->setMedia(std::move(*media.value()));
+
     m_decoder->setState(QMediaPlayer::PausedState);
     if (!checkNoError())
         return;
@@ -166,11 +171,67 @@ void QFFmpegAudioDecoder::start()
     setIsDecoding(true);
 }
 
+void QFFmpegAudioDecoder::startBulkDecoding(QSharedPointer<QFFmpeg::MediaDataHolder> media)
+{
+    if (!m_bulkOutput)
+        m_bulkOutput = QFFmpeg::DataChannel<QFFmpeg::BulkAudioDecoderOutput>::create(
+                this, &QFFmpegAudioDecoder::onBulkDecoderOutput);
+
+    const qint64 duration = media->duration();
+
+    m_bulkEndOfStream = false;
+    m_bulkDecoder.reset(new BulkAudioDecoder(std::move(media), m_audioFormat, m_decodingOptions,
+                                             m_bulkOutput, ++m_bulkSession));
+    m_bulkDecoder->start();
+
+    durationChanged(duration / 1000);
+    setIsDecoding(true);
+}
+
+void QFFmpegAudioDecoder::onBulkDecoderOutput(QFFmpeg::BulkAudioDecoderOutput output)
+{
+    if (output.session != m_bulkSession || !m_bulkDecoder)
+        return;
+
+    if (output.error != QMediaPlayer::NoError) {
+        errorSignal(output.error, output.errorString);
+        durationChanged(-1);
+        positionChanged(-1);
+        m_bulkDecoder.reset();
+        m_bulkBuffers.clear();
+        return;
+    }
+
+    if (output.buffer.isValid())
+        m_bulkBuffers.push_back(std::move(output.buffer));
+
+    m_bulkEndOfStream |= output.endOfStream;
+
+    deliverBulkBuffer();
+}
+
+void QFFmpegAudioDecoder::deliverBulkBuffer()
+{
+    if (!m_bulkDecoder || m_audioBuffer.isValid())
+        return;
+
+    if (!m_bulkBuffers.empty()) {
+        QAudioBuffer buffer = std::move(m_bulkBuffers.front());
+        m_bulkBuffers.pop_front();
+        newAudioBuffer(buffer);
+    } else if (m_bulkEndOfStream) {
+        m_bulkDecoder.reset();
+        done();
+    }
+}
+
 void QFFmpegAudioDecoder::stop()
 {
     qCDebug(qLcAudioDecoder) << ">>>>> stop";
-    if (m_decoder) {
+    m_bulkBuffers.clear();
+    if (m_decoder || m_bulkDecoder) {
         m_decoder.reset();
+        m_bulkDecoder.reset();
         done();
     }
 }
@@ -195,9 +256,22 @@ QAudioBuffer QFFmpegAudioDecoder::read()
     bufferAvailableChanged(false);
     if (m_decoder)
         m_decoder->nextBuffer();
+
+    if (m_bulkDecoder) {
+        m_bulkDecoder->bufferConsumed();
+        // Not synchronously, since read() is typically called from a slot of bufferReady
+        QMetaObject::invokeMethod(this, &QFFmpegAudioDecoder::deliverBulkBuffer,
+                                  Qt::QueuedConnection);
+    }
+
     return buffer;
 }
 
+void QFFmpegAudioDecoder::setDecodingOptions(const QFFmpeg::AudioDecodingOptions &options)
+{
+    m_decodingOptions = options;
+}
+
 void QFFmpegAudioDecoder::newAudioBuffer(const QAudioBuffer &b)
 {
     Q_ASSERT(b.isValid());
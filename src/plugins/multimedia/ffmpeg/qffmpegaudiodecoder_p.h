@@ -17,8 +17,11 @@
 
 #include "private/qplatformaudiodecoder_p.h"
 #include <qffmpeg_p.h>
+#include "qffmpegbulkaudiodecoder_p.h"
 #include <qurl.h>
 
+#include <deque>
+
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg {
@@ -47,6 +50,10 @@ public:
 
     QAudioBuffer read() override;
 
+    // Applied on the next start()
+    void setDecodingOptions(const QFFmpeg::AudioDecodingOptions &options);
+    QFFmpeg::AudioDecodingOptions decodingOptions() const { return m_decodingOptions; }
+
 public Q_SLOTS:
     void newAudioBuffer(const QAudioBuffer &b);
     void done();
@@ -54,6 +61,11 @@ public Q_SLOTS:
 
 private:
     using AudioDecoder = QFFmpeg::AudioDecoder;
+    using BulkAudioDecoder = QFFmpeg::BulkAudioDecoder;
+
+    void startBulkDecoding(QSharedPointer<QFFmpeg::MediaDataHolder> media);
+    void onBulkDecoderOutput(QFFmpeg::BulkAudioDecoderOutput output);
+    void deliverBulkBuffer();
 
     QUrl m_url;
     QIODevice *m_sourceDevice = nullptr;
@@ -61,6 +73,14 @@ private:
     QAudioFormat m_audioFormat;
 
     QAudioBuffer m_audioBuffer;
+
+    QFFmpeg::AudioDecodingOptions m_decodingOptions =
+            QFFmpeg::AudioDecodingOptions::defaultOptions();
+    QFFmpeg::ConsumerThreadUPtr<BulkAudioDecoder> m_bulkDecoder;
+    QFFmpeg::DataChannelPtr<QFFmpeg::BulkAudioDecoderOutput> m_bulkOutput;
+    quint64 m_bulkSession = 0; // outputs of the stopped decoders are ignored
+    std::deque<QAudioBuffer> m_bulkBuffers;
+    bool m_bulkEndOfStream = false;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,256 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qffmpegbulkaudiodecoder_p.h"
+#include "qffmpegmediaformatinfo_p.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtMultimedia/qmediaplayer.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+static Q_LOGGING_CATEGORY(qLcBulkAudioDecoder, "qt.multimedia.ffmpeg.bulkaudiodecoder");
+
+AudioDecodingOptions AudioDecodingOptions::defaultOptions()
+{
+    static const AudioDecodingOptions options = [] {
+        AudioDecodingOptions options;
+
+        const QByteArray mode = qgetenv("QT_FFMPEG_AUDIO_DECODER_MODE");
+        if (mode == "bulk")
+            options.mode = Bulk;
+        else if (!mode.isEmpty() && mode != "stepping")
+            qCWarning(qLcBulkAudioDecoder) << "Unknown audio decoder mode" << mode;
+
+        bool ok = false;
+        const int durationMs =
+                qEnvironmentVariableIntValue("QT_FFMPEG_AUDIO_DECODER_BUFFER_DURATION_MS", &ok);
+        if (ok && durationMs > 0)
+            options.bufferDurationUs = durationMs * qint64(1000);
+
+        return options;
+    }();
+
+    return options;
+}
+
+BulkAudioDecoder::BulkAudioDecoder(QSharedPointer<MediaDataHolder> media,
+                                   const QAudioFormat &format,
+                                   const AudioDecodingOptions &options,
+                                   DataChannelPtr<BulkAudioDecoderOutput> output, quint64 session)
+    : m_media(std::move(media)),
+      m_format(format),
+      m_options(options),
+      m_output(std::move(output)),
+      m_session(session),
+      // The queued buffers, the one being read and the one the reader is about to release
+      m_bufferPool(options.maxQueuedBuffers + 2)
+{
+    Q_ASSERT(m_media);
+    Q_ASSERT(m_output);
+    setObjectName(QLatin1String("BulkAudioDecoder"));
+}
+
+BulkAudioDecoder::~BulkAudioDecoder() = default;
+
+void BulkAudioDecoder::bufferConsumed()
+{
+    {
+        auto locker = lockLoopData();
+        Q_ASSERT(m_queuedBuffers > 0);
+        --m_queuedBuffers;
+    }
+
+    dataReady();
+}
+
+bool BulkAudioDecoder::init()
+{
+    m_streamIndex = m_media->currentStreamIndex(QPlatformMediaPlayer::AudioStream);
+    AVFormatContext *context = m_media->avContext();
+    if (m_streamIndex < 0) {
+        reportError(QLatin1String("The media doesn't contain an audio stream"));
+        return false;
+    }
+
+    // Only the audio stream is demuxed
+    for (unsigned i = 0; i < context->nb_streams; ++i)
+        context->streams[i]->discard =
+                int(i) == m_streamIndex ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+
+    AVStream *stream = context->streams[m_streamIndex];
+    auto codec = Codec::create(stream, context);
+    if (!codec) {
+        reportError(codec.error());
+        return false;
+    }
+    m_codec = codec.value();
+
+    if (!m_format.isValid())
+        // want the native format
+        m_format = QFFmpegMediaFormatInfo::audioFormatFromCodecParameters(stream->codecpar);
+
+    m_resampler = createResampleContext(AVAudioFormat(stream->codecpar), AVAudioFormat(m_format));
+    if (!m_resampler) {
+        reportError(QLatin1String("Cannot create the audio resampler"));
+        return false;
+    }
+
+    m_packet = AVPacketUPtr(av_packet_alloc());
+    m_frame = makeAVFrame();
+
+    qCDebug(qLcBulkAudioDecoder) << "BulkAudioDecoder::init started thread, buffer duration:"
+                                 << m_options.bufferDurationUs << "format:" << m_format;
+    return true;
+}
+
+void BulkAudioDecoder::cleanup()
+{
+    // The buffers which are still being read keep their data
+    m_bufferPool.clear();
+}
+
+bool BulkAudioDecoder::hasData() const
+{
+    return !m_finished && m_queuedBuffers < m_options.maxQueuedBuffers;
+}
+
+void BulkAudioDecoder::processOne()
+{
+    BulkAudioDecoderOutput output;
+    output.session = m_session;
+    output.buffer = decodeBuffer();
+
+    // An error has been reported instead
+    if (m_failed)
+        return;
+
+    if (!output.buffer.isValid() && !m_finished)
+        return;
+
+    output.endOfStream = m_finished;
+
+    {
+        auto locker = lockLoopData();
+        if (output.buffer.isValid())
+            ++m_queuedBuffers;
+    }
+
+    m_output->push(std::move(output));
+}
+
+bool BulkAudioDecoder::receiveFrame()
+{
+    AVCodecContext *codecContext = m_codec->context();
+
+    while (true) {
+        const int receiveResult = avcodec_receive_frame(codecContext, m_frame.get());
+        if (receiveResult >= 0)
+            return true;
+
+        if (receiveResult == AVERROR_EOF)
+            return false;
+
+        if (receiveResult != AVERROR(EAGAIN)) {
+            reportError(err2str(receiveResult));
+            return false;
+        }
+
+        if (m_demuxerAtEnd)
+            return false;
+
+        if (av_read_frame(m_media->avContext(), m_packet.get()) < 0) {
+            m_demuxerAtEnd = true;
+            avcodec_send_packet(codecContext, nullptr);
+            continue;
+        }
+
+        if (m_packet->stream_index == m_streamIndex) {
+            const int sendResult = avcodec_send_packet(codecContext, m_packet.get());
+            if (sendResult < 0 && sendResult != AVERROR(EAGAIN))
+                qCDebug(qLcBulkAudioDecoder) << "Dropped an audio packet:" << err2str(sendResult);
+        }
+
+        av_packet_unref(m_packet.get());
+    }
+}
+
+QAudioBuffer BulkAudioDecoder::decodeBuffer()
+{
+    const int targetFrames = qMax(m_format.framesForDuration(m_options.bufferDurationUs), 1);
+    QByteArray data = m_bufferPool.take(m_format.bytesForFrames(targetFrames));
+    int capacity = targetFrames;
+    int written = 0;
+
+    auto ensureCapacity = [&](int frames) {
+        if (written + frames > capacity) {
+            capacity = written + frames;
+            data.resize(m_format.bytesForFrames(capacity));
+        }
+    };
+
+    auto convert = [&](const uint8_t **input, int inputFrames) {
+        ensureCapacity(swr_get_out_samples(m_resampler.get(), inputFrames));
+        auto *out = reinterpret_cast<uint8_t *>(data.data()) + m_format.bytesForFrames(written);
+        const int converted =
+                swr_convert(m_resampler.get(), &out, capacity - written, input, inputFrames);
+        if (converted > 0)
+            written += converted;
+    };
+
+    while (written < targetFrames) {
+        if (!m_hasFrame)
+            m_hasFrame = receiveFrame();
+
+        if (m_failed) {
+            m_finished = true;
+            return {};
+        }
+
+        if (!m_hasFrame) {
+            // Take the samples buffered by the resampler
+            convert(nullptr, 0);
+            m_finished = true;
+            break;
+        }
+
+        // Don't exceed the target size unless a single frame does
+        const int frameOutput = swr_get_out_samples(m_resampler.get(), m_frame->nb_samples);
+        if (written > 0 && written + frameOutput > targetFrames)
+            break;
+
+        convert(const_cast<const uint8_t **>(m_frame->extended_data), m_frame->nb_samples);
+        av_frame_unref(m_frame.get());
+        m_hasFrame = false;
+    }
+
+    if (written == 0)
+        return {};
+
+    data.resize(m_format.bytesForFrames(written));
+    m_bufferPool.track(data);
+
+    const qint64 startTime = m_format.durationForFrames(m_framesDecoded);
+    m_framesDecoded += written;
+
+    return QAudioBuffer(data, m_format, startTime);
+}
+
+void BulkAudioDecoder::reportError(const QString &errorString)
+{
+    qCWarning(qLcBulkAudioDecoder) << errorString;
+
+    m_failed = true;
+
+    BulkAudioDecoderOutput output;
+    output.session = m_session;
+    output.error = QMediaPlayer::FormatError;
+    output.errorString = errorString;
+    m_output->push(std::move(output));
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
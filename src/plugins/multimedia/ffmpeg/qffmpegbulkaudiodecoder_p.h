@@ -0,0 +1,126 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QFFMPEGBULKAUDIODECODER_P_H
+#define QFFMPEGBULKAUDIODECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qffmpegthread_p.h"
+#include "playbackengine/qffmpegcodec_p.h"
+#include "playbackengine/qffmpegdatachannel_p.h"
+#include "playbackengine/qffmpegmediadataholder_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
+
+#include <QtMultimedia/qaudiobuffer.h>
+#include <QtMultimedia/qaudioformat.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+struct AudioDecodingOptions
+{
+    enum Mode {
+        // Decodes a buffer per codec frame on the playback engine, when the previous one is read
+        Stepping,
+        // Decodes ahead on a worker thread into large buffers, as fast as they are read
+        Bulk,
+    };
+
+    Mode mode = Stepping;
+
+    // Bulk mode only: the duration of the emitted buffers, and how many of them
+    // may be decoded ahead of the reader.
+    qint64 bufferDurationUs = 1'000'000;
+    int maxQueuedBuffers = 4;
+
+    // The defaults, which can be overridden by the environment variables
+    // QT_FFMPEG_AUDIO_DECODER_MODE (stepping or bulk) and
+    // QT_FFMPEG_AUDIO_DECODER_BUFFER_DURATION_MS.
+    static AudioDecodingOptions defaultOptions();
+};
+
+// A result of the bulk decoder: a buffer, the end of the stream, or an error
+struct BulkAudioDecoderOutput
+{
+    quint64 session = 0;
+    QAudioBuffer buffer;
+    bool endOfStream = false;
+    int error = 0; // QMediaPlayer::Error
+    QString errorString;
+};
+
+/*!
+    Decodes the audio stream of a media on a dedicated thread, without the
+    playback engine: the packets go from the demuxer straight to the decoder and
+    the resampler, which writes into large pooled buffers; each buffer collects
+    the samples of many codec frames.
+
+    Up to maxQueuedBuffers buffers are decoded ahead; bufferConsumed()
+    makes room for the next one.
+ */
+class BulkAudioDecoder : public ConsumerThread
+{
+public:
+    BulkAudioDecoder(QSharedPointer<MediaDataHolder> media, const QAudioFormat &format,
+                     const AudioDecodingOptions &options,
+                     DataChannelPtr<BulkAudioDecoderOutput> output, quint64 session);
+    ~BulkAudioDecoder() override;
+
+    // Can be called from any thread
+    void bufferConsumed();
+
+private:
+    bool init() override;
+    void cleanup() override;
+    bool hasData() const override;
+    void processOne() override;
+
+    // Decodes the next frame into m_frame; false at the end of the stream or on an error
+    bool receiveFrame();
+
+    // Fills a buffer with the samples of the next frames
+    QAudioBuffer decodeBuffer();
+
+    void reportError(const QString &errorString);
+
+private:
+    QSharedPointer<MediaDataHolder> m_media;
+    QAudioFormat m_format;
+    AudioDecodingOptions m_options;
+    DataChannelPtr<BulkAudioDecoderOutput> m_output;
+    quint64 m_session = 0;
+
+    int m_streamIndex = -1;
+    std::optional<Codec> m_codec;
+    SwrContextUPtr m_resampler;
+    AVPacketUPtr m_packet;
+    AVFrameUPtr m_frame;
+    bool m_hasFrame = false;
+    bool m_demuxerAtEnd = false;
+    bool m_finished = false;
+    bool m_failed = false;
+    qint64 m_framesDecoded = 0;
+
+    // The data of the buffers handed out; once the reader releases a buffer, its data is reused
+    ByteArrayPool m_bufferPool;
+
+    // Protected by the loop data mutex
+    int m_queuedBuffers = 0;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGBULKAUDIODECODER_P_H
@@ -3,6 +3,7 @@
 
 #include "qffmpegconverter_p.h"
 #include "qffmpeg_p.h"
+#include "qffmpegswscontextcache_p.h"
 #include <QtMultimedia/qvideoframeformat.h>
 #include <QtMultimedia/qvideoframe.h>
 #include <QtCore/qloggingcategory.h>
@@ -148,28 +149,25 @@ using PixelFormat = QVideoFrameFormat::PixelFormat;
 
 // clang-format off
 
-QFFmpeg::SwsContextUPtr createConverter(const QSize &srcSize, PixelFormat srcPixFmt,
-                               const QSize &dstSize, PixelFormat dstPixFmt)
-{
-    return QFFmpeg::createSwsContext(srcSize, toAVPixelFormat(srcPixFmt), dstSize, toAVPixelFormat(dstPixFmt), SWS_BILINEAR);
-}
-
-bool setColorSpaceDetails(SwsContext *context,
-                          const QVideoFrameFormat &srcFormat,
-                          const QVideoFrameFormat &dstFormat)
+QFFmpeg::SwsContextCache::Handle acquireConverter(const QSize &size,
+                                                 const QVideoFrameFormat &srcFormat,
+                                                 const QVideoFrameFormat &dstFormat)
 {
     const SwsColorSpace src = toSwsColorSpace(srcFormat.colorRange(), srcFormat.colorSpace());
     const SwsColorSpace dst = toSwsColorSpace(dstFormat.colorRange(), dstFormat.colorSpace());
 
-    constexpr int brightness = 0;
-    constexpr int contrast = 0;
-    constexpr int saturation = 0;
-    const int status = sws_setColorspaceDetails(context,
-        sws_getCoefficients(src.colorSpace), src.colorRange,
-        sws_getCoefficients(dst.colorSpace), dst.colorRange,
-        brightness, contrast, saturation);
-
-    return status == 0;
+    QFFmpeg::SwsContextKey key;
+    key.srcSize = size;
+    key.srcPixFmt = toAVPixelFormat(srcFormat.pixelFormat());
+    key.dstSize = size;
+    key.dstPixFmt = toAVPixelFormat(dstFormat.pixelFormat());
+    key.conversionType = SWS_BILINEAR;
+    key.srcColorSpace = src.colorSpace;
+    key.srcColorRange = src.colorRange;
+    key.dstColorSpace = dst.colorSpace;
+    key.dstColorRange = dst.colorRange;
+
+    return QFFmpeg::SwsContextCache::instance().acquire(key);
 }
 
 bool convert(SwsContext *context, QVideoFrame &src, int srcHeight, QVideoFrame &dst)
@@ -239,19 +237,14 @@ QVideoFrame convertFrame(QVideoFrame &src, const QVideoFrameFormat &dstFormat)
     if (size != src.size())
         qCWarning(lc) << "Input truncated to even width/height";
 
-    const QFFmpeg::SwsContextUPtr conv = createConverter(
-        size, src.pixelFormat(), size, dstFormat.pixelFormat());
+    const QFFmpeg::SwsContextCache::Handle conv =
+        acquireConverter(size, src.surfaceFormat(), dstFormat);
 
     if (!conv) {
         qCCritical(lc) << "Failed to create SW converter";
         return {};
     }
 
-    if (!setColorSpaceDetails(conv.get(), src.surfaceFormat(), dstFormat)) {
-        qCCritical(lc) << "Failed to set color space details";
-        return {};
-    }
-
     QVideoFrame dst{ dstFormat };
 
     if (!convert(conv.get(), src, size.height(), dst)) {
@@ -48,6 +48,8 @@ extern "C" {
     (LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(60, 11, 100)) // since FFmpeg n6.1
 #define QT_FFMPEG_HAS_AVCODEC_GET_SUPPORTED_CONFIG \
     (LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(59, 39, 100)) // since FFmpeg n7.1
+#define QT_FFMPEG_HAS_AVFORMAT_INDEX_GET_ENTRY \
+    (LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)) // since FFmpeg n4.4
 
 QT_BEGIN_NAMESPACE
 
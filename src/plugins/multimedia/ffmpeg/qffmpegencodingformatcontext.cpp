@@ -4,9 +4,16 @@
 #include "qffmpegencodingformatcontext_p.h"
 #include "qffmpegmediaformatinfo_p.h"
 #include "qffmpegioutils_p.h"
+#include "qffmpegasyncwriter_p.h"
 #include "qfile.h"
 #include "QtCore/qloggingcategory.h"
 
+#ifdef Q_OS_LINUX
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <cerrno>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg {
@@ -17,6 +24,54 @@ namespace {
 // In the example https://ffmpeg.org/doxygen/trunk/avio_read_callback_8c-example.html,
 // BufferSize = 4096 is suggested, however, it might be not optimal. To be investigated.
 constexpr size_t DefaultBufferSize = 4096;
+
+// Writing local files on a dedicated thread with a large buffer;
+// enabled by QT_FFMPEG_ENCODING_ASYNC_IO.
+bool isAsyncWritingEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_FFMPEG_ENCODING_ASYNC_IO");
+    return enabled;
+}
+
+// Reserves the disk space for the output file, which reduces the fragmentation and
+// the metadata updates of the file system; set by QT_FFMPEG_ENCODING_PREALLOCATE_SIZE.
+// Returns true if the space has been reserved.
+bool preallocate(QFile &file)
+{
+#ifdef Q_OS_LINUX
+    static const qint64 size =
+            qEnvironmentVariable("QT_FFMPEG_ENCODING_PREALLOCATE_SIZE").toLongLong();
+    if (size <= 0)
+        return false;
+
+    // Keep the file size, so that the file isn't longer than the data if recording crashes
+    if (fallocate(file.handle(), FALLOC_FL_KEEP_SIZE, 0, size) != 0) {
+        qCDebug(qLcEncodingFormatContext) << "Cannot preallocate" << size << "bytes for"
+                                          << file.fileName() << ", error:" << errno;
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED(file);
+    return false;
+#endif
+}
+
+// The blocks reserved beyond the written data stay allocated to the file
+// until it's truncated to its size
+void releasePreallocatedSpace(QFile &file)
+{
+#ifdef Q_OS_LINUX
+    file.flush();
+    if (ftruncate(file.handle(), file.size()) != 0)
+        qCDebug(qLcEncodingFormatContext)
+                << "Cannot release the preallocated space of" << file.fileName()
+                << ", error:" << errno;
+#else
+    Q_UNUSED(file);
+#endif
+}
 } // namespace
 
 EncodingFormatContext::EncodingFormatContext(QMediaFormat::FileFormat fileFormat)
@@ -38,6 +93,12 @@ void EncodingFormatContext::openAVIO(const QString &filePath)
     Q_ASSERT(!isAVIOOpen());
     Q_ASSERT(!filePath.isEmpty());
 
+    if (isAsyncWritingEnabled()) {
+        openAVIOWithQFile(filePath);
+        if (isAVIOOpen())
+            return;
+    }
+
     const QByteArray filePathUtf8 = filePath.toUtf8();
 
     std::unique_ptr<char, decltype(&av_free)> url(
@@ -71,10 +132,23 @@ void EncodingFormatContext::openAVIOWithQFile(const QString &filePath)
         return;
     }
 
-    openAVIO(file.get());
+    bool preallocated = false;
+    if (isAsyncWritingEnabled()) {
+        preallocated = preallocate(*file);
+        openAVIOWithAsyncWriter(file.get());
+    } else {
+        openAVIO(file.get());
+    }
 
-    if (isAVIOOpen())
-        m_outputFile = std::move(file);
+    if (!isAVIOOpen())
+        return;
+
+    // Muxers may reopen the output by the url, e.g. to move the index to the front
+    Q_ASSERT(m_avFormatContext->url == nullptr);
+    m_avFormatContext->url = av_strdup(filePath.toUtf8().constData());
+
+    m_outputFile = std::move(file);
+    m_outputFilePreallocated = preallocated;
 }
 
 void EncodingFormatContext::openAVIO(QIODevice *device)
@@ -88,27 +162,73 @@ void EncodingFormatContext::openAVIO(QIODevice *device)
     auto buffer = static_cast<uint8_t *>(av_malloc(DefaultBufferSize));
     m_avFormatContext->pb = avio_alloc_context(buffer, DefaultBufferSize, 1, device, nullptr,
                                                &writeQIODevice, &seekQIODevice);
+    if (isAVIOOpen())
+        m_avFormatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
 }
 
-void EncodingFormatContext::closeAVIO()
+void EncodingFormatContext::openAVIOWithAsyncWriter(QIODevice *device)
+{
+    Q_ASSERT(!isAVIOOpen());
+    Q_ASSERT(device);
+
+    if (!device->isWritable())
+        return;
+
+    ConsumerThreadUPtr<AsyncWriter> writer(new AsyncWriter(device));
+
+    const int bufferSize = AsyncWriter::bufferSize();
+    auto buffer = static_cast<uint8_t *>(av_malloc(bufferSize));
+    m_avFormatContext->pb =
+            avio_alloc_context(buffer, bufferSize, 1, writer.get(), nullptr,
+                               &AsyncWriter::writeCallback, &AsyncWriter::seekCallback);
+    if (!isAVIOOpen()) {
+        av_free(buffer);
+        return;
+    }
+
+    m_avFormatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+    writer->start();
+    m_asyncWriter = std::move(writer);
+}
+
+bool EncodingFormatContext::closeAVIO()
 {
     // Close the AVIOContext and release any file handles
-    if (isAVIOOpen()) {
-        if (m_avFormatContext->url && *m_avFormatContext->url != '\0') {
-            auto closeResult = avio_closep(&m_avFormatContext->pb);
-            Q_ASSERT(closeResult == 0);
-        } else {
-            av_free(std::exchange(m_avFormatContext->pb->buffer, nullptr));
-            avio_context_free(&m_avFormatContext->pb);
+    if (!isAVIOOpen()) {
+        Q_ASSERT(!m_outputFile);
+        return true;
+    }
+
+    bool written = true;
+    if (m_avFormatContext->flags & AVFMT_FLAG_CUSTOM_IO) {
+        avio_flush(m_avFormatContext->pb);
+        written = m_avFormatContext->pb->error >= 0;
+
+        if (m_asyncWriter) {
+            // The writer gets the buffered data with the flush above
+            written = m_asyncWriter->flush() && written;
+            m_asyncWriter.reset();
         }
 
-        // delete url even though it might be delete by avformat_free_context to
-        // ensure consistency in openAVIO/closeAVIO.
-        av_freep(&m_avFormatContext->url);
-        m_outputFile.reset();
+        av_free(std::exchange(m_avFormatContext->pb->buffer, nullptr));
+        avio_context_free(&m_avFormatContext->pb);
+        m_avFormatContext->flags &= ~AVFMT_FLAG_CUSTOM_IO;
     } else {
-        Q_ASSERT(!m_outputFile);
+        written = avio_closep(&m_avFormatContext->pb) == 0;
     }
+
+    if (!written)
+        qCWarning(qLcEncodingFormatContext) << "Cannot write the data to the output";
+
+    // delete url even though it might be delete by avformat_free_context to
+    // ensure consistency in openAVIO/closeAVIO.
+    av_freep(&m_avFormatContext->url);
+
+    if (m_outputFile && std::exchange(m_outputFilePreallocated, false))
+        releasePreallocatedSpace(*m_outputFile);
+    m_outputFile.reset();
+
+    return written;
 }
 
 } // namespace QFFmpeg
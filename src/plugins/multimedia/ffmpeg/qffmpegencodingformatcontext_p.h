@@ -5,6 +5,7 @@
 #define QFFMPEGENCODINGFORMATCONTEXT_P_H
 
 #include "qffmpegdefs_p.h"
+#include "qffmpegthread_p.h"
 #include "qmediaformat.h"
 
 //
@@ -25,6 +26,8 @@ class QFile;
 
 namespace QFFmpeg {
 
+class AsyncWriter;
+
 class EncodingFormatContext
 {
 public:
@@ -37,7 +40,8 @@ public:
 
     bool isAVIOOpen() const { return m_avFormatContext->pb != nullptr; }
 
-    void closeAVIO();
+    // Returns false if not all the data could be written to the output
+    bool closeAVIO();
 
     AVFormatContext *avFormatContext() { return m_avFormatContext; }
 
@@ -48,9 +52,13 @@ private:
 
     void openAVIOWithQFile(const QString &filePath);
 
+    void openAVIOWithAsyncWriter(QIODevice *device);
+
 private:
     AVFormatContext *m_avFormatContext;
     std::unique_ptr<QFile> m_outputFile;
+    bool m_outputFilePreallocated = false;
+    ConsumerThreadUPtr<AsyncWriter> m_asyncWriter;
 };
 
 } // namespace QFFmpeg
@@ -1,7 +1,6 @@
 // Copyright (C) 2021 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
-#include <QtMultimedia/private/qplatformmediaplugin_p.h>
 #include <qcameradevice.h>
 #include "qffmpegmediaintegration_p.h"
 #include "qffmpegmediaformatinfo_p.h"
@@ -70,24 +69,6 @@ extern "C" {
 
 QT_BEGIN_NAMESPACE
 
-class QFFmpegMediaPlugin : public QPlatformMediaPlugin
-{
-    Q_OBJECT
-    Q_PLUGIN_METADATA(IID QPlatformMediaPlugin_iid FILE "ffmpeg.json")
-
-public:
-    QFFmpegMediaPlugin()
-      : QPlatformMediaPlugin()
-    {}
-
-    QPlatformMediaIntegration* create(const QString &name) override
-    {
-        if (name == u"ffmpeg")
-            return new QFFmpegMediaIntegration;
-        return nullptr;
-    }
-};
-
 bool thread_local FFmpegLogsEnabledInThread = true;
 static bool UseCustomFFmpegLogger = false;
 
@@ -380,5 +361,3 @@ Q_DECL_EXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void * /*reserved*/)
 #endif
 
 QT_END_NAMESPACE
-
-#include "qffmpegmediaintegration.moc"
@@ -13,8 +13,12 @@
 #include <qtimer.h>
 #include <QtConcurrent/QtConcurrent>
 
+#include <qcoreevent.h>
 #include <qloggingcategory.h>
 
+#include <algorithm>
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg {
@@ -35,9 +39,43 @@ private:
 
 using namespace QFFmpeg;
 
+// The dynamic properties of the QMediaPlayer overriding the environment variables
+static constexpr std::pair<const char *, const char *> bufferingProperties[] = {
+    { "QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS", "ffmpegDemuxerMaxBufferedDurationMs" },
+    { "QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE", "ffmpegDemuxerMaxBufferedSize" },
+    { "QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT", "ffmpegDemuxerLowWaterMarkPercent" },
+    { "QT_FFMPEG_DEMUXER_LIVE_MODE", "ffmpegDemuxerLiveMode" },
+};
+
+static constexpr char seekModeProperty[] = "ffmpegSeekMode";
+
+static bool isBufferingProperty(const QByteArray &name)
+{
+    return std::any_of(std::begin(bufferingProperties), std::end(bufferingProperties),
+                       [&name](const auto &names) { return name == names.second; });
+}
+
+static BufferingPolicy bufferingPolicyOf(const QObject *player)
+{
+    auto intValue = [player](const char *variable, bool *ok) {
+        for (const auto &[name, property] : bufferingProperties) {
+            if (qstrcmp(variable, name) == 0)
+                return player->property(property).toInt(ok);
+        }
+        *ok = false;
+        return 0;
+    };
+
+    return BufferingPolicy::fromSettings(intValue, BufferingPolicy::defaultPolicy());
+}
+
 QFFmpegMediaPlayer::QFFmpegMediaPlayer(QMediaPlayer *player)
     : QPlatformMediaPlayer(player)
 {
+    // The per-player settings are dynamic properties of the QMediaPlayer
+    if (player)
+        player->installEventFilter(this);
+
     m_positionUpdateTimer.setInterval(50);
     m_positionUpdateTimer.setTimerType(Qt::PreciseTimer);
     connect(&m_positionUpdateTimer, &QTimer::timeout, this, &QFFmpegMediaPlayer::updatePosition);
@@ -108,6 +146,48 @@ void QFFmpegMediaPlayer::onBuffered()
         mediaStatusChanged(QMediaPlayer::BufferedMedia);
 }
 
+void QFFmpegMediaPlayer::setBufferingPolicy(const QFFmpeg::BufferingPolicy &policy)
+{
+    m_bufferingPolicy = policy;
+    if (m_playbackEngine)
+        m_playbackEngine->setBufferingPolicy(policy);
+}
+
+void QFFmpegMediaPlayer::setSeekMode(QFFmpeg::SeekMode mode)
+{
+    m_seekMode = mode;
+    if (m_playbackEngine)
+        m_playbackEngine->setSeekMode(mode);
+}
+
+QFFmpeg::BufferOccupancy QFFmpegMediaPlayer::bufferOccupancy() const
+{
+    return m_playbackEngine ? m_playbackEngine->bufferOccupancy() : QFFmpeg::BufferOccupancy{};
+}
+
+void QFFmpegMediaPlayer::updateSeekMode(const QByteArray &name)
+{
+    if (name.isEmpty())
+        setSeekMode(defaultSeekMode());
+    else if (auto mode = seekModeFromName(name))
+        setSeekMode(*mode);
+    else
+        qWarning() << "Unknown seek mode" << name;
+}
+
+bool QFFmpegMediaPlayer::eventFilter(QObject *object, QEvent *event)
+{
+    if (event->type() == QEvent::DynamicPropertyChange) {
+        const QByteArray name = static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName();
+        if (isBufferingProperty(name))
+            setBufferingPolicy(bufferingPolicyOf(object));
+        else if (name == seekModeProperty)
+            updateSeekMode(object->property(seekModeProperty).toByteArray());
+    }
+
+    return QObject::eventFilter(object, event);
+}
+
 float QFFmpegMediaPlayer::bufferProgress() const
 {
     return m_bufferProgress;
@@ -245,6 +325,8 @@ void QFFmpegMediaPlayer::setMediaAsync(QFFmpeg::MediaDataHolder::Maybe mediaData
     connect(m_playbackEngine.get(), &PlaybackEngine::buffered, this,
             &QFFmpegMediaPlayer::onBuffered);
 
+    m_playbackEngine->setBufferingPolicy(m_bufferingPolicy);
+    m_playbackEngine->setSeekMode(m_seekMode);
     m_playbackEngine->setMedia(std::move(*mediaDataHolder.value()));
 
     m_playbackEngine->setAudioBufferOutput(m_audioBufferOutput);
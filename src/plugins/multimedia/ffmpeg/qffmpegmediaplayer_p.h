@@ -22,6 +22,7 @@
 #include <qfuture.h>
 #include "qffmpeg_p.h"
 #include "playbackengine/qffmpegmediadataholder_p.h"
+#include "playbackengine/qffmpegbufferingpolicy_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -74,6 +75,25 @@ public:
     void setActiveTrack(TrackType, int streamNumber) override;
     void setLoops(int loops) override;
 
+    // Set by the application through the dynamic properties of the QMediaPlayer
+    // ffmpegDemuxerMaxBufferedDurationMs, ffmpegDemuxerMaxBufferedSize,
+    // ffmpegDemuxerLowWaterMarkPercent and ffmpegDemuxerLiveMode, which override
+    // the values given by the QT_FFMPEG_DEMUXER_* environment variables.
+    void setBufferingPolicy(const QFFmpeg::BufferingPolicy &policy);
+    QFFmpeg::BufferingPolicy bufferingPolicy() const { return m_bufferingPolicy; }
+
+    // Set by the application through the "ffmpegSeekMode" dynamic property of the
+    // QMediaPlayer, which takes the names accepted by QT_FFMPEG_PLAYBACK_SEEK_MODE.
+    void setSeekMode(QFFmpeg::SeekMode mode);
+    QFFmpeg::SeekMode seekMode() const { return m_seekMode; }
+
+    // The data read ahead of the decoders, for monitoring. Logged periodically under
+    // qt.multimedia.ffmpeg.playbackengine while the media is playing or paused.
+    QFFmpeg::BufferOccupancy bufferOccupancy() const;
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+
 private:
     void runPlayback();
     void handleIncorrectMedia(QMediaPlayer::MediaStatus status);
@@ -82,6 +102,8 @@ private:
 
     void mediaStatusChanged(QMediaPlayer::MediaStatus);
 
+    void updateSeekMode(const QByteArray &name);
+
 private slots:
     void updatePosition();
     void endOfStream();
@@ -107,6 +129,8 @@ private:
     QPointer<QIODevice> m_device;
     float m_playbackRate = 1.;
     float m_bufferProgress = 0.f;
+    QFFmpeg::BufferingPolicy m_bufferingPolicy = QFFmpeg::BufferingPolicy::defaultPolicy();
+    QFFmpeg::SeekMode m_seekMode = QFFmpeg::defaultSeekMode();
     QFuture<void> m_loadMedia;
     std::shared_ptr<QFFmpeg::CancelToken> m_cancelToken; // For interrupting ongoing
                                                          // network connection attempt
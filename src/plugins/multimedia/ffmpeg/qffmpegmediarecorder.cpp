@@ -13,14 +13,27 @@
 #include "qffmpegmediacapturesession_p.h"
 
 #include <qdebug.h>
+#include <qcoreevent.h>
 #include <qloggingcategory.h>
 
 static Q_LOGGING_CATEGORY(qLcMediaEncoder, "qt.multimedia.ffmpeg.encoder");
+static Q_LOGGING_CATEGORY(qLcQueueStatistics, "qt.multimedia.ffmpeg.encoderqueue.statistics");
 
 QT_BEGIN_NAMESPACE
 
+using namespace std::chrono_literals;
+
+static constexpr char queuePolicyProperty[] = "ffmpegEncodingQueuePolicy";
+static constexpr char fragmentDurationProperty[] = "ffmpegFragmentDurationMs";
+
 QFFmpegMediaRecorder::QFFmpegMediaRecorder(QMediaRecorder *parent) : QPlatformMediaRecorder(parent)
 {
+    // The per-recorder settings are dynamic properties of the QMediaRecorder
+    parent->installEventFilter(this);
+
+    m_queueStatisticsTimer.setInterval(5s);
+    connect(&m_queueStatisticsTimer, &QTimer::timeout, this,
+            &QFFmpegMediaRecorder::logQueueStatistics);
 }
 
 QFFmpegMediaRecorder::~QFFmpegMediaRecorder() = default;
@@ -80,6 +93,8 @@ void QFFmpegMediaRecorder::record(QMediaEncoderSettings &settings)
 
     m_recordingEngine.reset(new RecordingEngine(settings, std::move(formatContext)));
     m_recordingEngine->setMetaData(m_metaData);
+    m_recordingEngine->setQueuePolicy(m_queuePolicy);
+    m_recordingEngine->setFragmentation(m_fragmentation);
 
     connect(m_recordingEngine.get(), &QFFmpeg::RecordingEngine::durationChanged, this,
             &QFFmpegMediaRecorder::newDuration);
@@ -104,6 +119,9 @@ void QFFmpegMediaRecorder::record(QMediaEncoderSettings &settings)
     stateChanged(QMediaRecorder::RecordingState);
 
     m_recordingEngine->initialize(audioInputs, videoSources);
+
+    if (qLcQueueStatistics().isDebugEnabled())
+        m_queueStatisticsTimer.start();
 }
 
 void QFFmpegMediaRecorder::pause()
@@ -137,6 +155,10 @@ void QFFmpegMediaRecorder::stop()
         static_cast<QFFmpegAudioInput *>(input)->setRunning(false);
     qCDebug(qLcMediaEncoder) << "stop";
 
+    m_queueStatisticsTimer.stop();
+    if (m_recordingEngine)
+        qCInfo(qLcQueueStatistics) << "Recording stopped:" << m_recordingEngine->queueStatistics();
+
     m_recordingEngine.reset();
 }
 
@@ -187,6 +209,60 @@ void QFFmpegMediaRecorder::updateAutoStop()
     m_recordingEngine->setAutoStop(autoStop);
 }
 
+void QFFmpegMediaRecorder::setQueuePolicy(const QFFmpeg::EncoderQueuePolicy &policy)
+{
+    m_queuePolicy = policy;
+    if (m_recordingEngine)
+        m_recordingEngine->setQueuePolicy(policy);
+}
+
+void QFFmpegMediaRecorder::setFragmentation(const QFFmpeg::OutputFragmentation &fragmentation)
+{
+    m_fragmentation = fragmentation;
+}
+
+QFFmpeg::RecordingQueueStatistics QFFmpegMediaRecorder::queueStatistics() const
+{
+    return m_recordingEngine ? m_recordingEngine->queueStatistics()
+                             : QFFmpeg::RecordingQueueStatistics{};
+}
+
+void QFFmpegMediaRecorder::logQueueStatistics()
+{
+    qCDebug(qLcQueueStatistics) << queueStatistics();
+}
+
+bool QFFmpegMediaRecorder::eventFilter(QObject *object, QEvent *event)
+{
+    if (object != mediaRecorder() || event->type() != QEvent::DynamicPropertyChange)
+        return QObject::eventFilter(object, event);
+
+    const QByteArray name = static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName();
+    if (name == queuePolicyProperty) {
+        const QByteArray value = object->property(queuePolicyProperty).toByteArray();
+        if (value.isEmpty()) {
+            setQueuePolicy(QFFmpeg::EncoderQueuePolicy::defaultPolicy());
+        } else if (auto policy = QFFmpeg::EncoderQueuePolicy::fromName(value)) {
+            setQueuePolicy(*policy);
+        } else {
+            qCWarning(qLcMediaEncoder) << "Unknown encoding queue policy" << value;
+        }
+    } else if (name == fragmentDurationProperty) {
+        const QVariant value = object->property(fragmentDurationProperty);
+        bool ok = false;
+        const int duration = value.toInt(&ok);
+        if (ok && duration >= 0) {
+            setFragmentation({ std::chrono::milliseconds(duration) });
+        } else {
+            if (value.isValid())
+                qCWarning(qLcMediaEncoder) << "Invalid fragment duration" << value;
+            setFragmentation(QFFmpeg::OutputFragmentation::defaultFragmentation());
+        }
+    }
+
+    return QObject::eventFilter(object, event);
+}
+
 void QFFmpegMediaRecorder::RecordingEngineDeleter::operator()(
         RecordingEngine *recordingEngine) const
 {
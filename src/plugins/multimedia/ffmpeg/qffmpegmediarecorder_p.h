@@ -16,6 +16,10 @@
 //
 
 #include <private/qplatformmediarecorder_p.h>
+#include "recordingengine/qffmpegencoderqueue_p.h"
+#include "recordingengine/qffmpegoutputfragmentation_p.h"
+
+#include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -50,10 +54,30 @@ public:
 
     void updateAutoStop() override;
 
+    // Applies to the current and the following recordings. Set by the application
+    // through the "ffmpegEncodingQueuePolicy" dynamic property of the QMediaRecorder,
+    // which takes the names accepted by QT_FFMPEG_ENCODING_QUEUE_POLICY.
+    void setQueuePolicy(const QFFmpeg::EncoderQueuePolicy &policy);
+    QFFmpeg::EncoderQueuePolicy queuePolicy() const { return m_queuePolicy; }
+
+    // Of the current recording. Logged under qt.multimedia.ffmpeg.encoderqueue.statistics
+    // periodically while recording, and when the recording stops.
+    QFFmpeg::RecordingQueueStatistics queueStatistics() const;
+
+    // Applies to the following recordings. Set by the application through the
+    // "ffmpegFragmentDurationMs" dynamic property of the QMediaRecorder; 0 disables
+    // the fragmentation, and an invalid value restores the default.
+    void setFragmentation(const QFFmpeg::OutputFragmentation &fragmentation);
+    QFFmpeg::OutputFragmentation fragmentation() const { return m_fragmentation; }
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override;
+
 private Q_SLOTS:
     void newDuration(qint64 d) { durationChanged(d); }
     void finalizationDone();
     void handleSessionError(QMediaRecorder::Error code, const QString &description);
+    void logQueueStatistics();
 
 private:
     using RecordingEngine = QFFmpeg::RecordingEngine;
@@ -64,6 +88,10 @@ private:
 
     QFFmpegMediaCaptureSession *m_session = nullptr;
     QMediaMetaData m_metaData;
+    QFFmpeg::EncoderQueuePolicy m_queuePolicy = QFFmpeg::EncoderQueuePolicy::defaultPolicy();
+    QFFmpeg::OutputFragmentation m_fragmentation =
+            QFFmpeg::OutputFragmentation::defaultFragmentation();
+    QTimer m_queueStatisticsTimer;
 
     std::unique_ptr<RecordingEngine, RecordingEngineDeleter> m_recordingEngine;
 };
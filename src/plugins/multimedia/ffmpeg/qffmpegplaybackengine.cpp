@@ -48,6 +48,10 @@ PlaybackEngine::PlaybackEngine()
     qCDebug(qLcPlaybackEngine) << "Create PlaybackEngine";
     qRegisterMetaType<QFFmpeg::Packet>();
     qRegisterMetaType<QFFmpeg::Frame>();
+
+    m_bufferOccupancyLogTimer.setInterval(1000);
+    connect(&m_bufferOccupancyLogTimer, &QTimer::timeout, this,
+            &PlaybackEngine::logBufferOccupancy);
 }
 
 PlaybackEngine::~PlaybackEngine() {
@@ -56,6 +60,20 @@ PlaybackEngine::~PlaybackEngine() {
     finalizeOutputs();
     forEachExistingObject([](auto &object) { object.reset(); });
     deleteFreeThreads();
+
+    if (qLcPlaybackEngine().isDebugEnabled()) {
+        auto printStatistics = [](const char *name, const PoolStatistics &statistics) {
+            qCDebug(qLcPlaybackEngine)
+                    << name << "pool: created" << statistics.created << "reused"
+                    << statistics.reused << "dropped" << statistics.dropped << "idle"
+                    << statistics.idle;
+        };
+
+        printStatistics("AVPacket", avPacketPoolStatistics());
+        printStatistics("AVFrame", avFramePoolStatistics());
+        printStatistics("Packet", Packet::dataPoolStatistics());
+        printStatistics("Frame", Frame::dataPoolStatistics());
+    }
 }
 
 void PlaybackEngine::onRendererFinished()
@@ -76,6 +94,7 @@ void PlaybackEngine::onRendererFinished()
     if (std::exchange(m_state, QMediaPlayer::StoppedState) == QMediaPlayer::StoppedState)
         return;
 
+    m_bufferOccupancyLogTimer.stop();
     finilizeTime(duration());
 
     forceUpdate();
@@ -138,6 +157,11 @@ void PlaybackEngine::setState(QMediaPlayer::PlaybackState state) {
         triggerStepIfNeeded();
 
     updateObjectsPausedState();
+
+    if (m_state == QMediaPlayer::StoppedState)
+        m_bufferOccupancyLogTimer.stop();
+    else if (qLcPlaybackEngine().isDebugEnabled())
+        m_bufferOccupancyLogTimer.start();
 }
 
 void PlaybackEngine::updateObjectsPausedState()
@@ -237,6 +261,15 @@ void PlaybackEngine::seek(qint64 pos)
 {
     pos = boundPosition(pos);
 
+    const int videoStreamIndex = m_media.currentStreamIndex(QPlatformMediaPlayer::VideoStream);
+    if (m_seekMode == SeekMode::Fast && videoStreamIndex >= 0) {
+        if (auto keyframe = m_media.keyframeIndex()->nearestKeyframe(videoStreamIndex, pos)) {
+            qCDebug(qLcPlaybackEngine) << "Snap seek position" << pos << "to keyframe"
+                                       << keyframe->pos;
+            pos = boundPosition(keyframe->pos);
+        }
+    }
+
     m_timeController.setPaused(true);
     m_timeController.sync(m_currentLoopOffset.pos + pos);
 
@@ -294,6 +327,28 @@ float PlaybackEngine::playbackRate() const {
     return m_timeController.playbackRate();
 }
 
+void PlaybackEngine::setBufferingPolicy(const BufferingPolicy &policy)
+{
+    if (std::exchange(m_bufferingPolicy, policy) == policy)
+        return;
+
+    if (m_demuxer)
+        m_demuxer->setBufferingPolicy(policy);
+}
+
+BufferOccupancy PlaybackEngine::bufferOccupancy() const
+{
+    return m_demuxer ? m_demuxer->bufferOccupancy() : BufferOccupancy{};
+}
+
+void PlaybackEngine::logBufferOccupancy() const
+{
+    const BufferOccupancy occupancy = bufferOccupancy();
+    qCDebug(qLcPlaybackEngine) << "Buffered ahead of the decoders:" << occupancy.durationUs / 1000
+                               << "ms of max" << m_bufferingPolicy.maxDurationUs / 1000 << "ms,"
+                               << occupancy.size << "bytes of max" << m_bufferingPolicy.maxSize;
+}
+
 void PlaybackEngine::recreateObjects()
 {
     m_timeController.setPaused(true);
@@ -355,11 +410,11 @@ void PlaybackEngine::createStreamAndRenderer(QPlatformMediaPlayer::TrackType tra
 
     Q_ASSERT(trackType == stream->trackType());
 
-    connect(stream.get(), &StreamDecoder::requestHandleFrame, renderer.get(), &Renderer::render);
+    stream->setFrameOutput(DataChannel<Frame>::create(renderer.get(), &Renderer::render));
     connect(stream.get(), &PlaybackEngineObject::atEnd, renderer.get(),
             &Renderer::onFinalFrameReceived);
-    connect(renderer.get(), &Renderer::frameProcessed, stream.get(),
-            &StreamDecoder::onFrameProcessed);
+    renderer->setProcessedFrameOutput(
+            DataChannel<Frame>::create(stream.get(), &StreamDecoder::onFrameProcessed));
 }
 
 std::optional<Codec> PlaybackEngine::codecForTrack(QPlatformMediaPlayer::TrackType trackType)
@@ -411,17 +466,19 @@ void PlaybackEngine::createDemuxer()
     const PositionWithOffset positionWithOffset{ currentPosition(false), m_currentLoopOffset };
 
     m_demuxer = createPlaybackEngineObject<Demuxer>(m_media.avContext(), positionWithOffset,
-                                                    streamIndexes, m_loops);
+                                                    streamIndexes, m_loops, m_bufferingPolicy,
+                                                    m_media.keyframeIndex());
 
     connect(m_demuxer.get(), &Demuxer::packetsBuffered, this, &PlaybackEngine::buffered);
 
     forEachExistingObject<StreamDecoder>([&](auto &stream) {
-        connect(m_demuxer.get(), Demuxer::signalByTrackType(stream->trackType()), stream.get(),
-                &StreamDecoder::decode);
+        m_demuxer->setPacketOutput(stream->trackType(),
+                                   DataChannel<Packet>::create(stream.get(),
+                                                               &StreamDecoder::decode));
         connect(m_demuxer.get(), &PlaybackEngineObject::atEnd, stream.get(),
                 &StreamDecoder::onFinalPacketReceived);
-        connect(stream.get(), &StreamDecoder::packetProcessed, m_demuxer.get(),
-                &Demuxer::onPacketProcessed);
+        stream->setProcessedPacketOutput(
+                DataChannel<Packet>::create(m_demuxer.get(), &Demuxer::onPacketProcessed));
     });
 
     if (!isSeekable() || duration() <= 0) {
@@ -38,7 +38,11 @@
  * OBJECTS WEAK CONNECTIVITY
  *
  * - The objects know nothing about others and about PlaybackEngine.
- *   For any interactions the objects use slots/signals.
+ *   For control interactions the objects use slots/signals.
+ *
+ * - Packets and frames, and the notifications that they have been processed,
+ *   go through DataChannels, single-producer single-consumer queues that
+ *   wake up the consumer thread once per batch.
  *
  * - PlaybackEngine knows the objects object and is able to create/delete them and
  *   call their public methods.
@@ -50,8 +54,10 @@
 #include "playbackengine/qffmpegmediadataholder_p.h"
 #include "playbackengine/qffmpegcodec_p.h"
 #include "playbackengine/qffmpegpositionwithoffset_p.h"
+#include "playbackengine/qffmpegbufferingpolicy_p.h"
 
 #include <QtCore/qpointer.h>
+#include <QtCore/qtimer.h>
 
 #include <unordered_map>
 
@@ -104,6 +110,16 @@ public:
 
     float playbackRate() const;
 
+    void setBufferingPolicy(const BufferingPolicy &policy);
+
+    const BufferingPolicy &bufferingPolicy() const { return m_bufferingPolicy; }
+
+    BufferOccupancy bufferOccupancy() const;
+
+    void setSeekMode(SeekMode mode) { m_seekMode = mode; }
+
+    SeekMode seekMode() const { return m_seekMode; }
+
     void setActiveTrack(QPlatformMediaPlayer::TrackType type, int streamNumber);
 
     qint64 currentPosition(bool topPos = true) const;
@@ -197,6 +213,8 @@ private:
 
     qint64 boundPosition(qint64 position) const;
 
+    void logBufferOccupancy() const;
+
 private:
     MediaDataHolder m_media;
 
@@ -218,6 +236,9 @@ private:
     std::array<std::optional<Codec>, QPlatformMediaPlayer::NTrackTypes> m_codecs;
     int m_loops = QMediaPlayer::Once;
     LoopOffset m_currentLoopOffset;
+    BufferingPolicy m_bufferingPolicy = BufferingPolicy::defaultPolicy();
+    SeekMode m_seekMode = defaultSeekMode();
+    QTimer m_bufferOccupancyLogTimer; // runs if debug output is enabled
 };
 
 template<typename T, typename... Args>
@@ -9,10 +9,18 @@ static Q_LOGGING_CATEGORY(qLcResampler, "qt.multimedia.ffmpeg.resampler")
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// The consumers keep a few buffers at most, e.g. the audio renderer keeps one
+// until the sink takes it; a consumer keeping more just gets new allocations.
+constexpr int MaxPooledBuffers = 4;
+
+} // namespace
+
 using namespace QFFmpeg;
 
 QFFmpegResampler::QFFmpegResampler(const QAudioFormat &inputFormat, const QAudioFormat &outputFormat) :
-    m_inputFormat(inputFormat), m_outputFormat(outputFormat)
+    m_inputFormat(inputFormat), m_outputFormat(outputFormat), m_bufferPool(MaxPooledBuffers)
 {
     Q_ASSERT(inputFormat.isValid());
     Q_ASSERT(outputFormat.isValid());
@@ -23,7 +31,7 @@ QFFmpegResampler::QFFmpegResampler(const QAudioFormat &inputFormat, const QAudio
 
 QFFmpegResampler::QFFmpegResampler(const Codec *codec, const QAudioFormat &outputFormat,
                                    qint64 startTime)
-    : m_outputFormat(outputFormat), m_startTime(startTime)
+    : m_outputFormat(outputFormat), m_startTime(startTime), m_bufferPool(MaxPooledBuffers)
 {
     Q_ASSERT(codec);
 
@@ -54,23 +62,57 @@ QAudioBuffer QFFmpegResampler::resample(const AVFrame *frame)
     return resample(const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
 }
 
+qsizetype QFFmpegResampler::resampleInto(const AVFrame *frame, QSpan<char> destination)
+{
+    const int maxOutSamples = adjustMaxOutSamples(frame->nb_samples);
+    const int capacity = qMin(
+            maxOutSamples,
+            m_outputFormat.framesForBytes(qint32(qMin<qsizetype>(destination.size(), INT_MAX))));
+
+    const int outSamples = convert(const_cast<const uint8_t **>(frame->extended_data),
+                                   frame->nb_samples,
+                                   reinterpret_cast<uint8_t *>(destination.data()), capacity);
+
+    return m_outputFormat.bytesForFrames(outSamples);
+}
+
+qsizetype QFFmpegResampler::maxOutputBytes(const AVFrame *frame)
+{
+    return m_outputFormat.bytesForFrames(adjustMaxOutSamples(frame->nb_samples));
+}
+
 QAudioBuffer QFFmpegResampler::resample(const uint8_t **inputData, int inputSamplesCount)
 {
     const int maxOutSamples = adjustMaxOutSamples(inputSamplesCount);
 
-    QByteArray samples(m_outputFormat.bytesForFrames(maxOutSamples), Qt::Uninitialized);
-    auto *out = reinterpret_cast<uint8_t *>(samples.data());
+    QByteArray samples = m_bufferPool.take(m_outputFormat.bytesForFrames(maxOutSamples));
+    const qint64 startTime = m_outputFormat.durationForFrames(m_samplesProcessed) + m_startTime;
+
+    const int outSamples = convert(inputData, inputSamplesCount,
+                                   reinterpret_cast<uint8_t *>(samples.data()), maxOutSamples);
+
+    samples.resize(m_outputFormat.bytesForFrames(outSamples));
+    m_bufferPool.track(samples);
+
+    return QAudioBuffer(samples, m_outputFormat, startTime);
+}
+
+int QFFmpegResampler::convert(const uint8_t **inputData, int inputSamplesCount, uint8_t *out,
+                              int maxOutSamples)
+{
     const int outSamples =
             swr_convert(m_resampler.get(), &out, maxOutSamples, inputData, inputSamplesCount);
+    if (outSamples < 0) {
+        qCWarning(qLcResampler) << "swr_convert fail:" << outSamples;
+        return 0;
+    }
 
-    samples.resize(m_outputFormat.bytesForFrames(outSamples));
+    qCDebug(qLcResampler) << "    new frame"
+                          << m_outputFormat.durationForFrames(m_samplesProcessed) + m_startTime
+                          << "in_samples" << inputSamplesCount << outSamples << maxOutSamples;
 
-    const qint64 startTime = m_outputFormat.durationForFrames(m_samplesProcessed) + m_startTime;
     m_samplesProcessed += outSamples;
-
-    qCDebug(qLcResampler) << "    new frame" << startTime << "in_samples" << inputSamplesCount
-                          << outSamples << maxOutSamples;
-    return QAudioBuffer(samples, m_outputFormat, startTime);
+    return outSamples;
 }
 
 int QFFmpegResampler::adjustMaxOutSamples(int inputSamplesCount)
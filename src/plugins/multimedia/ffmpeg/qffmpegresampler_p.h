@@ -16,8 +16,11 @@
 
 #include "qaudiobuffer.h"
 #include "qffmpeg_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
 #include "private/qplatformaudioresampler_p.h"
 
+#include <QtCore/qspan.h>
+
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg
@@ -38,6 +41,12 @@ public:
 
     QAudioBuffer resample(const AVFrame *frame);
 
+    // Resamples into the caller's memory without allocating and returns the number
+    // of bytes written. The samples that don't fit are kept by the resampler
+    // and come first on the next call; maxOutputBytes() gives the size that fits all.
+    qsizetype resampleInto(const AVFrame *frame, QSpan<char> destination);
+    qsizetype maxOutputBytes(const AVFrame *frame);
+
     qint64 samplesProcessed() const { return m_samplesProcessed; }
     void setSampleCompensation(qint32 delta, quint32 distance);
     qint32 activeSampleCompensationDelta() const;
@@ -47,6 +56,8 @@ private:
 
     QAudioBuffer resample(const uint8_t **inputData, int inputSamplesCount);
 
+    int convert(const uint8_t **inputData, int inputSamplesCount, uint8_t *out, int maxOutSamples);
+
 private:
     QAudioFormat m_inputFormat;
     QAudioFormat m_outputFormat;
@@ -55,6 +66,7 @@ private:
     qint64 m_samplesProcessed = 0;
     qint64 m_endCompensationSample = std::numeric_limits<qint64>::min();
     qint32 m_sampleCompensationDelta = 0;
+    QFFmpeg::ByteArrayPool m_bufferPool; // the output buffers, reused once released
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,151 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qffmpegswscontextcache_p.h"
+
+#include <QtCore/qloggingcategory.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+static Q_LOGGING_CATEGORY(qLcSwsContextCache, "qt.multimedia.ffmpeg.swscontextcache");
+
+namespace QFFmpeg {
+
+namespace {
+
+// Log the hit rate once per this number of acquisitions
+constexpr quint64 StatisticsLogInterval = 1000;
+
+SwsContextUPtr createContext(const SwsContextKey &key)
+{
+    SwsContextUPtr context = createSwsContext(key.srcSize, key.srcPixFmt, key.dstSize,
+                                              key.dstPixFmt, key.conversionType);
+    if (!context || (key.srcColorSpace < 0 && key.dstColorSpace < 0))
+        return context;
+
+    auto coefficients = [](int colorSpace) {
+        return sws_getCoefficients(colorSpace < 0 ? SWS_CS_DEFAULT : colorSpace);
+    };
+
+    constexpr int brightness = 0;
+    constexpr int contrast = 0;
+    constexpr int saturation = 0;
+    const int status = sws_setColorspaceDetails(context.get(), coefficients(key.srcColorSpace),
+                                                key.srcColorRange, coefficients(key.dstColorSpace),
+                                                key.dstColorRange, brightness, contrast, saturation);
+
+    if (status != 0) {
+        qCWarning(qLcSwsContextCache) << "Failed to set color space details";
+        return {};
+    }
+
+    return context;
+}
+
+} // namespace
+
+SwsContextCache::Handle::~Handle()
+{
+    if (m_cache && m_context)
+        m_cache->release(m_key, std::move(m_context));
+}
+
+SwsContextCache &SwsContextCache::instance()
+{
+    static SwsContextCache cache([] {
+        bool ok = false;
+        const int size = qEnvironmentVariableIntValue("QT_FFMPEG_SWS_CONTEXT_CACHE_SIZE", &ok);
+        return ok ? size : DefaultMaxIdleContexts;
+    }());
+    return cache;
+}
+
+SwsContextCache::SwsContextCache(int maxIdleContexts) : m_maxIdleContexts(qMax(maxIdleContexts, 0))
+{
+}
+
+SwsContextCache::~SwsContextCache() = default;
+
+SwsContextCache::Handle SwsContextCache::acquire(const SwsContextKey &key)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const quint64 acquisitions = m_statistics.hits + m_statistics.misses + 1;
+        if (acquisitions % StatisticsLogInterval == 0)
+            qCDebug(qLcSwsContextCache)
+                    << "hits:" << m_statistics.hits << "misses:" << m_statistics.misses
+                    << "evictions:" << m_statistics.evictions
+                    << "idle contexts:" << m_idleCount;
+
+        auto found = std::find_if(m_idleContexts.begin(), m_idleContexts.end(),
+                                  [&key](const auto &entry) { return entry.first == key; });
+        if (found != m_idleContexts.end()) {
+            SwsContextUPtr context = std::move(found->second);
+            m_idleContexts.erase(found);
+            --m_idleCount;
+            ++m_statistics.hits;
+            return Handle(this, key, std::move(context));
+        }
+
+        ++m_statistics.misses;
+    }
+
+    // Don't block other threads while initializing the context
+    SwsContextUPtr context = createContext(key);
+    if (!context)
+        return {};
+
+    return Handle(this, key, std::move(context));
+}
+
+int SwsContextCache::maxIdleContexts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxIdleContexts;
+}
+
+void SwsContextCache::setMaxIdleContexts(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxIdleContexts = qMax(count, 0);
+    evictExcessContexts();
+}
+
+SwsContextCache::Statistics SwsContextCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    Statistics result = m_statistics;
+    result.idleContexts = m_idleCount;
+    return result;
+}
+
+void SwsContextCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_statistics.evictions += m_idleCount;
+    m_idleContexts.clear();
+    m_idleCount = 0;
+}
+
+void SwsContextCache::release(const SwsContextKey &key, SwsContextUPtr context)
+{
+    QMutexLocker locker(&m_mutex);
+    m_idleContexts.emplace_front(key, std::move(context));
+    ++m_idleCount;
+    evictExcessContexts();
+}
+
+void SwsContextCache::evictExcessContexts()
+{
+    for (; m_idleCount > m_maxIdleContexts; --m_idleCount) {
+        m_idleContexts.pop_back();
+        ++m_statistics.evictions;
+    }
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#ifndef QFFMPEGSWSCONTEXTCACHE_P_H
+#define QFFMPEGSWSCONTEXTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qffmpeg_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qsize.h>
+
+#include <list>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+struct SwsContextKey
+{
+    QSize srcSize;
+    AVPixelFormat srcPixFmt = AV_PIX_FMT_NONE;
+    QSize dstSize;
+    AVPixelFormat dstPixFmt = AV_PIX_FMT_NONE;
+    int conversionType = SWS_BICUBIC;
+
+    // Parameters of sws_setColorspaceDetails; a negative color space
+    // keeps the swscale defaults.
+    int srcColorSpace = -1;
+    int srcColorRange = 0;
+    int dstColorSpace = -1;
+    int dstColorRange = 0;
+
+    friend bool operator==(const SwsContextKey &lhs, const SwsContextKey &rhs)
+    {
+        return lhs.srcSize == rhs.srcSize && lhs.srcPixFmt == rhs.srcPixFmt
+                && lhs.dstSize == rhs.dstSize && lhs.dstPixFmt == rhs.dstPixFmt
+                && lhs.conversionType == rhs.conversionType
+                && lhs.srcColorSpace == rhs.srcColorSpace
+                && lhs.srcColorRange == rhs.srcColorRange
+                && lhs.dstColorSpace == rhs.dstColorSpace
+                && lhs.dstColorRange == rhs.dstColorRange;
+    }
+    friend bool operator!=(const SwsContextKey &lhs, const SwsContextKey &rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+/*!
+    Process wide pool of idle sws contexts.
+
+    Creating an SwsContext involves filter and table initialization that
+    is much more expensive than scaling a single frame, while video streams
+    convert many frames with identical parameters. A context is checked out
+    exclusively by acquire() and goes back to the pool when the returned
+    handle is destroyed, so the pool can be shared between threads.
+    Idle contexts are evicted in least-recently-used order once their
+    count exceeds maxIdleContexts().
+ */
+class SwsContextCache
+{
+public:
+    class Handle
+    {
+    public:
+        Handle() = default;
+        Handle(Handle &&other) noexcept = default;
+        Handle &operator=(Handle &&other) noexcept
+        {
+            Handle(std::move(other)).swap(*this);
+            return *this;
+        }
+        ~Handle();
+
+        SwsContext *get() const { return m_context.get(); }
+        explicit operator bool() const { return m_context != nullptr; }
+
+        void swap(Handle &other) noexcept
+        {
+            std::swap(m_cache, other.m_cache);
+            std::swap(m_key, other.m_key);
+            m_context.swap(other.m_context);
+        }
+
+    private:
+        friend class SwsContextCache;
+        Handle(SwsContextCache *cache, const SwsContextKey &key, SwsContextUPtr context)
+            : m_cache(cache), m_key(key), m_context(std::move(context))
+        {
+        }
+
+        SwsContextCache *m_cache = nullptr;
+        SwsContextKey m_key;
+        SwsContextUPtr m_context;
+    };
+
+    struct Statistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        int idleContexts = 0;
+    };
+
+    static SwsContextCache &instance();
+
+    SwsContextCache(int maxIdleContexts = DefaultMaxIdleContexts);
+    ~SwsContextCache();
+
+    Handle acquire(const SwsContextKey &key);
+
+    int maxIdleContexts() const;
+    void setMaxIdleContexts(int count);
+
+    Statistics statistics() const;
+    void clear();
+
+    static constexpr int DefaultMaxIdleContexts = 16;
+
+private:
+    void release(const SwsContextKey &key, SwsContextUPtr context);
+    void evictExcessContexts();
+
+private:
+    mutable QMutex m_mutex;
+    // Most recently released contexts go to the front
+    std::list<std::pair<SwsContextKey, SwsContextUPtr>> m_idleContexts;
+    int m_idleCount = 0;
+    int m_maxIdleContexts = DefaultMaxIdleContexts;
+    Statistics m_statistics;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGSWSCONTEXTCACHE_P_H
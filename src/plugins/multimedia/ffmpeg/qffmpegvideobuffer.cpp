@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qffmpegvideobuffer_p.h"
+#include "playbackengine/qffmpegobjectpool_p.h"
 #include "private/qvideotexturehelper_p.h"
 #include "private/qmultimediautils_p.h"
 #include "qffmpeghwaccel_p.h"
+#include "qffmpegswscontextcache_p.h"
 #include "qloggingcategory.h"
 
 extern "C" {
@@ -46,7 +48,12 @@ QFFmpegVideoBuffer::QFFmpegVideoBuffer(AVFrameUPtr frame, AVRational pixelAspect
     convertSWFrame();
 }
 
-QFFmpegVideoBuffer::~QFFmpegVideoBuffer() = default;
+QFFmpegVideoBuffer::~QFFmpegVideoBuffer()
+{
+    // The frames mostly come from the playback engine, give their shells back
+    QFFmpeg::recycleAVFrame(std::move(m_hwFrame));
+    QFFmpeg::recycleAVFrame(std::move(m_swFrame));
+}
 
 void QFFmpegVideoBuffer::convertSWFrame()
 {
@@ -60,8 +67,13 @@ void QFFmpegVideoBuffer::convertSWFrame()
         || m_size != actualSize) {
         Q_ASSERT(toQtPixelFormat(targetAVPixelFormat) == m_pixelFormat);
         // convert the format into something we can handle
-        SwsContextUPtr scaleContext = createSwsContext(actualSize, actualAVPixelFormat, m_size,
-                                                       targetAVPixelFormat, SWS_BICUBIC);
+        SwsContextKey key;
+        key.srcSize = actualSize;
+        key.srcPixFmt = actualAVPixelFormat;
+        key.dstSize = m_size;
+        key.dstPixFmt = targetAVPixelFormat;
+        key.conversionType = SWS_BICUBIC;
+        const SwsContextCache::Handle scaleContext = SwsContextCache::instance().acquire(key);
 
         auto newFrame = makeAVFrame();
         newFrame->width = m_size.width();
@@ -374,7 +374,12 @@ void QV4L2Camera::readFrame()
         return;
     }
 
-    auto videoBuffer = std::make_unique<QMemoryVideoBuffer>(buffer->data, m_bytesPerLine);
+    // Zero-copy buffers go back to the driver once the last frame referencing them is released
+    const bool enqueueAfterEmit = !buffer->videoBuffer;
+    std::unique_ptr<QAbstractVideoBuffer> videoBuffer = std::move(buffer->videoBuffer);
+    if (!videoBuffer)
+        videoBuffer = std::make_unique<QMemoryVideoBuffer>(buffer->data, m_bytesPerLine);
+
     QVideoFrame frame = QVideoFramePrivate::createFrame(std::move(videoBuffer), frameFormat());
 
     auto &v4l2Buffer = buffer->v4l2Buffer;
@@ -388,7 +393,7 @@ void QV4L2Camera::readFrame()
 
     emit newVideoFrame(frame);
 
-    if (!m_memoryTransfer->enqueueBuffer(v4l2Buffer.index))
+    if (enqueueAfterEmit && !m_memoryTransfer->enqueueBuffer(v4l2Buffer.index))
         qCWarning(qLcV4L2Camera) << "Cannot add buffer";
 }
 
@@ -636,7 +641,34 @@ void QV4L2Camera::initV4L2MemoryTransfer()
 
     Q_ASSERT(!m_memoryTransfer);
 
-    m_memoryTransfer = makeUserPtrMemoryTransfer(m_v4l2FileDescriptor, m_imageSize);
+    // Frames referencing driver memory may be held by the application, so MMAP
+    // gets a few more buffers than the user pointer transfer needs.
+    const int buffersCount = qEnvironmentVariableIntValue("QT_V4L2_CAMERA_BUFFERS_COUNT");
+    const quint32 userPtrBuffersCount = buffersCount > 0 ? buffersCount : 2;
+    const quint32 mmapBuffersCount = buffersCount > 0 ? buffersCount : 4;
+
+    // Exported dmabufs let hardware consumers import frames without CPU access,
+    // while the frames can still be mapped as with the plain MMAP transfer.
+    // Opt-in, as the export holds on to driver buffers and nothing imports them by default.
+    const bool exportDmaBufs = qEnvironmentVariableIntValue("QT_V4L2_CAMERA_DMABUF");
+    if (exportDmaBufs) {
+        m_memoryTransfer =
+                makeDmaBufMemoryTransfer(m_v4l2FileDescriptor, m_bytesPerLine, mmapBuffersCount);
+
+        if (m_memoryTransfer)
+            return;
+
+        if (errno == EBUSY) {
+            setCameraBusy();
+            return;
+        }
+
+        qCDebug(qLcV4L2Camera) << "Cannot init V4L2_MEMORY_MMAP with DMABUF export;"
+                               << "trying V4L2_MEMORY_USERPTR";
+    }
+
+    m_memoryTransfer =
+            makeUserPtrMemoryTransfer(m_v4l2FileDescriptor, m_imageSize, userPtrBuffersCount);
 
     if (m_memoryTransfer)
         return;
@@ -648,7 +680,8 @@ void QV4L2Camera::initV4L2MemoryTransfer()
 
     qCDebug(qLcV4L2Camera) << "Cannot init V4L2_MEMORY_USERPTR; trying V4L2_MEMORY_MMAP";
 
-    m_memoryTransfer = makeMMapMemoryTransfer(m_v4l2FileDescriptor);
+    m_memoryTransfer =
+            makeMMapMemoryTransfer(m_v4l2FileDescriptor, m_bytesPerLine, mmapBuffersCount);
 
     if (!m_memoryTransfer) {
         qCWarning(qLcV4L2Camera) << "Cannot init v4l2 memory transfer," << qt_error_string(errno);
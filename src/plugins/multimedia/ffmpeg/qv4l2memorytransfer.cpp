@@ -4,9 +4,14 @@
 #include "qv4l2memorytransfer_p.h"
 #include "qv4l2filedescriptor_p.h"
 
+#include <private/qhwvideobuffer_p.h>
+#include <private/qcore_unix_p.h>
+
 #include <qloggingcategory.h>
 #include <qdebug.h>
+#include <qmutex.h>
 #include <sys/mman.h>
+#include <algorithm>
 #include <optional>
 
 QT_BEGIN_NAMESPACE
@@ -27,9 +32,9 @@ v4l2_buffer makeV4l2Buffer(quint32 memoryType, quint32 index = 0)
 class UserPtrMemoryTransfer : public QV4L2MemoryTransfer
 {
 public:
-    static QV4L2MemoryTransferUPtr create(QV4L2FileDescriptorPtr fileDescriptor, quint32 imageSize)
+    static QV4L2MemoryTransferUPtr create(QV4L2FileDescriptorPtr fileDescriptor, quint32 imageSize,
+                                          quint32 buffersCount)
     {
-        quint32 buffersCount = 2;
         if (!fileDescriptor->requestBuffers(V4L2_MEMORY_USERPTR, buffersCount)) {
             qCWarning(qLcV4L2MemoryTransfer) << "Cannot request V4L2_MEMORY_USERPTR buffers";
             return {};
@@ -50,7 +55,7 @@ public:
         Q_ASSERT(v4l2Buffer.index < m_byteArrays.size());
         Q_ASSERT(!m_byteArrays[v4l2Buffer.index].isEmpty());
 
-        return Buffer{ v4l2Buffer, std::move(m_byteArrays[v4l2Buffer.index]) };
+        return Buffer{ v4l2Buffer, std::move(m_byteArrays[v4l2Buffer.index]), nullptr };
     }
 
     bool enqueueBuffer(quint32 index) override
@@ -90,7 +95,11 @@ private:
     std::vector<QByteArray> m_byteArrays;
 };
 
-class MMapMemoryTransfer : public QV4L2MemoryTransfer
+// Keep at least this number of buffers queued in the driver; if frames referencing
+// the mmapped memory hold more buffers, further frames are copied.
+constexpr quint32 MinDriverQueuedBuffers = 2;
+
+class MMapBuffers
 {
 public:
     struct MemorySpan
@@ -98,93 +107,357 @@ public:
         void *data = nullptr;
         size_t size = 0;
         bool inQueue = false;
+        bool heldByFrame = false;
+        bool released = false; // released by its frame, waiting to be queued again
+        int frameMapCount = 0;
+        QByteArray detachedData; // the frame's copy of the data once the transfer is gone
+        int dmaBufFd = -1;
     };
 
-    static QV4L2MemoryTransferUPtr create(QV4L2FileDescriptorPtr fileDescriptor)
+    MMapBuffers(QV4L2FileDescriptorPtr fileDescriptor)
+        : m_fileDescriptor(std::move(fileDescriptor))
     {
-        quint32 buffersCount = 2;
-        if (!fileDescriptor->requestBuffers(V4L2_MEMORY_MMAP, buffersCount)) {
-            qCWarning(qLcV4L2MemoryTransfer) << "Cannot request V4L2_MEMORY_MMAP buffers";
-            return {};
-        }
-
-        std::unique_ptr<MMapMemoryTransfer> result(
-                new MMapMemoryTransfer(std::move(fileDescriptor)));
+    }
 
-        return result->init(buffersCount) ? std::move(result) : nullptr;
+    ~MMapBuffers()
+    {
+        for (auto &span : m_spans)
+            unmapSpan(span);
     }
 
-    bool init(quint32 buffersCount)
+    bool map(quint32 buffersCount)
     {
         for (quint32 index = 0; index < buffersCount; ++index) {
             auto buf = makeV4l2Buffer(V4L2_MEMORY_MMAP, index);
 
-            if (!fileDescriptor().call(VIDIOC_QUERYBUF, &buf)) {
+            if (!m_fileDescriptor->call(VIDIOC_QUERYBUF, &buf)) {
                 qWarning() << "Can't map buffer" << index;
                 return false;
             }
 
             auto mappedData = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
-                                   fileDescriptor().get(), buf.m.offset);
+                                   m_fileDescriptor->get(), buf.m.offset);
 
             if (mappedData == MAP_FAILED) {
                 qWarning() << "mmap failed" << index << buf.length << buf.m.offset;
                 return false;
             }
 
-            m_spans.push_back(MemorySpan{ mappedData, buf.length, false });
+            MemorySpan span;
+            span.data = mappedData;
+            span.size = buf.length;
+            m_spans.push_back(std::move(span));
         }
 
         m_spans.shrink_to_fit();
-
-        return enqueueBuffers();
+        return true;
     }
 
-    ~MMapMemoryTransfer() override
+    // Exports all the buffers as dmabuf file descriptors. If the driver
+    // doesn't support VIDIOC_EXPBUF, the buffers stay CPU-only.
+    bool exportDmaBufs()
     {
-        for (const auto &span : m_spans)
-            munmap(span.data, span.size);
+        for (quint32 index = 0; index < m_spans.size(); ++index) {
+            v4l2_exportbuffer exportBuffer = {};
+            exportBuffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            exportBuffer.index = index;
+            exportBuffer.flags = O_RDONLY | O_CLOEXEC;
+
+            if (!m_fileDescriptor->call(VIDIOC_EXPBUF, &exportBuffer)) {
+                qCDebug(qLcV4L2MemoryTransfer) << "Cannot export buffer" << index
+                                               << "as dmabuf:" << qt_error_string(errno);
+                for (auto &span : m_spans) {
+                    if (span.dmaBufFd >= 0)
+                        qt_safe_close(std::exchange(span.dmaBufFd, -1));
+                }
+                return false;
+            }
+
+            m_spans[index].dmaBufFd = exportBuffer.fd;
+        }
+
+        return true;
     }
 
-    std::optional<Buffer> dequeueBuffer() override
+    quint32 count() const { return static_cast<quint32>(m_spans.size()); }
+
+    int dmaBufFd(quint32 index) const
     {
-        auto v4l2Buffer = makeV4l2Buffer(V4L2_MEMORY_MMAP);
-        if (!fileDescriptor().call(VIDIOC_DQBUF, &v4l2Buffer))
-            return {};
+        QMutexLocker locker(&m_mutex);
+        Q_ASSERT(index < m_spans.size());
+        return m_spans[index].dmaBufFd;
+    }
 
-        const auto index = v4l2Buffer.index;
+    // Marks the dequeued buffer, returns true if it may be held by a frame
+    bool takeDequeued(quint32 index)
+    {
+        QMutexLocker locker(&m_mutex);
 
         Q_ASSERT(index < m_spans.size());
-
         auto &span = m_spans[index];
 
         Q_ASSERT(span.inQueue);
         span.inQueue = false;
 
-        return Buffer{ v4l2Buffer,
-                       QByteArray(reinterpret_cast<const char *>(span.data), span.size) };
+        const auto queuedCount =
+                std::count_if(m_spans.begin(), m_spans.end(), [](const MemorySpan &span) {
+                    return span.inQueue;
+                });
+        span.heldByFrame = static_cast<quint32>(queuedCount) >= MinDriverQueuedBuffers;
+        return span.heldByFrame;
     }
 
-    bool enqueueBuffer(quint32 index) override
+    QByteArray copyData(quint32 index) const
+    {
+        QMutexLocker locker(&m_mutex);
+        Q_ASSERT(index < m_spans.size());
+        const auto &span = m_spans[index];
+        return QByteArray(static_cast<const char *>(span.data), span.size);
+    }
+
+    bool enqueue(quint32 index)
+    {
+        QMutexLocker locker(&m_mutex);
+        return enqueueLocked(index);
+    }
+
+    // Gives the buffers released by frames back to the driver. Frames may be released
+    // on any thread, so this is done by the transfer's thread before dequeuing.
+    bool enqueueReleased()
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (quint32 index = 0; index < m_spans.size(); ++index) {
+            auto &span = m_spans[index];
+            if (!span.released)
+                continue;
+
+            span.released = false;
+            if (!enqueueLocked(index)) {
+                qCWarning(qLcV4L2MemoryTransfer) << "Cannot return released buffer" << index;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::pair<uchar *, size_t> mapFrame(quint32 index)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Q_ASSERT(index < m_spans.size());
+        auto &span = m_spans[index];
+        Q_ASSERT(span.heldByFrame);
+
+        if (!span.detachedData.isNull())
+            return { reinterpret_cast<uchar *>(span.detachedData.data()),
+                     static_cast<size_t>(span.detachedData.size()) };
+
+        ++span.frameMapCount;
+        return { static_cast<uchar *>(span.data), span.size };
+    }
+
+    void unmapFrame(quint32 index)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Q_ASSERT(index < m_spans.size());
+        auto &span = m_spans[index];
+        if (span.detachedData.isNull() && --span.frameMapCount == 0 && m_detached)
+            detachSpan(span);
+    }
+
+    void releaseFrame(quint32 index)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Q_ASSERT(index < m_spans.size());
+        auto &span = m_spans[index];
+        Q_ASSERT(span.heldByFrame);
+        span.heldByFrame = false;
+        span.frameMapCount = 0;
+        span.detachedData = {};
+
+        if (m_detached)
+            unmapSpan(span);
+        else
+            span.released = true;
+    }
+
+    // Called when the transfer is being destroyed. The device can only allocate new
+    // buffers once the old ones are neither mapped nor exported, so the frames still
+    // holding buffers get copies of their data, and the driver memory is unmapped.
+    void detach()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_detached = true;
+
+        for (auto &span : m_spans) {
+            if (!span.heldByFrame)
+                unmapSpan(span);
+            else if (span.frameMapCount == 0)
+                detachSpan(span);
+            // else it is detached once the frame unmaps it
+        }
+    }
+
+private:
+    bool enqueueLocked(quint32 index)
     {
         Q_ASSERT(index < m_spans.size());
         Q_ASSERT(!m_spans[index].inQueue);
+        Q_ASSERT(!m_spans[index].heldByFrame);
 
         auto buf = makeV4l2Buffer(V4L2_MEMORY_MMAP, index);
-        if (!fileDescriptor().call(VIDIOC_QBUF, &buf))
+        if (!m_fileDescriptor->call(VIDIOC_QBUF, &buf))
             return false;
 
         m_spans[index].inQueue = true;
         return true;
     }
 
-    quint32 buffersCount() const override { return static_cast<quint32>(m_spans.size()); }
+    static void detachSpan(MemorySpan &span)
+    {
+        if (span.data)
+            span.detachedData = QByteArray(static_cast<const char *>(span.data), span.size);
+        unmapSpan(span);
+    }
 
-private:
-    using QV4L2MemoryTransfer::QV4L2MemoryTransfer;
+    static void unmapSpan(MemorySpan &span)
+    {
+        if (span.data)
+            munmap(std::exchange(span.data, nullptr), span.size);
+        if (span.dmaBufFd >= 0)
+            qt_safe_close(std::exchange(span.dmaBufFd, -1));
+    }
 
 private:
+    QV4L2FileDescriptorPtr m_fileDescriptor;
+    mutable QMutex m_mutex;
     std::vector<MemorySpan> m_spans;
+    bool m_detached = false;
+};
+
+using MMapBuffersPtr = std::shared_ptr<MMapBuffers>;
+
+// References an mmapped V4L2 buffer and releases it on destruction.
+// Video frames may be released on any thread, hence the buffers are shared with
+// the transfer, which queues the released buffers again on its own thread.
+// If the buffer has been exported, its dmabuf is exposed via dmaBufPlane().
+class MMapVideoBuffer : public QHwVideoBuffer
+{
+public:
+    MMapVideoBuffer(MMapBuffersPtr buffers, quint32 index, int bytesPerLine)
+        : QHwVideoBuffer(QVideoFrame::NoHandle),
+          m_buffers(std::move(buffers)),
+          m_index(index),
+          m_bytesPerLine(bytesPerLine)
+    {
+    }
+
+    ~MMapVideoBuffer() override { m_buffers->releaseFrame(m_index); }
+
+    MapData map(QVideoFrame::MapMode) override
+    {
+        const auto [data, size] = m_buffers->mapFrame(m_index);
+
+        MapData mapData;
+        mapData.planeCount = 1;
+        mapData.bytesPerLine[0] = m_bytesPerLine;
+        mapData.data[0] = data;
+        mapData.dataSize[0] = static_cast<int>(size);
+        return mapData;
+    }
+
+    void unmap() override { m_buffers->unmapFrame(m_index); }
+
+    DmaBufPlane dmaBufPlane(int plane) const override
+    {
+        const int fd = m_buffers->dmaBufFd(m_index);
+        if (plane != 0 || fd < 0)
+            return {};
+
+        return { fd, 0, m_bytesPerLine };
+    }
+
+private:
+    MMapBuffersPtr m_buffers;
+    quint32 m_index;
+    int m_bytesPerLine;
+};
+
+class MMapMemoryTransfer : public QV4L2MemoryTransfer
+{
+public:
+    static QV4L2MemoryTransferUPtr create(QV4L2FileDescriptorPtr fileDescriptor,
+                                          quint32 bytesPerLine, quint32 buffersCount,
+                                          bool exportDmaBufs)
+    {
+        if (!fileDescriptor->requestBuffers(V4L2_MEMORY_MMAP, buffersCount)) {
+            qCWarning(qLcV4L2MemoryTransfer) << "Cannot request V4L2_MEMORY_MMAP buffers";
+            return {};
+        }
+
+        std::unique_ptr<MMapMemoryTransfer> result(
+                new MMapMemoryTransfer(std::move(fileDescriptor), bytesPerLine));
+
+        return result->init(buffersCount, exportDmaBufs) ? std::move(result) : nullptr;
+    }
+
+    bool init(quint32 buffersCount, bool exportDmaBufs)
+    {
+        if (!m_buffers->map(buffersCount))
+            return false;
+
+        if (exportDmaBufs && !m_buffers->exportDmaBufs())
+            qCDebug(qLcV4L2MemoryTransfer) << "DMABUF export is not supported; using MMAP";
+
+        return enqueueBuffers();
+    }
+
+    ~MMapMemoryTransfer() override { m_buffers->detach(); }
+
+    std::optional<Buffer> dequeueBuffer() override
+    {
+        if (!m_buffers->enqueueReleased())
+            return {};
+
+        auto v4l2Buffer = makeV4l2Buffer(V4L2_MEMORY_MMAP);
+        if (!fileDescriptor().call(VIDIOC_DQBUF, &v4l2Buffer))
+            return {};
+
+        const auto index = v4l2Buffer.index;
+
+        Q_ASSERT(index < m_buffers->count());
+
+        if (m_buffers->takeDequeued(index)) {
+            return Buffer{ v4l2Buffer, {},
+                           std::make_unique<MMapVideoBuffer>(m_buffers, index,
+                                                             static_cast<int>(m_bytesPerLine)) };
+        }
+
+        qCDebug(qLcV4L2MemoryTransfer)
+                << "Too few buffers left in the driver queue, copying frame" << index;
+
+        return Buffer{ v4l2Buffer, m_buffers->copyData(index), nullptr };
+    }
+
+    bool enqueueBuffer(quint32 index) override { return m_buffers->enqueue(index); }
+
+    quint32 buffersCount() const override { return m_buffers->count(); }
+
+private:
+    MMapMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor, quint32 bytesPerLine)
+        : QV4L2MemoryTransfer(std::move(fileDescriptor)),
+          m_bytesPerLine(bytesPerLine),
+          m_buffers(std::make_shared<MMapBuffers>(fileDescriptorPtr()))
+    {
+    }
+
+private:
+    quint32 m_bytesPerLine;
+    MMapBuffersPtr m_buffers;
 };
 } // namespace
 
@@ -210,14 +483,23 @@ bool QV4L2MemoryTransfer::enqueueBuffers()
 }
 
 QV4L2MemoryTransferUPtr makeUserPtrMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
-                                                  quint32 imageSize)
+                                                  quint32 imageSize, quint32 buffersCount)
+{
+    return UserPtrMemoryTransfer::create(std::move(fileDescriptor), imageSize, buffersCount);
+}
+
+QV4L2MemoryTransferUPtr makeMMapMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
+                                               quint32 bytesPerLine, quint32 buffersCount)
 {
-    return UserPtrMemoryTransfer::create(std::move(fileDescriptor), imageSize);
+    return MMapMemoryTransfer::create(std::move(fileDescriptor), bytesPerLine, buffersCount,
+                                      false);
 }
 
-QV4L2MemoryTransferUPtr makeMMapMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor)
+QV4L2MemoryTransferUPtr makeDmaBufMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
+                                                 quint32 bytesPerLine, quint32 buffersCount)
 {
-    return MMapMemoryTransfer::create(std::move(fileDescriptor));
+    return MMapMemoryTransfer::create(std::move(fileDescriptor), bytesPerLine, buffersCount,
+                                      true);
 }
 
 QT_END_NAMESPACE
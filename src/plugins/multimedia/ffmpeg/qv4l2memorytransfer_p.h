@@ -6,6 +6,7 @@
 
 #include <private/qtmultimediaglobal_p.h>
 #include <qbytearray.h>
+#include <qabstractvideobuffer.h>
 #include <linux/videodev2.h>
 
 #include <memory>
@@ -33,6 +34,11 @@ public:
     {
         v4l2_buffer v4l2Buffer = {};
         QByteArray data;
+
+        // If set, the buffer references the driver memory directly and must not be
+        // enqueued by the caller. The transfer gives it back to the driver on the next
+        // dequeueBuffer() call after the video buffer has been destroyed.
+        std::unique_ptr<QAbstractVideoBuffer> videoBuffer;
     };
 
     QV4L2MemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor);
@@ -50,6 +56,8 @@ protected:
 
     const QV4L2FileDescriptor &fileDescriptor() const { return *m_fileDescriptor; }
 
+    const QV4L2FileDescriptorPtr &fileDescriptorPtr() const { return m_fileDescriptor; }
+
 private:
     QV4L2FileDescriptorPtr m_fileDescriptor;
 };
@@ -57,9 +65,20 @@ private:
 using QV4L2MemoryTransferUPtr = std::unique_ptr<QV4L2MemoryTransfer>;
 
 QV4L2MemoryTransferUPtr makeUserPtrMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
-                                                  quint32 imageSize);
-
-QV4L2MemoryTransferUPtr makeMMapMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor);
+                                                  quint32 imageSize, quint32 buffersCount = 2);
+
+// Frames reference the mmapped driver buffers without copying as long as enough
+// buffers stay queued in the driver; otherwise the frame data is copied.
+// Frames that outlive the transfer get a copy of their data, so that the device
+// can allocate new buffers.
+QV4L2MemoryTransferUPtr makeMMapMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
+                                               quint32 bytesPerLine, quint32 buffersCount = 4);
+
+// Like the MMAP transfer, but additionally exports the buffers via VIDIOC_EXPBUF so that
+// the frames' QHwVideoBuffer::dmaBufPlane() describes them; falls back to plain MMAP if
+// export fails.
+QV4L2MemoryTransferUPtr makeDmaBufMemoryTransfer(QV4L2FileDescriptorPtr fileDescriptor,
+                                                 quint32 bytesPerLine, quint32 buffersCount = 4);
 
 QT_END_NAMESPACE
 
@@ -101,8 +101,10 @@ void AudioEncoder::addBuffer(const QAudioBuffer &buffer)
         return;
     }
 
+    // Blocking for longer than the buffer's duration would make the audio device overrun
+    waitForQueueSpaceIfBlocking(std::chrono::microseconds(buffer.duration()));
+
     {
-        const std::chrono::microseconds bufferDuration(buffer.duration());
         auto guard = lockLoopData();
 
         resetEndOfSourceStream();
@@ -110,20 +112,30 @@ void AudioEncoder::addBuffer(const QAudioBuffer &buffer)
         if (m_paused)
             return;
 
-        // TODO: apply logic with canPushFrame
+        if (m_encodingStarted && m_audioBufferQueue.isFull()) {
+            reportDroppedFrame();
+
+            // The dropped audio is skipped in the timeline, keeping the next buffers in sync
+            if (m_queuePolicy.mode != EncoderQueuePolicy::DropOldest) {
+                m_audioBufferQueue.dropNewest(buffer);
+                return;
+            }
+
+            m_audioBufferQueue.dropOldest();
+        }
 
         m_audioBufferQueue.push(buffer);
-        m_queueDuration += bufferDuration;
+        updateQueueHighWaterMark(m_audioBufferQueue.size());
     }
 
     dataReady();
 }
 
-QAudioBuffer AudioEncoder::takeBuffer()
+AudioBufferQueue::Entry AudioEncoder::takeBuffer()
 {
     auto locker = lockLoopData();
-    QAudioBuffer result = dequeueIfPossible(m_audioBufferQueue);
-    m_queueDuration -= std::chrono::microseconds(result.duration());
+    AudioBufferQueue::Entry result = m_audioBufferQueue.take();
+    notifyQueueSpace();
     return result;
 }
 
@@ -186,7 +198,7 @@ bool AudioEncoder::init()
 
 void AudioEncoder::cleanup()
 {
-    while (!m_audioBufferQueue.empty())
+    while (!m_audioBufferQueue.isEmpty())
         processOne();
 
     if (m_avFrameSamplesOffset) {
@@ -203,7 +215,7 @@ void AudioEncoder::cleanup()
 
 bool AudioEncoder::hasData() const
 {
-    return !m_audioBufferQueue.empty();
+    return !m_audioBufferQueue.isEmpty();
 }
 
 void AudioEncoder::retrievePackets()
@@ -231,9 +243,12 @@ void AudioEncoder::retrievePackets()
 
 void AudioEncoder::processOne()
 {
-    QAudioBuffer buffer = takeBuffer();
+    const auto [buffer, droppedBefore] = takeBuffer();
     Q_ASSERT(buffer.isValid());
 
+    if (droppedBefore.count() > 0)
+        skipDroppedAudio(droppedBefore);
+
     //    qCDebug(qLcFFmpegEncoder) << "new audio buffer" << buffer.byteCount() << buffer.format()
     //    << buffer.frameCount() << codec->frame_size;
 
@@ -249,12 +264,17 @@ void AudioEncoder::processOne()
     Q_ASSERT(samplesOffset == bufferSamplesCount);
 }
 
+bool AudioEncoder::isQueueFull() const
+{
+    return m_audioBufferQueue.isFull();
+}
+
 bool AudioEncoder::checkIfCanPushFrame() const
 {
     if (m_encodingStarted)
-        return m_audioBufferQueue.size() <= 1 || m_queueDuration < m_maxQueueDuration;
+        return !m_audioBufferQueue.isFull();
     if (!isFinished())
-        return m_audioBufferQueue.empty();
+        return m_audioBufferQueue.isEmpty();
 
     return false;
 }
@@ -391,6 +411,34 @@ void AudioEncoder::sendPendingFrameToAVCodec()
     std::fill(m_avFramePlanesData.begin(), m_avFramePlanesData.end(), nullptr);
 }
 
+void AudioEncoder::skipDroppedAudio(std::chrono::microseconds duration)
+{
+    qint64 samples = av_rescale(duration.count(), m_codecContext->sample_rate, 1'000'000);
+
+    // The pts of the pending frame is set; fill it up with silence, keeping the frame size
+    if (m_avFrame && samples > 0) {
+#if QT_FFMPEG_HAS_AV_CHANNEL_LAYOUT
+        const int channelsCount = m_codecContext->ch_layout.nb_channels;
+#else
+        const int channelsCount = m_codecContext->channels;
+#endif
+        const int silentSamples = static_cast<int>(
+                qMin<qint64>(samples, m_avFrame->nb_samples - m_avFrameSamplesOffset));
+        av_samples_set_silence(m_avFrame->extended_data, m_avFrameSamplesOffset, silentSamples,
+                               channelsCount, m_codecContext->sample_fmt);
+        m_avFrameSamplesOffset += silentSamples;
+        samples -= silentSamples;
+
+        if (m_avFrameSamplesOffset == m_avFrame->nb_samples) {
+            retrievePackets();
+            sendPendingFrameToAVCodec();
+        }
+    }
+
+    // The next frame starts after the gap
+    m_samplesWritten += samples;
+}
+
 void AudioEncoder::handleAudioData(const uchar *data, int &samplesOffset, int samplesCount)
 {
     ensurePendingFrame(samplesCount - samplesOffset);
@@ -7,7 +7,6 @@
 #include "qffmpegencoderthread_p.h"
 #include "private/qplatformmediarecorder_p.h"
 #include <qaudiobuffer.h>
-#include <queue>
 #include <chrono>
 
 QT_BEGIN_NAMESPACE
@@ -26,9 +25,10 @@ public:
 
 protected:
     bool checkIfCanPushFrame() const override;
+    bool isQueueFull() const override;
 
 private:
-    QAudioBuffer takeBuffer();
+    AudioBufferQueue::Entry takeBuffer();
     void retrievePackets();
     bool updateResampler(const QAudioFormat &sourceFormat);
 
@@ -45,13 +45,12 @@ private:
 
     void sendPendingFrameToAVCodec();
 
-private:
-    std::queue<QAudioBuffer> m_audioBufferQueue;
-
-    // Arbitrarily chosen to limit audio queue duration
-    const std::chrono::microseconds m_maxQueueDuration = std::chrono::seconds(5);
+    // Advances the timeline by the audio dropped due to the queue overflow
+    void skipDroppedAudio(std::chrono::microseconds duration);
 
-    std::chrono::microseconds m_queueDuration{ 0 };
+private:
+    // The duration is arbitrarily limited to 5 seconds
+    AudioBufferQueue m_audioBufferQueue;
 
     AVStream *m_stream = nullptr;
     AVCodecContextUPtr m_codecContext;
@@ -0,0 +1,117 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "qffmpegencoderqueue_p.h"
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qloggingcategory.h>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+static Q_LOGGING_CATEGORY(qLcEncoderQueue, "qt.multimedia.ffmpeg.encoderqueue");
+
+EncoderQueuePolicy EncoderQueuePolicy::defaultPolicy()
+{
+    static const EncoderQueuePolicy policy = fromEnvironment();
+    return policy;
+}
+
+EncoderQueuePolicy EncoderQueuePolicy::fromEnvironment()
+{
+    const QByteArray mode = qgetenv("QT_FFMPEG_ENCODING_QUEUE_POLICY");
+    if (mode.isEmpty())
+        return {};
+
+    const std::optional<EncoderQueuePolicy> result = fromName(mode);
+    if (!result)
+        qCWarning(qLcEncoderQueue) << "Unknown encoding queue policy" << mode;
+    return result.value_or(EncoderQueuePolicy{});
+}
+
+std::optional<EncoderQueuePolicy> EncoderQueuePolicy::fromName(QByteArrayView name)
+{
+    EncoderQueuePolicy result;
+    if (name == "drop-newest")
+        result.mode = DropNewest;
+    else if (name == "drop-oldest")
+        result.mode = DropOldest;
+    else if (name == "block")
+        result.mode = Block;
+    else if (name == "degrade")
+        result.mode = Degrade;
+    else
+        return std::nullopt;
+    return result;
+}
+
+QDebug operator<<(QDebug dbg, const EncoderQueueStatistics &statistics)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "EncoderQueueStatistics(dropped: " << statistics.droppedFrames
+                  << ", skipped: " << statistics.skippedFrames
+                  << ", high water mark: " << statistics.queueHighWaterMark << ')';
+    return dbg;
+}
+
+QDebug operator<<(QDebug dbg, const RecordingQueueStatistics &statistics)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "RecordingQueueStatistics(audio: " << statistics.audio
+                  << ", video: " << statistics.video << ')';
+    return dbg;
+}
+
+int degradedFrameInterval(size_t queueSize, size_t maxQueueSize)
+{
+    if (queueSize * 4 >= maxQueueSize * 3)
+        return 3;
+    if (queueSize * 2 >= maxQueueSize)
+        return 2;
+    return 1;
+}
+
+void AudioBufferQueue::push(const QAudioBuffer &buffer)
+{
+    m_entries.push_back({ buffer, std::exchange(m_droppedAfterLast, {}) });
+    m_duration += std::chrono::microseconds(buffer.duration());
+}
+
+void AudioBufferQueue::dropNewest(const QAudioBuffer &buffer)
+{
+    m_droppedAfterLast += std::chrono::microseconds(buffer.duration());
+}
+
+void AudioBufferQueue::dropOldest()
+{
+    if (m_entries.empty())
+        return;
+
+    const Entry &oldest = m_entries.front();
+    const std::chrono::microseconds bufferDuration(oldest.buffer.duration());
+    const std::chrono::microseconds gap = oldest.droppedBefore + bufferDuration;
+    m_duration -= bufferDuration;
+    m_entries.pop_front();
+
+    if (m_entries.empty())
+        m_droppedAfterLast += gap;
+    else
+        m_entries.front().droppedBefore += gap;
+}
+
+AudioBufferQueue::Entry AudioBufferQueue::take()
+{
+    if (m_entries.empty())
+        return {};
+
+    Entry result = std::move(m_entries.front());
+    m_entries.pop_front();
+    m_duration -= std::chrono::microseconds(result.buffer.duration());
+    return result;
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,139 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#ifndef QFFMPEGENCODERQUEUE_P_H
+#define QFFMPEGENCODERQUEUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtMultimedia/qaudiobuffer.h>
+#include <QtCore/qbytearrayview.h>
+
+#include <chrono>
+#include <deque>
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+namespace QFFmpeg {
+
+// Defines what an encoder does with new data if its queue is full,
+// i.e. if the encoder cannot keep up with the source.
+struct EncoderQueuePolicy
+{
+    enum Mode {
+        DropNewest, // drop the incoming frame
+        DropOldest, // drop the oldest queued frame to make room for the incoming one
+        Block,      // block the source until there is room, up to maxBlockingTime
+        Degrade,    // lower the frame rate once the queue fills up; the same as
+                    // DropNewest for audio
+    };
+
+    Mode mode = DropNewest;
+
+    // Short, since the source might be a capture device thread. Audio sources
+    // are not blocked for longer than the duration of the incoming buffer.
+    std::chrono::milliseconds maxBlockingTime = std::chrono::milliseconds(50);
+
+    // DropNewest, can be overridden by QT_FFMPEG_ENCODING_QUEUE_POLICY set to
+    // drop-newest, drop-oldest, block or degrade. The environment is read once.
+    static EncoderQueuePolicy defaultPolicy();
+
+    // Reads the environment variable on each call
+    static EncoderQueuePolicy fromEnvironment();
+
+    // Parses the names accepted by QT_FFMPEG_ENCODING_QUEUE_POLICY;
+    // returns nullopt for an unknown name.
+    static std::optional<EncoderQueuePolicy> fromName(QByteArrayView name);
+};
+
+struct EncoderQueueStatistics
+{
+    quint64 droppedFrames = 0; // lost due to the queue overflow
+    quint64 skippedFrames = 0; // skipped on purpose by EncoderQueuePolicy::Degrade
+    qsizetype queueHighWaterMark = 0;
+
+    EncoderQueueStatistics &operator+=(const EncoderQueueStatistics &other)
+    {
+        droppedFrames += other.droppedFrames;
+        skippedFrames += other.skippedFrames;
+        queueHighWaterMark = qMax(queueHighWaterMark, other.queueHighWaterMark);
+        return *this;
+    }
+};
+
+struct RecordingQueueStatistics
+{
+    EncoderQueueStatistics audio;
+    EncoderQueueStatistics video;
+};
+
+QDebug operator<<(QDebug dbg, const EncoderQueueStatistics &statistics);
+QDebug operator<<(QDebug dbg, const RecordingQueueStatistics &statistics);
+
+// With EncoderQueuePolicy::Degrade, every n-th frame is kept: every frame while
+// the queue is below the half, then every second, then every third one from
+// three quarters on.
+int degradedFrameInterval(size_t queueSize, size_t maxQueueSize);
+
+/*!
+    The queue of the audio encoder, bounded by the duration of the queued audio.
+
+    The audio pts are derived from the count of the encoded samples, so dropped
+    buffers must not shift the following audio back in time. The queue tracks
+    the duration dropped in front of each buffer, which the encoder skips in
+    the timeline before encoding the buffer.
+ */
+class AudioBufferQueue
+{
+public:
+    struct Entry
+    {
+        QAudioBuffer buffer;
+        std::chrono::microseconds droppedBefore{ 0 };
+    };
+
+    explicit AudioBufferQueue(std::chrono::microseconds maxDuration = std::chrono::seconds(5))
+        : m_maxDuration(maxDuration)
+    {
+    }
+
+    // Always takes at least two buffers
+    bool isFull() const { return m_entries.size() > 1 && m_duration >= m_maxDuration; }
+    bool isEmpty() const { return m_entries.empty(); }
+    qsizetype size() const { return static_cast<qsizetype>(m_entries.size()); }
+    std::chrono::microseconds duration() const { return m_duration; }
+
+    void push(const QAudioBuffer &buffer);
+
+    // Drops the incoming buffer, leaving a gap in front of the next pushed one
+    void dropNewest(const QAudioBuffer &buffer);
+
+    // Drops the oldest buffer, leaving a gap in front of the following one
+    void dropOldest();
+
+    // Returns an empty entry if the queue is empty
+    Entry take();
+
+private:
+    std::deque<Entry> m_entries;
+    std::chrono::microseconds m_duration{ 0 };
+    std::chrono::microseconds m_droppedAfterLast{ 0 };
+    const std::chrono::microseconds m_maxDuration;
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGENCODERQUEUE_P_H
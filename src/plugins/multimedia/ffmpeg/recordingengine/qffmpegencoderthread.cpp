@@ -2,11 +2,15 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 #include "qffmpegencoderthread_p.h"
 #include "qmetaobject.h"
+#include "qdeadlinetimer.h"
+#include "qloggingcategory.h"
 
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg {
 
+static Q_LOGGING_CATEGORY(qLcEncoderThread, "qt.multimedia.ffmpeg.encoderthread");
+
 EncoderThread::EncoderThread(RecordingEngine &recordingEngine) : m_recordingEngine(recordingEngine)
 {
 }
@@ -15,6 +19,7 @@ void EncoderThread::setPaused(bool paused)
 {
     auto guard = lockLoopData();
     m_paused = paused;
+    notifyQueueSpace();
 }
 
 void EncoderThread::setAutoStop(bool autoStop)
@@ -23,6 +28,45 @@ void EncoderThread::setAutoStop(bool autoStop)
     m_autoStop = autoStop;
 }
 
+void EncoderThread::setQueuePolicy(const EncoderQueuePolicy &policy)
+{
+    auto guard = lockLoopData();
+    m_queuePolicy = policy;
+    notifyQueueSpace();
+}
+
+EncoderQueueStatistics EncoderThread::queueStatistics() const
+{
+    auto locker = ConsumerThread::lockLoopData();
+    return m_queueStatistics;
+}
+
+void EncoderThread::waitForQueueSpaceIfBlocking(std::chrono::microseconds maxTime)
+{
+    auto locker = ConsumerThread::lockLoopData();
+    if (m_queuePolicy.mode != EncoderQueuePolicy::Block)
+        return;
+
+    using std::chrono::microseconds;
+    QDeadlineTimer deadline(qMin<microseconds>(m_queuePolicy.maxBlockingTime, maxTime));
+    while (m_encodingStarted && !m_paused && isQueueFull()) {
+        if (!m_queueSpaceCondition.wait(locker.mutex(), deadline))
+            break; // the frame is to be dropped
+    }
+}
+
+void EncoderThread::updateQueueHighWaterMark(qsizetype queueSize)
+{
+    m_queueStatistics.queueHighWaterMark = qMax(m_queueStatistics.queueHighWaterMark, queueSize);
+}
+
+void EncoderThread::reportDroppedFrame()
+{
+    if (m_queueStatistics.droppedFrames++ == 0)
+        qCWarning(qLcEncoderThread) << "Encoder" << this
+                                    << "cannot keep up with the source, dropping data";
+}
+
 void EncoderThread::setEndOfSourceStream()
 {
     {
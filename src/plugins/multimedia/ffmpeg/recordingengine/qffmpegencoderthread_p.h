@@ -4,11 +4,15 @@
 #define QFFMPEGENCODERTHREAD_P_H
 
 #include "qffmpegthread_p.h"
+#include "qffmpegencoderqueue_p.h"
 #include "qpointer.h"
 #include "qsemaphore.h"
+#include "qwaitcondition.h"
 
 #include "private/qmediainputencoderinterface_p.h"
 
+#include <chrono>
+
 QT_BEGIN_NAMESPACE
 
 namespace QFFmpeg {
@@ -39,6 +43,10 @@ public:
 
     bool isInitialized() const { return m_initialized; }
 
+    void setQueuePolicy(const EncoderQueuePolicy &policy);
+
+    EncoderQueueStatistics queueStatistics() const;
+
 protected:
     bool init() override;
 
@@ -48,6 +56,30 @@ protected:
 
     void resetEndOfSourceStream() { m_endOfSourceStream = false; }
 
+    /*!
+        Must return true if the queue cannot take more data without dropping
+        or degrading; called with the loop data locked.
+     */
+    virtual bool isQueueFull() const = 0;
+
+    /*!
+        With the Block policy, waits until the queue is not full or the blocking
+        time limit is reached; \a maxTime lowers the limit of the policy.
+        Must be called with the loop data unlocked.
+     */
+    void waitForQueueSpaceIfBlocking(
+            std::chrono::microseconds maxTime = std::chrono::microseconds::max());
+
+    /*!
+        Wakes up the source waiting for the queue space;
+        to be called with the loop data locked after data has been dequeued.
+     */
+    void notifyQueueSpace() { m_queueSpaceCondition.wakeAll(); }
+
+    // To be called with the loop data locked
+    void updateQueueHighWaterMark(qsizetype queueSize);
+    void reportDroppedFrame();
+
     auto lockLoopData()
     {
         return QScopeGuard([this, locker = ConsumerThread::lockLoopData()]() mutable {
@@ -74,6 +106,13 @@ protected:
     RecordingEngine &m_recordingEngine;
     QPointer<QObject> m_source;
     QSemaphore m_encodingStartSemaphore;
+
+    // Protected by the loop data mutex
+    EncoderQueuePolicy m_queuePolicy = EncoderQueuePolicy::defaultPolicy();
+    EncoderQueueStatistics m_queueStatistics;
+
+private:
+    QWaitCondition m_queueSpaceCondition;
 };
 
 } // namespace QFFmpeg
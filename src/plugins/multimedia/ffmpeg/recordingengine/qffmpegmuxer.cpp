@@ -27,10 +27,10 @@ void Muxer::addPacket(AVPacketUPtr packet)
     dataReady();
 }
 
-AVPacketUPtr Muxer::takePacket()
+std::queue<AVPacketUPtr> Muxer::takePackets()
 {
     QMutexLocker locker = lockLoopData();
-    return dequeueIfPossible(m_packetQueue);
+    return std::exchange(m_packetQueue, {});
 }
 
 bool Muxer::init()
@@ -52,12 +52,16 @@ bool QFFmpeg::Muxer::hasData() const
 
 void Muxer::processOne()
 {
-    auto packet = takePacket();
-    //   qCDebug(qLcFFmpegEncoder) << "writing packet to file" << packet->pts << packet->duration <<
-    //   packet->stream_index;
+    // Drain the whole queue per wake-up to avoid locking the loop data per packet
+    auto packets = takePackets();
 
-    // the function takes ownership for the packet
-    av_interleaved_write_frame(m_encoder->avFormatContext(), packet.release());
+    for (; !packets.empty(); packets.pop()) {
+        //   qCDebug(qLcFFmpegEncoder) << "writing packet to file" << packets.front()->pts <<
+        //   packets.front()->duration << packets.front()->stream_index;
+
+        // the function takes ownership for the packet
+        av_interleaved_write_frame(m_encoder->avFormatContext(), packets.front().release());
+    }
 }
 
 } // namespace QFFmpeg
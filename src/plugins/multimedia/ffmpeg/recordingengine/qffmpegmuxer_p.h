@@ -21,7 +21,7 @@ public:
     void addPacket(AVPacketUPtr packet);
 
 private:
-    AVPacketUPtr takePacket();
+    std::queue<AVPacketUPtr> takePackets();
 
     bool init() override;
     void cleanup() override;
@@ -0,0 +1,59 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "qffmpegoutputfragmentation_p.h"
+
+#include <QtCore/qbytearrayview.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+OutputFragmentation OutputFragmentation::defaultFragmentation()
+{
+    static const OutputFragmentation fragmentation = fromEnvironment();
+    return fragmentation;
+}
+
+OutputFragmentation OutputFragmentation::fromEnvironment()
+{
+    OutputFragmentation result;
+    bool ok = false;
+    const int duration =
+            qEnvironmentVariableIntValue("QT_FFMPEG_ENCODING_FRAGMENT_DURATION_MS", &ok);
+    if (ok && duration > 0)
+        result.fragmentDuration = std::chrono::milliseconds(duration);
+    return result;
+}
+
+bool OutputFragmentation::addMuxerOptions(const AVOutputFormat *format,
+                                          AVDictionary **options) const
+{
+    Q_ASSERT(format);
+    Q_ASSERT(options);
+
+    if (!isEnabled())
+        return true;
+
+    const QByteArrayView formatName = format->name;
+    const qint64 durationMs = fragmentDuration.count();
+
+    if (formatName == "mp4" || formatName == "mov" || formatName == "ipod") {
+        // Fragmented MP4: an empty moov upfront, then self-contained moof+mdat fragments,
+        // started at keyframes once the fragment duration is reached
+        av_dict_set(options, "movflags", "frag_keyframe+empty_moov+default_base_moof", 0);
+        av_dict_set_int(options, "min_frag_duration", durationMs * 1000, 0);
+        return true;
+    }
+
+    if (formatName == "matroska" || formatName == "webm") {
+        // Matroska clusters are self-contained; only the cues are written in the trailer
+        av_dict_set_int(options, "cluster_time_limit", durationMs, 0);
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
@@ -0,0 +1,51 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#ifndef QFFMPEGOUTPUTFRAGMENTATION_P_H
+#define QFFMPEGOUTPUTFRAGMENTATION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qffmpegdefs_p.h"
+
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFFmpeg {
+
+// Makes the muxer write the container index along with the data, fragment by fragment,
+// instead of in the trailer. Thus, the output stays playable if the recording is
+// interrupted, finalization doesn't depend on the recording duration, and the written
+// part can be consumed while recording is in progress.
+struct OutputFragmentation
+{
+    std::chrono::milliseconds fragmentDuration{ 0 }; // 0 disables fragmentation
+
+    bool isEnabled() const { return fragmentDuration.count() > 0; }
+
+    // Adds the muxer options implementing the fragmentation to the options for
+    // avformat_write_header; returns false if the output format doesn't support it.
+    bool addMuxerOptions(const AVOutputFormat *format, AVDictionary **options) const;
+
+    // Disabled, can be overridden by QT_FFMPEG_ENCODING_FRAGMENT_DURATION_MS.
+    // The environment is read once.
+    static OutputFragmentation defaultFragmentation();
+
+    // Reads the environment variable on each call
+    static OutputFragmentation fromEnvironment();
+};
+
+} // namespace QFFmpeg
+
+QT_END_NAMESPACE
+
+#endif // QFFMPEGOUTPUTFRAGMENTATION_P_H
@@ -85,8 +85,12 @@ AudioEncoder *RecordingEngine::createAudioEncoder(const QAudioFormat &format)
     Q_ASSERT(format.isValid());
 
     auto audioEncoder = new AudioEncoder(*this, format, m_settings);
+    audioEncoder->setQueuePolicy(m_queuePolicy);
 
-    m_audioEncoders.emplace_back(audioEncoder);
+    {
+        QMutexLocker locker(&m_encodersMutex);
+        m_audioEncoders.emplace_back(audioEncoder);
+    }
     connect(audioEncoder, &EncoderThread::endOfSourceStream, this,
             &RecordingEngine::handleSourceEndOfStream);
     connect(audioEncoder, &EncoderThread::initialized, this,
@@ -125,7 +129,11 @@ void RecordingEngine::addVideoSource(QPlatformVideoSource *source, const QVideoF
                               << "ffmpegHWPixelFormat=" << (hwPixelFormat ? *hwPixelFormat : AV_PIX_FMT_NONE);
 
     auto videoEncoder = new VideoEncoder(*this, m_settings, frameFormat, hwPixelFormat);
-    m_videoEncoders.emplace_back(videoEncoder);
+    videoEncoder->setQueuePolicy(m_queuePolicy);
+    {
+        QMutexLocker locker(&m_encodersMutex);
+        m_videoEncoders.emplace_back(videoEncoder);
+    }
     if (m_autoStop)
         videoEncoder->setAutoStop(true);
 
@@ -199,7 +207,9 @@ void RecordingEngine::EncodingFinalizer::run()
     // else ffmpeg might crash
 
     // close AVIO before emitting finalizationDone.
-    m_recordingEngine.m_formatContext->closeAVIO();
+    if (!m_recordingEngine.m_formatContext->closeAVIO())
+        emit m_recordingEngine.sessionError(QMediaRecorder::ResourceError,
+                                            QLatin1String("Cannot write to the output"));
 
     qCDebug(qLcFFmpegEncoder) << "    done finalizing.";
     emit m_recordingEngine.finalizationDone();
@@ -241,6 +251,31 @@ void RecordingEngine::setAutoStop(bool autoStop)
     handleSourceEndOfStream();
 }
 
+void RecordingEngine::setQueuePolicy(const EncoderQueuePolicy &policy)
+{
+    m_queuePolicy = policy;
+    forEachEncoder(&EncoderThread::setQueuePolicy, policy);
+}
+
+RecordingQueueStatistics RecordingEngine::queueStatistics() const
+{
+    RecordingQueueStatistics result;
+
+    QMutexLocker locker(&m_encodersMutex);
+    for (auto &audioEncoder : m_audioEncoders)
+        result.audio += audioEncoder->queueStatistics();
+    for (auto &videoEncoder : m_videoEncoders)
+        result.video += videoEncoder->queueStatistics();
+
+    return result;
+}
+
+void RecordingEngine::setFragmentation(const OutputFragmentation &fragmentation)
+{
+    Q_ASSERT(m_state == State::None || m_state == State::FormatsInitialization);
+    m_fragmentation = fragmentation;
+}
+
 void RecordingEngine::setMetaData(const QMediaMetaData &metaData)
 {
     m_metaData = metaData;
@@ -286,7 +321,12 @@ void RecordingEngine::handleEncoderInitialization()
 
     avFormatContext()->metadata = QFFmpegMetaData::toAVMetaData(m_metaData);
 
-    const int res = avformat_write_header(avFormatContext(), nullptr);
+    AVDictionaryHolder options;
+    if (!m_fragmentation.addMuxerOptions(avFormatContext()->oformat, options))
+        qCWarning(qLcFFmpegEncoder) << "Fragmentation is not supported by the output format;"
+                                    << "the index is written on finalization";
+
+    const int res = avformat_write_header(avFormatContext(), options);
     if (res < 0) {
         qWarning() << "could not write header, error:" << res << err2str(res);
         emit sessionError(QMediaRecorder::ResourceError,
@@ -294,6 +334,11 @@ void RecordingEngine::handleEncoderInitialization()
         return;
     }
 
+    // The muxer leaves the options it doesn't know in the dictionary
+    const AVDictionaryEntry *option = nullptr;
+    while ((option = av_dict_get(options.opts, "", option, AV_DICT_IGNORE_SUFFIX)))
+        qCWarning(qLcFFmpegEncoder) << "The muxer ignored the option" << option->key;
+
     qCDebug(qLcFFmpegEncoder) << "stream header is successfully written";
 
     m_state = State::Encoding;
@@ -303,8 +348,17 @@ void RecordingEngine::handleEncoderInitialization()
 
 void RecordingEngine::stopAndDeleteThreads()
 {
-    m_audioEncoders.clear();
-    m_videoEncoders.clear();
+    // Taken out under the lock, but stopped without it
+    std::vector<ConsumerThreadUPtr<AudioEncoder>> audioEncoders;
+    std::vector<ConsumerThreadUPtr<VideoEncoder>> videoEncoders;
+    {
+        QMutexLocker locker(&m_encodersMutex);
+        audioEncoders.swap(m_audioEncoders);
+        videoEncoders.swap(m_videoEncoders);
+    }
+
+    audioEncoders.clear();
+    videoEncoders.clear();
     m_muxer.reset();
 }
 
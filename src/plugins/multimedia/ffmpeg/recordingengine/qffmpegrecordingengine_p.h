@@ -15,7 +15,9 @@
 //
 
 #include "qffmpegthread_p.h"
+#include "qffmpegencoderthread_p.h"
 #include "qffmpegencodingformatcontext_p.h"
+#include "qffmpegoutputfragmentation_p.h"
 
 #include <private/qplatformmediarecorder_p.h>
 #include <qmediarecorder.h>
@@ -56,6 +58,14 @@ public:
 
     bool autoStop() const { return m_autoStop; }
 
+    void setQueuePolicy(const EncoderQueuePolicy &policy);
+
+    // Summed up over the encoders; empty once the encoders have been deleted
+    RecordingQueueStatistics queueStatistics() const;
+
+    // Must be set before the encoders are initialized
+    void setFragmentation(const OutputFragmentation &fragmentation);
+
     void setMetaData(const QMediaMetaData &metaData);
     AVFormatContext *avFormatContext() { return m_formatContext->avFormatContext(); }
     Muxer *getMuxer() { return m_muxer.get(); }
@@ -129,6 +139,9 @@ private:
     std::unique_ptr<EncodingFormatContext> m_formatContext;
     ConsumerThreadUPtr<Muxer> m_muxer;
 
+    // Guards the encoder lists against queueStatistics(), which may be called from
+    // another thread while the finalizer deletes the encoders
+    mutable QMutex m_encodersMutex;
     std::vector<ConsumerThreadUPtr<AudioEncoder>> m_audioEncoders;
     std::vector<ConsumerThreadUPtr<VideoEncoder>> m_videoEncoders;
     std::unique_ptr<EncodingInitializer> m_formatsInitializer;
@@ -137,6 +150,8 @@ private:
     qint64 m_timeRecorded = 0;
 
     bool m_autoStop = false;
+    EncoderQueuePolicy m_queuePolicy = EncoderQueuePolicy::defaultPolicy();
+    OutputFragmentation m_fragmentation = OutputFragmentation::defaultFragmentation();
     size_t m_initializedEncodersCount = 0;
     State m_state = State::None;
 };
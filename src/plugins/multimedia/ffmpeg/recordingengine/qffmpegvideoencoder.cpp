@@ -59,6 +59,8 @@ void VideoEncoder::addFrame(const QVideoFrame &frame)
         return;
     }
 
+    waitForQueueSpaceIfBlocking();
+
     {
         auto guard = lockLoopData();
 
@@ -69,17 +71,32 @@ void VideoEncoder::addFrame(const QVideoFrame &frame)
             return;
         }
 
+        if (m_queuePolicy.mode == EncoderQueuePolicy::Degrade && !shouldKeepFrameWhenDegrading()) {
+            ++m_queueStatistics.skippedFrames;
+            return;
+        }
+
         // Drop frames if encoder can not keep up with the video source data rate;
         // canPushFrame might be used instead
-        const bool queueFull = m_videoFrameQueue.size() >= m_maxQueueSize;
-
-        if (queueFull) {
+        if (isQueueFull()) {
             qCDebug(qLcFFmpegVideoEncoder) << "RecordingEngine frame queue full. Frame lost.";
-            return;
+            reportDroppedFrame();
+
+            if (m_queuePolicy.mode != EncoderQueuePolicy::DropOldest)
+                return;
+
+            // The time base adjustment should apply to the next frame in the queue
+            const bool shouldAdjustTimeBase = m_videoFrameQueue.front().shouldAdjustTimeBase;
+            m_videoFrameQueue.pop();
+            if (m_videoFrameQueue.empty())
+                m_shouldAdjustTimeBaseForNextFrame |= shouldAdjustTimeBase;
+            else
+                m_videoFrameQueue.front().shouldAdjustTimeBase |= shouldAdjustTimeBase;
         }
 
         m_videoFrameQueue.push({ frame, m_shouldAdjustTimeBaseForNextFrame });
         m_shouldAdjustTimeBaseForNextFrame = false;
+        updateQueueHighWaterMark(m_videoFrameQueue.size());
     }
 
     dataReady();
@@ -88,7 +105,15 @@ void VideoEncoder::addFrame(const QVideoFrame &frame)
 VideoEncoder::FrameInfo VideoEncoder::takeFrame()
 {
     auto guard = lockLoopData();
-    return dequeueIfPossible(m_videoFrameQueue);
+    FrameInfo result = dequeueIfPossible(m_videoFrameQueue);
+    notifyQueueSpace();
+    return result;
+}
+
+bool VideoEncoder::shouldKeepFrameWhenDegrading()
+{
+    const int keepEvery = degradedFrameInterval(m_videoFrameQueue.size(), m_maxQueueSize);
+    return m_degradationCounter++ % keepEvery == 0;
 }
 
 void VideoEncoder::retrievePackets()
@@ -157,9 +182,10 @@ void VideoEncoder::processOne()
 
     auto *videoBuffer = dynamic_cast<QFFmpegVideoBuffer *>(QVideoFramePrivate::hwBuffer(frame));
     if (videoBuffer) {
-        // ffmpeg video buffer, let's use the native AVFrame stored in there
+        // ffmpeg video buffer, let's use the native AVFrame stored in there;
+        // the frame encoder maps or downloads it if it differs from the encoder's hw format
         auto *hwFrame = videoBuffer->getHWFrame();
-        if (hwFrame && hwFrame->format == m_frameEncoder->sourceFormat())
+        if (hwFrame && hwFrame->hw_frames_ctx)
             avFrame.reset(av_frame_clone(hwFrame));
     }
 
@@ -167,7 +193,10 @@ void VideoEncoder::processOne()
         frame.map(QVideoFrame::ReadOnly);
         auto size = frame.size();
         avFrame = makeAVFrame();
-        avFrame->format = m_frameEncoder->sourceFormat();
+        // The mapped data is in the frame's sw format. The frame encoder's source format
+        // may be a hw one, and it follows the format of the last frame sent.
+        const AVPixelFormat swFormat = QFFmpegVideoBuffer::toAVPixelFormat(frame.pixelFormat());
+        avFrame->format = isSwPixelFormat(swFormat) ? swFormat : m_sourceParams.swFormat;
         avFrame->width = size.width();
         avFrame->height = size.height();
 
@@ -224,6 +253,11 @@ void VideoEncoder::processOne()
     }
 }
 
+bool VideoEncoder::isQueueFull() const
+{
+    return m_videoFrameQueue.size() >= m_maxQueueSize;
+}
+
 bool VideoEncoder::checkIfCanPushFrame() const
 {
     if (m_encodingStarted)
@@ -28,6 +28,7 @@ public:
 
 protected:
     bool checkIfCanPushFrame() const override;
+    bool isQueueFull() const override;
 
 private:
     struct FrameInfo
@@ -46,6 +47,9 @@ private:
 
     std::pair<qint64, qint64> frameTimeStamps(const QVideoFrame &frame) const;
 
+    // Returns false if the frame is to be skipped to lower the frame rate
+    bool shouldKeepFrameWhenDegrading();
+
 private:
     QMediaEncoderSettings m_settings;
     VideoFrameEncoder::SourceParams m_sourceParams;
@@ -56,6 +60,7 @@ private:
     qint64 m_baseTime = 0;
     bool m_shouldAdjustTimeBaseForNextFrame = true;
     qint64 m_lastFrameTime = 0;
+    quint64 m_degradationCounter = 0;
 };
 
 } // namespace QFFmpeg
@@ -8,6 +8,8 @@
 #include "qffmpegcodecstorage_p.h"
 #include <qloggingcategory.h>
 #include <QtMultimedia/private/qmaybe_p.h>
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <QtCore/qthread.h>
 
 extern "C" {
 #include "libavutil/display.h"
@@ -22,6 +24,29 @@ namespace QFFmpeg {
 
 namespace {
 
+// The number of frames scaled ahead of the codec, 0 scales synchronously
+int maxPendingFrames()
+{
+    static const int count = [] {
+        bool ok = false;
+        const int count = qEnvironmentVariableIntValue("QT_FFMPEG_ENCODING_CONVERSION_THREADS", &ok);
+        return ok ? qBound(0, count, 16) : qMin(QThread::idealThreadCount() / 2, 4);
+    }();
+    return count;
+}
+
+// Mapping hw frames between devices, can be disabled by QT_FFMPEG_ENCODING_HW_FRAME_MAPPING=0
+// to force the conversion via the CPU memory
+bool isHWFrameMappingEnabled()
+{
+    static const bool enabled = [] {
+        bool ok = false;
+        const int value = qEnvironmentVariableIntValue("QT_FFMPEG_ENCODING_HW_FRAME_MAPPING", &ok);
+        return !ok || value != 0;
+    }();
+    return enabled;
+}
+
 AVCodecID avCodecID(const QMediaEncoderSettings &settings)
 {
     const QMediaFormat::VideoCodec qVideoCodec = settings.videoCodec();
@@ -127,8 +152,11 @@ VideoFrameEncoder::VideoFrameEncoder(AVStream *stream, const AVCodec *codec, HWA
       m_accel(std::move(hwAccel)),
       m_sourceSize(sourceParams.size),
       m_sourceFormat(sourceParams.format),
-      m_sourceSWFormat(sourceParams.swFormat)
+      m_sourceSWFormat(sourceParams.swFormat),
+      m_maxPendingFrames(maxPendingFrames())
 {
+    m_conversionThreadPool.setMaxThreadCount(qMax(m_maxPendingFrames, 1));
+    m_conversionThreadPool.setObjectName(QStringLiteral("VideoFrameEncoderConversion"));
 }
 
 AVStream *VideoFrameEncoder::createStream(const SourceParams &sourceParams,
@@ -253,7 +281,11 @@ bool VideoFrameEncoder::initTargetFormats(const AVPixelFormatSet &prohibitedTarg
     return true;
 }
 
-VideoFrameEncoder::~VideoFrameEncoder() = default;
+VideoFrameEncoder::~VideoFrameEncoder()
+{
+    // The conversions read the source frames
+    m_conversionThreadPool.waitForDone();
+}
 
 void VideoFrameEncoder::initStream()
 {
@@ -349,6 +381,36 @@ const AVRational &VideoFrameEncoder::getTimeBase() const
 }
 
 namespace {
+
+AVFrameUPtr scaleFrame(const AVFrame *source, const SwsContextKey &key)
+{
+    auto scaleContext = SwsContextCache::instance().acquire(key);
+    if (!scaleContext)
+        return {};
+
+    AVFrameUPtr scaledFrame = makeAVFrame();
+
+    scaledFrame->format = key.dstPixFmt;
+    scaledFrame->width = key.dstSize.width();
+    scaledFrame->height = key.dstSize.height();
+
+    const int status = av_frame_get_buffer(scaledFrame.get(), 0);
+    if (status < 0) {
+        qCWarning(qLcVideoFrameEncoder) << "Cannot allocate scaled frame" << err2str(status);
+        return {};
+    }
+
+    const auto scaledHeight =
+            sws_scale(scaleContext.get(), source->data, source->linesize, 0, source->height,
+                      scaledFrame->data, scaledFrame->linesize);
+
+    if (scaledHeight != scaledFrame->height)
+        qCWarning(qLcVideoFrameEncoder)
+                << "Scaled height" << scaledHeight << "!=" << scaledFrame->height;
+
+    return scaledFrame;
+}
+
 struct FrameConverter
 {
     FrameConverter(AVFrameUPtr inputFrame) : m_inputFrame{ std::move(inputFrame) } { }
@@ -368,29 +430,19 @@ struct FrameConverter
         return 0;
     }
 
-    void convert(SwsContext *scaleContext, AVPixelFormat format, const QSize &size)
+    int convert(const SwsContextKey &key)
     {
-        AVFrameUPtr scaledFrame = makeAVFrame();
-
-        scaledFrame->format = format;
-        scaledFrame->width = size.width();
-        scaledFrame->height = size.height();
-
-        av_frame_get_buffer(scaledFrame.get(), 0);
-
-        const AVFrame *srcFrame = currentFrame();
-
-        const auto scaledHeight =
-                sws_scale(scaleContext, srcFrame->data, srcFrame->linesize, 0, srcFrame->height,
-                          scaledFrame->data, scaledFrame->linesize);
-
-        if (scaledHeight != scaledFrame->height)
-            qCWarning(qLcVideoFrameEncoder)
-                    << "Scaled height" << scaledHeight << "!=" << scaledFrame->height;
+        AVFrameUPtr scaledFrame = scaleFrame(currentFrame(), key);
+        if (!scaledFrame)
+            return AVERROR(ENOMEM);
 
         setFrame(std::move(scaledFrame));
+        return 0;
     }
 
+    // Takes the frame scaled asynchronously from the current one
+    void setScaledFrame(AVFrameUPtr frame) { setFrame(std::move(frame)); }
+
     int uploadToHw(HWAccel *accel)
     {
         auto *hwFramesContext = accel->hwFramesContextAsBuffer();
@@ -452,6 +504,18 @@ private:
     AVFrameUPtr m_inputFrame;
     AVFrameUPtr m_convertedFrame;
 };
+
+// Uploads the converted frame to the hw surface if needed
+QMaybe<AVFrameUPtr, int> finalizeFrame(FrameConverter &converter, HWAccel *uploadAccel)
+{
+    if (uploadAccel) {
+        const int status = converter.uploadToHw(uploadAccel);
+        if (status != 0)
+            return status;
+    }
+
+    return converter.takeResultFrame();
+}
 }
 
 int VideoFrameEncoder::sendFrame(AVFrameUPtr inputFrame)
@@ -461,12 +525,27 @@ int VideoFrameEncoder::sendFrame(AVFrameUPtr inputFrame)
         return AVERROR(EINVAL);
     }
 
-    if (!inputFrame)
+    if (!inputFrame) {
+        const int status = sendPendingFrames(true);
+        if (status != 0)
+            return status;
+
         return avcodec_send_frame(m_codecContext.get(), nullptr); // Flush
+    }
 
     if (!updateSourceFormatAndSize(inputFrame.get()))
         return AVERROR(EINVAL);
 
+    if (m_mapToTargetHW) {
+        if (AVFrameUPtr mappedFrame = mapToTargetHW(*inputFrame))
+            return sendReadyFrame(std::move(mappedFrame));
+
+        qCWarning(qLcVideoFrameEncoder) << "Cannot map hw frames from" << m_sourceFormat << "to"
+                                        << m_targetFormat << "; converting via the CPU memory";
+        m_hwMappingFailed = true;
+        updateConversions();
+    }
+
     FrameConverter converter{ std::move(inputFrame) };
 
     if (m_downloadFromHW) {
@@ -475,25 +554,150 @@ int VideoFrameEncoder::sendFrame(AVFrameUPtr inputFrame)
             return status;
     }
 
-    if (m_scaleContext)
-        converter.convert(m_scaleContext.get(), m_targetSWFormat, m_targetSize);
+    if (m_scaleKey && m_maxPendingFrames > 0) {
+        QMaybe<AVFrameUPtr, int> source = converter.takeResultFrame();
+        if (!source)
+            return source.error();
 
-    if (m_uploadToHW) {
-        const int status = converter.uploadToHw(m_accel.get());
+        PendingFrame pendingFrame{ std::move(source.value()), {}, {} };
+        pendingFrame.scaled = QtConcurrent::run(&m_conversionThreadPool, scaleFrame,
+                                                pendingFrame.source.get(), *m_scaleKey);
+        m_pendingFrames.push_back(std::move(pendingFrame));
+
+        // The frame is queued, EAGAIN only means that the codec wants its packets retrieved
+        const int status = sendPendingFrames(false);
+        return status == AVERROR(EAGAIN) ? 0 : status;
+    }
+
+    if (m_scaleKey) {
+        const int status = converter.convert(*m_scaleKey);
         if (status != 0)
             return status;
     }
 
-    const QMaybe<AVFrameUPtr, int> resultFrame = converter.takeResultFrame();
+    QMaybe<AVFrameUPtr, int> resultFrame =
+            finalizeFrame(converter, m_uploadToHW ? m_accel.get() : nullptr);
     if (!resultFrame)
         return resultFrame.error();
 
+    return sendReadyFrame(std::move(resultFrame.value()));
+}
+
+int VideoFrameEncoder::sendReadyFrame(AVFrameUPtr frame)
+{
+    // The conversions might have changed, keep the order of the frames
+    int status = sendPendingFrames(true);
+    if (status == 0)
+        status = sendToCodec(*frame);
+
+    if (status != AVERROR(EAGAIN))
+        return status;
+
+    // The codec accepts the frame once its packets are retrieved; it's resent by the next calls
+    m_pendingFrames.push_back(PendingFrame{ {}, {}, std::move(frame) });
+    return 0;
+}
+
+int VideoFrameEncoder::sendPendingFrames(bool flush)
+{
+    // If not flushing, send one frame per input frame at most, since the caller
+    // retrieves the packets in between, which the codec might need to accept frames.
+    // Frames left over by earlier EAGAINs are sent on top, until the pipeline is in bounds.
+    int sentCount = 0;
+    auto hasBacklog = [this]() {
+        return static_cast<int>(m_pendingFrames.size()) > qMax(m_maxPendingFrames, 1);
+    };
+
+    while (!m_pendingFrames.empty() && (flush || sentCount == 0 || hasBacklog())) {
+        PendingFrame &pendingFrame = m_pendingFrames.front();
+
+        if (!pendingFrame.ready) {
+            const bool mustWait =
+                    flush || static_cast<int>(m_pendingFrames.size()) > m_maxPendingFrames;
+            if (!mustWait && !pendingFrame.scaled.isFinished())
+                break;
+
+            AVFrameUPtr scaledFrame = pendingFrame.scaled.takeResult();
+            if (!scaledFrame) {
+                m_pendingFrames.pop_front();
+                return AVERROR(ENOMEM);
+            }
+
+            FrameConverter converter{ std::move(pendingFrame.source) };
+            converter.setScaledFrame(std::move(scaledFrame));
+
+            QMaybe<AVFrameUPtr, int> resultFrame =
+                    finalizeFrame(converter, m_uploadToHW ? m_accel.get() : nullptr);
+            if (!resultFrame) {
+                m_pendingFrames.pop_front();
+                return resultFrame.error();
+            }
+
+            pendingFrame.ready = std::move(resultFrame.value());
+        }
+
+        const int status = sendToCodec(*pendingFrame.ready);
+        if (status == AVERROR(EAGAIN))
+            return status; // the frame is to be resent after the packets are retrieved
+
+        m_pendingFrames.pop_front();
+        ++sentCount;
+
+        if (status != 0)
+            return status;
+    }
+
+    return 0;
+}
+
+AVFrameUPtr VideoFrameEncoder::mapToTargetHW(const AVFrame &frame)
+{
+    Q_ASSERT(m_accel);
+
+    if (!frame.hw_frames_ctx)
+        return {};
+
+    if (!m_mappedFramesContext || m_mappedSourceFramesContext != frame.hw_frames_ctx->data) {
+        // The derived context keeps the source one alive, so its address identifies it
+        AVBufferRef *framesContext = nullptr;
+        const int status = av_hwframe_ctx_create_derived(&framesContext, m_targetFormat,
+                                                         m_accel->hwDeviceContextAsBuffer(),
+                                                         frame.hw_frames_ctx, AV_HWFRAME_MAP_READ);
+        if (status < 0) {
+            qCDebug(qLcVideoFrameEncoder)
+                    << "Cannot derive hw frames context" << err2str(status);
+            return {};
+        }
+
+        m_mappedFramesContext.reset(framesContext);
+        m_mappedSourceFramesContext = frame.hw_frames_ctx->data;
+    }
+
+    AVFrameUPtr mappedFrame = makeAVFrame();
+    mappedFrame->format = m_targetFormat;
+    mappedFrame->hw_frames_ctx = av_buffer_ref(m_mappedFramesContext.get());
+
+    int status = av_hwframe_map(mappedFrame.get(), &frame, AV_HWFRAME_MAP_READ);
+    if (status < 0) {
+        qCDebug(qLcVideoFrameEncoder) << "Cannot map hw frame" << err2str(status);
+        return {};
+    }
+
+    status = av_frame_copy_props(mappedFrame.get(), &frame);
+    if (status < 0)
+        return {};
+
+    return mappedFrame;
+}
+
+int VideoFrameEncoder::sendToCodec(const AVFrame &frame)
+{
     AVRational timeBase{};
     int64_t pts{};
-    getAVFrameTime(*resultFrame.value(), pts, timeBase);
+    getAVFrameTime(frame, pts, timeBase);
     qCDebug(qLcVideoFrameEncoder) << "sending frame" << pts << "*" << timeBase;
 
-    return avcodec_send_frame(m_codecContext.get(), resultFrame.value().get());
+    return avcodec_send_frame(m_codecContext.get(), &frame);
 }
 
 qint64 VideoFrameEncoder::estimateDuration(const AVPacket &packet, bool isFirstPacket)
@@ -615,12 +819,21 @@ bool VideoFrameEncoder::updateSourceFormatAndSize(const AVFrame *frame)
     return applySourceFormatAndSize(framesCtx->sw_format);
 }
 
+bool VideoFrameEncoder::canMapToTargetHW() const
+{
+    // Scaling and format conversions on the GPU would need libavfilter
+    return isHWFrameMappingEnabled() && !m_hwMappingFailed && isHwPixelFormat(m_sourceFormat)
+            && isHwPixelFormat(m_targetFormat) && m_sourceSWFormat == m_targetSWFormat
+            && m_sourceSize == m_targetSize;
+}
+
 void VideoFrameEncoder::updateConversions()
 {
     const bool needToScale = m_sourceSize != m_targetSize;
     const bool zeroCopy = m_sourceFormat == m_targetFormat && !needToScale;
 
-    m_scaleContext.reset();
+    m_scaleKey.reset();
+    m_mapToTargetHW = false;
 
     if (zeroCopy) {
         m_downloadFromHW = false;
@@ -631,6 +844,16 @@ void VideoFrameEncoder::updateConversions()
         return;
     }
 
+    if (canMapToTargetHW()) {
+        m_downloadFromHW = false;
+        m_uploadToHW = false;
+        m_mapToTargetHW = true;
+
+        qCDebug(qLcVideoFrameEncoder) << "mapping hw frames from" << m_sourceFormat << "to"
+                                      << m_targetFormat << ", sw format" << m_targetSWFormat;
+        return;
+    }
+
     m_downloadFromHW = m_sourceFormat != m_sourceSWFormat;
     m_uploadToHW = m_targetFormat != m_targetSWFormat;
 
@@ -639,8 +862,13 @@ void VideoFrameEncoder::updateConversions()
                 << "video source and encoder use different formats:" << m_sourceSWFormat
                 << m_targetSWFormat << "or sizes:" << m_sourceSize << m_targetSize;
 
-        m_scaleContext = createSwsContext(m_sourceSize, m_sourceSWFormat, m_targetSize,
-                                          m_targetSWFormat, SWS_FAST_BILINEAR);
+        SwsContextKey key;
+        key.srcSize = m_sourceSize;
+        key.srcPixFmt = m_sourceSWFormat;
+        key.dstSize = m_targetSize;
+        key.dstPixFmt = m_targetSWFormat;
+        key.conversionType = SWS_FAST_BILINEAR;
+        m_scaleKey = key;
     }
 
     qCDebug(qLcVideoFrameEncoder) << "VideoFrameEncoder conversions initialized:"
@@ -650,7 +878,8 @@ void VideoFrameEncoder::updateConversions()
                                   << (isHwPixelFormat(m_targetFormat) ? "(hw)" : "(sw)")
                                   << "sourceSWFormat:" << m_sourceSWFormat
                                   << "targetSWFormat:" << m_targetSWFormat
-                                  << "scaleContext:" << m_scaleContext.get();
+                                  << "scaling:" << m_scaleKey.has_value()
+                                  << "pipelined frames:" << m_maxPendingFrames;
 }
 
 } // namespace QFFmpeg
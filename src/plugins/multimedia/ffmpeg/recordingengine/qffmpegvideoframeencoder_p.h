@@ -15,9 +15,15 @@
 //
 
 #include "qffmpeghwaccel_p.h"
+#include "qffmpegswscontextcache_p.h"
 #include "private/qplatformmediarecorder_p.h"
 #include "private/qmultimediautils_p.h"
 
+#include <QtCore/qfuture.h>
+#include <QtCore/qthreadpool.h>
+
+#include <deque>
+#include <optional>
 #include <unordered_set>
 
 QT_BEGIN_NAMESPACE
@@ -49,7 +55,6 @@ public:
 
     ~VideoFrameEncoder();
 
-    AVPixelFormat sourceFormat() const { return m_sourceFormat; }
     AVPixelFormat targetFormat() const { return m_targetFormat; }
 
     qreal codecFrameRate() const;
@@ -58,6 +63,9 @@ public:
 
     const AVRational &getTimeBase() const;
 
+    // Returns 0 if the frame has been sent to the codec or queued. Frames the codec
+    // rejects with EAGAIN are queued and resent by the next calls, after the caller has
+    // retrieved the packets. Only a flush (nullptr) returns EAGAIN, and is to be repeated.
     int sendFrame(AVFrameUPtr inputFrame);
     AVPacketUPtr retrievePacket();
 
@@ -72,6 +80,21 @@ private:
 
     void updateConversions();
 
+    bool canMapToTargetHW() const;
+
+    // Maps the hw frame to the encoder's hw device without copying the data
+    // to the CPU memory; returns nullptr if the frame cannot be mapped.
+    AVFrameUPtr mapToTargetHW(const AVFrame &frame);
+
+    int sendToCodec(const AVFrame &frame);
+
+    // Sends the frame after the pending ones, or queues it if the codec returns EAGAIN
+    int sendReadyFrame(AVFrameUPtr frame);
+
+    // Sends the pending frames whose conversion has finished, in order; waits for
+    // the oldest conversion if the pipeline is full, or for all of them if flushing
+    int sendPendingFrames(bool flush);
+
     struct CreationResult
     {
         VideoFrameEncoderUPtr encoder;
@@ -108,7 +131,7 @@ private:
 
     qint64 m_lastPacketTime = AV_NOPTS_VALUE;
     AVCodecContextUPtr m_codecContext;
-    SwsContextUPtr m_scaleContext;
+    std::optional<SwsContextKey> m_scaleKey;
     AVPixelFormat m_sourceFormat = AV_PIX_FMT_NONE;
     AVPixelFormat m_sourceSWFormat = AV_PIX_FMT_NONE;
     AVPixelFormat m_targetFormat = AV_PIX_FMT_NONE;
@@ -116,10 +139,29 @@ private:
     bool m_downloadFromHW = false;
     bool m_uploadToHW = false;
 
+    // The source and the encoder use different hw devices, e.g. a DRM_PRIME decoder
+    // and a VAAPI encoder; the frames are mapped from one device to the other.
+    bool m_mapToTargetHW = false;
+    bool m_hwMappingFailed = false;
+    AVBufferUPtr m_mappedFramesContext; // derived from the source hw frames context
+    const void *m_mappedSourceFramesContext = nullptr;
+
     AVRational m_codecFrameRate = { 0, 1 };
 
     int64_t m_prevPacketDts = AV_NOPTS_VALUE;
     int64_t m_packetDtsOffset = 0;
+
+    // Frames being scaled on the thread pool, so that scaling of the next frames
+    // overlaps encoding of the current one. They are sent to the codec in order.
+    struct PendingFrame
+    {
+        AVFrameUPtr source;
+        QFuture<AVFrameUPtr> scaled;
+        AVFrameUPtr ready; // rejected by the codec with EAGAIN, to be resent
+    };
+    std::deque<PendingFrame> m_pendingFrames;
+    int m_maxPendingFrames = 0;
+    QThreadPool m_conversionThreadPool;
 };
 }
 
@@ -75,6 +75,14 @@ void tst_QAudioDecoderBackend::init()
 
 void tst_QAudioDecoderBackend::initTestCase()
 {
+#ifdef TST_QAUDIODECODERBACKEND_BULK_MODE
+    if (!isFFMPEGPlatform())
+        QSKIP("The bulk decoding mode is specific to the FFmpeg backend");
+
+    // Read once, when the backend creates its first decoder
+    qputenv("QT_FFMPEG_AUDIO_DECODER_MODE", "bulk");
+#endif
+
     QAudioDecoder d;
     if (!d.isSupported())
         QSKIP("Audio decoder service is not available");
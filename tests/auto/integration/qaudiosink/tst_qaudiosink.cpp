@@ -183,6 +183,11 @@ void tst_QAudioSink::generate_audiofile_testrows()
 
 void tst_QAudioSink::initTestCase()
 {
+#ifdef TST_QAUDIOSINK_PULSE_CALLBACK_MODE
+    // Read once, when the first sink opens its stream
+    qputenv("QT_PULSEAUDIO_OUTPUT_CALLBACK_MODE", "1");
+#endif
+
     // Only perform tests if audio output device exists
     const QList<QAudioDevice> devices = QMediaDevices::audioOutputs();
 
@@ -75,6 +75,10 @@ private slots:
     void record_writesVideo_withCorrectColors_data();
     void record_writesVideo_withCorrectColors();
 
+    void record_writesAllFrames_whenFramesAreConvertedAheadOfEncoder();
+
+    void record_writesAllFrames_whenSoftwareFramesChangePixelFormat();
+
     void actualLocation_returnsNonEmptyLocation_whenRecorderEntersRecordingState();
 
     void record_writesToOutputDevice_whenWritableOutputDeviceAndLocationAreSet();
@@ -418,6 +422,55 @@ void tst_QMediaFrameInputsBackend::record_writesVideo_withCorrectColors()
     QVERIFY(fuzzyCompare(expectedColors[3], actualColors[3]));
 }
 
+void tst_QMediaFrameInputsBackend::record_writesAllFrames_whenFramesAreConvertedAheadOfEncoder()
+{
+    // The frames need a pixel format conversion, which runs ahead of the codec. A codec
+    // rejecting a frame with EAGAIN until its packets are retrieved must neither fail
+    // the recording nor lose the frame.
+    constexpr int frameCount = 60;
+
+    CaptureSessionFixture f{ StreamType::Video };
+    f.m_videoGenerator.setPixelFormat(QVideoFrameFormat::Format_ARGB8888);
+    f.m_videoGenerator.setPattern(ImagePattern::ColoredSquares);
+    f.m_videoGenerator.setFrameCount(frameCount);
+    f.m_videoGenerator.setSize({ 320, 240 });
+
+    f.start(RunMode::Pull, AutoStop::EmitEmpty);
+    QVERIFY(f.waitForRecorderStopped(60s));
+    QVERIFY2(f.m_recorder.error() == QMediaRecorder::NoError,
+             f.m_recorder.errorString().toLatin1());
+
+    const auto info = MediaInfo::create(f.m_recorder.actualLocation());
+    QCOMPARE_EQ(info->m_frameCount, frameCount);
+}
+
+void tst_QMediaFrameInputsBackend::record_writesAllFrames_whenSoftwareFramesChangePixelFormat()
+{
+    // The frames mapped to the CPU memory must be passed to the encoder in their own
+    // pixel format, not in the format of the frames sent before.
+    constexpr int frameCount = 60;
+
+    CaptureSessionFixture f{ StreamType::Video };
+    f.m_videoGenerator.setPixelFormat(QVideoFrameFormat::Format_ARGB8888);
+    f.m_videoGenerator.setPattern(ImagePattern::ColoredSquares);
+    f.m_videoGenerator.setFrameCount(frameCount);
+    f.m_videoGenerator.setSize({ 320, 240 });
+
+    int framesCreated = 0;
+    connect(&f.m_videoGenerator, &VideoGenerator::frameCreated, this, [&] {
+        if (++framesCreated == frameCount / 2)
+            f.m_videoGenerator.setPixelFormat(QVideoFrameFormat::Format_YUV420P);
+    });
+
+    f.start(RunMode::Pull, AutoStop::EmitEmpty);
+    QVERIFY(f.waitForRecorderStopped(60s));
+    QVERIFY2(f.m_recorder.error() == QMediaRecorder::NoError,
+             f.m_recorder.errorString().toLatin1());
+
+    const auto info = MediaInfo::create(f.m_recorder.actualLocation());
+    QCOMPARE_EQ(info->m_frameCount, frameCount);
+}
+
 void tst_QMediaFrameInputsBackend::actualLocation_returnsNonEmptyLocation_whenRecorderEntersRecordingState()
 {
     const QUrl url = QUrl::fromLocalFile(m_tempDir.filePath("any_file_name"));
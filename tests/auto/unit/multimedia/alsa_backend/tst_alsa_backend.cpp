@@ -0,0 +1,265 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/qbuffer.h>
+#include <QtCore/qtimer.h>
+
+#include "qalsaaudiosink_p.h"
+#include "qalsaaudiosource_p.h"
+#include "qalsammap_p.h"
+
+#include <algorithm>
+
+QT_USE_NAMESPACE
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+// The null PCM of alsa-lib discards the playback and captures silence, no sound card is needed
+constexpr char NullDevice[] = "null";
+
+QAudioFormat makeFormat(QAudioFormat::SampleFormat sampleFormat = QAudioFormat::Int16)
+{
+    QAudioFormat format;
+    format.setSampleFormat(sampleFormat);
+    format.setSampleRate(48000);
+    format.setChannelCount(2);
+    return format;
+}
+
+bool canOpenNullDevice(snd_pcm_stream_t stream)
+{
+    snd_pcm_t *handle = nullptr;
+    if (snd_pcm_open(&handle, NullDevice, stream, SND_PCM_NONBLOCK) < 0)
+        return false;
+
+    snd_pcm_close(handle);
+    return true;
+}
+
+snd_pcm_format_t toPcmFormat(QAudioFormat::SampleFormat sampleFormat)
+{
+    switch (sampleFormat) {
+    case QAudioFormat::UInt8:
+        return SND_PCM_FORMAT_U8;
+    case QAudioFormat::Int16:
+        return SND_PCM_FORMAT_S16;
+    case QAudioFormat::Int32:
+        return SND_PCM_FORMAT_S32;
+    case QAudioFormat::Float:
+        return SND_PCM_FORMAT_FLOAT;
+    default:
+        return SND_PCM_FORMAT_UNKNOWN;
+    }
+}
+
+// Returns nullptr if the null PCM doesn't provide mmap access for the format
+snd_pcm_t *openMMapNullDevice(const QAudioFormat &deviceFormat)
+{
+    snd_pcm_t *handle = nullptr;
+    if (snd_pcm_open(&handle, NullDevice, SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK) < 0)
+        return nullptr;
+
+    if (snd_pcm_set_params(handle, toPcmFormat(deviceFormat.sampleFormat()),
+                           SND_PCM_ACCESS_MMAP_INTERLEAVED, deviceFormat.channelCount(),
+                           deviceFormat.sampleRate(), 1, 100'000)
+        < 0) {
+        snd_pcm_close(handle);
+        return nullptr;
+    }
+
+    return handle;
+}
+
+// The timer that feeds the device on the owner's thread in the default mode
+bool hasActiveTimer(const QObject &object)
+{
+    const auto timers = object.findChildren<QTimer *>(Qt::FindDirectChildrenOnly);
+    return std::any_of(timers.begin(), timers.end(),
+                       [](const QTimer *timer) { return timer->isActive(); });
+}
+
+} // namespace
+
+class tst_QAlsaBackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void ioThreadSink_playsPulledData_withoutTimer();
+    void ioThreadSink_playsPushedData_withoutTimer();
+    void ioThreadSink_resumes_withoutTimer();
+    void ioThreadSource_capturesData_withoutTimer();
+
+    void mmapWrite_writesAndStarts_data();
+    void mmapWrite_writesAndStarts();
+    void mmapWrite_writesNoMoreThanBufferRoom();
+};
+
+void tst_QAlsaBackend::initTestCase()
+{
+    if (!canOpenNullDevice(SND_PCM_STREAM_PLAYBACK) || !canOpenNullDevice(SND_PCM_STREAM_CAPTURE))
+        QSKIP("The ALSA null PCM is not available");
+
+    // Read once, when the first sink or source opens its device
+    qputenv("QT_ALSA_IO_THREAD", "1");
+#ifdef TST_ALSA_BACKEND_MMAP_MODE
+    qputenv("QT_ALSA_OUTPUT_MMAP", "1");
+#endif
+}
+
+void tst_QAlsaBackend::ioThreadSink_playsPulledData_withoutTimer()
+{
+    const QAudioFormat format = makeFormat();
+    QAlsaAudioSink sink(NullDevice, nullptr);
+    sink.setFormat(format);
+
+    QByteArray data(format.bytesForDuration(200'000), 0);
+    QBuffer source(&data);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+
+    sink.start(&source);
+    QCOMPARE(sink.error(), QAudio::NoError);
+    QVERIFY(!hasActiveTimer(sink));
+
+    QTRY_VERIFY(source.atEnd());
+    QTRY_COMPARE(sink.state(), QAudio::IdleState);
+    QCOMPARE(sink.error(), QAudio::NoError);
+    QVERIFY(sink.processedUSecs() > 0);
+    QVERIFY(!hasActiveTimer(sink));
+
+    sink.stop();
+    QCOMPARE(sink.state(), QAudio::StoppedState);
+}
+
+void tst_QAlsaBackend::ioThreadSink_playsPushedData_withoutTimer()
+{
+    const QAudioFormat format = makeFormat();
+    QAlsaAudioSink sink(NullDevice, nullptr);
+    sink.setFormat(format);
+
+    QIODevice *device = sink.start();
+    QVERIFY(device);
+    QCOMPARE(sink.error(), QAudio::NoError);
+    QVERIFY(!hasActiveTimer(sink));
+
+    QVERIFY(device->write(QByteArray(format.bytesForDuration(10'000), 0)) > 0);
+
+    QTRY_VERIFY(sink.processedUSecs() > 0);
+    QVERIFY(!hasActiveTimer(sink));
+
+    sink.stop();
+}
+
+void tst_QAlsaBackend::ioThreadSink_resumes_withoutTimer()
+{
+    const QAudioFormat format = makeFormat();
+    QAlsaAudioSink sink(NullDevice, nullptr);
+    sink.setFormat(format);
+
+    QIODevice *device = sink.start();
+    QVERIFY(device);
+    device->write(QByteArray(format.bytesForDuration(10'000), 0));
+
+    sink.suspend();
+    QCOMPARE(sink.state(), QAudio::SuspendedState);
+
+    sink.resume();
+    QVERIFY(sink.state() != QAudio::SuspendedState);
+    QCOMPARE(sink.error(), QAudio::NoError);
+    QVERIFY(!hasActiveTimer(sink));
+
+    sink.stop();
+}
+
+void tst_QAlsaBackend::ioThreadSource_capturesData_withoutTimer()
+{
+    QAlsaAudioSource source(NullDevice, nullptr);
+    source.setFormat(makeFormat());
+
+    QIODevice *device = source.start();
+    QVERIFY(device);
+    QCOMPARE(source.error(), QAudio::NoError);
+    QVERIFY(!hasActiveTimer(source));
+
+    QTRY_VERIFY(source.bytesReady() > 0);
+    QVERIFY(!device->readAll().isEmpty());
+    QVERIFY(!hasActiveTimer(source));
+
+    source.stop();
+    QCOMPARE(source.state(), QAudio::StoppedState);
+}
+
+void tst_QAlsaBackend::mmapWrite_writesAndStarts_data()
+{
+    QTest::addColumn<int>("sampleFormatValue");
+    QTest::addColumn<int>("deviceSampleFormatValue");
+    QTest::addColumn<float>("volume");
+
+    QTest::addRow("copy") << int(QAudioFormat::Int16) << int(QAudioFormat::Int16) << 1.f;
+    QTest::addRow("volume") << int(QAudioFormat::Int16) << int(QAudioFormat::Int16) << 0.5f;
+    QTest::addRow("Float to Int16") << int(QAudioFormat::Float) << int(QAudioFormat::Int16) << 1.f;
+    QTest::addRow("UInt8 to Float") << int(QAudioFormat::UInt8) << int(QAudioFormat::Float)
+                                    << 0.5f;
+    QTest::addRow("Int16 to Int32") << int(QAudioFormat::Int16) << int(QAudioFormat::Int32)
+                                    << 0.5f;
+}
+
+void tst_QAlsaBackend::mmapWrite_writesAndStarts()
+{
+    QFETCH(const int, sampleFormatValue);
+    QFETCH(const int, deviceSampleFormatValue);
+    QFETCH(const float, volume);
+
+    const QAudioFormat format = makeFormat(QAudioFormat::SampleFormat(sampleFormatValue));
+    const QAudioFormat deviceFormat =
+            makeFormat(QAudioFormat::SampleFormat(deviceSampleFormatValue));
+
+    snd_pcm_t *handle = openMMapNullDevice(deviceFormat);
+    if (!handle)
+        QSKIP("The ALSA null PCM doesn't support mmap access for the format");
+    auto closeHandle = qScopeGuard([handle] { snd_pcm_close(handle); });
+
+    const QByteArray data(format.bytesForDuration(10'000), 0);
+    const auto frames = snd_pcm_uframes_t(format.framesForBytes(data.size()));
+
+    const snd_pcm_sframes_t written =
+            QAlsaMMap::writeInterleaved(handle, data.constData(), frames, format, deviceFormat,
+                                        volume);
+
+    QCOMPARE(written, snd_pcm_sframes_t(frames));
+    QVERIFY(snd_pcm_state(handle) == SND_PCM_STATE_RUNNING);
+}
+
+void tst_QAlsaBackend::mmapWrite_writesNoMoreThanBufferRoom()
+{
+    const QAudioFormat format = makeFormat();
+
+    snd_pcm_t *handle = openMMapNullDevice(format);
+    if (!handle)
+        QSKIP("The ALSA null PCM doesn't support mmap access");
+    auto closeHandle = qScopeGuard([handle] { snd_pcm_close(handle); });
+
+    snd_pcm_uframes_t bufferFrames = 0;
+    snd_pcm_uframes_t periodFrames = 0;
+    QCOMPARE(snd_pcm_get_params(handle, &bufferFrames, &periodFrames), 0);
+
+    // Doesn't block when the data doesn't fit
+    const QByteArray data(format.bytesForFrames(int(bufferFrames) * 4), 0);
+    const snd_pcm_sframes_t written = QAlsaMMap::writeInterleaved(
+            handle, data.constData(), bufferFrames * 4, format, format, 1.f);
+
+    QVERIFY(written > 0);
+    QVERIFY(written < snd_pcm_sframes_t(bufferFrames * 4));
+}
+
+QTEST_GUILESS_MAIN(tst_QAlsaBackend)
+
+#include "tst_alsa_backend.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "qffmpegasyncwriter_p.h"
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+// Fails all writes after the first failingAfter bytes
+class FailingDevice : public QIODevice
+{
+public:
+    explicit FailingDevice(qint64 failingAfter) : m_failingAfter(failingAfter)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *, qint64 len) override
+    {
+        if (m_written + len > m_failingAfter)
+            return -1;
+        m_written += len;
+        return len;
+    }
+
+private:
+    const qint64 m_failingAfter;
+    qint64 m_written = 0;
+};
+
+ConsumerThreadUPtr<AsyncWriter> startWriter(QIODevice &device)
+{
+    ConsumerThreadUPtr<AsyncWriter> writer(new AsyncWriter(&device));
+    writer->start();
+    return writer;
+}
+
+int write(AsyncWriter &writer, QByteArray data)
+{
+    return AsyncWriter::writeCallback(&writer, reinterpret_cast<uint8_t *>(data.data()),
+                                      int(data.size()));
+}
+
+} // namespace
+
+class tst_QFFmpegAsyncWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void write_writesBlocksInOrder();
+    void seek_waitsForPendingBlocks();
+    void stop_writesPendingBlocks();
+    void flush_returnsFalse_whenDeviceFails();
+    void write_fails_afterDeviceHasFailed();
+};
+
+void tst_QFFmpegAsyncWriter::write_writesBlocksInOrder()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    auto writer = startWriter(buffer);
+
+    QByteArray expected;
+    for (int i = 0; i < 100; ++i) {
+        const QByteArray block(1000 + i, char('a' + i % 26));
+        QCOMPARE(write(*writer, block), int(block.size()));
+        expected += block;
+    }
+
+    QVERIFY(writer->flush());
+    QCOMPARE(buffer.data(), expected);
+}
+
+void tst_QFFmpegAsyncWriter::seek_waitsForPendingBlocks()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    auto writer = startWriter(buffer);
+
+    for (int i = 0; i < 10; ++i)
+        write(*writer, QByteArray(100, 'x'));
+
+    QCOMPARE(AsyncWriter::seekCallback(writer.get(), 0, AVSEEK_SIZE), int64_t(1000));
+
+    // Patches the header like muxers do
+    QCOMPARE(AsyncWriter::seekCallback(writer.get(), 10, SEEK_SET), int64_t(10));
+    write(*writer, QByteArray(5, 'y'));
+    QVERIFY(writer->flush());
+
+    QCOMPARE(buffer.data().size(), 1000);
+    QCOMPARE(buffer.data().mid(8, 9), QByteArray("xxyyyyyxx"));
+}
+
+void tst_QFFmpegAsyncWriter::stop_writesPendingBlocks()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    {
+        auto writer = startWriter(buffer);
+        for (int i = 0; i < 7; ++i)
+            write(*writer, QByteArray(100, 'x'));
+    }
+
+    QCOMPARE(buffer.data().size(), 700);
+}
+
+void tst_QFFmpegAsyncWriter::flush_returnsFalse_whenDeviceFails()
+{
+    FailingDevice device(150);
+    auto writer = startWriter(device);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot write to the output device"));
+
+    write(*writer, QByteArray(100, 'x'));
+    write(*writer, QByteArray(100, 'x'));
+
+    QVERIFY(!writer->flush());
+}
+
+void tst_QFFmpegAsyncWriter::write_fails_afterDeviceHasFailed()
+{
+    FailingDevice device(0);
+    auto writer = startWriter(device);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot write to the output device"));
+
+    write(*writer, QByteArray(100, 'x'));
+    QVERIFY(!writer->flush());
+
+    QCOMPARE(write(*writer, QByteArray(100, 'x')), AVERROR(EIO));
+    QCOMPARE(AsyncWriter::seekCallback(writer.get(), 0, SEEK_SET), int64_t(AVERROR(EIO)));
+}
+
+QTEST_GUILESS_MAIN(tst_QFFmpegAsyncWriter)
+
+#include "tst_qffmpegasyncwriter.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,205 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "playbackengine/qffmpegbufferingpolicy_p.h"
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+const char *const EnvironmentVariables[] = {
+    "QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS",
+    "QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE",
+    "QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT",
+    "QT_FFMPEG_DEMUXER_LIVE_MODE",
+};
+
+} // namespace
+
+class tst_QFFmpegBufferingPolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void fromEnvironment_returnsDefaults_whenNothingIsSet();
+    void fromEnvironment_appliesOverrides();
+    void fromEnvironment_ignoresInvalidValues();
+    void fromEnvironment_startsFromLivePolicy_inLiveMode();
+    void fromSettings_overridesFallback_withGivenSettingsOnly();
+    void fromSettings_ignoresFallback_whenLiveModeIsSet();
+
+    void isLimitReached_pausesAtAnyLimit_data();
+    void isLimitReached_pausesAtAnyLimit();
+    void isLimitReached_usesPacketPositions_whenPacketsHaveNoDuration();
+    void isLimitReached_resumesAtLowWaterMark();
+    void isLimitReached_resumesBelowLimits_withoutLowWaterMark();
+};
+
+void tst_QFFmpegBufferingPolicy::init()
+{
+    for (const char *name : EnvironmentVariables)
+        qunsetenv(name);
+}
+
+void tst_QFFmpegBufferingPolicy::cleanup()
+{
+    init();
+}
+
+void tst_QFFmpegBufferingPolicy::fromEnvironment_returnsDefaults_whenNothingIsSet()
+{
+    const BufferingPolicy policy = BufferingPolicy::fromEnvironment();
+
+    QCOMPARE(policy, BufferingPolicy{});
+    QCOMPARE(policy.maxDurationUs, qint64(4'000'000));
+    QCOMPARE(policy.maxSize, qint64(32 * 1024 * 1024));
+    QCOMPARE(policy.lowWaterMark, 1.f);
+    QVERIFY(!policy.liveMode);
+}
+
+void tst_QFFmpegBufferingPolicy::fromEnvironment_appliesOverrides()
+{
+    qputenv("QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS", "1500");
+    qputenv("QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE", "1048576");
+    qputenv("QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT", "50");
+
+    const BufferingPolicy policy = BufferingPolicy::fromEnvironment();
+
+    QCOMPARE(policy.maxDurationUs, qint64(1'500'000));
+    QCOMPARE(policy.maxSize, qint64(1024 * 1024));
+    QCOMPARE(policy.lowWaterMark, 0.5f);
+    QVERIFY(!policy.liveMode);
+}
+
+void tst_QFFmpegBufferingPolicy::fromEnvironment_ignoresInvalidValues()
+{
+    qputenv("QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS", "-1");
+    qputenv("QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE", "abc");
+    qputenv("QT_FFMPEG_DEMUXER_LOW_WATER_MARK_PERCENT", "150");
+
+    QCOMPARE(BufferingPolicy::fromEnvironment(), BufferingPolicy{});
+}
+
+void tst_QFFmpegBufferingPolicy::fromEnvironment_startsFromLivePolicy_inLiveMode()
+{
+    qputenv("QT_FFMPEG_DEMUXER_LIVE_MODE", "1");
+
+    QCOMPARE(BufferingPolicy::fromEnvironment(), BufferingPolicy::live());
+
+    qputenv("QT_FFMPEG_DEMUXER_MAX_BUFFERED_DURATION_MS", "200");
+    const BufferingPolicy policy = BufferingPolicy::fromEnvironment();
+    QVERIFY(policy.liveMode);
+    QCOMPARE(policy.maxDurationUs, qint64(200'000));
+    QCOMPARE(policy.maxSize, BufferingPolicy::live().maxSize);
+}
+
+void tst_QFFmpegBufferingPolicy::fromSettings_overridesFallback_withGivenSettingsOnly()
+{
+    BufferingPolicy fallback;
+    fallback.maxDurationUs = 2'000'000;
+    fallback.lowWaterMark = 0.25f;
+
+    const BufferingPolicy policy = BufferingPolicy::fromSettings(
+            [](const char *name, bool *ok) {
+                *ok = qstrcmp(name, "QT_FFMPEG_DEMUXER_MAX_BUFFERED_SIZE") == 0;
+                return *ok ? 1000 : 0;
+            },
+            fallback);
+
+    QCOMPARE(policy.maxDurationUs, fallback.maxDurationUs);
+    QCOMPARE(policy.maxSize, qint64(1000));
+    QCOMPARE(policy.lowWaterMark, fallback.lowWaterMark);
+    QVERIFY(!policy.liveMode);
+}
+
+void tst_QFFmpegBufferingPolicy::fromSettings_ignoresFallback_whenLiveModeIsSet()
+{
+    const BufferingPolicy fallback = BufferingPolicy::live();
+
+    const BufferingPolicy policy = BufferingPolicy::fromSettings(
+            [](const char *name, bool *ok) {
+                *ok = qstrcmp(name, "QT_FFMPEG_DEMUXER_LIVE_MODE") == 0;
+                return 0;
+            },
+            fallback);
+
+    QCOMPARE(policy, BufferingPolicy{});
+}
+
+void tst_QFFmpegBufferingPolicy::isLimitReached_pausesAtAnyLimit_data()
+{
+    QTest::addColumn<qint64>("bufferedDurationUs");
+    QTest::addColumn<qint64>("bufferedSize");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("empty") << qint64(0) << qint64(0) << false;
+    QTest::newRow("below limits") << qint64(999'999) << qint64(999) << false;
+    QTest::newRow("duration limit") << qint64(1'000'000) << qint64(0) << true;
+    QTest::newRow("size limit") << qint64(1) << qint64(1000) << true;
+}
+
+void tst_QFFmpegBufferingPolicy::isLimitReached_pausesAtAnyLimit()
+{
+    QFETCH(const qint64, bufferedDurationUs);
+    QFETCH(const qint64, bufferedSize);
+    QFETCH(const bool, expected);
+
+    BufferingPolicy policy;
+    policy.maxDurationUs = 1'000'000;
+    policy.maxSize = 1000;
+
+    QCOMPARE(policy.isLimitReached(bufferedDurationUs, 0, bufferedSize, false), expected);
+}
+
+void tst_QFFmpegBufferingPolicy::isLimitReached_usesPacketPositions_whenPacketsHaveNoDuration()
+{
+    BufferingPolicy policy;
+    policy.maxDurationUs = 1'000'000;
+
+    QVERIFY(!policy.isLimitReached(0, 999'999, 0, false));
+    QVERIFY(policy.isLimitReached(0, 1'000'000, 0, false));
+
+    // The durations take precedence once known
+    QVERIFY(!policy.isLimitReached(1, 1'000'000, 0, false));
+}
+
+void tst_QFFmpegBufferingPolicy::isLimitReached_resumesAtLowWaterMark()
+{
+    BufferingPolicy policy;
+    policy.maxDurationUs = 1'000'000;
+    policy.maxSize = 1000;
+    policy.lowWaterMark = 0.5f;
+
+    // Stays paused while above the low water mark of both limits
+    QVERIFY(policy.isLimitReached(999'999, 0, 0, true));
+    QVERIFY(policy.isLimitReached(500'000, 0, 0, true));
+    QVERIFY(policy.isLimitReached(1, 0, 500, true));
+
+    QVERIFY(!policy.isLimitReached(499'999, 0, 499, true));
+
+    // Not yet paused, only the full limits apply
+    QVERIFY(!policy.isLimitReached(500'000, 0, 500, false));
+}
+
+void tst_QFFmpegBufferingPolicy::isLimitReached_resumesBelowLimits_withoutLowWaterMark()
+{
+    BufferingPolicy policy;
+    policy.maxDurationUs = 1'000'000;
+    policy.maxSize = 1000;
+
+    QVERIFY(policy.isLimitReached(1'000'000, 0, 0, true));
+    QVERIFY(!policy.isLimitReached(999'999, 0, 999, true));
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegBufferingPolicy)
+
+#include "tst_qffmpegbufferingpolicy.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,165 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "playbackengine/qffmpegdatachannel_p.h"
+
+#include <thread>
+
+using namespace QFFmpeg;
+using namespace std::chrono_literals;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+class Consumer : public QObject
+{
+public:
+    void handle(int value)
+    {
+        // The values must arrive once and in order
+        if (value != m_expected)
+            m_outOfOrder.storeRelaxed(true);
+        m_expected = value + 1;
+        m_received.storeRelease(m_expected);
+    }
+
+    int received() const { return m_received.loadAcquire(); }
+    bool outOfOrder() const { return m_outOfOrder.loadRelaxed(); }
+
+private:
+    int m_expected = 0;
+    QAtomicInt m_received;
+    QAtomicInteger<bool> m_outOfOrder = false;
+};
+
+} // namespace
+
+class tst_QFFmpegDataChannel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void spscQueue_deliversValuesInOrder_acrossThreads();
+    void spscQueue_reusesDrainedSegments();
+
+    void push_deliversAllValues_toConsumerThread();
+    void push_doesNotLoseWakeUps_underContention();
+    void push_isIgnored_afterConsumerIsDestroyed();
+
+private:
+    void runProducer(int count, int burstSize);
+};
+
+void tst_QFFmpegDataChannel::spscQueue_deliversValuesInOrder_acrossThreads()
+{
+    constexpr int Count = 1'000'000;
+    SpscQueue<int, 8> queue;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < Count; ++i)
+            queue.push(i);
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < Count) {
+        int value = -1;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        inOrder = inOrder && value == expected;
+        ++expected;
+    }
+
+    producer.join();
+
+    QVERIFY(inOrder);
+    int value = -1;
+    QVERIFY(!queue.pop(value));
+    QCOMPARE(queue.size(), 0);
+}
+
+void tst_QFFmpegDataChannel::spscQueue_reusesDrainedSegments()
+{
+    SpscQueue<std::shared_ptr<int>, 4> queue;
+    auto value = std::make_shared<int>(1);
+
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 10; ++i)
+            queue.push(value);
+        QCOMPARE(queue.size(), 10);
+
+        std::shared_ptr<int> popped;
+        while (queue.pop(popped))
+            QCOMPARE(popped, value);
+    }
+
+    // The queue doesn't keep references to the popped values
+    QCOMPARE(value.use_count(), 1);
+}
+
+void tst_QFFmpegDataChannel::runProducer(int count, int burstSize)
+{
+    QThread consumerThread;
+    Consumer consumer;
+    consumer.moveToThread(&consumerThread);
+    consumerThread.start();
+
+    auto channel = DataChannel<int>::create(&consumer, &Consumer::handle);
+
+    std::thread producer([channel, count, burstSize]() {
+        for (int i = 0; i < count; ++i) {
+            channel->push(i);
+            // Let the consumer catch up, so that it resets the flag concurrently with the pushes
+            if (burstSize > 0 && i % burstSize == 0)
+                std::this_thread::yield();
+        }
+    });
+    producer.join();
+
+    // A lost wake-up leaves the last values in the queue forever
+    QTRY_COMPARE_WITH_TIMEOUT(consumer.received(), count, 10s);
+    QVERIFY(!consumer.outOfOrder());
+
+    consumerThread.quit();
+    consumerThread.wait();
+}
+
+void tst_QFFmpegDataChannel::push_deliversAllValues_toConsumerThread()
+{
+    runProducer(1000, 0);
+}
+
+void tst_QFFmpegDataChannel::push_doesNotLoseWakeUps_underContention()
+{
+    // Each round ends with a push racing a drain
+    for (int round = 0; round < 200; ++round) {
+        runProducer(round % 7 + 1, 1);
+        if (QTest::currentTestFailed())
+            return;
+    }
+
+    runProducer(200'000, 3);
+}
+
+void tst_QFFmpegDataChannel::push_isIgnored_afterConsumerIsDestroyed()
+{
+    auto consumer = std::make_unique<Consumer>();
+    auto channel = DataChannel<int>::create(consumer.get(), &Consumer::handle);
+
+    consumer.reset();
+    channel->push(1);
+
+    // No wake-up is posted to the deleted consumer
+    QCoreApplication::processEvents();
+}
+
+QTEST_GUILESS_MAIN(tst_QFFmpegDataChannel)
+
+#include "tst_qffmpegdatachannel.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,220 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "qffmpegencoderqueue_p.h"
+
+using namespace QFFmpeg;
+using namespace std::chrono_literals;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+// 10 ms of mono 16-bit audio at 48 kHz
+QAudioBuffer makeBuffer(qint64 startTime)
+{
+    QAudioFormat format;
+    format.setSampleFormat(QAudioFormat::Int16);
+    format.setSampleRate(48000);
+    format.setChannelCount(1);
+    return QAudioBuffer(QByteArray(format.bytesForDuration(10000), 0), format, startTime);
+}
+
+} // namespace
+
+class tst_QFFmpegEncoderQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromEnvironment_parsesPolicyNames_data();
+    void fromEnvironment_parsesPolicyNames();
+    void fromName_returnsNullopt_forUnknownName_data();
+    void fromName_returnsNullopt_forUnknownName();
+    void degradedFrameInterval_growsAsQueueFillsUp();
+
+    void audioQueue_isFull_whenMaxDurationIsReached_andHasTwoBuffers();
+    void audioQueue_take_returnsBuffersInOrder();
+    void audioQueue_dropNewest_leavesGapBeforeNextBuffer();
+    void audioQueue_dropNewest_accumulatesGaps();
+    void audioQueue_dropOldest_movesGapToFollowingBuffer();
+    void audioQueue_dropOldest_keepsGap_whenQueueBecomesEmpty();
+};
+
+void tst_QFFmpegEncoderQueue::fromEnvironment_parsesPolicyNames_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<int>("expectedMode");
+
+    QTest::addRow("unset") << QByteArray() << int(EncoderQueuePolicy::DropNewest);
+    QTest::addRow("drop-newest") << QByteArray("drop-newest")
+                                 << int(EncoderQueuePolicy::DropNewest);
+    QTest::addRow("drop-oldest") << QByteArray("drop-oldest")
+                                 << int(EncoderQueuePolicy::DropOldest);
+    QTest::addRow("block") << QByteArray("block") << int(EncoderQueuePolicy::Block);
+    QTest::addRow("degrade") << QByteArray("degrade") << int(EncoderQueuePolicy::Degrade);
+    QTest::addRow("unknown") << QByteArray("unknown") << int(EncoderQueuePolicy::DropNewest);
+}
+
+void tst_QFFmpegEncoderQueue::fromEnvironment_parsesPolicyNames()
+{
+    QFETCH(const QByteArray, value);
+    QFETCH(const int, expectedMode);
+
+    if (value.isNull())
+        qunsetenv("QT_FFMPEG_ENCODING_QUEUE_POLICY");
+    else
+        qputenv("QT_FFMPEG_ENCODING_QUEUE_POLICY", value);
+    auto resetEnvironment = qScopeGuard([] { qunsetenv("QT_FFMPEG_ENCODING_QUEUE_POLICY"); });
+
+    if (value == "unknown")
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Unknown encoding queue policy"));
+
+    const EncoderQueuePolicy policy = EncoderQueuePolicy::fromEnvironment();
+
+    QCOMPARE(int(policy.mode), expectedMode);
+    QCOMPARE_LE(policy.maxBlockingTime, 50ms);
+}
+
+void tst_QFFmpegEncoderQueue::fromName_returnsNullopt_forUnknownName_data()
+{
+    QTest::addColumn<QByteArray>("name");
+
+    QTest::addRow("empty") << QByteArray();
+    QTest::addRow("unknown") << QByteArray("unknown");
+    QTest::addRow("different case") << QByteArray("Block");
+}
+
+void tst_QFFmpegEncoderQueue::fromName_returnsNullopt_forUnknownName()
+{
+    QFETCH(const QByteArray, name);
+
+    QVERIFY(!EncoderQueuePolicy::fromName(name));
+    QVERIFY(EncoderQueuePolicy::fromName("block"));
+}
+
+void tst_QFFmpegEncoderQueue::degradedFrameInterval_growsAsQueueFillsUp()
+{
+    QCOMPARE(degradedFrameInterval(0, 8), 1);
+    QCOMPARE(degradedFrameInterval(3, 8), 1);
+    QCOMPARE(degradedFrameInterval(4, 8), 2);
+    QCOMPARE(degradedFrameInterval(5, 8), 2);
+    QCOMPARE(degradedFrameInterval(6, 8), 3);
+    QCOMPARE(degradedFrameInterval(8, 8), 3);
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_isFull_whenMaxDurationIsReached_andHasTwoBuffers()
+{
+    AudioBufferQueue longBufferQueue(5ms);
+    longBufferQueue.push(makeBuffer(0));
+    QVERIFY(!longBufferQueue.isFull());
+
+    AudioBufferQueue queue(30ms);
+    QVERIFY(queue.isEmpty());
+
+    queue.push(makeBuffer(0));
+    queue.push(makeBuffer(10000));
+    QVERIFY(!queue.isFull());
+    QCOMPARE(queue.duration(), 20000us);
+
+    queue.push(makeBuffer(20000));
+    QVERIFY(queue.isFull());
+    QCOMPARE(queue.size(), qsizetype(3));
+
+    queue.take();
+    QVERIFY(!queue.isFull());
+    QCOMPARE(queue.duration(), 20000us);
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_take_returnsBuffersInOrder()
+{
+    AudioBufferQueue queue;
+    queue.push(makeBuffer(0));
+    queue.push(makeBuffer(10000));
+
+    AudioBufferQueue::Entry first = queue.take();
+    QCOMPARE(first.buffer.startTime(), qint64(0));
+    QCOMPARE(first.droppedBefore, 0us);
+
+    QCOMPARE(queue.take().buffer.startTime(), qint64(10000));
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.duration(), 0us);
+
+    QVERIFY(!queue.take().buffer.isValid());
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_dropNewest_leavesGapBeforeNextBuffer()
+{
+    AudioBufferQueue queue(20ms);
+    queue.push(makeBuffer(0));
+    queue.push(makeBuffer(10000));
+    QVERIFY(queue.isFull());
+
+    queue.dropNewest(makeBuffer(20000));
+    QCOMPARE(queue.size(), qsizetype(2));
+    QCOMPARE(queue.duration(), 20000us);
+
+    queue.take();
+    queue.push(makeBuffer(30000));
+
+    QCOMPARE(queue.take().droppedBefore, 0us);
+
+    // The encoder skips the dropped 10 ms, keeping the buffer at its start time
+    const AudioBufferQueue::Entry entry = queue.take();
+    QCOMPARE(entry.buffer.startTime(), qint64(30000));
+    QCOMPARE(entry.droppedBefore, 10000us);
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_dropNewest_accumulatesGaps()
+{
+    AudioBufferQueue queue;
+    queue.dropNewest(makeBuffer(0));
+    queue.dropNewest(makeBuffer(10000));
+    queue.push(makeBuffer(20000));
+    queue.dropNewest(makeBuffer(30000));
+    queue.push(makeBuffer(40000));
+
+    QCOMPARE(queue.take().droppedBefore, 20000us);
+    QCOMPARE(queue.take().droppedBefore, 10000us);
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_dropOldest_movesGapToFollowingBuffer()
+{
+    AudioBufferQueue queue;
+    queue.dropNewest(makeBuffer(0));
+    queue.push(makeBuffer(10000));
+    queue.push(makeBuffer(20000));
+
+    queue.dropOldest();
+
+    QCOMPARE(queue.size(), qsizetype(1));
+    QCOMPARE(queue.duration(), 10000us);
+
+    // The gap in front of the dropped buffer and the buffer itself
+    const AudioBufferQueue::Entry entry = queue.take();
+    QCOMPARE(entry.buffer.startTime(), qint64(20000));
+    QCOMPARE(entry.droppedBefore, 20000us);
+}
+
+void tst_QFFmpegEncoderQueue::audioQueue_dropOldest_keepsGap_whenQueueBecomesEmpty()
+{
+    AudioBufferQueue queue;
+    queue.push(makeBuffer(0));
+
+    queue.dropOldest();
+    QVERIFY(queue.isEmpty());
+
+    // Does nothing on an empty queue
+    queue.dropOldest();
+
+    queue.push(makeBuffer(10000));
+    QCOMPARE(queue.take().droppedBefore, 10000us);
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegEncoderQueue)
+
+#include "tst_qffmpegencoderqueue.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
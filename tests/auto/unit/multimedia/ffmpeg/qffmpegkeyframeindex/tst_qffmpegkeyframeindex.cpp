@@ -0,0 +1,263 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "playbackengine/qffmpegkeyframeindex_p.h"
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+constexpr int StreamIndex = 0;
+constexpr qint64 Second = 1'000'000;
+
+// Keyframes every 2 seconds, read through by the demuxer from the start
+void addReadKeyframes(KeyframeIndex &index, int count)
+{
+    std::optional<qint64> previousPos;
+    for (int i = 0; i < count; ++i) {
+        const qint64 pos = i * 2 * Second;
+        index.addKeyframe(StreamIndex, { pos, 1000 * i }, previousPos);
+        previousPos = pos;
+    }
+}
+
+// -1 if there is no keyframe
+qint64 keyframePosBefore(const KeyframeIndex &index, qint64 pos)
+{
+    const auto keyframe = index.keyframeBefore(StreamIndex, pos);
+    return keyframe ? keyframe->pos : -1;
+}
+
+qint64 nearestKeyframePos(const KeyframeIndex &index, qint64 pos)
+{
+    const auto keyframe = index.nearestKeyframe(StreamIndex, pos);
+    return keyframe ? keyframe->pos : -1;
+}
+
+} // namespace
+
+class tst_QFFmpegKeyframeIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void keyframeBefore_returnsNothing_whenIndexIsEmpty();
+    void keyframeBefore_returnsKeyframeAtOrBeforePos_withinReadIntervals();
+    void keyframeBefore_returnsNothing_afterLastKeyframe();
+    void keyframeBefore_returnsNothing_acrossSkippedInterval();
+    void keyframeBefore_returnsNothing_whenKeyframeInBetweenIsUnknown();
+    void keyframeBefore_becomesAvailable_whenSkippedIntervalIsRead();
+    void keyframeBefore_returnsBytePos();
+    void addKeyframe_completesUnknownBytePos();
+
+    void nearestKeyframe_snapsToClosestKeyframe();
+    void nearestKeyframe_doesNotSnap_outsideReadIntervals();
+
+    void forMedia_sharesIndex_forSameLocalFile();
+    void forMedia_createsNewIndex_whenLocalFileChanges();
+    void forMedia_sharesIndex_forRemoteUrlWithSameSize();
+    void forMedia_createsNewIndex_whenMediaCannotBeIdentified();
+
+    void seekModeFromName_parsesModeNames();
+};
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsNothing_whenIndexIsEmpty()
+{
+    KeyframeIndex index;
+
+    QVERIFY(!index.keyframeBefore(StreamIndex, 0));
+    QVERIFY(!index.nearestKeyframe(StreamIndex, 0));
+    QCOMPARE(index.keyframeCount(StreamIndex), qsizetype(0));
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsKeyframeAtOrBeforePos_withinReadIntervals()
+{
+    KeyframeIndex index;
+    addReadKeyframes(index, 3);
+
+    QCOMPARE(index.keyframeCount(StreamIndex), qsizetype(3));
+    QCOMPARE(keyframePosBefore(index, 0), qint64(0));
+    QCOMPARE(keyframePosBefore(index, Second), qint64(0));
+    QCOMPARE(keyframePosBefore(index, 2 * Second - 1), qint64(0));
+    QCOMPARE(keyframePosBefore(index, 2 * Second), 2 * Second);
+    QCOMPARE(keyframePosBefore(index, 3 * Second), 2 * Second);
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsNothing_afterLastKeyframe()
+{
+    KeyframeIndex index;
+    addReadKeyframes(index, 3);
+
+    // There might be a keyframe between the last known one and the position
+    QVERIFY(!index.keyframeBefore(StreamIndex, 4 * Second));
+    QVERIFY(!index.keyframeBefore(StreamIndex, 5 * Second));
+    QVERIFY(!index.keyframeBefore(StreamIndex, -1));
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsNothing_acrossSkippedInterval()
+{
+    KeyframeIndex index;
+    index.addKeyframe(StreamIndex, { 0, 0 });
+
+    // The demuxer has seeked from 0 to 10 s
+    index.addKeyframe(StreamIndex, { 10 * Second, 10000 });
+    index.addKeyframe(StreamIndex, { 12 * Second, 12000 }, 10 * Second);
+
+    QVERIFY(!index.keyframeBefore(StreamIndex, 5 * Second));
+    QCOMPARE(keyframePosBefore(index, 11 * Second), 10 * Second);
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsNothing_whenKeyframeInBetweenIsUnknown()
+{
+    KeyframeIndex index;
+    index.addKeyframe(StreamIndex, { 0, 0 });
+
+    // The previous keyframe read, at 2 s, is not in the index
+    index.addKeyframe(StreamIndex, { 4 * Second, 4000 }, 2 * Second);
+
+    QVERIFY(!index.keyframeBefore(StreamIndex, 3 * Second));
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_becomesAvailable_whenSkippedIntervalIsRead()
+{
+    KeyframeIndex index;
+    index.addKeyframe(StreamIndex, { 0, 0 });
+    index.addKeyframe(StreamIndex, { 4 * Second, 4000 });
+    QVERIFY(!index.keyframeBefore(StreamIndex, 3 * Second));
+
+    // Played through from the start
+    index.addKeyframe(StreamIndex, { 2 * Second, 2000 }, 0);
+    index.addKeyframe(StreamIndex, { 4 * Second, 4000 }, 2 * Second);
+
+    QCOMPARE(keyframePosBefore(index, Second), qint64(0));
+    QCOMPARE(keyframePosBefore(index, 3 * Second), 2 * Second);
+    QCOMPARE(index.keyframeCount(StreamIndex), qsizetype(3));
+}
+
+void tst_QFFmpegKeyframeIndex::keyframeBefore_returnsBytePos()
+{
+    KeyframeIndex index;
+    addReadKeyframes(index, 3);
+
+    const auto keyframe = index.keyframeBefore(StreamIndex, 3 * Second);
+    QVERIFY(keyframe);
+    QCOMPARE(keyframe->bytePos, qint64(1000));
+
+    // Other streams have their own keyframes
+    QVERIFY(!index.keyframeBefore(StreamIndex + 1, 3 * Second));
+}
+
+void tst_QFFmpegKeyframeIndex::addKeyframe_completesUnknownBytePos()
+{
+    KeyframeIndex index;
+    index.addKeyframe(StreamIndex, { 0, -1 });
+    index.addKeyframe(StreamIndex, { 2 * Second, 2000 }, 0);
+
+    QCOMPARE(index.keyframeBefore(StreamIndex, Second)->bytePos, qint64(-1));
+
+    index.addKeyframe(StreamIndex, { 0, 500 });
+    QCOMPARE(index.keyframeBefore(StreamIndex, Second)->bytePos, qint64(500));
+
+    // A known byte position is kept
+    index.addKeyframe(StreamIndex, { 0, 700 });
+    QCOMPARE(index.keyframeBefore(StreamIndex, Second)->bytePos, qint64(500));
+}
+
+void tst_QFFmpegKeyframeIndex::nearestKeyframe_snapsToClosestKeyframe()
+{
+    KeyframeIndex index;
+    addReadKeyframes(index, 3);
+
+    QCOMPARE(nearestKeyframePos(index, 0), qint64(0));
+    QCOMPARE(nearestKeyframePos(index, Second - 1), qint64(0));
+    QCOMPARE(nearestKeyframePos(index, Second), qint64(0)); // the earlier one on a tie
+    QCOMPARE(nearestKeyframePos(index, Second + 1), 2 * Second);
+    QCOMPARE(nearestKeyframePos(index, 3 * Second + 1), 4 * Second);
+}
+
+void tst_QFFmpegKeyframeIndex::nearestKeyframe_doesNotSnap_outsideReadIntervals()
+{
+    KeyframeIndex index;
+    index.addKeyframe(StreamIndex, { 0, 0 });
+    index.addKeyframe(StreamIndex, { 4 * Second, 4000 });
+
+    QVERIFY(!index.nearestKeyframe(StreamIndex, Second));
+    QVERIFY(!index.nearestKeyframe(StreamIndex, 5 * Second));
+}
+
+void tst_QFFmpegKeyframeIndex::forMedia_sharesIndex_forSameLocalFile()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("data");
+    file.flush();
+    const QUrl url = QUrl::fromLocalFile(file.fileName());
+
+    const auto index = KeyframeIndex::forMedia(url, -1);
+    QCOMPARE(KeyframeIndex::forMedia(url, -1).get(), index.get());
+
+    // The size is taken from the file
+    QCOMPARE(KeyframeIndex::forMedia(url, 12345).get(), index.get());
+}
+
+void tst_QFFmpegKeyframeIndex::forMedia_createsNewIndex_whenLocalFileChanges()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("data");
+    file.flush();
+    const QUrl url = QUrl::fromLocalFile(file.fileName());
+
+    const auto index = KeyframeIndex::forMedia(url, -1);
+
+    file.write("more data");
+    file.flush();
+
+    QCOMPARE_NE(KeyframeIndex::forMedia(url, -1).get(), index.get());
+}
+
+void tst_QFFmpegKeyframeIndex::forMedia_sharesIndex_forRemoteUrlWithSameSize()
+{
+    const QUrl url(QStringLiteral("https://example.com/video.mp4"));
+
+    const auto index = KeyframeIndex::forMedia(url, 1000);
+    QCOMPARE(KeyframeIndex::forMedia(url, 1000).get(), index.get());
+    QCOMPARE_NE(KeyframeIndex::forMedia(url, 2000).get(), index.get());
+
+    const QUrl otherUrl(QStringLiteral("https://example.com/other.mp4"));
+    QCOMPARE_NE(KeyframeIndex::forMedia(otherUrl, 1000).get(), index.get());
+}
+
+void tst_QFFmpegKeyframeIndex::forMedia_createsNewIndex_whenMediaCannotBeIdentified()
+{
+    const QUrl remoteUrl(QStringLiteral("rtsp://example.com/stream"));
+    const auto remoteIndex = KeyframeIndex::forMedia(remoteUrl, -1);
+    QVERIFY(remoteIndex);
+    QCOMPARE_NE(KeyframeIndex::forMedia(remoteUrl, -1).get(), remoteIndex.get());
+
+    const auto emptyUrlIndex = KeyframeIndex::forMedia({}, 1000);
+    QVERIFY(emptyUrlIndex);
+    QCOMPARE_NE(KeyframeIndex::forMedia({}, 1000).get(), emptyUrlIndex.get());
+
+    const QUrl missingFile = QUrl::fromLocalFile(QStringLiteral("/nonexistent/video.mp4"));
+    const auto missingFileIndex = KeyframeIndex::forMedia(missingFile, -1);
+    QCOMPARE_NE(KeyframeIndex::forMedia(missingFile, -1).get(), missingFileIndex.get());
+}
+
+void tst_QFFmpegKeyframeIndex::seekModeFromName_parsesModeNames()
+{
+    QVERIFY(seekModeFromName("accurate") == SeekMode::Accurate);
+    QVERIFY(seekModeFromName("fast") == SeekMode::Fast);
+    QVERIFY(!seekModeFromName(""));
+    QVERIFY(!seekModeFromName("Fast"));
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegKeyframeIndex)
+
+#include "tst_qffmpegkeyframeindex.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,305 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "playbackengine/qffmpegobjectpool_p.h"
+
+#include <thread>
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+using IntPool = RecyclingPool<int>;
+
+auto makeInt(int value = 0)
+{
+    return [value]() { return std::make_unique<int>(value); };
+}
+
+struct PooledObject : PoolAllocated<PooledObject>
+{
+    qint64 values[4] = {};
+};
+
+// Not the string, which QCOMPARE would compare for char pointers
+const void *addressOf(const QByteArray &data)
+{
+    return data.constData();
+}
+
+} // namespace
+
+class tst_QFFmpegObjectPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void acquire_createsObject_whenPoolIsEmpty();
+    void acquire_reusesRecycledObject();
+    void recycle_dropsObject_whenPoolIsFull();
+    void recycle_ignoresNull();
+    void zeroSizedPool_disablesPooling();
+    void recycle_acceptsObjectsFromOtherThreads();
+
+    void recycleAVPacket_resetsPacket();
+    void recycleAVFrame_resetsFrame();
+
+    void poolAllocated_reusesMemory();
+
+    void byteArrayPool_reusesArray_whenConsumersReleasedIt();
+    void byteArrayPool_createsArray_whileConsumersHoldIt();
+    void byteArrayPool_forgetsOldestArray_whenFull();
+};
+
+void tst_QFFmpegObjectPool::acquire_createsObject_whenPoolIsEmpty()
+{
+    IntPool pool(2);
+
+    IntPool::Ptr object = pool.acquire(makeInt(42));
+
+    QVERIFY(object);
+    QCOMPARE(*object, 42);
+
+    const PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.created, quint64(1));
+    QCOMPARE(statistics.reused, quint64(0));
+    QCOMPARE(statistics.dropped, quint64(0));
+    QCOMPARE(statistics.idle, 0);
+}
+
+void tst_QFFmpegObjectPool::acquire_reusesRecycledObject()
+{
+    IntPool pool(2);
+
+    IntPool::Ptr object = pool.acquire(makeInt());
+    int *const address = object.get();
+    pool.recycle(std::move(object));
+    QCOMPARE(pool.statistics().idle, 1);
+
+    bool created = false;
+    IntPool::Ptr reused = pool.acquire([&created]() {
+        created = true;
+        return std::make_unique<int>();
+    });
+
+    QVERIFY(!created);
+    QCOMPARE(reused.get(), address);
+
+    const PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.created, quint64(1));
+    QCOMPARE(statistics.reused, quint64(1));
+    QCOMPARE(statistics.idle, 0);
+}
+
+void tst_QFFmpegObjectPool::recycle_dropsObject_whenPoolIsFull()
+{
+    IntPool pool(2);
+
+    for (int i = 0; i < 3; ++i)
+        pool.recycle(std::make_unique<int>(i));
+
+    PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.idle, 2);
+    QCOMPARE(statistics.dropped, quint64(1));
+
+    // The last recycled object is reused first
+    QCOMPARE(*pool.acquire(makeInt()), 1);
+    QCOMPARE(*pool.acquire(makeInt()), 0);
+    QCOMPARE(*pool.acquire(makeInt(7)), 7);
+
+    statistics = pool.statistics();
+    QCOMPARE(statistics.reused, quint64(2));
+    QCOMPARE(statistics.created, quint64(1));
+}
+
+void tst_QFFmpegObjectPool::recycle_ignoresNull()
+{
+    IntPool pool(2);
+
+    pool.recycle(nullptr);
+
+    const PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.idle, 0);
+    QCOMPARE(statistics.dropped, quint64(0));
+}
+
+void tst_QFFmpegObjectPool::zeroSizedPool_disablesPooling()
+{
+    IntPool pool(0);
+
+    pool.recycle(pool.acquire(makeInt()));
+    pool.recycle(pool.acquire(makeInt()));
+
+    const PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.created, quint64(2));
+    QCOMPARE(statistics.reused, quint64(0));
+    QCOMPARE(statistics.dropped, quint64(2));
+    QCOMPARE(statistics.idle, 0);
+}
+
+void tst_QFFmpegObjectPool::recycle_acceptsObjectsFromOtherThreads()
+{
+    constexpr int Iterations = 10000;
+    IntPool pool(4);
+
+    // A producer and a consumer thread, like a decoder and a renderer
+    std::thread consumer;
+    {
+        std::vector<IntPool::Ptr> objects;
+        objects.reserve(Iterations);
+        for (int i = 0; i < Iterations; ++i)
+            objects.push_back(pool.acquire(makeInt(i)));
+
+        consumer = std::thread([&pool, objects = std::move(objects)]() mutable {
+            for (auto &object : objects)
+                pool.recycle(std::move(object));
+        });
+    }
+
+    for (int i = 0; i < Iterations; ++i)
+        pool.recycle(pool.acquire(makeInt()));
+
+    consumer.join();
+
+    const PoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.created + statistics.reused, quint64(Iterations * 2));
+    QCOMPARE(statistics.reused + statistics.dropped + quint64(statistics.idle),
+             quint64(Iterations * 2));
+    QVERIFY(statistics.idle <= 4);
+}
+
+void tst_QFFmpegObjectPool::recycleAVPacket_resetsPacket()
+{
+    if (defaultMaxIdlePoolObjects() == 0)
+        QSKIP("Pooling is disabled by QT_FFMPEG_OBJECT_POOL_SIZE");
+
+    AVPacketUPtr packet = acquireAVPacket();
+    QVERIFY(packet);
+    QCOMPARE(av_new_packet(packet.get(), 64), 0);
+    packet->pts = 100;
+    packet->stream_index = 1;
+    AVPacket *const address = packet.get();
+
+    recycleAVPacket(std::move(packet));
+    AVPacketUPtr reused = acquireAVPacket();
+
+    QCOMPARE(reused.get(), address);
+    QCOMPARE(reused->buf, nullptr);
+    QCOMPARE(reused->data, nullptr);
+    QCOMPARE(reused->size, 0);
+    QCOMPARE(reused->pts, AV_NOPTS_VALUE);
+    QCOMPARE(reused->stream_index, 0);
+}
+
+void tst_QFFmpegObjectPool::recycleAVFrame_resetsFrame()
+{
+    if (defaultMaxIdlePoolObjects() == 0)
+        QSKIP("Pooling is disabled by QT_FFMPEG_OBJECT_POOL_SIZE");
+
+    AVFrameUPtr frame = acquireAVFrame();
+    QVERIFY(frame);
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = 16;
+    frame->height = 16;
+    QCOMPARE(av_frame_get_buffer(frame.get(), 0), 0);
+    AVFrame *const address = frame.get();
+
+    recycleAVFrame(std::move(frame));
+    AVFrameUPtr reused = acquireAVFrame();
+
+    QCOMPARE(reused.get(), address);
+    QCOMPARE(reused->buf[0], nullptr);
+    QCOMPARE(reused->data[0], nullptr);
+    QCOMPARE(reused->width, 0);
+    QCOMPARE(reused->height, 0);
+    QCOMPARE(reused->format, -1);
+}
+
+void tst_QFFmpegObjectPool::poolAllocated_reusesMemory()
+{
+    if (defaultMaxIdlePoolObjects() == 0)
+        QSKIP("Pooling is disabled by QT_FFMPEG_OBJECT_POOL_SIZE");
+
+    auto *object = new PooledObject;
+    void *const address = object;
+    delete object;
+
+    const PoolStatistics before = PooledObject::poolStatistics();
+    QCOMPARE(before.idle, 1);
+
+    auto *reused = new PooledObject;
+    QCOMPARE(static_cast<void *>(reused), address);
+    QCOMPARE(PooledObject::poolStatistics().reused, before.reused + 1);
+    delete reused;
+}
+
+void tst_QFFmpegObjectPool::byteArrayPool_reusesArray_whenConsumersReleasedIt()
+{
+    ByteArrayPool pool(2);
+
+    QByteArray data = pool.take(1024);
+    QCOMPARE(data.size(), qsizetype(1024));
+    const void *const dataAddress = addressOf(data);
+    pool.track(data);
+    data = {};
+
+    // Shrinking and growing within the capacity keep the allocation
+    QByteArray reused = pool.take(512);
+    QCOMPARE(addressOf(reused), dataAddress);
+    QCOMPARE(reused.size(), qsizetype(512));
+    QCOMPARE(pool.trackedCount(), 0);
+
+    pool.track(reused);
+    reused = {};
+    reused = pool.take(1024);
+    QCOMPARE(addressOf(reused), dataAddress);
+}
+
+void tst_QFFmpegObjectPool::byteArrayPool_createsArray_whileConsumersHoldIt()
+{
+    ByteArrayPool pool(2);
+
+    const QByteArray held = pool.take(1024);
+    pool.track(held);
+
+    const QByteArray other = pool.take(1024);
+    QVERIFY(addressOf(other) != addressOf(held));
+    QCOMPARE(pool.trackedCount(), 1);
+
+    // Empty arrays are not tracked
+    pool.track(QByteArray());
+    QCOMPARE(pool.trackedCount(), 1);
+}
+
+void tst_QFFmpegObjectPool::byteArrayPool_forgetsOldestArray_whenFull()
+{
+    ByteArrayPool pool(2);
+
+    QByteArray first = pool.take(16);
+    QByteArray second = pool.take(16);
+    QByteArray third = pool.take(16);
+    const void *const thirdAddress = addressOf(third);
+    pool.track(first);
+    pool.track(second);
+    pool.track(third);
+    QCOMPARE(pool.trackedCount(), 2);
+
+    first = {};
+    second = {};
+    third = {};
+
+    // The first array has been freed; the second one is the oldest tracked one
+    QVERIFY(addressOf(pool.take(16)) != thirdAddress);
+    QCOMPARE(addressOf(pool.take(16)), thirdAddress);
+    QCOMPARE(pool.trackedCount(), 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegObjectPool)
+
+#include "tst_qffmpegobjectpool.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
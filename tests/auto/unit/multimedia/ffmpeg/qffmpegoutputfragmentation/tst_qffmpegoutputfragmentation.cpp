@@ -0,0 +1,173 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "qffmpegoutputfragmentation_p.h"
+
+using namespace QFFmpeg;
+using namespace std::chrono_literals;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+OutputFragmentation makeFragmentation(std::chrono::milliseconds duration)
+{
+    OutputFragmentation fragmentation;
+    fragmentation.fragmentDuration = duration;
+    return fragmentation;
+}
+
+// Writes the header of an output with a single MJPEG stream into a memory buffer
+// and returns the written data; the options consumed by the muxer are removed.
+std::optional<QByteArray> writeHeader(const char *formatName, AVDictionary **options)
+{
+    AVFormatContext *context = nullptr;
+    if (avformat_alloc_output_context2(&context, nullptr, formatName, nullptr) < 0)
+        return {};
+    auto freeContext = qScopeGuard([context] { avformat_free_context(context); });
+
+    if (avio_open_dyn_buf(&context->pb) < 0)
+        return {};
+
+    AVStream *stream = avformat_new_stream(context, nullptr);
+    stream->time_base = { 1, 1000 };
+    stream->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+    stream->codecpar->codec_id = AV_CODEC_ID_MJPEG;
+    stream->codecpar->width = 64;
+    stream->codecpar->height = 64;
+
+    const int result = avformat_write_header(context, options);
+    avio_flush(context->pb);
+
+    uint8_t *data = nullptr;
+    const int size = avio_close_dyn_buf(context->pb, &data);
+    context->pb = nullptr;
+    QByteArray written(reinterpret_cast<const char *>(data), size);
+    av_free(data);
+
+    if (result < 0)
+        return {};
+    return written;
+}
+
+} // namespace
+
+class tst_QFFmpegOutputFragmentation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromEnvironment_readsFragmentDuration_data();
+    void fromEnvironment_readsFragmentDuration();
+
+    void addMuxerOptions_addsNothing_whenDisabled();
+    void addMuxerOptions_returnsFalse_forUnsupportedFormat();
+    void addMuxerOptions_optionsAreAcceptedByMuxer_data();
+    void addMuxerOptions_optionsAreAcceptedByMuxer();
+    void addMuxerOptions_makesMp4Fragmented();
+};
+
+void tst_QFFmpegOutputFragmentation::fromEnvironment_readsFragmentDuration_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<qint64>("expectedDurationMs");
+
+    QTest::addRow("unset") << QByteArray() << qint64(0);
+    QTest::addRow("valid") << QByteArray("2000") << qint64(2000);
+    QTest::addRow("negative") << QByteArray("-1") << qint64(0);
+    QTest::addRow("invalid") << QByteArray("abc") << qint64(0);
+}
+
+void tst_QFFmpegOutputFragmentation::fromEnvironment_readsFragmentDuration()
+{
+    QFETCH(const QByteArray, value);
+    QFETCH(const qint64, expectedDurationMs);
+
+    if (value.isNull())
+        qunsetenv("QT_FFMPEG_ENCODING_FRAGMENT_DURATION_MS");
+    else
+        qputenv("QT_FFMPEG_ENCODING_FRAGMENT_DURATION_MS", value);
+    auto resetEnvironment =
+            qScopeGuard([] { qunsetenv("QT_FFMPEG_ENCODING_FRAGMENT_DURATION_MS"); });
+
+    const OutputFragmentation fragmentation = OutputFragmentation::fromEnvironment();
+
+    QCOMPARE(qint64(fragmentation.fragmentDuration.count()), expectedDurationMs);
+    QCOMPARE(fragmentation.isEnabled(), expectedDurationMs > 0);
+}
+
+void tst_QFFmpegOutputFragmentation::addMuxerOptions_addsNothing_whenDisabled()
+{
+    AVDictionary *options = nullptr;
+    auto freeOptions = qScopeGuard([&options] { av_dict_free(&options); });
+
+    QVERIFY(OutputFragmentation{}.addMuxerOptions(av_guess_format("mp4", nullptr, nullptr),
+                                                  &options));
+    QCOMPARE(av_dict_count(options), 0);
+}
+
+void tst_QFFmpegOutputFragmentation::addMuxerOptions_returnsFalse_forUnsupportedFormat()
+{
+    AVDictionary *options = nullptr;
+    auto freeOptions = qScopeGuard([&options] { av_dict_free(&options); });
+
+    QVERIFY(!makeFragmentation(1s).addMuxerOptions(av_guess_format("avi", nullptr, nullptr),
+                                                   &options));
+    QCOMPARE(av_dict_count(options), 0);
+}
+
+void tst_QFFmpegOutputFragmentation::addMuxerOptions_optionsAreAcceptedByMuxer_data()
+{
+    QTest::addColumn<QByteArray>("formatName");
+
+    QTest::addRow("mp4") << QByteArray("mp4");
+    QTest::addRow("mov") << QByteArray("mov");
+    QTest::addRow("matroska") << QByteArray("matroska");
+}
+
+void tst_QFFmpegOutputFragmentation::addMuxerOptions_optionsAreAcceptedByMuxer()
+{
+    QFETCH(const QByteArray, formatName);
+
+    const AVOutputFormat *format = av_guess_format(formatName.constData(), nullptr, nullptr);
+    QVERIFY(format);
+
+    AVDictionary *options = nullptr;
+    auto freeOptions = qScopeGuard([&options] { av_dict_free(&options); });
+
+    QVERIFY(makeFragmentation(1s).addMuxerOptions(format, &options));
+    QCOMPARE_GT(av_dict_count(options), 0);
+
+    QVERIFY(writeHeader(formatName.constData(), &options));
+
+    // The muxer leaves the options it doesn't know in the dictionary
+    QCOMPARE(av_dict_count(options), 0);
+}
+
+void tst_QFFmpegOutputFragmentation::addMuxerOptions_makesMp4Fragmented()
+{
+    AVDictionary *options = nullptr;
+    auto freeOptions = qScopeGuard([&options] { av_dict_free(&options); });
+
+    const std::optional<QByteArray> regular = writeHeader("mp4", &options);
+    QVERIFY(regular);
+
+    QVERIFY(makeFragmentation(1s).addMuxerOptions(av_guess_format("mp4", nullptr, nullptr),
+                                                  &options));
+    const std::optional<QByteArray> fragmented = writeHeader("mp4", &options);
+    QVERIFY(fragmented);
+
+    // The regular MP4 has the moov in the trailer, the fragmented one upfront
+    // with the movie extends box
+    QVERIFY(!regular->contains("moov"));
+    QVERIFY(fragmented->contains("moov"));
+    QVERIFY(fragmented->contains("mvex"));
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegOutputFragmentation)
+
+#include "tst_qffmpegoutputfragmentation.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
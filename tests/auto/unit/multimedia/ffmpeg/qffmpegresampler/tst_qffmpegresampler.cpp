@@ -0,0 +1,140 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtCore/qmath.h>
+
+#include "qffmpegresampler_p.h"
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+constexpr int FrameCount = 8;
+constexpr int SamplesPerFrame = 1024;
+
+QAudioFormat makeFormat(QAudioFormat::SampleFormat sampleFormat, int sampleRate, int channels)
+{
+    QAudioFormat format;
+    format.setSampleFormat(sampleFormat);
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    return format;
+}
+
+// Interleaved Int16 sine, continuous across the frames
+QByteArray makeInput(const QAudioFormat &format, int frameIndex)
+{
+    QByteArray data(format.bytesForFrames(SamplesPerFrame), Qt::Uninitialized);
+    auto *samples = reinterpret_cast<qint16 *>(data.data());
+
+    for (int i = 0; i < SamplesPerFrame; ++i) {
+        const double t = double(frameIndex * SamplesPerFrame + i) / format.sampleRate();
+        for (int channel = 0; channel < format.channelCount(); ++channel)
+            *samples++ = qint16(10000 * std::sin(2 * M_PI * 440 * (channel + 1) * t));
+    }
+
+    return data;
+}
+
+// A frame that refers to the data without owning it; only the packed
+// sample formats are used, so there is a single plane
+AVFrameUPtr wrapInput(QByteArray &data)
+{
+    AVFrameUPtr frame = makeAVFrame();
+    frame->data[0] = reinterpret_cast<uint8_t *>(data.data());
+    frame->extended_data = frame->data;
+    frame->nb_samples = SamplesPerFrame;
+    return frame;
+}
+
+QByteArray toByteArray(const QAudioBuffer &buffer)
+{
+    return QByteArray(buffer.constData<char>(), buffer.byteCount());
+}
+
+} // namespace
+
+class tst_QFFmpegResampler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void resampleInto_writesSameBytesAsResample_data();
+    void resampleInto_writesSameBytesAsResample();
+    void resampleInto_keepsSamplesThatDontFit_forSmallDestination();
+};
+
+void tst_QFFmpegResampler::resampleInto_writesSameBytesAsResample_data()
+{
+    QTest::addColumn<QAudioFormat>("inputFormat");
+    QTest::addColumn<QAudioFormat>("outputFormat");
+
+    QTest::newRow("sample format only") << makeFormat(QAudioFormat::Int16, 48000, 2)
+                                        << makeFormat(QAudioFormat::Float, 48000, 2);
+    QTest::newRow("downsampling") << makeFormat(QAudioFormat::Int16, 48000, 2)
+                                  << makeFormat(QAudioFormat::Int16, 44100, 2);
+    QTest::newRow("upsampling and upmixing") << makeFormat(QAudioFormat::Int16, 22050, 1)
+                                             << makeFormat(QAudioFormat::Int32, 48000, 2);
+}
+
+void tst_QFFmpegResampler::resampleInto_writesSameBytesAsResample()
+{
+    QFETCH(QAudioFormat, inputFormat);
+    QFETCH(QAudioFormat, outputFormat);
+
+    QFFmpegResampler resampler(inputFormat, outputFormat);
+    QFFmpegResampler intoResampler(inputFormat, outputFormat);
+
+    for (int i = 0; i < FrameCount; ++i) {
+        QByteArray input = makeInput(inputFormat, i);
+        AVFrameUPtr frame = wrapInput(input);
+
+        const QByteArray expected = toByteArray(resampler.resample(frame.get()));
+
+        QByteArray destination(intoResampler.maxOutputBytes(frame.get()), Qt::Uninitialized);
+        const qsizetype written = intoResampler.resampleInto(frame.get(), destination);
+
+        QVERIFY(written <= destination.size());
+        QCOMPARE(destination.first(written), expected);
+        QCOMPARE(intoResampler.samplesProcessed(), resampler.samplesProcessed());
+    }
+}
+
+void tst_QFFmpegResampler::resampleInto_keepsSamplesThatDontFit_forSmallDestination()
+{
+    const QAudioFormat inputFormat = makeFormat(QAudioFormat::Int16, 48000, 2);
+    const QAudioFormat outputFormat = makeFormat(QAudioFormat::Float, 44100, 2);
+
+    QFFmpegResampler resampler(inputFormat, outputFormat);
+    QFFmpegResampler intoResampler(inputFormat, outputFormat);
+
+    QByteArray expected;
+    QByteArray actual;
+    for (int i = 0; i < FrameCount; ++i) {
+        QByteArray input = makeInput(inputFormat, i);
+        AVFrameUPtr frame = wrapInput(input);
+
+        expected += toByteArray(resampler.resample(frame.get()));
+
+        QByteArray destination(intoResampler.maxOutputBytes(frame.get()) / 2, Qt::Uninitialized);
+        const qsizetype written = intoResampler.resampleInto(frame.get(), destination);
+
+        QVERIFY(written <= destination.size());
+        QCOMPARE(written % outputFormat.bytesPerFrame(), qsizetype(0));
+        actual += destination.first(written);
+    }
+
+    // The samples that didn't fit are delayed, not dropped
+    QVERIFY(!actual.isEmpty());
+    QVERIFY(actual.size() < expected.size());
+    QCOMPARE(actual, expected.first(actual.size()));
+}
+
+QTEST_GUILESS_MAIN(tst_QFFmpegResampler)
+
+#include "tst_qffmpegresampler.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
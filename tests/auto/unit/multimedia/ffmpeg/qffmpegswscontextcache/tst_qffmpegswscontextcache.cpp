@@ -0,0 +1,235 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include "qffmpegswscontextcache_p.h"
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+SwsContextKey makeKey(int width)
+{
+    SwsContextKey key;
+    key.srcSize = QSize(width, 16);
+    key.srcPixFmt = AV_PIX_FMT_YUV420P;
+    key.dstSize = QSize(width, 16);
+    key.dstPixFmt = AV_PIX_FMT_RGBA;
+    return key;
+}
+
+} // namespace
+
+class tst_QFFmpegSwsContextCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void acquire_createsContext_onMiss();
+    void acquire_reusesReleasedContext_onHit();
+    void acquire_createsNewContext_whenMatchingContextIsCheckedOut();
+    void acquire_missesForDifferentKey();
+    void acquire_appliesColorSpaceDetails();
+    void release_evictsLeastRecentlyUsedContext();
+    void setMaxIdleContexts_evictsExcessContexts();
+    void clear_evictsAllIdleContexts();
+    void movedHandle_releasesContextOnce();
+};
+
+void tst_QFFmpegSwsContextCache::acquire_createsContext_onMiss()
+{
+    SwsContextCache cache;
+
+    SwsContextCache::Handle handle = cache.acquire(makeKey(32));
+
+    QVERIFY(handle);
+    QVERIFY(handle.get());
+
+    const SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits, quint64(0));
+    QCOMPARE(statistics.misses, quint64(1));
+    QCOMPARE(statistics.evictions, quint64(0));
+    QCOMPARE(statistics.idleContexts, 0);
+}
+
+void tst_QFFmpegSwsContextCache::acquire_reusesReleasedContext_onHit()
+{
+    SwsContextCache cache;
+
+    SwsContext *context = nullptr;
+    {
+        SwsContextCache::Handle handle = cache.acquire(makeKey(32));
+        context = handle.get();
+    }
+    QCOMPARE(cache.statistics().idleContexts, 1);
+
+    SwsContextCache::Handle handle = cache.acquire(makeKey(32));
+
+    QCOMPARE(handle.get(), context);
+
+    const SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits, quint64(1));
+    QCOMPARE(statistics.misses, quint64(1));
+    QCOMPARE(statistics.idleContexts, 0);
+}
+
+void tst_QFFmpegSwsContextCache::acquire_createsNewContext_whenMatchingContextIsCheckedOut()
+{
+    SwsContextCache cache;
+
+    SwsContextCache::Handle first = cache.acquire(makeKey(32));
+    SwsContextCache::Handle second = cache.acquire(makeKey(32));
+
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(first.get() != second.get());
+    QCOMPARE(cache.statistics().misses, quint64(2));
+
+    first = {};
+    second = {};
+    QCOMPARE(cache.statistics().idleContexts, 2);
+}
+
+void tst_QFFmpegSwsContextCache::acquire_missesForDifferentKey()
+{
+    SwsContextCache cache;
+    cache.acquire(makeKey(32));
+
+    SwsContextKey otherFormat = makeKey(32);
+    otherFormat.dstPixFmt = AV_PIX_FMT_BGRA;
+    SwsContextCache::Handle handle = cache.acquire(otherFormat);
+
+    QVERIFY(handle);
+
+    const SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits, quint64(0));
+    QCOMPARE(statistics.misses, quint64(2));
+    QCOMPARE(statistics.idleContexts, 1);
+}
+
+void tst_QFFmpegSwsContextCache::acquire_appliesColorSpaceDetails()
+{
+    SwsContextCache cache;
+
+    SwsContextKey key = makeKey(32);
+    key.srcColorSpace = SWS_CS_ITU709;
+    key.srcColorRange = 1;
+    key.dstColorSpace = SWS_CS_ITU709;
+    key.dstColorRange = 0;
+
+    SwsContextCache::Handle handle = cache.acquire(key);
+    QVERIFY(handle);
+
+    int *invTable = nullptr;
+    int *table = nullptr;
+    int srcRange = -1;
+    int dstRange = -1;
+    int brightness = 0;
+    int contrast = 0;
+    int saturation = 0;
+    QCOMPARE(sws_getColorspaceDetails(handle.get(), &invTable, &srcRange, &table, &dstRange,
+                                      &brightness, &contrast, &saturation),
+             0);
+    QCOMPARE(srcRange, 1);
+    QCOMPARE(dstRange, 0);
+
+    // The color space is a part of the key
+    handle = {};
+    SwsContextCache::Handle defaults = cache.acquire(makeKey(32));
+    QCOMPARE(cache.statistics().hits, quint64(0));
+}
+
+void tst_QFFmpegSwsContextCache::release_evictsLeastRecentlyUsedContext()
+{
+    SwsContextCache cache(2);
+
+    cache.acquire(makeKey(32));
+    cache.acquire(makeKey(64));
+    cache.acquire(makeKey(96));
+
+    SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.evictions, quint64(1));
+    QCOMPARE(statistics.idleContexts, 2);
+
+    // The first released context has been evicted, the others are still there
+    cache.acquire(makeKey(96));
+    cache.acquire(makeKey(64));
+    QCOMPARE(cache.statistics().hits, quint64(2));
+
+    cache.acquire(makeKey(32));
+    statistics = cache.statistics();
+    QCOMPARE(statistics.hits, quint64(2));
+    QCOMPARE(statistics.misses, quint64(4));
+}
+
+void tst_QFFmpegSwsContextCache::setMaxIdleContexts_evictsExcessContexts()
+{
+    SwsContextCache cache;
+    cache.acquire(makeKey(32));
+    cache.acquire(makeKey(64));
+    cache.acquire(makeKey(96));
+    QCOMPARE(cache.statistics().idleContexts, 3);
+
+    cache.setMaxIdleContexts(1);
+
+    QCOMPARE(cache.maxIdleContexts(), 1);
+    SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.evictions, quint64(2));
+    QCOMPARE(statistics.idleContexts, 1);
+
+    // The most recently released context stays
+    cache.acquire(makeKey(96));
+    QCOMPARE(cache.statistics().hits, quint64(1));
+
+    cache.setMaxIdleContexts(0);
+    cache.acquire(makeKey(96));
+    statistics = cache.statistics();
+    QCOMPARE(statistics.hits, quint64(2));
+    QCOMPARE(statistics.evictions, quint64(3));
+    QCOMPARE(statistics.idleContexts, 0);
+}
+
+void tst_QFFmpegSwsContextCache::clear_evictsAllIdleContexts()
+{
+    SwsContextCache cache;
+    SwsContextCache::Handle checkedOut = cache.acquire(makeKey(32));
+    cache.acquire(makeKey(64));
+    cache.acquire(makeKey(96));
+
+    cache.clear();
+
+    SwsContextCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.evictions, quint64(2));
+    QCOMPARE(statistics.idleContexts, 0);
+
+    // Checked out contexts return to the pool after clear()
+    checkedOut = {};
+    QCOMPARE(cache.statistics().idleContexts, 1);
+}
+
+void tst_QFFmpegSwsContextCache::movedHandle_releasesContextOnce()
+{
+    SwsContextCache cache;
+
+    {
+        SwsContextCache::Handle handle = cache.acquire(makeKey(32));
+        SwsContextCache::Handle moved = std::move(handle);
+        QVERIFY(!handle); // NOLINT(bugprone-use-after-move)
+        QVERIFY(moved);
+
+        SwsContextCache::Handle assigned;
+        assigned = std::move(moved);
+        QVERIFY(assigned);
+    }
+
+    QCOMPARE(cache.statistics().idleContexts, 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QFFmpegSwsContextCache)
+
+#include "tst_qffmpegswscontextcache.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,276 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtCore/qscopeguard.h>
+#include <QtCore/qtemporarydir.h>
+
+#include "playbackengine/qffmpegthumbnailextractor_p.h"
+
+#include <limits>
+
+using namespace QFFmpeg;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+constexpr QSize ClipSize(320, 240);
+constexpr int ClipFrameCount = 20;
+constexpr int ClipFrameRate = 25; // 40 ms per frame
+constexpr int ClipGopSize = 10;   // keyframes at 0 and 400 ms
+
+constexpr qint64 frameTimeUs(int frameIndex)
+{
+    return qint64(frameIndex) * 1000000 / ClipFrameRate;
+}
+
+// Each frame of the clip is flat, with a distinct luma
+constexpr int lumaOf(int frameIndex)
+{
+    return 40 + 8 * frameIndex;
+}
+
+// The frame index whose luma is the closest to the center of the image
+int frameIndexOf(const QImage &image)
+{
+    const int gray = qGray(image.pixel(image.width() / 2, image.height() / 2));
+
+    int result = -1;
+    int bestDistance = std::numeric_limits<int>::max();
+    for (int i = 0; i < ClipFrameCount; ++i) {
+        // limited range luma to full range RGB
+        const int expected = (lumaOf(i) - 16) * 255 / 219;
+        const int distance = qAbs(gray - expected);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            result = i;
+        }
+    }
+
+    return result;
+}
+
+// Encodes the clip with the built-in MPEG-4 part 2 encoder, which supports lowres decoding
+QString writeClip(const QString &fileName)
+{
+    const AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    if (!encoder)
+        return {};
+
+    AVFormatContext *format = nullptr;
+    if (avformat_alloc_output_context2(&format, nullptr, "matroska", nullptr) < 0 || !format)
+        return {};
+    auto freeFormat = qScopeGuard([&]() {
+        if (format->pb)
+            avio_closep(&format->pb);
+        avformat_free_context(format);
+    });
+
+    AVCodecContextUPtr codecContext(avcodec_alloc_context3(encoder));
+    codecContext->width = ClipSize.width();
+    codecContext->height = ClipSize.height();
+    codecContext->pix_fmt = AV_PIX_FMT_YUV420P;
+    codecContext->time_base = { 1, ClipFrameRate };
+    codecContext->framerate = { ClipFrameRate, 1 };
+    codecContext->gop_size = ClipGopSize;
+    codecContext->max_b_frames = 0;
+    codecContext->bit_rate = 4000000;
+    if (format->oformat->flags & AVFMT_GLOBALHEADER)
+        codecContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    if (avcodec_open2(codecContext.get(), encoder, nullptr) < 0)
+        return {};
+
+    AVStream *stream = avformat_new_stream(format, nullptr);
+    if (!stream || avcodec_parameters_from_context(stream->codecpar, codecContext.get()) < 0)
+        return {};
+    stream->time_base = codecContext->time_base;
+
+    const QByteArray path = QFile::encodeName(fileName);
+    if (avio_open(&format->pb, path.constData(), AVIO_FLAG_WRITE) < 0
+        || avformat_write_header(format, nullptr) < 0)
+        return {};
+
+    AVPacketUPtr packet(av_packet_alloc());
+    auto writePackets = [&]() {
+        while (avcodec_receive_packet(codecContext.get(), packet.get()) >= 0) {
+            av_packet_rescale_ts(packet.get(), codecContext->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            if (av_interleaved_write_frame(format, packet.get()) < 0)
+                return false;
+        }
+        return true;
+    };
+
+    for (int i = 0; i < ClipFrameCount; ++i) {
+        AVFrameUPtr frame = makeAVFrame();
+        frame->width = ClipSize.width();
+        frame->height = ClipSize.height();
+        frame->format = AV_PIX_FMT_YUV420P;
+        if (av_frame_get_buffer(frame.get(), 0) < 0)
+            return {};
+
+        for (int y = 0; y < frame->height; ++y)
+            memset(frame->data[0] + y * frame->linesize[0], lumaOf(i), frame->width);
+        for (int plane = 1; plane < 3; ++plane)
+            for (int y = 0; y < frame->height / 2; ++y)
+                memset(frame->data[plane] + y * frame->linesize[plane], 128, frame->width / 2);
+
+        frame->pts = i;
+        if (avcodec_send_frame(codecContext.get(), frame.get()) < 0 || !writePackets())
+            return {};
+    }
+
+    avcodec_send_frame(codecContext.get(), nullptr);
+    if (!writePackets() || av_write_trailer(format) < 0)
+        return {};
+
+    return fileName;
+}
+
+} // namespace
+
+class tst_QFFmpegThumbnailExtractor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void extract_returnsKeyframeAtOrBeforePosition_inKeyframesMode();
+    void extract_returnsFrameAtPosition_inExactMode();
+    void extract_spreadsPositionsOverDuration_whenNoPositionsGiven();
+    void extract_fitsImageIntoMaxSize_data();
+    void extract_fitsImageIntoMaxSize();
+    void extract_fails_forMissingFile();
+    void extractAsync_returnsSameThumbnailsAsExtract();
+
+private:
+    QTemporaryDir m_dir;
+    QUrl m_clip;
+};
+
+void tst_QFFmpegThumbnailExtractor::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    const QString clip = writeClip(m_dir.filePath(QStringLiteral("clip.mkv")));
+    if (clip.isEmpty())
+        QSKIP("Cannot encode a test clip with this FFmpeg build");
+
+    m_clip = QUrl::fromLocalFile(clip);
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_returnsKeyframeAtOrBeforePosition_inKeyframesMode()
+{
+    ThumbnailRequest request;
+    request.positions = { frameTimeUs(3), frameTimeUs(12) };
+    request.mode = ThumbnailRequest::Keyframes;
+
+    const auto thumbnails = ThumbnailExtractor::extract(m_clip, request);
+
+    QVERIFY(thumbnails);
+    QCOMPARE(thumbnails.value().size(), qsizetype(2));
+    QCOMPARE(thumbnails.value()[0].pos, frameTimeUs(0));
+    QCOMPARE(frameIndexOf(thumbnails.value()[0].image), 0);
+    QCOMPARE(thumbnails.value()[1].pos, frameTimeUs(ClipGopSize));
+    QCOMPARE(frameIndexOf(thumbnails.value()[1].image), ClipGopSize);
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_returnsFrameAtPosition_inExactMode()
+{
+    ThumbnailRequest request;
+    request.positions = { frameTimeUs(7), frameTimeUs(13) };
+    request.mode = ThumbnailRequest::Exact;
+
+    const auto thumbnails = ThumbnailExtractor::extract(m_clip, request);
+
+    QVERIFY(thumbnails);
+    QCOMPARE(thumbnails.value().size(), qsizetype(2));
+    QCOMPARE(thumbnails.value()[0].pos, frameTimeUs(7));
+    QCOMPARE(frameIndexOf(thumbnails.value()[0].image), 7);
+    QCOMPARE(thumbnails.value()[1].pos, frameTimeUs(13));
+    QCOMPARE(frameIndexOf(thumbnails.value()[1].image), 13);
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_spreadsPositionsOverDuration_whenNoPositionsGiven()
+{
+    ThumbnailRequest request;
+    request.count = 4; // the middles of the quarters: frames 2.5, 7.5, 12.5 and 17.5
+    request.mode = ThumbnailRequest::Keyframes;
+
+    const auto thumbnails = ThumbnailExtractor::extract(m_clip, request);
+
+    QVERIFY(thumbnails);
+    QCOMPARE(thumbnails.value().size(), qsizetype(4));
+    QCOMPARE(thumbnails.value()[0].pos, frameTimeUs(0));
+    QCOMPARE(thumbnails.value()[1].pos, frameTimeUs(0));
+    QCOMPARE(thumbnails.value()[2].pos, frameTimeUs(ClipGopSize));
+    QCOMPARE(thumbnails.value()[3].pos, frameTimeUs(ClipGopSize));
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_fitsImageIntoMaxSize_data()
+{
+    QTest::addColumn<QSize>("maxSize");
+    QTest::addColumn<QSize>("expectedSize");
+
+    QTest::newRow("no limit") << QSize() << ClipSize;
+    QTest::newRow("larger than the frame") << QSize(640, 640) << ClipSize;
+    // lowres decodes 80x60 directly
+    QTest::newRow("quarter of the frame") << QSize(80, 60) << QSize(80, 60);
+    // lowres decodes 160x120, which is then scaled down keeping the aspect ratio
+    QTest::newRow("square") << QSize(100, 100) << QSize(100, 75);
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_fitsImageIntoMaxSize()
+{
+    QFETCH(QSize, maxSize);
+    QFETCH(QSize, expectedSize);
+
+    ThumbnailRequest request;
+    request.positions = { frameTimeUs(ClipGopSize) };
+    request.maxSize = maxSize;
+
+    const auto thumbnails = ThumbnailExtractor::extract(m_clip, request);
+
+    QVERIFY(thumbnails);
+    QCOMPARE(thumbnails.value().size(), qsizetype(1));
+    QCOMPARE(thumbnails.value()[0].image.size(), expectedSize);
+    QCOMPARE(frameIndexOf(thumbnails.value()[0].image), ClipGopSize);
+}
+
+void tst_QFFmpegThumbnailExtractor::extract_fails_forMissingFile()
+{
+    const QUrl missing = QUrl::fromLocalFile(m_dir.filePath(QStringLiteral("missing.mkv")));
+
+    const auto thumbnails = ThumbnailExtractor::extract(missing, ThumbnailRequest{});
+
+    QVERIFY(!thumbnails);
+}
+
+void tst_QFFmpegThumbnailExtractor::extractAsync_returnsSameThumbnailsAsExtract()
+{
+    ThumbnailRequest request;
+    request.positions = { frameTimeUs(5), frameTimeUs(15) };
+    request.mode = ThumbnailRequest::Exact;
+
+    const auto expected = ThumbnailExtractor::extract(m_clip, request);
+    QVERIFY(expected);
+
+    QFuture<QList<Thumbnail>> future = ThumbnailExtractor::extractAsync(m_clip, request);
+    future.waitForFinished();
+    const QList<Thumbnail> thumbnails = future.result();
+
+    QCOMPARE(thumbnails.size(), expected.value().size());
+    for (qsizetype i = 0; i < thumbnails.size(); ++i) {
+        QCOMPARE(thumbnails[i].pos, expected.value()[i].pos);
+        QCOMPARE(thumbnails[i].image, expected.value()[i].image);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QFFmpegThumbnailExtractor)
+
+#include "tst_qffmpegthumbnailextractor.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
@@ -0,0 +1,246 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/qdir.h>
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtMultimedia/private/qhwvideobuffer_p.h>
+#include <QtMultimedia/private/qvideoframe_p.h>
+
+#include "qv4l2filedescriptor_p.h"
+#include "qv4l2memorytransfer_p.h"
+
+#include <linux/videodev2.h>
+
+#include <thread>
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+constexpr quint32 BuffersCount = 4;
+
+// The tests need the vivid virtual driver: modprobe vivid
+QV4L2FileDescriptorPtr openVividDevice()
+{
+    const QStringList devices = QDir(QStringLiteral("/dev")).entryList({ QStringLiteral("video*") },
+                                                                        QDir::System);
+    for (const QString &device : devices) {
+        const QByteArray path = QFile::encodeName(QStringLiteral("/dev/") + device);
+        const int fd = qt_safe_open(path.constData(), O_RDWR);
+        if (fd < 0)
+            continue;
+
+        auto descriptor = std::make_shared<QV4L2FileDescriptor>(fd);
+
+        v4l2_capability capability = {};
+        if (descriptor->call(VIDIOC_QUERYCAP, &capability)
+            && qstrcmp(reinterpret_cast<const char *>(capability.driver), "vivid") == 0
+            && (capability.device_caps & V4L2_CAP_VIDEO_CAPTURE)
+            && (capability.device_caps & V4L2_CAP_STREAMING))
+            return descriptor;
+    }
+
+    return {};
+}
+
+} // namespace
+
+class tst_QV4L2MemoryTransfer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void dequeueBuffer_referencesDriverMemory_whenEnoughBuffersAreQueued();
+    void releasedFrames_areQueuedAgain_byTransferThread();
+    void frameOutlivingTransfer_keepsItsData_andDeviceRestarts();
+    void dmaBufTransfer_exposesExportedBuffers_viaPrivateApi();
+
+private:
+    void stopStreamIfStarted();
+    std::optional<QV4L2MemoryTransfer::Buffer> dequeueZeroCopyBuffer(QV4L2MemoryTransfer &transfer);
+
+    QV4L2FileDescriptorPtr m_descriptor;
+    QVideoFrameFormat m_format;
+    quint32 m_bytesPerLine = 0;
+};
+
+void tst_QV4L2MemoryTransfer::init()
+{
+    m_descriptor = openVividDevice();
+    if (!m_descriptor)
+        QSKIP("No vivid capture device found");
+
+    v4l2_format format = {};
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    format.fmt.pix.width = 640;
+    format.fmt.pix.height = 480;
+    format.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+    format.fmt.pix.field = V4L2_FIELD_NONE;
+    QVERIFY(m_descriptor->call(VIDIOC_S_FMT, &format));
+
+    m_bytesPerLine = format.fmt.pix.bytesperline;
+    m_format = QVideoFrameFormat(QSize(format.fmt.pix.width, format.fmt.pix.height),
+                                 QVideoFrameFormat::Format_YUYV);
+}
+
+void tst_QV4L2MemoryTransfer::cleanup()
+{
+    m_descriptor.reset();
+}
+
+// The transfers must not be destroyed while streaming, also if a test fails
+void tst_QV4L2MemoryTransfer::stopStreamIfStarted()
+{
+    if (m_descriptor->streamStarted())
+        m_descriptor->stopStream();
+}
+
+std::optional<QV4L2MemoryTransfer::Buffer>
+tst_QV4L2MemoryTransfer::dequeueZeroCopyBuffer(QV4L2MemoryTransfer &transfer)
+{
+    for (quint32 i = 0; i < BuffersCount * 2; ++i) {
+        auto buffer = transfer.dequeueBuffer();
+        if (!buffer)
+            return {};
+        if (buffer->videoBuffer)
+            return buffer;
+        if (!transfer.enqueueBuffer(buffer->v4l2Buffer.index))
+            return {};
+    }
+
+    return {};
+}
+
+void tst_QV4L2MemoryTransfer::dequeueBuffer_referencesDriverMemory_whenEnoughBuffersAreQueued()
+{
+    auto transfer = makeMMapMemoryTransfer(m_descriptor, m_bytesPerLine, BuffersCount);
+    QVERIFY(transfer);
+    QVERIFY(m_descriptor->startStream());
+    auto stopStream = qScopeGuard([this] { stopStreamIfStarted(); });
+
+    // The transfer keeps two buffers in the driver queue, the others may be held by frames
+    std::vector<QVideoFrame> frames;
+    const quint32 heldCount = transfer->buffersCount() - 2;
+    for (quint32 i = 0; i < heldCount; ++i) {
+        auto buffer = transfer->dequeueBuffer();
+        QVERIFY(buffer);
+        QVERIFY(buffer->videoBuffer);
+        QVERIFY(buffer->data.isEmpty());
+        frames.push_back(
+                QVideoFramePrivate::createFrame(std::move(buffer->videoBuffer), m_format));
+    }
+
+    auto copied = transfer->dequeueBuffer();
+    QVERIFY(copied);
+    QVERIFY(!copied->videoBuffer);
+    QVERIFY(copied->data.size() >= qsizetype(m_bytesPerLine) * m_format.frameHeight());
+    QVERIFY(transfer->enqueueBuffer(copied->v4l2Buffer.index));
+
+    frames.clear();
+}
+
+void tst_QV4L2MemoryTransfer::releasedFrames_areQueuedAgain_byTransferThread()
+{
+    auto transfer = makeMMapMemoryTransfer(m_descriptor, m_bytesPerLine, BuffersCount);
+    QVERIFY(transfer);
+    QVERIFY(m_descriptor->startStream());
+    auto stopStream = qScopeGuard([this] { stopStreamIfStarted(); });
+
+    // If the frames released on other threads didn't get their buffers back into
+    // the driver, the transfer would copy all frames after the first two.
+    int zeroCopyFrames = 0;
+    for (quint32 i = 0; i < BuffersCount * 3; ++i) {
+        auto buffer = transfer->dequeueBuffer();
+        QVERIFY(buffer);
+
+        if (!buffer->videoBuffer) {
+            QVERIFY(transfer->enqueueBuffer(buffer->v4l2Buffer.index));
+            continue;
+        }
+
+        ++zeroCopyFrames;
+        QVideoFrame frame =
+                QVideoFramePrivate::createFrame(std::move(buffer->videoBuffer), m_format);
+        std::thread([frame = std::move(frame)]() mutable { frame = {}; }).join();
+    }
+
+    QCOMPARE(zeroCopyFrames, int(BuffersCount) * 3);
+}
+
+void tst_QV4L2MemoryTransfer::frameOutlivingTransfer_keepsItsData_andDeviceRestarts()
+{
+    auto transfer = makeMMapMemoryTransfer(m_descriptor, m_bytesPerLine, BuffersCount);
+    QVERIFY(transfer);
+    QVERIFY(m_descriptor->startStream());
+    auto stopStream = qScopeGuard([this] { stopStreamIfStarted(); });
+
+    auto buffer = dequeueZeroCopyBuffer(*transfer);
+    QVERIFY(buffer);
+
+    QVideoFrame frame = QVideoFramePrivate::createFrame(std::move(buffer->videoBuffer), m_format);
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+    const QByteArray expected(reinterpret_cast<const char *>(frame.bits(0)), frame.mappedBytes(0));
+    frame.unmap();
+
+    QVERIFY(m_descriptor->stopStream());
+    transfer.reset();
+
+    // The frame got a copy of the driver memory, so the device can allocate new buffers
+    transfer = makeMMapMemoryTransfer(m_descriptor, m_bytesPerLine, BuffersCount);
+    QVERIFY2(transfer, qPrintable(qt_error_string(errno)));
+    QVERIFY(m_descriptor->startStream());
+    auto restartedBuffer = transfer->dequeueBuffer();
+    QVERIFY(restartedBuffer);
+
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(frame.bits(0)), frame.mappedBytes(0)),
+             expected);
+    frame.unmap();
+
+    frame = {};
+}
+
+void tst_QV4L2MemoryTransfer::dmaBufTransfer_exposesExportedBuffers_viaPrivateApi()
+{
+    auto transfer = makeDmaBufMemoryTransfer(m_descriptor, m_bytesPerLine, BuffersCount);
+    QVERIFY(transfer);
+    QVERIFY(m_descriptor->startStream());
+    auto stopStream = qScopeGuard([this] { stopStreamIfStarted(); });
+
+    auto buffer = dequeueZeroCopyBuffer(*transfer);
+    QVERIFY(buffer);
+
+    QVideoFrame frame = QVideoFramePrivate::createFrame(std::move(buffer->videoBuffer), m_format);
+    QCOMPARE(frame.handleType(), QVideoFrame::NoHandle);
+
+    QHwVideoBuffer *hwBuffer = QVideoFramePrivate::hwBuffer(frame);
+    QVERIFY(hwBuffer);
+    const QHwVideoBuffer::DmaBufPlane plane = hwBuffer->dmaBufPlane(0);
+    QVERIFY(plane.fd >= 0);
+    QCOMPARE(plane.offset, qsizetype(0));
+    QCOMPARE(plane.stride, int(m_bytesPerLine));
+    QCOMPARE(hwBuffer->dmaBufPlane(1).fd, -1);
+
+    // Exported frames are still mappable
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+    QVERIFY(frame.bits(0));
+    frame.unmap();
+
+    // The export is closed with the transfer, the frame keeps a copy of the data
+    QVERIFY(m_descriptor->stopStream());
+    transfer.reset();
+    QCOMPARE(hwBuffer->dmaBufPlane(0).fd, -1);
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+    frame.unmap();
+}
+
+QTEST_GUILESS_MAIN(tst_QV4L2MemoryTransfer)
+
+#include "tst_qv4l2memorytransfer.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
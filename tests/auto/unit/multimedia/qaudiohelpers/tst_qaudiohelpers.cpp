@@ -0,0 +1,289 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtMultimedia/private/qaudiohelpers_p.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace QAudioHelperInternal;
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+namespace {
+
+// Enough samples for the vectorized kernels plus a scalar tail
+constexpr int SamplesCount = 16 * 5 + 7;
+
+QAudioFormat makeFormat(QAudioFormat::SampleFormat sampleFormat, int channels = 1)
+{
+    QAudioFormat format;
+    format.setSampleFormat(sampleFormat);
+    format.setSampleRate(48000);
+    format.setChannelCount(channels);
+    return format;
+}
+
+template<typename T>
+std::vector<T> makeSamples()
+{
+    std::vector<T> samples(SamplesCount);
+    for (int i = 0; i < SamplesCount; ++i) {
+        const double position = double(i) / (SamplesCount - 1) * 2. - 1.;
+        if constexpr (std::is_same_v<T, float>)
+            samples[i] = float(position);
+        else if constexpr (std::is_same_v<T, quint8>)
+            samples[i] = quint8(qBound(0., 128. + position * 128., 255.));
+        else
+            samples[i] = T(position * std::numeric_limits<T>::max());
+    }
+    return samples;
+}
+
+// The expected result of scaling a sample: computed in float (double for Int32),
+// rounded to nearest even and saturated
+template<typename T>
+T scaledSample(T sample, qreal factor)
+{
+    if constexpr (std::is_same_v<T, float>) {
+        return sample * float(factor);
+    } else if constexpr (std::is_same_v<T, quint8>) {
+        const float value = std::nearbyint((int(sample) - 128) * float(factor));
+        return quint8(128 + qBound(-128.f, value, 127.f));
+    } else if constexpr (std::is_same_v<T, qint16>) {
+        const float value = std::nearbyint(sample * float(factor));
+        return qint16(qBound(-32768.f, value, 32767.f));
+    } else {
+        const double value = std::nearbyint(sample * factor);
+        return qint32(qBound(-2147483648., value, 2147483647.));
+    }
+}
+
+template<typename T>
+void verifyMultiplySamples(QAudioFormat::SampleFormat sampleFormat, qreal factor)
+{
+    const std::vector<T> samples = makeSamples<T>();
+    std::vector<T> result(samples.size());
+
+    qMultiplySamples(factor, makeFormat(sampleFormat), samples.data(), result.data(),
+                     int(samples.size() * sizeof(T)));
+
+    for (size_t i = 0; i < samples.size(); ++i)
+        QCOMPARE(result[i], scaledSample(samples[i], factor));
+}
+
+} // namespace
+
+class tst_QAudioHelpers : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void multiplySamples_matchesScalarReference_data();
+    void multiplySamples_matchesScalarReference();
+    void multiplySamples_saturatesIntegerSamples();
+    void multiplySamples_worksInPlace();
+
+    void rampSamples_interpolatesFactorAcrossFrames();
+    void rampSamples_appliesConstantFactor_whenFactorsAreEqual();
+
+    void convertAndMultiply_convertsUInt8AroundBias();
+    void convertAndMultiply_roundsAndSaturatesIntegerOutput();
+    void convertAndMultiply_clampsFloatOutput();
+    void convertAndMultiply_appliesFactor_whenConvertingBetweenIntegerFormats();
+};
+
+void tst_QAudioHelpers::multiplySamples_matchesScalarReference_data()
+{
+    QTest::addColumn<int>("sampleFormatValue");
+    QTest::addColumn<qreal>("factor");
+
+    for (auto sampleFormat : { QAudioFormat::UInt8, QAudioFormat::Int16, QAudioFormat::Int32,
+                               QAudioFormat::Float }) {
+        for (qreal factor : { 0., 0.3, 0.5, 1., 1.7 }) {
+            QTest::addRow("%s, factor %.1f", qPrintable(QDebug::toString(sampleFormat)), factor)
+                    << int(sampleFormat) << factor;
+        }
+    }
+}
+
+void tst_QAudioHelpers::multiplySamples_matchesScalarReference()
+{
+    QFETCH(const int, sampleFormatValue);
+    QFETCH(const qreal, factor);
+
+    const auto sampleFormat = QAudioFormat::SampleFormat(sampleFormatValue);
+    switch (sampleFormat) {
+    case QAudioFormat::UInt8:
+        verifyMultiplySamples<quint8>(sampleFormat, factor);
+        break;
+    case QAudioFormat::Int16:
+        verifyMultiplySamples<qint16>(sampleFormat, factor);
+        break;
+    case QAudioFormat::Int32:
+        verifyMultiplySamples<qint32>(sampleFormat, factor);
+        break;
+    case QAudioFormat::Float:
+        verifyMultiplySamples<float>(sampleFormat, factor);
+        break;
+    default:
+        QFAIL("Unexpected sample format");
+    }
+}
+
+void tst_QAudioHelpers::multiplySamples_saturatesIntegerSamples()
+{
+    std::vector<qint16> int16Samples(SamplesCount, 20000);
+    int16Samples[3] = -20000;
+    qMultiplySamples(4., makeFormat(QAudioFormat::Int16), int16Samples.data(),
+                     int16Samples.data(), int(int16Samples.size() * sizeof(qint16)));
+    QCOMPARE(int16Samples[0], qint16(32767));
+    QCOMPARE(int16Samples[3], qint16(-32768));
+    QCOMPARE(int16Samples.back(), qint16(32767));
+
+    std::vector<quint8> uint8Samples(SamplesCount, 250);
+    uint8Samples[3] = 5;
+    qMultiplySamples(4., makeFormat(QAudioFormat::UInt8), uint8Samples.data(),
+                     uint8Samples.data(), int(uint8Samples.size()));
+    QCOMPARE(uint8Samples[0], quint8(255));
+    QCOMPARE(uint8Samples[3], quint8(0));
+    QCOMPARE(uint8Samples.back(), quint8(255));
+
+    std::vector<qint32> int32Samples(SamplesCount, 2000000000);
+    int32Samples[3] = -2000000000;
+    qMultiplySamples(2., makeFormat(QAudioFormat::Int32), int32Samples.data(),
+                     int32Samples.data(), int(int32Samples.size() * sizeof(qint32)));
+    QCOMPARE(int32Samples[0], std::numeric_limits<qint32>::max());
+    QCOMPARE(int32Samples[3], std::numeric_limits<qint32>::min());
+}
+
+void tst_QAudioHelpers::multiplySamples_worksInPlace()
+{
+    std::vector<qint16> samples = makeSamples<qint16>();
+    const std::vector<qint16> original = samples;
+
+    qMultiplySamples(0.5, makeFormat(QAudioFormat::Int16), samples.data(), samples.data(),
+                     int(samples.size() * sizeof(qint16)));
+
+    for (size_t i = 0; i < samples.size(); ++i)
+        QCOMPARE(samples[i], scaledSample(original[i], 0.5));
+}
+
+void tst_QAudioHelpers::rampSamples_interpolatesFactorAcrossFrames()
+{
+    constexpr int Channels = 2;
+    constexpr int Frames = 100;
+    const std::vector<qint16> samples(Frames * Channels, 10000);
+    std::vector<qint16> result(samples.size());
+
+    qMultiplySamples(0., 1., makeFormat(QAudioFormat::Int16, Channels), samples.data(),
+                     result.data(), int(samples.size() * sizeof(qint16)));
+
+    for (int frame = 0; frame < Frames; ++frame) {
+        const qint16 expected = qint16(std::nearbyint(10000.f * (float(frame) / Frames)));
+        for (int channel = 0; channel < Channels; ++channel)
+            QCOMPARE(result[frame * Channels + channel], expected);
+    }
+}
+
+void tst_QAudioHelpers::rampSamples_appliesConstantFactor_whenFactorsAreEqual()
+{
+    const std::vector<float> samples = makeSamples<float>();
+    std::vector<float> result(samples.size());
+
+    qMultiplySamples(0.5, 0.5, makeFormat(QAudioFormat::Float, 1), samples.data(), result.data(),
+                     int(samples.size() * sizeof(float)));
+
+    for (size_t i = 0; i < samples.size(); ++i)
+        QCOMPARE(result[i], samples[i] * 0.5f);
+}
+
+void tst_QAudioHelpers::convertAndMultiply_convertsUInt8AroundBias()
+{
+    const quint8 uint8Samples[] = { 0, 64, 128, 255 };
+    float floatSamples[4] = {};
+
+    qConvertAndMultiplySamples(1., makeFormat(QAudioFormat::UInt8), uint8Samples,
+                               makeFormat(QAudioFormat::Float), floatSamples,
+                               int(sizeof(uint8Samples)));
+
+    QCOMPARE(floatSamples[0], -1.f);
+    QCOMPARE(floatSamples[1], -0.5f);
+    QCOMPARE(floatSamples[2], 0.f);
+    QCOMPARE(floatSamples[3], 127.f / 128.f);
+
+    // And back without a loss
+    quint8 roundTrip[4] = {};
+    qConvertAndMultiplySamples(1., makeFormat(QAudioFormat::Float), floatSamples,
+                               makeFormat(QAudioFormat::UInt8), roundTrip,
+                               int(sizeof(floatSamples)));
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(roundTrip[i], uint8Samples[i]);
+}
+
+void tst_QAudioHelpers::convertAndMultiply_roundsAndSaturatesIntegerOutput()
+{
+    const float floatSamples[] = { -2.f, -1.f, 0.75f / 32768.f, 0.5f, 1.f, 2.f };
+    qint16 int16Samples[6] = {};
+    quint8 uint8Samples[6] = {};
+
+    qConvertAndMultiplySamples(1., makeFormat(QAudioFormat::Float), floatSamples,
+                               makeFormat(QAudioFormat::Int16), int16Samples,
+                               int(sizeof(floatSamples)));
+    qConvertAndMultiplySamples(1., makeFormat(QAudioFormat::Float), floatSamples,
+                               makeFormat(QAudioFormat::UInt8), uint8Samples,
+                               int(sizeof(floatSamples)));
+
+    const qint16 expectedInt16[] = { -32768, -32768, 1, 16384, 32767, 32767 };
+    const quint8 expectedUInt8[] = { 0, 0, 128, 192, 255, 255 };
+    for (int i = 0; i < 6; ++i) {
+        QCOMPARE(int16Samples[i], expectedInt16[i]);
+        QCOMPARE(uint8Samples[i], expectedUInt8[i]);
+    }
+}
+
+void tst_QAudioHelpers::convertAndMultiply_clampsFloatOutput()
+{
+    const float samples[] = { -3.f, -0.5f, 0.25f, 1.5f };
+    float result[4] = {};
+
+    qConvertAndMultiplySamples(1., makeFormat(QAudioFormat::Float), samples,
+                               makeFormat(QAudioFormat::Float), result, int(sizeof(samples)));
+
+    QCOMPARE(result[0], -1.f);
+    QCOMPARE(result[1], -0.5f);
+    QCOMPARE(result[2], 0.25f);
+    QCOMPARE(result[3], 1.f);
+
+    const qint16 int16Samples[] = { -32768, 16384 };
+    float fromInt16[2] = {};
+    qConvertAndMultiplySamples(4., makeFormat(QAudioFormat::Int16), int16Samples,
+                               makeFormat(QAudioFormat::Float), fromInt16,
+                               int(sizeof(int16Samples)));
+    QCOMPARE(fromInt16[0], -1.f);
+    QCOMPARE(fromInt16[1], 1.f);
+}
+
+void tst_QAudioHelpers::convertAndMultiply_appliesFactor_whenConvertingBetweenIntegerFormats()
+{
+    const qint16 int16Samples[] = { -32768, -16384, 0, 16384 };
+    qint32 int32Samples[4] = {};
+
+    qConvertAndMultiplySamples(0.5, makeFormat(QAudioFormat::Int16), int16Samples,
+                               makeFormat(QAudioFormat::Int32), int32Samples,
+                               int(sizeof(int16Samples)));
+
+    QCOMPARE(int32Samples[0], -1073741824);
+    QCOMPARE(int32Samples[1], -536870912);
+    QCOMPARE(int32Samples[2], 0);
+    QCOMPARE(int32Samples[3], 536870912);
+}
+
+QTEST_APPLESS_MAIN(tst_QAudioHelpers)
+
+#include "tst_qaudiohelpers.moc"
+
+// NOLINTEND(readability-convert-member-functions-to-static)
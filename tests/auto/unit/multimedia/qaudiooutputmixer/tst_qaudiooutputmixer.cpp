@@ -0,0 +1,252 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtMultimedia/qmediadevices.h>
+#include <private/qaudiooutputmixer_p.h>
+
+namespace {
+
+constexpr int SampleRate = 48000;
+constexpr int Channels = 2;
+
+QAudioFormat makeFormat(QAudioFormat::SampleFormat sampleFormat)
+{
+    QAudioFormat format;
+    format.setSampleRate(SampleRate);
+    format.setChannelCount(Channels);
+    format.setSampleFormat(sampleFormat);
+    return format;
+}
+
+std::shared_ptr<QAudioOutputMixer> makeMixer()
+{
+    return std::make_shared<QAudioOutputMixer>(makeFormat(QAudioFormat::Float));
+}
+
+qint64 writeFrames(QAudioOutputMixerInput &input, float value, qint64 frames)
+{
+    const QList<float> samples(frames * Channels, value);
+    return input.write(reinterpret_cast<const char *>(samples.constData()),
+                       samples.size() * sizeof(float))
+            / qint64(Channels * sizeof(float));
+}
+
+qint64 bufferedFrames(const QAudioOutputMixerInput &input)
+{
+    return (input.bufferSize() - input.bytesFree()) / qint64(Channels * sizeof(float));
+}
+
+template <typename T>
+QList<T> readSamples(QAudioOutputMixer &mixer, qint64 frames)
+{
+    QList<T> result(frames * mixer.format().channelCount());
+    const qint64 bytes = result.size() * sizeof(T);
+    if (mixer.read(reinterpret_cast<char *>(result.data()), bytes) != bytes)
+        return {};
+    return result;
+}
+
+// 960 frames of buffer, 480 frames of target
+constexpr qint64 BufferDurationUs = 20000;
+constexpr qint64 TargetDurationUs = 10000;
+constexpr qint64 TargetFrames = 480;
+
+} // namespace
+
+class tst_QAudioOutputMixer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void read_producesSilence_whenNoInputsAreOpen();
+    void read_sumsInputsWithTheirVolume();
+    void read_clampsMixedSamples_whenOutputIsInt16();
+    void read_makesInputIdle_whenItIsDrained();
+    void read_consumesFaster_whenInputIsAboveTarget();
+    void write_acceptsWholeFramesOnly();
+    void destructor_removesInputFromMixer();
+    void constructor_doesNotOpenInput_whenMixerHasNoFreeInput();
+    void downstreamLatency_isZero_whenMixerHasNoSink();
+    void downstreamLatency_coversSinkBuffer_whenMixerOutputsToDevice();
+};
+
+void tst_QAudioOutputMixer::read_producesSilence_whenNoInputsAreOpen()
+{
+    auto mixer = makeMixer();
+
+    QCOMPARE(readSamples<float>(*mixer, 64), QList<float>(128, 0.f));
+    QCOMPARE(mixer->inputCount(), 0);
+}
+
+void tst_QAudioOutputMixer::read_sumsInputsWithTheirVolume()
+{
+    auto mixer = makeMixer();
+    QAudioOutputMixerInput input1(mixer, BufferDurationUs, TargetDurationUs);
+    QAudioOutputMixerInput input2(mixer, BufferDurationUs, TargetDurationUs);
+    QVERIFY(input1.isOpen());
+    QVERIFY(input2.isOpen());
+    QCOMPARE(input1.state(), QAudio::IdleState);
+
+    input2.setVolume(0.5f);
+    QCOMPARE(writeFrames(input1, 0.25f, TargetFrames), TargetFrames);
+    QCOMPARE(writeFrames(input2, 0.5f, TargetFrames), TargetFrames);
+    QCOMPARE(input1.state(), QAudio::ActiveState);
+
+    const QList<float> samples = readSamples<float>(*mixer, 64);
+
+    QCOMPARE(samples, QList<float>(128, 0.5f));
+    QCOMPARE(input1.state(), QAudio::ActiveState);
+
+    // At the target fill, no drift is compensated; one frame is read ahead for interpolation
+    QCOMPARE(bufferedFrames(input1), TargetFrames - 65);
+}
+
+void tst_QAudioOutputMixer::read_clampsMixedSamples_whenOutputIsInt16()
+{
+    auto mixer = std::make_shared<QAudioOutputMixer>(makeFormat(QAudioFormat::Int16));
+    QCOMPARE(mixer->inputFormat().sampleFormat(), QAudioFormat::Float);
+
+    QAudioOutputMixerInput input1(mixer, BufferDurationUs, TargetDurationUs);
+    QAudioOutputMixerInput input2(mixer, BufferDurationUs, TargetDurationUs);
+    writeFrames(input1, 0.75f, TargetFrames);
+    writeFrames(input2, 0.75f, TargetFrames);
+
+    QCOMPARE(readSamples<qint16>(*mixer, 16), QList<qint16>(32, 32767));
+}
+
+void tst_QAudioOutputMixer::read_makesInputIdle_whenItIsDrained()
+{
+    auto mixer = makeMixer();
+    QAudioOutputMixerInput input(mixer, BufferDurationUs, TargetDurationUs);
+    QSignalSpy stateSpy(&input, &QAudioOutputMixerInput::stateChanged);
+
+    writeFrames(input, 0.5f, 10);
+    const QList<float> samples = readSamples<float>(*mixer, 64);
+
+    QVERIFY(samples.mid(4, 12) != QList<float>(12, 0.f));
+    QCOMPARE(samples.mid(24), QList<float>(104, 0.f));
+    QCOMPARE(bufferedFrames(input), 0);
+    QCOMPARE(input.state(), QAudio::IdleState);
+
+    // Idle is delivered to the input's thread
+    QTRY_COMPARE(stateSpy.size(), 2);
+    QCOMPARE(stateSpy.at(0).front().value<QAudio::State>(), QAudio::ActiveState);
+    QCOMPARE(stateSpy.at(1).front().value<QAudio::State>(), QAudio::IdleState);
+}
+
+void tst_QAudioOutputMixer::read_consumesFaster_whenInputIsAboveTarget()
+{
+    auto mixer = makeMixer();
+
+    // The owner's clock runs ahead of the device: one second buffered, 1 ms of target
+    QAudioOutputMixerInput input(mixer, 2000000, 1000);
+    QCOMPARE(writeFrames(input, 0.5f, SampleRate), SampleRate);
+
+    constexpr qint64 readFrames = 10000;
+    for (int i = 0; i < 10; ++i)
+        readSamples<float>(*mixer, readFrames / 10);
+
+    // Consumed at up to 0.5% faster than the device rate
+    const qint64 consumedFrames = SampleRate - bufferedFrames(input);
+    QCOMPARE_GT(consumedFrames, readFrames + 1);
+    QCOMPARE_LE(consumedFrames, readFrames + readFrames / 200 + 1);
+}
+
+void tst_QAudioOutputMixer::write_acceptsWholeFramesOnly()
+{
+    auto mixer = makeMixer();
+    QAudioOutputMixerInput input(mixer, BufferDurationUs, TargetDurationUs);
+    QCOMPARE(input.bufferSize(), qsizetype(2 * TargetFrames * Channels * sizeof(float)));
+
+    const float samples[3] = { 0.1f, 0.2f, 0.3f };
+    QCOMPARE(input.write(reinterpret_cast<const char *>(samples), sizeof(samples)),
+             qint64(Channels * sizeof(float)));
+    QCOMPARE(bufferedFrames(input), 1);
+
+    // The excess of a full buffer isn't accepted
+    QCOMPARE(writeFrames(input, 0.f, 2 * TargetFrames), 2 * TargetFrames - 1);
+    QCOMPARE(input.bytesFree(), 0);
+}
+
+void tst_QAudioOutputMixer::destructor_removesInputFromMixer()
+{
+    auto mixer = makeMixer();
+    {
+        QAudioOutputMixerInput input(mixer, BufferDurationUs, TargetDurationUs);
+        writeFrames(input, 0.5f, TargetFrames);
+        QCOMPARE(mixer->inputCount(), 1);
+    }
+
+    QCOMPARE(mixer->inputCount(), 0);
+    QCOMPARE(readSamples<float>(*mixer, 8), QList<float>(16, 0.f));
+}
+
+void tst_QAudioOutputMixer::constructor_doesNotOpenInput_whenMixerHasNoFreeInput()
+{
+    auto mixer = makeMixer();
+    std::vector<std::unique_ptr<QAudioOutputMixerInput>> inputs;
+    for (int i = 0; i < QAudioOutputMixer::MaxInputs; ++i) {
+        inputs.push_back(std::make_unique<QAudioOutputMixerInput>(mixer, BufferDurationUs,
+                                                                  TargetDurationUs));
+        QVERIFY(inputs.back()->isOpen());
+    }
+
+    {
+        QTest::ignoreMessage(QtWarningMsg, "No free input, the limit is 32");
+        QAudioOutputMixerInput input(mixer, BufferDurationUs, TargetDurationUs);
+        QVERIFY(!input.isOpen());
+    }
+
+    // The input that hasn't been opened doesn't free a slot
+    QCOMPARE(mixer->inputCount(), QAudioOutputMixer::MaxInputs);
+
+    inputs.pop_back();
+    QCOMPARE(mixer->inputCount(), QAudioOutputMixer::MaxInputs - 1);
+}
+
+void tst_QAudioOutputMixer::downstreamLatency_isZero_whenMixerHasNoSink()
+{
+    auto mixer = makeMixer();
+    QAudioOutputMixerInput input(mixer, BufferDurationUs, TargetDurationUs);
+    writeFrames(input, 0.5f, TargetFrames);
+
+    readSamples<float>(*mixer, 64);
+
+    // The caller of read() accounts for what it buffers
+    QCOMPARE(input.downstreamLatencyUs(), qint64(0));
+}
+
+void tst_QAudioOutputMixer::downstreamLatency_coversSinkBuffer_whenMixerOutputsToDevice()
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (device.isNull())
+        QSKIP("No audio output device");
+
+    auto mixer = QAudioOutputMixer::instance(device);
+    if (!mixer)
+        QSKIP("The audio output device has no preferred format");
+
+    const QAudioFormat format = mixer->format();
+    const qint64 bytesPerFrame = mixer->inputFormat().bytesPerFrame();
+    QAudioOutputMixerInput input(mixer, 200000, 100000);
+    QVERIFY(input.isOpen());
+
+    // 40 ms of the sink buffer until the first mix cycle measures it
+    QCOMPARE_GT(input.downstreamLatencyUs(), 0);
+
+    const QList<float> samples(format.framesForDuration(100000) * format.channelCount(), 0.f);
+    const qint64 written = input.write(reinterpret_cast<const char *>(samples.constData()),
+                                       samples.size() * sizeof(float));
+    QCOMPARE(written, qint64(samples.size() * sizeof(float)));
+
+    // The mixer pulls the input into the sink
+    QTRY_COMPARE_LT(input.bufferSize() - input.bytesFree(), written - bytesPerFrame);
+
+    QCOMPARE_GT(input.downstreamLatencyUs(), 0);
+    QCOMPARE_LT(input.downstreamLatencyUs(), 1000000);
+}
+
+QTEST_GUILESS_MAIN(tst_QAudioOutputMixer)
+
+#include "tst_qaudiooutputmixer.moc"
@@ -0,0 +1,172 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtMultimedia/private/qaudiotelemetry_p.h>
+
+#include <thread>
+
+// NOLINTBEGIN(readability-convert-member-functions-to-static)
+
+class tst_QAudioTelemetry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void snapshot_isEmpty_byDefault();
+    void counters_areAccumulated();
+    void recordCallback_sortsJitterIntoBuckets();
+    void recordCallback_ignoresFirstCallback();
+    void recordUserCallbackTime_keepsTotalAndMax();
+    void userCallbackScope_recordsElapsedTime();
+    void reset_clearsStatistics();
+    void snapshot_isConsistent_whenUpdatedFromAnotherThread();
+};
+
+void tst_QAudioTelemetry::snapshot_isEmpty_byDefault()
+{
+    QAudioTelemetry telemetry;
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+
+    QCOMPARE(snapshot.latencyUs, -1);
+    QCOMPARE(snapshot.bufferFill, 0);
+    QCOMPARE(snapshot.bufferSize, 0);
+    QCOMPARE(snapshot.underrunCount, 0u);
+    QCOMPARE(snapshot.overrunCount, 0u);
+    QCOMPARE(snapshot.callbackCount, 0u);
+    for (quint64 count : snapshot.jitterHistogram)
+        QCOMPARE(count, 0u);
+    QCOMPARE(snapshot.maxJitterUs, 0);
+    QCOMPARE(snapshot.userCallbackTimeUs, 0);
+    QCOMPARE(snapshot.maxUserCallbackTimeUs, 0);
+}
+
+void tst_QAudioTelemetry::counters_areAccumulated()
+{
+    QAudioTelemetry telemetry;
+    telemetry.addUnderrun();
+    telemetry.addUnderrun();
+    telemetry.addOverrun();
+    telemetry.setLatency(20000);
+    telemetry.setBufferFill(1024, 4096);
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.underrunCount, 2u);
+    QCOMPARE(snapshot.overrunCount, 1u);
+    QCOMPARE(snapshot.latencyUs, 20000);
+    QCOMPARE(snapshot.bufferFill, 1024);
+    QCOMPARE(snapshot.bufferSize, 4096);
+}
+
+void tst_QAudioTelemetry::recordCallback_sortsJitterIntoBuckets()
+{
+    QAudioTelemetry telemetry;
+    constexpr qint64 interval = 10000;
+
+    qint64 now = 1000000;
+    telemetry.recordCallback(interval, now);
+
+    // Deviations of 0, 300 (early), 1500, 30000 us
+    for (qint64 deviation : { 0, -300, 1500, 30000 }) {
+        now += interval + deviation;
+        telemetry.recordCallback(interval, now);
+    }
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.callbackCount, 5u);
+    QCOMPARE(snapshot.jitterHistogram[0], 1u); // <= 100
+    QCOMPARE(snapshot.jitterHistogram[1], 1u); // <= 500
+    QCOMPARE(snapshot.jitterHistogram[3], 1u); // <= 2000
+    QCOMPARE(snapshot.jitterHistogram[QAudioTelemetry::JitterBucketCount - 1], 1u);
+    QCOMPARE(snapshot.maxJitterUs, 30000);
+}
+
+void tst_QAudioTelemetry::recordCallback_ignoresFirstCallback()
+{
+    QAudioTelemetry telemetry;
+    telemetry.recordCallback(10000, 5000000);
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.callbackCount, 1u);
+    for (quint64 count : snapshot.jitterHistogram)
+        QCOMPARE(count, 0u);
+}
+
+void tst_QAudioTelemetry::recordUserCallbackTime_keepsTotalAndMax()
+{
+    QAudioTelemetry telemetry;
+    telemetry.recordUserCallbackTime(100);
+    telemetry.recordUserCallbackTime(300);
+    telemetry.recordUserCallbackTime(200);
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.userCallbackTimeUs, 600);
+    QCOMPARE(snapshot.maxUserCallbackTimeUs, 300);
+}
+
+void tst_QAudioTelemetry::userCallbackScope_recordsElapsedTime()
+{
+    QAudioTelemetry telemetry;
+    {
+        QAudioTelemetry::UserCallbackScope scope(telemetry);
+        QThread::msleep(5);
+    }
+
+    QCOMPARE_GE(telemetry.snapshot().userCallbackTimeUs, 5000);
+}
+
+void tst_QAudioTelemetry::reset_clearsStatistics()
+{
+    QAudioTelemetry telemetry;
+    telemetry.addUnderrun();
+    telemetry.setLatency(1000);
+    telemetry.recordCallback(1000, 1000);
+    telemetry.recordCallback(1000, 5000);
+    telemetry.recordUserCallbackTime(100);
+
+    telemetry.reset();
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.underrunCount, 0u);
+    QCOMPARE(snapshot.latencyUs, -1);
+    QCOMPARE(snapshot.callbackCount, 0u);
+    QCOMPARE(snapshot.maxJitterUs, 0);
+    QCOMPARE(snapshot.userCallbackTimeUs, 0);
+
+    // The interval isn't measured from the callback before the reset
+    telemetry.recordCallback(1000, 100000);
+    QCOMPARE(telemetry.snapshot().maxJitterUs, 0);
+}
+
+void tst_QAudioTelemetry::snapshot_isConsistent_whenUpdatedFromAnotherThread()
+{
+    QAudioTelemetry telemetry;
+    constexpr int iterations = 100000;
+
+    std::thread writer([&] {
+        for (int i = 0; i < iterations; ++i) {
+            telemetry.addUnderrun();
+            telemetry.recordUserCallbackTime(1);
+        }
+    });
+
+    // Counters never go backwards for the reader
+    quint64 previous = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const quint64 current = telemetry.snapshot().underrunCount;
+        QCOMPARE_GE(current, previous);
+        previous = current;
+    }
+
+    writer.join();
+
+    const QAudioTelemetry::Snapshot snapshot = telemetry.snapshot();
+    QCOMPARE(snapshot.underrunCount, quint64(iterations));
+    QCOMPARE(snapshot.userCallbackTimeUs, iterations);
+    QCOMPARE(snapshot.maxUserCallbackTimeUs, 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QAudioTelemetry);
+
+#include "tst_qaudiotelemetry.moc"
@@ -18,6 +18,7 @@ private slots:
     void testNotEnoughCapacity();
     void testInvalidFile();
     void testIncompatibleFile();
+    void testMappedSample();
 
 private:
 
@@ -165,6 +166,41 @@ void tst_QSampleCache::testIncompatibleFile()
     }
 }
 
+void tst_QSampleCache::testMappedSample()
+{
+    QSampleCache cache;
+    cache.setMappingEnabled(true);
+    cache.setCapacity(1); // mapped samples don't count towards the capacity
+
+    const QUrl url = QUrl::fromLocalFile(QFINDTESTDATA("testdata/test.wav"));
+    QSample *sample = cache.requestSample(url);
+    QVERIFY(sample);
+    QTRY_COMPARE(sample->state(), QSample::Ready);
+    QTRY_VERIFY(!cache.isLoading());
+
+    QVERIFY(sample->isMapped());
+    QVERIFY(!sample->data().isEmpty());
+    QCOMPARE(sample->format().sampleFormat(), QAudioFormat::Int16);
+    QCOMPARE(sample->format().sampleRate(), 44100);
+    QCOMPARE(sample->format().channelCount(), 1);
+    QCOMPARE(cache.mappedUsage(), sample->data().size());
+    QCOMPARE(cache.usage(), 0);
+
+    // The mapped data is the same as the decoded one
+    QSampleCache decodingCache;
+    decodingCache.setMappingEnabled(false);
+    QSample *decodedSample = decodingCache.requestSample(url);
+    QTRY_COMPARE(decodedSample->state(), QSample::Ready);
+    QTRY_VERIFY(!decodingCache.isLoading());
+    QVERIFY(!decodedSample->isMapped());
+    QCOMPARE(sample->data(), decodedSample->data());
+    decodedSample->release();
+
+    sample->release();
+    QVERIFY(!cache.isCached(url));
+    QCOMPARE(cache.mappedUsage(), qint64(0));
+}
+
 QTEST_MAIN(tst_QSampleCache)
 
 #include "tst_qsamplecache.moc"
@@ -0,0 +1,167 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <private/qsoundeffectmixer_p.h>
+
+namespace {
+
+QAudioFormat makeFormat(QAudioFormat::SampleFormat sampleFormat)
+{
+    QAudioFormat format;
+    format.setSampleRate(48000);
+    format.setChannelCount(2);
+    format.setSampleFormat(sampleFormat);
+    return format;
+}
+
+class TestVoice : public QSoundEffectMixer::Voice
+{
+public:
+    TestVoice(float value, qint64 frames, int channels)
+        : m_value(value), m_remainingFrames(frames), m_channels(channels)
+    {
+    }
+
+    bool mix(float *accumulator, qint64 frames) override
+    {
+        const qint64 toMix = qMin(frames, m_remainingFrames);
+        for (qint64 i = 0; i < toMix * m_channels; ++i)
+            accumulator[i] += m_value;
+        m_remainingFrames -= toMix;
+        return m_remainingFrames > 0;
+    }
+
+    void voiceStopped() override { ++stoppedCount; }
+
+    int stoppedCount = 0;
+
+private:
+    float m_value;
+    qint64 m_remainingFrames;
+    int m_channels;
+};
+
+template <typename T>
+QList<T> readSamples(QSoundEffectMixer &mixer, qint64 frames)
+{
+    QList<T> result(frames * mixer.format().channelCount());
+    const qint64 bytes = result.size() * sizeof(T);
+    if (mixer.read(reinterpret_cast<char *>(result.data()), bytes) != bytes)
+        return {};
+    return result;
+}
+
+} // namespace
+
+class tst_QSoundEffectMixer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void read_producesSilence_whenNoVoicesAreActive();
+    void read_sumsActiveVoices();
+    void read_removesFinishedVoices();
+    void read_clampsMixedSamples_whenOutputIsInt16();
+    void startVoice_stealsOldestVoice_whenPolyphonyLimitIsReached();
+    void stopVoice_removesVoiceWithoutNotification();
+};
+
+void tst_QSoundEffectMixer::read_producesSilence_whenNoVoicesAreActive()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Float));
+
+    const QList<float> samples = readSamples<float>(mixer, 64);
+
+    QCOMPARE(samples, QList<float>(128, 0.f));
+}
+
+void tst_QSoundEffectMixer::read_sumsActiveVoices()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Float));
+    TestVoice voice1(0.25f, 100, 2);
+    TestVoice voice2(0.5f, 100, 2);
+    mixer.startVoice(&voice1);
+    mixer.startVoice(&voice2);
+
+    const QList<float> samples = readSamples<float>(mixer, 64);
+
+    QCOMPARE(samples, QList<float>(128, 0.75f));
+    QCOMPARE(mixer.activeVoiceCount(), 2);
+    QCOMPARE(voice1.stoppedCount, 0);
+
+    mixer.stopVoice(&voice1);
+    mixer.stopVoice(&voice2);
+}
+
+void tst_QSoundEffectMixer::read_removesFinishedVoices()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Float));
+    TestVoice voice(0.5f, 10, 2);
+    mixer.startVoice(&voice);
+
+    const QList<float> samples = readSamples<float>(mixer, 64);
+
+    QCOMPARE(samples.mid(0, 20), QList<float>(20, 0.5f));
+    QCOMPARE(samples.mid(20), QList<float>(108, 0.f));
+    QCOMPARE(mixer.activeVoiceCount(), 0);
+    QCOMPARE(voice.stoppedCount, 1);
+}
+
+void tst_QSoundEffectMixer::read_clampsMixedSamples_whenOutputIsInt16()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Int16));
+    QCOMPARE(mixer.voiceFormat().sampleFormat(), QAudioFormat::Float);
+
+    TestVoice voice1(0.75f, 100, 2);
+    TestVoice voice2(0.75f, 100, 2);
+    mixer.startVoice(&voice1);
+    mixer.startVoice(&voice2);
+
+    const QList<qint16> samples = readSamples<qint16>(mixer, 16);
+
+    QCOMPARE(samples, QList<qint16>(32, 32767));
+
+    mixer.stopVoice(&voice1);
+    mixer.stopVoice(&voice2);
+}
+
+void tst_QSoundEffectMixer::startVoice_stealsOldestVoice_whenPolyphonyLimitIsReached()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Float));
+    mixer.setMaxVoices(2);
+
+    TestVoice voice1(0.1f, 100, 2);
+    TestVoice voice2(0.1f, 100, 2);
+    TestVoice voice3(0.1f, 100, 2);
+    mixer.startVoice(&voice1);
+    mixer.startVoice(&voice2);
+    mixer.startVoice(&voice3);
+
+    QCOMPARE(mixer.activeVoiceCount(), 2);
+    QVERIFY(!mixer.isVoiceActive(&voice1));
+    QVERIFY(mixer.isVoiceActive(&voice2));
+    QVERIFY(mixer.isVoiceActive(&voice3));
+    QCOMPARE(voice1.stoppedCount, 1);
+    QCOMPARE(voice2.stoppedCount, 0);
+
+    mixer.stopVoice(&voice2);
+    mixer.stopVoice(&voice3);
+}
+
+void tst_QSoundEffectMixer::stopVoice_removesVoiceWithoutNotification()
+{
+    QSoundEffectMixer mixer(makeFormat(QAudioFormat::Float));
+    TestVoice voice(0.5f, 100, 2);
+    mixer.startVoice(&voice);
+
+    mixer.stopVoice(&voice);
+
+    QCOMPARE(mixer.activeVoiceCount(), 0);
+    QCOMPARE(voice.stoppedCount, 0);
+    QCOMPARE(readSamples<float>(mixer, 8), QList<float>(16, 0.f));
+}
+
+QTEST_GUILESS_MAIN(tst_QSoundEffectMixer)
+
+#include "tst_qsoundeffectmixer.moc"
@@ -13,6 +13,7 @@
 #include <QtCore/QPointer>
 #include <QtMultimedia/private/qtmultimedia-config_p.h>
 #include "private/qvideoframeconverter_p.h"
+#include "private/qvideotransformation_p.h"
 #include <private/mediabackendutils_p.h>
 
 // Adds an enum, and the stringized version
@@ -213,6 +214,9 @@ private slots:
     void qImageFromVideoFrame_doesNotCrash_whenCalledWithEvenAndOddSizedFrames_data();
     void qImageFromVideoFrame_doesNotCrash_whenCalledWithEvenAndOddSizedFrames();
 
+    void qImageFromVideoFrameOnCpu_matchesSingleThreadedConversionAndQImageTransform_data();
+    void qImageFromVideoFrameOnCpu_matchesSingleThreadedConversionAndQImageTransform();
+
     void isMapped();
     void isReadable();
     void isWritable();
@@ -1085,6 +1089,76 @@ void tst_QVideoFrame::qImageFromVideoFrame_doesNotCrash_whenCalledWithEvenAndOdd
     // TODO: Investigate why 16 bit formats fail on some Android flavors.
 }
 
+void tst_QVideoFrame::qImageFromVideoFrameOnCpu_matchesSingleThreadedConversionAndQImageTransform_data()
+{
+    QTest::addColumn<QVideoFrameFormat::PixelFormat>("pixelFormat");
+    QTest::addColumn<QtVideo::Rotation>("rotation");
+    QTest::addColumn<bool>("mirrored");
+    QTest::addColumn<int>("threadCount");
+
+    const QVideoFrameFormat::PixelFormat pixelFormats[] = {
+        QVideoFrameFormat::Format_ARGB8888, QVideoFrameFormat::Format_YUV420P,
+        QVideoFrameFormat::Format_NV12,     QVideoFrameFormat::Format_IMC2,
+        QVideoFrameFormat::Format_UYVY,     QVideoFrameFormat::Format_P010,
+    };
+    const QtVideo::Rotation rotations[] = {
+        QtVideo::Rotation::None,
+        QtVideo::Rotation::Clockwise90,
+        QtVideo::Rotation::Clockwise180,
+        QtVideo::Rotation::Clockwise270,
+    };
+
+    for (const QVideoFrameFormat::PixelFormat pixelFormat : pixelFormats) {
+        for (const QtVideo::Rotation rotation : rotations) {
+            for (const bool mirrored : { false, true }) {
+                for (const int threadCount : { 1, 4 }) {
+                    QTest::addRow("%s_%d%s_%dthreads",
+                                  QVideoFrameFormat::pixelFormatToString(pixelFormat)
+                                          .toLatin1()
+                                          .constData(),
+                                  qToUnderlying(rotation), mirrored ? "_mirrored" : "",
+                                  threadCount)
+                            << pixelFormat << rotation << mirrored << threadCount;
+                }
+            }
+        }
+    }
+}
+
+void tst_QVideoFrame::qImageFromVideoFrameOnCpu_matchesSingleThreadedConversionAndQImageTransform()
+{
+    QFETCH(const QVideoFrameFormat::PixelFormat, pixelFormat);
+    QFETCH(const QtVideo::Rotation, rotation);
+    QFETCH(const bool, mirrored);
+    QFETCH(const int, threadCount);
+
+    // even size, so that every pixel is written; the height spans several tiles
+    QVideoFrame frame(QVideoFrameFormat({ 202, 150 }, pixelFormat));
+    QVERIFY(frame.map(QVideoFrame::WriteOnly));
+    for (int plane = 0; plane < frame.planeCount(); ++plane) {
+        uchar *bits = frame.bits(plane);
+        for (int i = 0; i < frame.mappedBytes(plane); ++i)
+            bits[i] = uchar(i * 7 + plane * 31);
+    }
+    frame.unmap();
+
+    VideoTransformation transformation;
+    transformation.rotation = rotation;
+    transformation.mirrorredHorizontallyAfterRotation = mirrored;
+
+    const QImage actual = qImageFromVideoFrameOnCpu(frame, transformation, threadCount);
+
+    QTransform transform;
+    transform.rotate(qreal(rotation));
+    if (mirrored)
+        transform.scale(-1., 1);
+    const QImage expected = qImageFromVideoFrameOnCpu(frame, {}, 1).transformed(transform);
+
+    QCOMPARE(actual.size(), expected.size());
+    QCOMPARE(actual.convertToFormat(QImage::Format_ARGB32_Premultiplied),
+             expected.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+}
+
 #define TEST_MAPPED(frame, mode) \
 do { \
     QVERIFY(frame.bits(0)); \
@@ -0,0 +1,174 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+// TESTED_COMPONENT=src/multimedia
+
+#include <QtTest/QtTest>
+#include <QtCore/qrandom.h>
+#include <qvideoframe.h>
+#include <qvideoframeformat.h>
+#include <private/qvideoframeconversionhelper_p.h>
+
+QT_USE_NAMESPACE
+
+namespace {
+
+QVideoFrame createRandomFrame(QVideoFrameFormat::PixelFormat pixelFormat, QSize size)
+{
+    QVideoFrame frame(QVideoFrameFormat(size, pixelFormat));
+    if (!frame.map(QVideoFrame::WriteOnly))
+        return {};
+
+    QRandomGenerator generator(size.width() * 1000 + size.height());
+    for (int plane = 0; plane < frame.planeCount(); ++plane) {
+        uchar *bits = frame.bits(plane);
+        for (int i = 0; i < frame.mappedBytes(plane); ++i)
+            bits[i] = uchar(generator.bounded(256));
+    }
+
+    frame.unmap();
+    return frame;
+}
+
+const QVideoFrameFormat::PixelFormat YuvPixelFormats[] = {
+    QVideoFrameFormat::Format_YUV420P, QVideoFrameFormat::Format_YUV422P,
+    QVideoFrameFormat::Format_YV12,    QVideoFrameFormat::Format_UYVY,
+    QVideoFrameFormat::Format_YUYV,    QVideoFrameFormat::Format_NV12,
+    QVideoFrameFormat::Format_NV21,    QVideoFrameFormat::Format_IMC1,
+    QVideoFrameFormat::Format_IMC2,    QVideoFrameFormat::Format_IMC3,
+    QVideoFrameFormat::Format_IMC4,    QVideoFrameFormat::Format_P010,
+    QVideoFrameFormat::Format_P016,
+};
+
+// The widths cover the vector loops, their leftovers and odd sizes; 15, 31 and 63
+// leave the longest tails for 16 and 32 pixels per iteration
+const QSize FrameSizes[] = { { 2, 2 },   { 7, 3 },   { 8, 2 },   { 15, 3 },   { 16, 4 },
+                             { 17, 5 },  { 31, 7 },  { 33, 6 },  { 63, 9 },   { 64, 16 },
+                             { 65, 3 },  { 131, 17 }, { 640, 480 } };
+
+QByteArray formatName(QVideoFrameFormat::PixelFormat pixelFormat)
+{
+    return QVideoFrameFormat::pixelFormatToString(pixelFormat).toLatin1();
+}
+
+std::vector<quint32> convert(VideoFrameConvertFunc converter, QVideoFrame &frame)
+{
+    // prefill with a pattern so that untouched pixels compare equal as well
+    std::vector<quint32> result(frame.width() * frame.height(), 0xdeadbeef);
+    converter(frame, reinterpret_cast<uchar *>(result.data()));
+    return result;
+}
+
+} // namespace
+
+class tst_QVideoFrameConversionHelper : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void converter_isBitExactWithGenericConverter_data();
+    void converter_isBitExactWithGenericConverter();
+    void simdConverter_isBitExactWithGenericConverter_data();
+    void simdConverter_isBitExactWithGenericConverter();
+};
+
+void tst_QVideoFrameConversionHelper::converter_isBitExactWithGenericConverter_data()
+{
+    QTest::addColumn<QVideoFrameFormat::PixelFormat>("pixelFormat");
+    QTest::addColumn<QSize>("size");
+
+    for (QVideoFrameFormat::PixelFormat pixelFormat : YuvPixelFormats) {
+        for (QSize size : FrameSizes) {
+            QTest::addRow("%s_%dx%d", formatName(pixelFormat).constData(), size.width(),
+                          size.height())
+                    << pixelFormat << size;
+        }
+    }
+}
+
+void tst_QVideoFrameConversionHelper::converter_isBitExactWithGenericConverter()
+{
+    QFETCH(QVideoFrameFormat::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+
+    VideoFrameConvertFunc converter = qConverterForFormat(pixelFormat);
+    VideoFrameConvertFunc genericConverter = qGenericConverterForFormat(pixelFormat);
+    QVERIFY(converter);
+    QVERIFY(genericConverter);
+
+    QVideoFrame frame = createRandomFrame(pixelFormat, size);
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+
+    const std::vector<quint32> expected = convert(genericConverter, frame);
+    const std::vector<quint32> actual = convert(converter, frame);
+
+    frame.unmap();
+
+    QCOMPARE(actual, expected);
+}
+
+void tst_QVideoFrameConversionHelper::simdConverter_isBitExactWithGenericConverter_data()
+{
+    QTest::addColumn<VideoFrameConverterIsa>("isa");
+    QTest::addColumn<QVideoFrameFormat::PixelFormat>("pixelFormat");
+    QTest::addColumn<QSize>("size");
+
+    const std::pair<VideoFrameConverterIsa, const char *> isas[] = {
+        { VideoFrameConverterIsa::Sse2, "sse2" },
+        { VideoFrameConverterIsa::Ssse3, "ssse3" },
+        { VideoFrameConverterIsa::Avx2, "avx2" },
+        { VideoFrameConverterIsa::Neon, "neon" },
+    };
+
+    // The swizzling converters of straight alpha and X formats keep the alpha byte as is,
+    // whereas the generic ones premultiply or make it opaque; compare the premultiplied ones.
+    std::vector<QVideoFrameFormat::PixelFormat> pixelFormats(std::begin(YuvPixelFormats),
+                                                             std::end(YuvPixelFormats));
+    pixelFormats.push_back(QVideoFrameFormat::Format_ARGB8888_Premultiplied);
+    pixelFormats.push_back(QVideoFrameFormat::Format_BGRA8888_Premultiplied);
+
+    bool hasConverters = false;
+    for (const auto &[isa, isaName] : isas) {
+        for (QVideoFrameFormat::PixelFormat pixelFormat : pixelFormats) {
+            // the instruction sets the CPU doesn't support give no converters
+            if (!qSimdConverterForFormat(pixelFormat, isa))
+                continue;
+
+            hasConverters = true;
+            for (QSize size : FrameSizes) {
+                QTest::addRow("%s_%s_%dx%d", isaName, formatName(pixelFormat).constData(),
+                              size.width(), size.height())
+                        << isa << pixelFormat << size;
+            }
+        }
+    }
+
+    if (!hasConverters)
+        QSKIP("No SIMD converters for this CPU");
+}
+
+void tst_QVideoFrameConversionHelper::simdConverter_isBitExactWithGenericConverter()
+{
+    QFETCH(VideoFrameConverterIsa, isa);
+    QFETCH(QVideoFrameFormat::PixelFormat, pixelFormat);
+    QFETCH(QSize, size);
+
+    VideoFrameConvertFunc converter = qSimdConverterForFormat(pixelFormat, isa);
+    VideoFrameConvertFunc genericConverter = qGenericConverterForFormat(pixelFormat);
+    QVERIFY(converter);
+    QVERIFY(genericConverter);
+
+    QVideoFrame frame = createRandomFrame(pixelFormat, size);
+    QVERIFY(frame.map(QVideoFrame::ReadOnly));
+
+    const std::vector<quint32> expected = convert(genericConverter, frame);
+    const std::vector<quint32> actual = convert(converter, frame);
+
+    frame.unmap();
+
+    QCOMPARE(actual, expected);
+}
+
+QTEST_APPLESS_MAIN(tst_QVideoFrameConversionHelper)
+
+#include "tst_qvideoframeconversionhelper.moc"